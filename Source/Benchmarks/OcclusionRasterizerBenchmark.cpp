@@ -0,0 +1,292 @@
+/*+===================================================================
+  File:      OCCLUSIONRASTERIZERBENCHMARK.CPP
+
+  Summary:   Times the software occlusion rasterizer on a terrain-like
+             grid of chunk occluder boxes, the same work the renderer
+             does every frame: binning the chunk boxes, drawing the
+             depth buffer on the calling thread and on a thread pool,
+             and testing every chunk against it.
+
+  Functions: main
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "Renderer/OcclusionRasterizer.h"
+#include "Thread/ThreadPool.h"
+
+namespace
+{
+    constexpr const uint32_t NUM_CHUNKS_X = 64u;
+    constexpr const uint32_t NUM_CHUNKS_Z = 64u;
+    constexpr const float CHUNK_SIZE = 16.0f;
+    constexpr const uint32_t DEFAULT_NUM_FRAMES = 200u;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   ChunkBox
+
+      Summary:  Solid part of a chunk used as an occluder and the full
+                bounds of the chunk tested against the depth buffer
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ChunkBox
+    {
+        float OccluderMin[3];
+        float OccluderMax[3];
+        float BoundsMin[3];
+        float BoundsMax[3];
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   FrameTimes
+
+      Summary:  Milliseconds spent in each step, summed over the frames
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct FrameTimes
+    {
+        double Add;
+        double Rasterize;
+        double Query;
+        uint32_t uNumTriangles;
+        uint32_t uNumHidden;
+    };
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: makeViewProjection
+
+      Summary:  Builds a row-major view-projection the same way
+                XMMatrixLookAtLH and XMMatrixPerspectiveFovLH do, with
+                a 90 degree vertical field of view
+
+      Args:     const float* pEye
+                  Position of the camera
+                const float* pAt
+                  Point the camera looks at
+                float* pViewProjection
+                  Resulting 4x4 matrix
+
+      Modifies: [pViewProjection].
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void makeViewProjection(const float* pEye, const float* pAt, float* pViewProjection)
+    {
+        float aAxisZ[3] = { pAt[0] - pEye[0], pAt[1] - pEye[1], pAt[2] - pEye[2] };
+        const float lengthZ = std::sqrt(aAxisZ[0] * aAxisZ[0] + aAxisZ[1] * aAxisZ[1] + aAxisZ[2] * aAxisZ[2]);
+        for (float& component : aAxisZ)
+        {
+            component /= lengthZ;
+        }
+
+        // x = normalize(cross(up, z)) with up = (0, 1, 0), y = cross(z, x)
+        float aAxisX[3] = { aAxisZ[2], 0.0f, -aAxisZ[0] };
+        const float lengthX = std::sqrt(aAxisX[0] * aAxisX[0] + aAxisX[2] * aAxisX[2]);
+        aAxisX[0] /= lengthX;
+        aAxisX[2] /= lengthX;
+        const float aAxisY[3] =
+        {
+            aAxisZ[1] * aAxisX[2] - aAxisZ[2] * aAxisX[1],
+            aAxisZ[2] * aAxisX[0] - aAxisZ[0] * aAxisX[2],
+            aAxisZ[0] * aAxisX[1] - aAxisZ[1] * aAxisX[0],
+        };
+
+        const float* apAxes[3] = { aAxisX, aAxisY, aAxisZ };
+        float aView[16] = { 0.0f, };
+        for (uint32_t uAxisIdx = 0u; uAxisIdx < 3u; ++uAxisIdx)
+        {
+            const float* pAxis = apAxes[uAxisIdx];
+            aView[0u * 4u + uAxisIdx] = pAxis[0];
+            aView[1u * 4u + uAxisIdx] = pAxis[1];
+            aView[2u * 4u + uAxisIdx] = pAxis[2];
+            aView[3u * 4u + uAxisIdx] = -(pAxis[0] * pEye[0] + pAxis[1] * pEye[1] + pAxis[2] * pEye[2]);
+        }
+        aView[15] = 1.0f;
+
+        const float nearPlane = 0.01f;
+        const float farPlane = 1000.0f;
+        const float scaleY = 1.0f / std::tan(0.25f * 3.14159265f);
+        const float range = farPlane / (farPlane - nearPlane);
+        const float aProjection[16] =
+        {
+            scaleY * static_cast<float>(library::OcclusionRasterizer::DEFAULT_HEIGHT) / static_cast<float>(library::OcclusionRasterizer::DEFAULT_WIDTH), 0.0f, 0.0f, 0.0f,
+            0.0f, scaleY, 0.0f, 0.0f,
+            0.0f, 0.0f, range, 1.0f,
+            0.0f, 0.0f, -range * nearPlane, 0.0f,
+        };
+
+        for (uint32_t uRow = 0u; uRow < 4u; ++uRow)
+        {
+            for (uint32_t uColumn = 0u; uColumn < 4u; ++uColumn)
+            {
+                pViewProjection[uRow * 4u + uColumn] = 0.0f;
+                for (uint32_t k = 0u; k < 4u; ++k)
+                {
+                    pViewProjection[uRow * 4u + uColumn] += aView[uRow * 4u + k] * aProjection[k * 4u + uColumn];
+                }
+            }
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: makeTerrain
+
+      Summary:  Creates rolling hills of chunks. The occluder of a
+                chunk reaches up to its lowest column, its bounds up to
+                its highest one
+
+      Returns:  std::vector<ChunkBox>
+                  Chunk boxes, row by row
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    std::vector<ChunkBox> makeTerrain()
+    {
+        std::vector<ChunkBox> aChunks;
+        aChunks.reserve(static_cast<size_t>(NUM_CHUNKS_X) * NUM_CHUNKS_Z);
+        for (uint32_t z = 0u; z < NUM_CHUNKS_Z; ++z)
+        {
+            for (uint32_t x = 0u; x < NUM_CHUNKS_X; ++x)
+            {
+                const float minX = static_cast<float>(x) * CHUNK_SIZE;
+                const float minZ = static_cast<float>(z) * CHUNK_SIZE;
+                const float hill = 24.0f + 16.0f * std::sin(static_cast<float>(x) * 0.3f) * std::cos(static_cast<float>(z) * 0.2f);
+                aChunks.push_back(
+                    ChunkBox
+                    {
+                        .OccluderMin = { minX, 0.0f, minZ },
+                        .OccluderMax = { minX + CHUNK_SIZE, std::floor(hill), minZ + CHUNK_SIZE },
+                        .BoundsMin = { minX, 0.0f, minZ },
+                        .BoundsMax = { minX + CHUNK_SIZE, std::floor(hill) + 6.0f, minZ + CHUNK_SIZE },
+                    }
+                );
+            }
+        }
+
+        return aChunks;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: runFrames
+
+      Summary:  Renders the occlusion of a camera walking over the
+                terrain for a number of frames
+
+      Args:     const std::vector<ChunkBox>& aChunks
+                  Chunk boxes
+                uint32_t uNumFrames
+                  Number of frames
+                library::ThreadPool* pThreadPool
+                  Pool to rasterize on, nullptr for the calling thread
+
+      Returns:  FrameTimes
+                  Time per step summed over the frames, with the counts
+                  of the last frame
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    FrameTimes runFrames(const std::vector<ChunkBox>& aChunks, uint32_t uNumFrames, library::ThreadPool* pThreadPool)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        library::OcclusionRasterizer rasterizer;
+        FrameTimes times = { .Add = 0.0, .Rasterize = 0.0, .Query = 0.0, .uNumTriangles = 0u, .uNumHidden = 0u };
+        for (uint32_t uFrame = 0u; uFrame < uNumFrames; ++uFrame)
+        {
+            const float walked = static_cast<float>(uFrame) * 2.0f;
+            const float aEye[3] = { 512.0f, 56.0f, 32.0f + walked };
+            const float aAt[3] = { 512.0f, 40.0f, 96.0f + walked };
+            float aViewProjection[16];
+            makeViewProjection(aEye, aAt, aViewProjection);
+
+            const Clock::time_point start = Clock::now();
+            rasterizer.Begin(aViewProjection);
+            for (const ChunkBox& chunk : aChunks)
+            {
+                rasterizer.AddTerrainOccluderBox(chunk.OccluderMin, chunk.OccluderMax, aEye);
+            }
+            const Clock::time_point added = Clock::now();
+            rasterizer.Rasterize(pThreadPool);
+            const Clock::time_point rasterized = Clock::now();
+            uint32_t uNumHidden = 0u;
+            for (const ChunkBox& chunk : aChunks)
+            {
+                uNumHidden += rasterizer.IsVisible(chunk.BoundsMin, chunk.BoundsMax) ? 0u : 1u;
+            }
+            const Clock::time_point queried = Clock::now();
+
+            times.Add += std::chrono::duration<double, std::milli>(added - start).count();
+            times.Rasterize += std::chrono::duration<double, std::milli>(rasterized - added).count();
+            times.Query += std::chrono::duration<double, std::milli>(queried - rasterized).count();
+            times.uNumTriangles = rasterizer.GetNumTriangles();
+            times.uNumHidden = uNumHidden;
+        }
+
+        return times;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: printTimes
+
+      Summary:  Prints the milliseconds per frame of each step
+
+      Args:     const char* pszName
+                  Name of the run
+                const FrameTimes& times
+                  Summed times
+                uint32_t uNumFrames
+                  Number of frames
+                size_t uNumChunks
+                  Number of chunks tested per frame
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void printTimes(const char* pszName, const FrameTimes& times, uint32_t uNumFrames, size_t uNumChunks)
+    {
+        const double frames = static_cast<double>(uNumFrames);
+        std::printf(
+            "%-10s add %7.3f ms  rasterize %7.3f ms  query %7.3f ms  total %7.3f ms per frame  (%u triangles, %u of %zu chunks hidden)\n",
+            pszName,
+            times.Add / frames,
+            times.Rasterize / frames,
+            times.Query / frames,
+            (times.Add + times.Rasterize + times.Query) / frames,
+            times.uNumTriangles,
+            times.uNumHidden,
+            uNumChunks
+        );
+    }
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: main
+
+  Summary:  Runs the frames on the calling thread and then on a thread
+            pool. The number of frames can be given as the first
+            argument
+
+  Args:     int argc
+              Number of arguments
+            char** argv
+              Arguments
+
+  Returns:  int
+              0
+F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+int main(int argc, char** argv)
+{
+    const uint32_t uNumFrames = argc > 1 ? static_cast<uint32_t>((std::max)(std::atoi(argv[1]), 1)) : DEFAULT_NUM_FRAMES;
+    const std::vector<ChunkBox> aChunks = makeTerrain();
+    library::ThreadPool threadPool;
+
+    std::printf(
+        "%ux%u depth buffer, %zu chunks, %u frames, %u worker threads\n",
+        library::OcclusionRasterizer::DEFAULT_WIDTH,
+        library::OcclusionRasterizer::DEFAULT_HEIGHT,
+        aChunks.size(),
+        uNumFrames,
+        threadPool.GetNumThreads()
+    );
+
+    printTimes("serial", runFrames(aChunks, uNumFrames, nullptr), uNumFrames, aChunks.size());
+    printTimes("parallel", runFrames(aChunks, uNumFrames, &threadPool), uNumFrames, aChunks.size());
+
+    return 0;
+}
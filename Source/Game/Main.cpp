@@ -12,18 +12,24 @@
 #include "Common.h"
 
 #include <cstdio>
-#include <fstream>
 #include <memory>
 
+#include <shellapi.h>
+
 #include "Cube/Cube.h"
 #include "Cube/RotatingCube.h"
 #include "Game/Game.h"
+#include "Light/DirectionalLight.h"
 #include "Light/RotatingPointLight.h"
 #include "Model/Model.h"
+#include "Profiler/Profiler.h"
 #include "Renderer/Skybox.h"
 #include "Scene/Scene.h"
+#include "Scene/TerrainGenerator.h"
 #include "Scene/Voxel.h"
+#include "Shader/ShadowVertexShader.h"
 #include "Shader/SkyMapVertexShader.h"
+#include "Shader/VoxelVertexShader.h"
 
 /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
   Function: wWinMain
@@ -49,167 +55,68 @@
 INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPWSTR lpCmdLine, _In_ INT nCmdShow)
 {
     UNREFERENCED_PARAMETER(hPrevInstance);
-    UNREFERENCED_PARAMETER(lpCmdLine);
-
-    std::unique_ptr<library::Game> game = std::make_unique<library::Game>(L"Game Graphics Programming Assignment 3: Cube Mapping");
-
-    std::ofstream sceneFile;
-    sceneFile.open("HeightMap.txt");
-    constexpr const UINT MAP_WIDTH = 0;
-    constexpr const UINT MAP_HEIGHT = 0;
-    constexpr const UINT MAP_DEPTH = 0;
-    XMFLOAT4 aColors[] =
-    {
-        XMFLOAT4(0.0f,      0.666f, 0.0f,   1.0f),  // GRASSLAND
-        XMFLOAT4(1.0f,      1.0f,   1.0f,   1.0f),  // SNOW
-        XMFLOAT4(0.0f,      0.0f,   0.666f, 1.0f),  // OCEAN
-        XMFLOAT4(1.0f,      0.666f, 0.0f,   1.0f),  // SAND
-        XMFLOAT4(0.666f,    0.0f,   0.0f,   1.0f),  // SCORCHED
-        XMFLOAT4(0.956f,    0.643f, 0.376f, 1.0f),  // BARE
-        XMFLOAT4(0.941f,    0.0f,   1.0f,   1.0f),  // TUNDRA
-        XMFLOAT4(0.803f,    0.521f, 0.247f, 1.0f),  // TEMPERATE_DESERT
-        XMFLOAT4(0.42f,     0.556f, 0.137f, 1.0f),  // SHRUBLAND
-        XMFLOAT4(0.0f,      0.392f, 0.0f,   1.0f),  // TAIGA
-        XMFLOAT4(1.0f,      0.55f,  0.0f,   1.0f),  // TEMPERATE_DECIDUOUS_FOREST
-        XMFLOAT4(0.0f,      0.5f,   0.0f,   1.0f),  // TEMPERATE_RAIN_FOREST
-        XMFLOAT4(0.956f,    0.643f, 0.376f, 1.0f),  // SUBTROPICAL_DESERT
-        XMFLOAT4(0.133f,    0.545f, 0.133f, 1.0f),  // TROPICAL_SEASONAL_FOREST
-        XMFLOAT4(0.15f,     0.372f, 0.15f,  1.0f),  // TROPICAL_RAIN_FOREST
-    };
 
-    sceneFile << MAP_WIDTH << " " << MAP_HEIGHT << " " << MAP_DEPTH << ' ' << ARRAYSIZE(aColors) << '\n';
+    // "-headless" renders a fixed number of frames without a window and
+    // reports their CPU cost to the debugger output
+    const BOOL bHeadless = lpCmdLine && wcsstr(lpCmdLine, L"-headless") != nullptr;
 
-    for (UINT colorIdx = 0; colorIdx < ARRAYSIZE(aColors); ++colorIdx)
-    {
-        sceneFile << aColors[colorIdx].x << ' ' <<
-            aColors[colorIdx].y << ' ' <<
-            aColors[colorIdx].z << '\n';
-    }
+    // "-profile" times the recent frames and reports them when the game
+    // ends, the profiler does nothing otherwise
+    library::Profiler::Get().SetEnabled(lpCmdLine && wcsstr(lpCmdLine, L"-profile") != nullptr);
 
-    for (UINT z = 0u; z < MAP_DEPTH; ++z)
+    // "-convert <text map> <binary map>" is an asset build step: it
+    // converts a text height map into the memory-mapped .vxm format
+    // and exits without starting the game
+    if (lpCmdLine && wcsstr(lpCmdLine, L"-convert") != nullptr)
     {
-        for (UINT x = 0u; x < MAP_WIDTH; ++x)
+        INT nArgs = 0;
+        LPWSTR* ppszArgs = CommandLineToArgvW(lpCmdLine, &nArgs);
+        if (!ppszArgs)
         {
-            FLOAT height = 0.0f;
+            return 1;
+        }
 
-            FLOAT frequencySum = 0.0f;
-            for (UINT i = 0; i < 4; ++i)
+        HRESULT hr = E_INVALIDARG;
+        for (INT i = 0; i + 2 < nArgs; ++i)
+        {
+            if (wcscmp(ppszArgs[i], L"-convert") == 0)
             {
-                FLOAT frequency = pow(2.0f, static_cast<FLOAT>(i));
-                frequencySum += 1.0f / frequency;
-                height += library::Scene::GetPerlin2d(frequency * static_cast<FLOAT>(x), frequency * static_cast<FLOAT>(z), 0.1f, 4u) / frequency;
-            }
-            height /= frequencySum;
-            height = pow(height * 1.2f, 1.25f);
-
-            assert(height >= 0.0f);
-
-            FLOAT moisture = 0.0f;
+                library::ThreadPool converterThreadPool;
+                hr = library::HeightMap::ConvertTextToBinary(ppszArgs[i + 1], ppszArgs[i + 2], &converterThreadPool);
 
-            frequencySum = 0.0f;
-            for (UINT i = 0; i < 4; ++i)
-            {
-                FLOAT frequency = pow(2.0f, static_cast<FLOAT>(i));
-                frequencySum += 1.0f / frequency;
-                moisture += library::Scene::GetPerlin2d(frequency * static_cast<FLOAT>(x), frequency * static_cast<FLOAT>(z), 0.1f, 4u) / frequency;
+                WCHAR szMessage[512];
+                swprintf_s(szMessage, L"Converting %s to %s: 0x%08lX\n", ppszArgs[i + 1], ppszArgs[i + 2], static_cast<ULONG>(hr));
+                OutputDebugStringW(szMessage);
+                break;
             }
-            moisture /= frequencySum;
-            moisture = pow(moisture * 1.2f, 1.25f);
-
-            library::eBlockType blockType = library::eBlockType::GRASSLAND;
+        }
+        LocalFree(ppszArgs);
 
-            if (height < 0.1f)
-            {
-                blockType = library::eBlockType::OCEAN;
-            }
-            else if (height < 0.12f)
-            {
-                blockType = library::eBlockType::SAND;
-            }
-            else if (height > 0.8f)
-            {
-                if (moisture < 0.1f)
-                {
-                    blockType = library::eBlockType::SCORCHED;
-                }
-                else if (moisture < 0.2f)
-                {
-                    blockType = library::eBlockType::BARE;
-                }
-                else if (moisture < 0.5f)
-                {
-                    blockType = library::eBlockType::TUNDRA;
-                }
-                else
-                {
-                    blockType = library::eBlockType::SNOW;
-                }
-            }
-            else if (height > 0.6f)
-            {
-                if (moisture < 0.33f)
-                {
-                    blockType = library::eBlockType::TEMPERATE_DESERT;
-                }
-                else if (moisture < 0.66f)
-                {
-                    blockType = library::eBlockType::SHRUBLAND;
-                }
-                else
-                {
-                    blockType = library::eBlockType::TAIGA;
-                }
-            }
-            else if (height > 0.3f)
-            {
-                if (moisture < 0.16f)
-                {
-                    blockType = library::eBlockType::TEMPERATE_DESERT;
-                }
-                else if (moisture < 0.5f)
-                {
-                    blockType = library::eBlockType::GRASSLAND;
-                }
-                else if (moisture < 0.83f)
-                {
-                    blockType = library::eBlockType::TEMPERATE_DECIDUOUS_FOREST;
-                }
-                else
-                {
-                    blockType = library::eBlockType::TEMPERATE_RAIN_FOREST;
-                }
-            }
-            else
-            {
+        return SUCCEEDED(hr) ? 0 : 1;
+    }
 
-                if (moisture < 0.16f)
-                {
-                    blockType = library::eBlockType::SUBTROPICAL_DESERT;
-                }
-                else if (moisture < 0.33f)
-                {
-                    blockType = library::eBlockType::GRASSLAND;
-                }
-                else if (moisture < 0.66f)
-                {
-                    blockType = library::eBlockType::TROPICAL_SEASONAL_FOREST;
-                }
-                else
-                {
-                    blockType = library::eBlockType::TROPICAL_RAIN_FOREST;
-                }
-            }
+    std::unique_ptr<library::Game> game = std::make_unique<library::Game>(L"Game Graphics Programming Assignment 3: Cube Mapping");
 
-            sceneFile << static_cast<CHAR>(blockType);
+    constexpr const UINT MAP_WIDTH = 0;
+    constexpr const UINT MAP_HEIGHT = 0;
+    constexpr const UINT MAP_DEPTH = 0;
 
-            sceneFile << height << ' ';
-        }
-        sceneFile << '\n';
+    // The terrain is generated straight into memory, no HeightMap.txt
+    // round-trip
+    library::ThreadPool threadPool;
+    library::HeightMap heightMap;
+    const library::TerrainDesc terrainDesc =
+    {
+        .Width = MAP_WIDTH,
+        .Height = MAP_HEIGHT,
+        .Depth = MAP_DEPTH,
+    };
+    if (FAILED(library::TerrainGenerator(terrainDesc).Generate(heightMap, &threadPool)))
+    {
+        return 0;
     }
-    sceneFile << std::endl;
-    sceneFile.close();
 
-    std::shared_ptr<library::Scene> mainScene = std::make_shared<library::Scene>(L"HeightMap.txt");
+    std::shared_ptr<library::Scene> mainScene = std::make_shared<library::Scene>(heightMap, library::eVoxelExtractionMode::SURFACE, &threadPool);
 
     // Phong
     std::shared_ptr<library::VertexShader> phongVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSPhong", "vs_5_0");
@@ -223,6 +130,18 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
     {
         return 0;
     }
+    // Quantized Voxel
+    std::shared_ptr<library::VoxelVertexShader> voxelQuantizedVertexShader = std::make_shared<library::VoxelVertexShader>(L"Shaders/VoxelShaders.fxh", "VSVoxelQuantized", "vs_5_0");
+    if (FAILED(mainScene->AddVertexShader(L"VoxelQuantizedShader", voxelQuantizedVertexShader)))
+    {
+        return 0;
+    }
+    // Voxel Mesh
+    std::shared_ptr<library::VertexShader> voxelMeshVertexShader = std::make_shared<library::VertexShader>(L"Shaders/VoxelShaders.fxh", "VSVoxelMesh", "vs_5_0");
+    if (FAILED(mainScene->AddVertexShader(L"VoxelMeshShader", voxelMeshVertexShader)))
+    {
+        return 0;
+    }
     // Light Cube
     std::shared_ptr<library::VertexShader> lightVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSLightCube", "vs_5_0");
     if (FAILED(mainScene->AddVertexShader(L"LightShader", lightVertexShader)))
@@ -241,6 +160,23 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
     {
         return 0;
     }
+    // Instanced variants, drawn when copies of a renderable share the
+    // geometry, shaders and materials
+    std::shared_ptr<library::VertexShader> phongInstancedVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSPhongInstanced", "vs_5_0");
+    if (FAILED(mainScene->AddVertexShader(L"PhongInstancedShader", phongInstancedVertexShader)))
+    {
+        return 0;
+    }
+    std::shared_ptr<library::VertexShader> lightInstancedVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSLightCubeInstanced", "vs_5_0");
+    if (FAILED(mainScene->AddVertexShader(L"LightInstancedShader", lightInstancedVertexShader)))
+    {
+        return 0;
+    }
+    std::shared_ptr<library::VertexShader> environmentMapInstancedVertexShader = std::make_shared<library::VertexShader>(L"Shaders/Shaders.fxh", "VSEnvironmentMapInstanced", "vs_5_0");
+    if (FAILED(mainScene->AddVertexShader(L"EnvironmentMapInstancedShader", environmentMapInstancedVertexShader)))
+    {
+        return 0;
+    }
 
     // Phong
     std::shared_ptr<library::PixelShader> phongPixelShader = std::make_shared<library::PixelShader>(L"Shaders/PhongShaders.fxh", "PSPhong", "ps_5_0");
@@ -278,11 +214,41 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         return 0;
     }
 
+    if (FAILED(mainScene->SetVertexShaderOfQuantizedVoxel(L"VoxelQuantizedShader")))
+    {
+        return 0;
+    }
+
     if (FAILED(mainScene->SetPixelShaderOfVoxel(L"VoxelShader")))
     {
         return 0;
     }
 
+    if (FAILED(mainScene->SetVertexShaderOfVoxelMesh(L"VoxelMeshShader")))
+    {
+        return 0;
+    }
+
+    if (FAILED(mainScene->SetPixelShaderOfVoxelMesh(L"VoxelShader")))
+    {
+        return 0;
+    }
+
+    if (FAILED(mainScene->SetInstancedVertexShader(L"PhongShader", L"PhongInstancedShader")))
+    {
+        return 0;
+    }
+
+    if (FAILED(mainScene->SetInstancedVertexShader(L"LightShader", L"LightInstancedShader")))
+    {
+        return 0;
+    }
+
+    if (FAILED(mainScene->SetInstancedVertexShader(L"EnvironmentMapShader", L"EnvironmentMapInstancedShader")))
+    {
+        return 0;
+    }
+
     std::shared_ptr<library::Skybox> skybox = std::make_shared<library::Skybox>(L"Content/Common/Maskonaive2_1024.dds", 1000.0f);
     skybox->SetVertexShader(cubeMapVertexShader);
     skybox->SetPixelShader(cubeMapPixelShader);
@@ -327,6 +293,27 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         return 0;
     }
 
+    // Torches over the floor, each lights only the clusters in its
+    // short range
+    constexpr const UINT NUM_TORCHES_PER_SIDE = 8u;
+    constexpr const FLOAT TORCH_SPACING = 20.0f;
+    XMFLOAT4 torchColor;
+    XMStoreFloat4(&torchColor, Colors::Gold);
+    for (UINT i = 0u; i < NUM_TORCHES_PER_SIDE * NUM_TORCHES_PER_SIDE; ++i)
+    {
+        const FLOAT x = (static_cast<FLOAT>(i % NUM_TORCHES_PER_SIDE) - 0.5f * static_cast<FLOAT>(NUM_TORCHES_PER_SIDE - 1u)) * TORCH_SPACING;
+        const FLOAT z = (static_cast<FLOAT>(i / NUM_TORCHES_PER_SIDE) - 0.5f * static_cast<FLOAT>(NUM_TORCHES_PER_SIDE - 1u)) * TORCH_SPACING;
+        if (FAILED(mainScene->AddPointLight(1u + i, std::make_shared<library::PointLight>(XMFLOAT4(x, 3.0f, z, 1.0f), torchColor, 2.0f))))
+        {
+            return 0;
+        }
+    }
+
+    mainScene->SetDirectionalLight(std::make_shared<library::DirectionalLight>(
+        XMFLOAT4(-0.4f, -1.0f, 0.3f, 0.0f),
+        XMFLOAT4(0.6f, 0.6f, 0.55f, 1.0f)
+        ));
+
     XMFLOAT4 white;
     XMStoreFloat4(&white, Colors::White);
     const auto floorMaterial = std::make_shared<library::Material>(L"FloorMat");
@@ -336,6 +323,7 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
     const auto floor = std::make_shared<Cube>(white);
     floor->Scale(200.f, 1.0f, 200.f);
     floor->AddMaterial(floorMaterial);
+    floor->SetStatic(TRUE);
     if (FAILED(mainScene->AddRenderable(L"Floor", floor)))
         return 0;
     if (FAILED(mainScene->SetVertexShaderOfRenderable(L"Floor", L"EnvironmentMapShader")))
@@ -386,6 +374,24 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         return 0;
     }
 
+    // Shadow map, only the depth seen from the light is rendered
+    std::shared_ptr<library::ShadowVertexShader> shadowVertexShader = std::make_shared<library::ShadowVertexShader>(L"Shaders/ShadowShaders.fxh", "VSShadow", "vs_5_0");
+    std::shared_ptr<library::VoxelVertexShader> shadowQuantizedVertexShader = std::make_shared<library::VoxelVertexShader>(L"Shaders/ShadowShaders.fxh", "VSShadowQuantized", "vs_5_0");
+    game->GetRenderer()->SetShadowMapShaders(shadowVertexShader, shadowQuantizedVertexShader);
+
+    // "-prepass" starts with the depth pre-pass on, P toggles it
+    game->GetRenderer()->SetDepthPrepass(lpCmdLine && wcsstr(lpCmdLine, L"-prepass") != nullptr);
+
+    if (bHeadless)
+    {
+        if (FAILED(game->InitializeHeadless(800u, 600u)))
+        {
+            return 0;
+        }
+
+        return game->RunHeadless(600u, 1.0f / 60.0f);
+    }
+
     if (FAILED(game->Initialize(hInstance, nCmdShow)))
     {
         return 0;
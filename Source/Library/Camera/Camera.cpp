@@ -82,6 +82,21 @@ namespace library
     {
         return m_up;
     }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Camera::GetForward
+
+      Summary:  Returns the forward vector, the direction the camera
+                walks in
+
+      Returns:  const XMVECTOR&
+                  The forward vector
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMVECTOR& Camera::GetForward() const
+    {
+        return m_cameraForward;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Camera::GetView
 
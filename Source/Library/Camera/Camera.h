@@ -29,6 +29,8 @@ namespace library
                   Getter for the at vector
                 GetUp
                   Getter for the up vector
+                GetForward
+                  Getter for the forward vector
                 GetView
                   Getter for the view transform matrix
                 GetConstantBuffer
@@ -58,6 +60,7 @@ namespace library
         const XMVECTOR& GetEye() const;
         const XMVECTOR& GetAt() const;
         const XMVECTOR& GetUp() const;
+        const XMVECTOR& GetForward() const;
         const XMMATRIX& GetView() const;
         ComPtr<ID3D11Buffer>& GetConstantBuffer();
 
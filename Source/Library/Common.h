@@ -104,4 +104,18 @@ namespace library
         TROPICAL_RAIN_FOREST,
         COUNT,
     };
+
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+        Enum:     eVoxelExtractionMode
+
+        Summary:  Enumeration of the ways voxels are extracted from a
+                  height map
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eVoxelExtractionMode : BYTE
+    {
+        FILLED_COLUMNS,
+        SURFACE,
+        GREEDY_MESH,
+        COUNT,
+    };
 }
\ No newline at end of file
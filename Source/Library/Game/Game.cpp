@@ -53,10 +53,36 @@ namespace library
         return S_OK;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Game::InitializeHeadless
+
+      Summary:  Initializes the renderer without a window, so frames
+                are recorded instead of drawn
+
+      Args:     UINT uWidth
+                  Width of the frame
+                UINT uHeight
+                  Height of the frame
+
+      Modifies: [m_renderer].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Game::InitializeHeadless(_In_ UINT uWidth, _In_ UINT uHeight)
+    {
+        if (FAILED(m_renderer->InitializeHeadless(uWidth, uHeight)))
+        {
+            return E_FAIL;
+        }
+        return S_OK;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Game::Run
 
-      Summary:  Runs the game loop
+      Summary:  Runs the game loop. Each frame is a frame of the
+                profiler, whose results are reported when the loop ends
 
       Returns:  INT
                   Status code to return to the operating system
@@ -82,18 +108,108 @@ namespace library
             }
             else
             {
+                Profiler::Get().BeginFrame(m_renderer->GetProfiledContext());
                 QueryPerformanceCounter(&EndingTime);
                 ElapsedSeconds = (FLOAT)(EndingTime.QuadPart - StartingTime.QuadPart) / (FLOAT)Frequency.QuadPart;
                 QueryPerformanceCounter(&StartingTime);
-                m_renderer->HandleInput(m_mainWindow->GetDirections(), m_mainWindow->GetMouseRelativeMovement(), ElapsedSeconds);
-                m_renderer->Update(ElapsedSeconds);
-                m_renderer->Render();  // Do some rendering
+                {
+                    ProfileScope profileScope("Input");
+                    m_renderer->HandleInput(m_mainWindow->GetDirections(), m_mainWindow->GetMouseRelativeMovement(), ElapsedSeconds);
+                    if (m_mainWindow->TakeDepthPrepassToggle())
+                    {
+                        m_renderer->SetDepthPrepass(!m_renderer->IsDepthPrepassEnabled());
+                    }
+                }
+                {
+                    ProfileScope profileScope("Update");
+                    m_renderer->Update(ElapsedSeconds);
+                }
+                {
+                    ProfileScope profileScope("Render");
+                    m_renderer->Render();  // Do some rendering
+                }
                 m_mainWindow->ResetMouseMovement();
+                Profiler::Get().EndFrame(m_renderer->GetProfiledContext());
             }
         }
+        reportProfile();
         return static_cast<INT>(msg.wParam);
     }
     
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Game::RunHeadless
+
+      Summary:  Updates and renders a fixed number of frames with a
+                fixed time step and no input, then writes the average
+                CPU time of Render and the command stream of the last
+                frame to the debugger output, followed by the profiled
+                frames
+
+      Args:     UINT uNumFrames
+                  Number of frames to render
+                FLOAT deltaTime
+                  Time step of each frame in seconds
+
+      Returns:  INT
+                  Status code to return to the operating system
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    INT Game::RunHeadless(_In_ UINT uNumFrames, _In_ FLOAT deltaTime)
+    {
+        LARGE_INTEGER StartingTime, EndingTime;
+        LARGE_INTEGER Frequency;
+        LONGLONG renderTicks = 0;
+
+        QueryPerformanceFrequency(&Frequency);
+        for (UINT i = 0u; i < uNumFrames; ++i)
+        {
+            Profiler::Get().BeginFrame(nullptr);
+            {
+                ProfileScope profileScope("Update");
+                m_renderer->Update(deltaTime);
+            }
+
+            QueryPerformanceCounter(&StartingTime);
+            {
+                ProfileScope profileScope("Render");
+                m_renderer->Render();
+            }
+            QueryPerformanceCounter(&EndingTime);
+            renderTicks += EndingTime.QuadPart - StartingTime.QuadPart;
+            Profiler::Get().EndFrame(nullptr);
+        }
+
+        const CommandStreamAnalyzer& analyzer = m_renderer->GetCommandStreamAnalyzer();
+        const DOUBLE renderMilliseconds = uNumFrames > 0u
+            ? 1000.0 * static_cast<DOUBLE>(renderTicks) / static_cast<DOUBLE>(Frequency.QuadPart) / static_cast<DOUBLE>(uNumFrames)
+            : 0.0;
+        WCHAR szReport[512];
+        swprintf_s(
+            szReport,
+            L"%u frames, Render %.3f ms/frame\n"
+            L"commands %u, draws %u, binds %u, redundant binds %u, uploads %u, bytes uploaded %llu\n"
+            L"issued calls %u, skipped calls %u, command lists %u\n"
+            L"clustered lights %u, light indices %u, depth pre-pass %s\n",
+            uNumFrames,
+            renderMilliseconds,
+            analyzer.GetNumCommands(),
+            analyzer.GetNumDraws(),
+            analyzer.GetNumBinds(),
+            analyzer.GetNumRedundantBinds(),
+            analyzer.GetNumUploads(),
+            analyzer.GetNumBytesUploaded(),
+            m_renderer->GetNumIssuedCalls(),
+            m_renderer->GetNumSkippedCalls(),
+            m_renderer->GetNumCommandLists(),
+            m_renderer->GetNumClusteredLights(),
+            m_renderer->GetNumLightIndices(),
+            m_renderer->IsDepthPrepassEnabled() ? L"on" : L"off"
+        );
+        OutputDebugString(szReport);
+        reportProfile();
+
+        return 0;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Game::GetGameName
 
@@ -142,4 +258,47 @@ namespace library
         return m_renderer;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Game::reportProfile
+
+      Summary:  Writes the min, average and 99th percentile time of
+                every profiled zone to the debugger output, and the
+                profiled frames to Profile.json. Does nothing if no
+                frame was profiled
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Game::reportProfile() const
+    {
+        const Profiler& profiler = Profiler::Get();
+        if (profiler.GetNumFrames() == 0u)
+        {
+            return;
+        }
+
+        std::vector<ProfileSummary> aSummaries;
+        profiler.Summarize(aSummaries);
+
+        WCHAR szLine[256];
+        swprintf_s(szLine, L"%u profiled frames, min / avg / p99 ms\n", profiler.GetNumFrames());
+        OutputDebugString(szLine);
+        for (const ProfileSummary& summary : aSummaries)
+        {
+            swprintf_s(
+                szLine,
+                L"%hs%s %.3f / %.3f / %.3f (%u frames)\n",
+                summary.pszName,
+                summary.bGpu ? L" (GPU)" : L"",
+                summary.MinMilliseconds,
+                summary.AverageMilliseconds,
+                summary.P99Milliseconds,
+                summary.uNumFrames
+            );
+            OutputDebugString(szLine);
+        }
+
+        if (FAILED(profiler.ExportChromeTrace(L"Profile.json")))
+        {
+            OutputDebugString(L"Profile.json could not be written\n");
+        }
+    }
+
 }
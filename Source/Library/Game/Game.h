@@ -26,8 +26,13 @@ namespace library
 
       Methods:  Initialize
                   Initializes the components of the game
+                InitializeHeadless
+                  Initializes the renderer without a window
                 Run
                   Runs the game loop
+                RunHeadless
+                  Renders a number of frames without a window and
+                  reports their CPU cost
                 GetGameName
                   Returns the name of the game
                 GetWindow
@@ -36,6 +41,9 @@ namespace library
                 GetRenderer
                   Returns the reference to the unique pointer to the 
                   renderer
+                reportProfile
+                  Writes the summary of the profiled frames and
+                  exports them as a Chrome trace
                 Game
                   Constructor.
                 ~Game
@@ -52,11 +60,16 @@ namespace library
         ~Game() = default;
 
         HRESULT Initialize(_In_ HINSTANCE hInstance, _In_ INT nCmdShow);
+        HRESULT InitializeHeadless(_In_ UINT uWidth, _In_ UINT uHeight);
         INT Run();
+        INT RunHeadless(_In_ UINT uNumFrames, _In_ FLOAT deltaTime);
 
         PCWSTR GetGameName() const;
         std::unique_ptr<MainWindow>& GetWindow();
         std::unique_ptr<Renderer>& GetRenderer();
+    private:
+        void reportProfile() const;
+
     private:
         PCWSTR m_pszGameName;
         std::unique_ptr<MainWindow> m_mainWindow;
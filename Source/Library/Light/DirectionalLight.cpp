@@ -0,0 +1,62 @@
+#include "Light/DirectionalLight.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DirectionalLight::DirectionalLight
+
+      Summary:  Constructor
+
+      Args:     const XMFLOAT4& direction
+                  Direction the light travels in, normalized here
+                const XMFLOAT4& color
+                  Color of the light
+
+      Modifies: [m_direction, m_color].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    DirectionalLight::DirectionalLight(_In_ const XMFLOAT4& direction, _In_ const XMFLOAT4& color)
+        : m_direction()
+        , m_color(color)
+    {
+        XMStoreFloat4(&m_direction, XMVector3Normalize(XMVectorSetW(XMLoadFloat4(&direction), 0.0f)));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DirectionalLight::GetDirection
+
+      Summary:  Returns the direction the light travels in
+
+      Returns:  const XMFLOAT4&
+                  Normalized direction of the light, w is 0
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMFLOAT4& DirectionalLight::GetDirection() const
+    {
+        return m_direction;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DirectionalLight::GetColor
+
+      Summary:  Returns the color of the light
+
+      Returns:  const XMFLOAT4&
+                  Color of the light
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMFLOAT4& DirectionalLight::GetColor() const
+    {
+        return m_color;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DirectionalLight::Update
+
+      Summary:  Updates the light every frame
+
+      Args:     FLOAT deltaTime
+                  Elapsed time
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DirectionalLight::Update(_In_ FLOAT deltaTime)
+    {
+        UNREFERENCED_PARAMETER(deltaTime);
+    }
+}
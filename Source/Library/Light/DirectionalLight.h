@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    DirectionalLight
+
+      Summary:  Light that comes from infinitely far away along one
+                direction, like the sun. It casts the cascaded shadows
+
+      Methods:  GetDirection
+                  Returns the direction the light travels in
+                GetColor
+                  Returns the color of the light
+                Update
+                  Updates the light
+                DirectionalLight
+                  Constructor.
+                ~DirectionalLight
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class DirectionalLight
+    {
+    public:
+        DirectionalLight() = delete;
+        DirectionalLight(_In_ const XMFLOAT4& direction, _In_ const XMFLOAT4& color);
+        DirectionalLight(const DirectionalLight& other) = default;
+        DirectionalLight(DirectionalLight&& other) = default;
+        DirectionalLight& operator=(const DirectionalLight& other) = default;
+        DirectionalLight& operator=(DirectionalLight&& other) = default;
+        virtual ~DirectionalLight() = default;
+
+        const XMFLOAT4& GetDirection() const;
+        const XMFLOAT4& GetColor() const;
+
+        virtual void Update(_In_ FLOAT deltaTime);
+
+    protected:
+        XMFLOAT4 m_direction;
+        XMFLOAT4 m_color;
+    };
+}
@@ -16,7 +16,8 @@ namespace library
                 FLOAT attenuationDistance
                   Attenuation distance
 
-      Modifies: [m_position, m_color, m_attenuationDistance].
+      Modifies: [m_position, m_color, m_eye, m_at, m_up, m_view,
+                 m_projection, m_attenuationDistance].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     /*--------------------------------------------------------------------
       TODO: PointLight::PointLight definition (remove the comment)
@@ -25,13 +26,13 @@ namespace library
         : m_position(position),
         m_color(color),
         m_eye(),
-        m_at(),
+        m_at(DEFAULT_AT),
         m_up(DEFAULT_UP),
         m_view(),
-        m_projection(),
+        m_projection(XMMatrixPerspectiveFovLH(SHADOW_FIELD_OF_VIEW, 1.0f, SHADOW_NEAR_PLANE, SHADOW_FAR_PLANE)),
         m_attenuationDistance(attenuationDistance)
     {
-
+        updateViewMatrix();
     }
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   PointLight::GetPosition
@@ -79,25 +80,35 @@ namespace library
         return m_attenuationDistance;
     }
 
-    /*const XMMATRIX& PointLight::GetViewMatrix() const
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PointLight::GetViewMatrix
+
+      Summary:  Returns the view matrix of the shadow map, looking from
+                the light at the origin
+
+      Returns:  const XMMATRIX&
+                  View matrix of the light
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMMATRIX& PointLight::GetViewMatrix() const
     {
         return m_view;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PointLight::GetProjectionMatrix
+
+      Summary:  Returns the projection matrix of the shadow map. The
+                shadow map is square, so the aspect ratio is 1
+                whatever the size of the window
+
+      Returns:  const XMMATRIX&
+                  Projection matrix of the light
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     const XMMATRIX& PointLight::GetProjectionMatrix() const
     {
         return m_projection;
-    }*/
-
-    /*void PointLight::Initialize(_In_ UINT uWidth, _In_ UINT uHeight)
-    {
-        m_projection = XMMatrixPerspectiveFovLH(
-            XM_PIDIV4,
-            static_cast<FLOAT>(uWidth) / static_cast<FLOAT>(uHeight),
-            0.01f,
-            1000.0f
-        );
-    }*/
+    }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   PointLight::Update
@@ -110,5 +121,36 @@ namespace library
     void PointLight::Update(_In_ FLOAT deltaTime)
     {
         UNREFERENCED_PARAMETER(deltaTime);
+
+        updateViewMatrix();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PointLight::updateViewMatrix
+
+      Summary:  Recomputes the view matrix from the position. A light
+                straight above or below the point it looks at takes
+                the z axis as up, since the y axis would be parallel to
+                the view direction. A light at that point keeps looking
+                down the z axis
+
+      Modifies: [m_eye, m_up, m_view].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void PointLight::updateViewMatrix()
+    {
+        m_eye = XMLoadFloat4(&m_position);
+        m_up = DEFAULT_UP;
+        if (XMVector3NearEqual(m_eye, m_at, XMVectorReplicate(0.001f)))
+        {
+            m_view = XMMatrixTranslationFromVector(XMVectorNegate(m_eye));
+            return;
+        }
+
+        XMVECTOR direction = XMVector3Normalize(XMVectorSubtract(m_at, m_eye));
+        if (fabsf(XMVectorGetY(direction)) > 0.99f)
+        {
+            m_up = VERTICAL_UP;
+        }
+        m_view = XMMatrixLookAtLH(m_eye, m_at, m_up);
     }
 }
\ No newline at end of file
@@ -16,6 +16,12 @@ namespace library
                   Returns the position of the light
                 GetColor
                   Returns the color of the light
+                GetViewMatrix
+                  Returns the view matrix of the shadow map
+                GetProjectionMatrix
+                  Returns the projection matrix of the shadow map
+                GetAttenuationDistance
+                  Returns the attenuation distance
                 Update
                   Updates the light
                 PointLight
@@ -36,13 +42,15 @@ namespace library
 
         const XMFLOAT4& GetPosition() const;
         const XMFLOAT4& GetColor() const;
-        /*const XMMATRIX& GetViewMatrix() const;
-        const XMMATRIX& GetProjectionMatrix() const;*/
+        const XMMATRIX& GetViewMatrix() const;
+        const XMMATRIX& GetProjectionMatrix() const;
         FLOAT GetAttenuationDistance() const;
 
-        /*virtual void Initialize(_In_ UINT uWidth, _In_ UINT uHeight);*/
         virtual void Update(_In_ FLOAT deltaTime);
 
+    protected:
+        void updateViewMatrix();
+
     protected:
         XMFLOAT4 m_position;
         XMFLOAT4 m_color;
@@ -53,6 +61,11 @@ namespace library
         XMMATRIX m_projection;
         FLOAT m_attenuationDistance;
 
+        static constexpr const XMVECTORF32 DEFAULT_AT = { 0.0f, 0.0f, 0.0f, 1.0f };
         static constexpr const XMVECTORF32 DEFAULT_UP = { 0.0f, 1.0f, 0.0f, 0.0f };
+        static constexpr const XMVECTORF32 VERTICAL_UP = { 0.0f, 0.0f, 1.0f, 0.0f };
+        static constexpr const FLOAT SHADOW_FIELD_OF_VIEW = XM_PIDIV2;
+        static constexpr const FLOAT SHADOW_NEAR_PLANE = 1.0f;
+        static constexpr const FLOAT SHADOW_FAR_PLANE = 1000.0f;
     };
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "assimp/scene.h"		// output data structure
 #include "assimp/postprocess.h"	// post processing flags
 
+#include "Profiler/Profiler.h"
+
 namespace library
 {
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -175,6 +177,8 @@ namespace library
     --------------------------------------------------------------------*/
     void Model::Update(_In_ FLOAT deltaTime)
     {
+        ProfileScope profileScope("Model::Update");
+
         m_timeSinceLoaded += deltaTime;
         if (m_pScene->HasAnimations())
         {
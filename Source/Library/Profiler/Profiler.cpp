@@ -0,0 +1,666 @@
+#include "Profiler/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+namespace library
+{
+    Profiler Profiler::s_profiler;
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::Get
+
+      Summary:  Returns the profiler of the process, so zones can be
+                marked anywhere without passing it around
+
+      Returns:  Profiler&
+                  Profiler of the process
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Profiler& Profiler::Get()
+    {
+        return s_profiler;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::Profiler
+
+      Summary:  Constructor. The ring of frames is only allocated when
+                the profiler is first enabled
+
+      Modifies: [m_bEnabled, m_bInFrame, m_bHasGpuQueries, m_frequency,
+                 m_uFrameNumber, m_uNumFrames, m_aFrames,
+                 m_aGpuQueryFrames].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Profiler::Profiler()
+        : m_bEnabled(FALSE)
+        , m_bInFrame(FALSE)
+        , m_bHasGpuQueries(FALSE)
+        , m_frequency(1)
+        , m_uFrameNumber(0u)
+        , m_uNumFrames(0u)
+        , m_aFrames()
+        , m_aGpuQueryFrames(std::make_unique<GpuQueryFrame[]>(NUM_GPU_QUERY_FRAMES))
+    {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        m_frequency = frequency.QuadPart;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::Initialize
+
+      Summary:  Creates the timestamp queries of every frame in flight.
+                Without them only CPU zones are recorded
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the queries with
+
+      Modifies: [m_bHasGpuQueries, m_aGpuQueryFrames].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Profiler::Initialize(_In_ ID3D11Device* pDevice)
+    {
+        m_bHasGpuQueries = FALSE;
+
+        HRESULT hr = S_OK;
+        for (UINT i = 0u; i < NUM_GPU_QUERY_FRAMES; ++i)
+        {
+            GpuQueryFrame& queryFrame = m_aGpuQueryFrames[i];
+            queryFrame.uNumZones = 0u;
+            queryFrame.bActive = FALSE;
+            queryFrame.bPending = FALSE;
+
+            D3D11_QUERY_DESC qd =
+            {
+                .Query = D3D11_QUERY_TIMESTAMP_DISJOINT,
+                .MiscFlags = 0u,
+            };
+            hr = pDevice->CreateQuery(&qd, queryFrame.Disjoint.ReleaseAndGetAddressOf());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            qd.Query = D3D11_QUERY_TIMESTAMP;
+            hr = pDevice->CreateQuery(&qd, queryFrame.FrameBegin.ReleaseAndGetAddressOf());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+            for (UINT k = 0u; k < MAX_GPU_ZONES_PER_FRAME; ++k)
+            {
+                hr = pDevice->CreateQuery(&qd, queryFrame.aBegin[k].ReleaseAndGetAddressOf());
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+                hr = pDevice->CreateQuery(&qd, queryFrame.aEnd[k].ReleaseAndGetAddressOf());
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+            }
+        }
+
+        m_bHasGpuQueries = TRUE;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::SetEnabled
+
+      Summary:  Starts or stops recording from the next frame. The
+                recorded frames are kept
+
+      Args:     BOOL bEnabled
+                  Whether to record frames
+
+      Modifies: [m_bEnabled, m_aFrames].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Profiler::SetEnabled(_In_ BOOL bEnabled)
+    {
+        if (bEnabled && !m_aFrames)
+        {
+            m_aFrames = std::make_unique<FrameRecord[]>(NUM_FRAMES);
+        }
+
+        m_bEnabled = bEnabled;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::IsEnabled
+
+      Summary:  Returns whether frames are recorded
+
+      Returns:  BOOL
+                  TRUE if enabled
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Profiler::IsEnabled() const
+    {
+        return m_bEnabled;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::BeginFrame
+
+      Summary:  Starts the next frame of the ring. The queries of the
+                frame that last used the same query slot are read back
+                first, if they are not done yet their zones are lost
+                rather than waited for
+
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  Immediate context to time the GPU zones on, nullptr
+                  to record CPU zones only
+
+      Modifies: [m_bInFrame, m_aFrames, m_aGpuQueryFrames].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Profiler::BeginFrame(_In_opt_ ID3D11DeviceContext* pImmediateContext)
+    {
+        if (!m_bEnabled)
+        {
+            return;
+        }
+
+        LARGE_INTEGER ticks;
+        QueryPerformanceCounter(&ticks);
+
+        FrameRecord& frame = m_aFrames[m_uFrameNumber % NUM_FRAMES];
+        frame.BeginTicks = ticks.QuadPart;
+        frame.EndTicks = ticks.QuadPart;
+        frame.dwThreadId = GetCurrentThreadId();
+        frame.uNumCpuZones.store(0u, std::memory_order_relaxed);
+        frame.uNumGpuZones = 0u;
+        m_bInFrame = TRUE;
+
+        if (!pImmediateContext || !m_bHasGpuQueries)
+        {
+            return;
+        }
+
+        GpuQueryFrame& queryFrame = m_aGpuQueryFrames[m_uFrameNumber % NUM_GPU_QUERY_FRAMES];
+        if (queryFrame.bPending)
+        {
+            resolveGpuQueries(pImmediateContext, queryFrame);
+        }
+        queryFrame.uNumZones = 0u;
+        queryFrame.uFrameNumber = m_uFrameNumber;
+        queryFrame.bActive = TRUE;
+        pImmediateContext->Begin(queryFrame.Disjoint.Get());
+        pImmediateContext->End(queryFrame.FrameBegin.Get());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::EndFrame
+
+      Summary:  Ends the current frame. A frame begun while enabled is
+                ended even if the profiler was disabled since
+
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  Immediate context passed to BeginFrame
+
+      Modifies: [m_bInFrame, m_uFrameNumber, m_uNumFrames, m_aFrames,
+                 m_aGpuQueryFrames].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Profiler::EndFrame(_In_opt_ ID3D11DeviceContext* pImmediateContext)
+    {
+        if (!m_bInFrame)
+        {
+            return;
+        }
+
+        LARGE_INTEGER ticks;
+        QueryPerformanceCounter(&ticks);
+        m_aFrames[m_uFrameNumber % NUM_FRAMES].EndTicks = ticks.QuadPart;
+
+        GpuQueryFrame& queryFrame = m_aGpuQueryFrames[m_uFrameNumber % NUM_GPU_QUERY_FRAMES];
+        if (queryFrame.bActive && pImmediateContext)
+        {
+            pImmediateContext->End(queryFrame.Disjoint.Get());
+            queryFrame.bPending = TRUE;
+        }
+        queryFrame.bActive = FALSE;
+
+        ++m_uFrameNumber;
+        m_uNumFrames = (std::min)(m_uNumFrames + 1u, NUM_FRAMES);
+        m_bInFrame = FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::BeginCpuZone
+
+      Summary:  Opens a CPU zone of the current frame. Safe to call
+                from any thread while the frame is running
+
+      Args:     PCSTR pszName
+                  Name of the zone, a string literal
+
+      Modifies: [m_aFrames].
+
+      Returns:  ProfileZone*
+                  Zone to pass to EndCpuZone, nullptr if disabled,
+                  outside of a frame or the frame is full
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ProfileZone* Profiler::BeginCpuZone(_In_ PCSTR pszName)
+    {
+        if (!m_bEnabled || !m_bInFrame)
+        {
+            return nullptr;
+        }
+
+        FrameRecord& frame = m_aFrames[m_uFrameNumber % NUM_FRAMES];
+        const UINT uZone = frame.uNumCpuZones.fetch_add(1u, std::memory_order_relaxed);
+        if (uZone >= MAX_CPU_ZONES_PER_FRAME)
+        {
+            return nullptr;
+        }
+
+        LARGE_INTEGER ticks;
+        QueryPerformanceCounter(&ticks);
+
+        ProfileZone& zone = frame.aCpuZones[uZone];
+        zone.pszName = pszName;
+        zone.dwThreadId = GetCurrentThreadId();
+        zone.BeginTicks = ticks.QuadPart;
+        zone.EndTicks = ticks.QuadPart;
+
+        return &zone;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::EndCpuZone
+
+      Summary:  Closes a CPU zone
+
+      Args:     ProfileZone* pZone
+                  Zone returned by BeginCpuZone
+
+      Modifies: [pZone].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Profiler::EndCpuZone(_In_opt_ ProfileZone* pZone)
+    {
+        if (!pZone)
+        {
+            return;
+        }
+
+        LARGE_INTEGER ticks;
+        QueryPerformanceCounter(&ticks);
+        pZone->EndTicks = ticks.QuadPart;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::BeginGpuZone
+
+      Summary:  Opens a GPU zone of the current frame with a timestamp
+                query. Only the thread that owns the immediate context
+                may call it
+
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  Immediate context passed to BeginFrame
+                PCSTR pszName
+                  Name of the zone, a string literal
+
+      Modifies: [m_aGpuQueryFrames].
+
+      Returns:  UINT
+                  Zone to pass to EndGpuZone, INVALID_ZONE if nothing
+                  is timed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Profiler::BeginGpuZone(_In_ ID3D11DeviceContext* pImmediateContext, _In_ PCSTR pszName)
+    {
+        if (!m_bEnabled || !m_bInFrame || !m_bHasGpuQueries)
+        {
+            return INVALID_ZONE;
+        }
+
+        GpuQueryFrame& queryFrame = m_aGpuQueryFrames[m_uFrameNumber % NUM_GPU_QUERY_FRAMES];
+        if (!queryFrame.bActive || queryFrame.uNumZones >= MAX_GPU_ZONES_PER_FRAME)
+        {
+            return INVALID_ZONE;
+        }
+
+        pImmediateContext->End(queryFrame.aBegin[queryFrame.uNumZones].Get());
+        queryFrame.apszNames[queryFrame.uNumZones] = pszName;
+
+        return queryFrame.uNumZones++;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::EndGpuZone
+
+      Summary:  Closes a GPU zone with a timestamp query
+
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  Immediate context passed to BeginGpuZone
+                UINT uZone
+                  Zone returned by BeginGpuZone
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Profiler::EndGpuZone(_In_ ID3D11DeviceContext* pImmediateContext, _In_ UINT uZone)
+    {
+        if (uZone == INVALID_ZONE)
+        {
+            return;
+        }
+
+        GpuQueryFrame& queryFrame = m_aGpuQueryFrames[m_uFrameNumber % NUM_GPU_QUERY_FRAMES];
+        if (!queryFrame.bActive || uZone >= queryFrame.uNumZones)
+        {
+            return;
+        }
+
+        pImmediateContext->End(queryFrame.aEnd[uZone].Get());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::GetNumFrames
+
+      Summary:  Returns the number of finished frames in the ring
+
+      Returns:  UINT
+                  Number of recorded frames, at most NUM_FRAMES
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Profiler::GetNumFrames() const
+    {
+        return m_uNumFrames;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::Summarize
+
+      Summary:  Computes the time of every zone over the recorded
+                frames. The first summary is the whole frame, the rest
+                follow in the order the zones first appear
+
+      Args:     std::vector<ProfileSummary>& aSummaries
+                  Receives the summaries
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Profiler::Summarize(_Out_ std::vector<ProfileSummary>& aSummaries) const
+    {
+        aSummaries.clear();
+        if (m_uNumFrames == 0u)
+        {
+            return;
+        }
+
+        // Per summary, the time of the zone in each frame it ran in, and
+        // its time in the frame being added or a negative value if it
+        // has not run in it
+        std::vector<std::vector<DOUBLE>> aaSamples;
+        std::vector<DOUBLE> aFrameTimes;
+        auto findSummary = [&](PCSTR pszName, BOOL bGpu)
+        {
+            for (size_t i = 0u; i < aSummaries.size(); ++i)
+            {
+                if (aSummaries[i].bGpu == bGpu && strcmp(aSummaries[i].pszName, pszName) == 0)
+                {
+                    return i;
+                }
+            }
+
+            aSummaries.push_back(ProfileSummary{ .pszName = pszName, .bGpu = bGpu });
+            aaSamples.emplace_back();
+            aFrameTimes.push_back(-1.0);
+            return aSummaries.size() - 1u;
+        };
+        findSummary("Frame", FALSE);
+
+        const DOUBLE millisecondsPerTick = 1000.0 / static_cast<DOUBLE>(m_frequency);
+        for (UINT i = 0u; i < m_uNumFrames; ++i)
+        {
+            const FrameRecord& frame = m_aFrames[(m_uFrameNumber - m_uNumFrames + i) % NUM_FRAMES];
+            std::fill(aFrameTimes.begin(), aFrameTimes.end(), -1.0);
+            aFrameTimes[0] = static_cast<DOUBLE>(frame.EndTicks - frame.BeginTicks) * millisecondsPerTick;
+
+            auto addZone = [&](const ProfileZone& zone, BOOL bGpu)
+            {
+                const size_t uSummary = findSummary(zone.pszName, bGpu);
+                aFrameTimes[uSummary] = (std::max)(aFrameTimes[uSummary], 0.0) + static_cast<DOUBLE>(zone.EndTicks - zone.BeginTicks) * millisecondsPerTick;
+            };
+            for (UINT k = 0u; k < getNumCpuZones(frame); ++k)
+            {
+                addZone(frame.aCpuZones[k], FALSE);
+            }
+            for (UINT k = 0u; k < frame.uNumGpuZones; ++k)
+            {
+                addZone(frame.aGpuZones[k], TRUE);
+            }
+
+            for (size_t uSummary = 0u; uSummary < aSummaries.size(); ++uSummary)
+            {
+                if (aFrameTimes[uSummary] >= 0.0)
+                {
+                    aaSamples[uSummary].push_back(aFrameTimes[uSummary]);
+                }
+            }
+        }
+
+        for (size_t uSummary = 0u; uSummary < aSummaries.size(); ++uSummary)
+        {
+            std::vector<DOUBLE>& aSamples = aaSamples[uSummary];
+            std::sort(aSamples.begin(), aSamples.end());
+
+            DOUBLE sum = 0.0;
+            for (DOUBLE sample : aSamples)
+            {
+                sum += sample;
+            }
+
+            const size_t uNumSamples = aSamples.size();
+            const size_t uP99Index = static_cast<size_t>(std::ceil(0.99 * static_cast<DOUBLE>(uNumSamples)));
+            ProfileSummary& summary = aSummaries[uSummary];
+            summary.uNumFrames = static_cast<UINT>(uNumSamples);
+            summary.MinMilliseconds = aSamples.front();
+            summary.AverageMilliseconds = sum / static_cast<DOUBLE>(uNumSamples);
+            summary.P99Milliseconds = aSamples[(std::min)(uP99Index, uNumSamples) - 1u];
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::ExportChromeTrace
+
+      Summary:  Writes the recorded frames in the Chrome trace event
+                format, which chrome://tracing and Perfetto open. Each
+                frame and zone is a complete event on the thread that
+                ran it, GPU zones are on a thread named GPU. Zone names
+                are written as they are, without escaping
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the JSON file to write
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Profiler::ExportChromeTrace(_In_ const std::filesystem::path& filePath) const
+    {
+        std::ofstream outputFile(filePath, std::ios::trunc);
+        if (!outputFile.is_open())
+        {
+            return HRESULT_FROM_WIN32(ERROR_CANNOT_MAKE);
+        }
+
+        outputFile << std::fixed << std::setprecision(3);
+        outputFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        outputFile << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"GPU\"}}";
+
+        if (m_uNumFrames > 0u)
+        {
+            const LONGLONG originTicks = m_aFrames[(m_uFrameNumber - m_uNumFrames) % NUM_FRAMES].BeginTicks;
+            const DOUBLE microsecondsPerTick = 1000000.0 / static_cast<DOUBLE>(m_frequency);
+            auto writeEvent = [&](PCSTR pszName, PCSTR pszCategory, DWORD dwThreadId, LONGLONG beginTicks, LONGLONG endTicks)
+            {
+                outputFile
+                    << ",\n{\"name\":\"" << pszName
+                    << "\",\"cat\":\"" << pszCategory
+                    << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << dwThreadId
+                    << ",\"ts\":" << static_cast<DOUBLE>(beginTicks - originTicks) * microsecondsPerTick
+                    << ",\"dur\":" << static_cast<DOUBLE>(endTicks - beginTicks) * microsecondsPerTick
+                    << "}";
+            };
+
+            for (UINT i = 0u; i < m_uNumFrames; ++i)
+            {
+                const FrameRecord& frame = m_aFrames[(m_uFrameNumber - m_uNumFrames + i) % NUM_FRAMES];
+                writeEvent("Frame", "frame", frame.dwThreadId, frame.BeginTicks, frame.EndTicks);
+                for (UINT k = 0u; k < getNumCpuZones(frame); ++k)
+                {
+                    const ProfileZone& zone = frame.aCpuZones[k];
+                    writeEvent(zone.pszName, "cpu", zone.dwThreadId, zone.BeginTicks, zone.EndTicks);
+                }
+                for (UINT k = 0u; k < frame.uNumGpuZones; ++k)
+                {
+                    const ProfileZone& zone = frame.aGpuZones[k];
+                    writeEvent(zone.pszName, "gpu", zone.dwThreadId, zone.BeginTicks, zone.EndTicks);
+                }
+            }
+        }
+
+        outputFile << "\n]}\n";
+        if (outputFile.fail())
+        {
+            return HRESULT_FROM_WIN32(ERROR_WRITE_FAULT);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::resolveGpuQueries
+
+      Summary:  Reads back the timestamps of a finished frame without
+                waiting and stores them as GPU zones of its frame
+                record. The timestamp of the frame begin is taken to be
+                the CPU begin of the frame. Frames whose timestamps are
+                not ready, are disjoint or have left the ring get no
+                GPU zones
+
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  Immediate context the queries ran on
+                GpuQueryFrame& queryFrame
+                  Queries of the frame
+
+      Modifies: [m_aFrames, queryFrame].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Profiler::resolveGpuQueries(_In_ ID3D11DeviceContext* pImmediateContext, _Inout_ GpuQueryFrame& queryFrame)
+    {
+        queryFrame.bPending = FALSE;
+        if (m_uFrameNumber - queryFrame.uFrameNumber >= NUM_FRAMES)
+        {
+            return;
+        }
+
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint = {};
+        if (pImmediateContext->GetData(queryFrame.Disjoint.Get(), &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK || disjoint.Disjoint)
+        {
+            return;
+        }
+
+        UINT64 uFrameBegin = 0u;
+        if (pImmediateContext->GetData(queryFrame.FrameBegin.Get(), &uFrameBegin, sizeof(uFrameBegin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+        {
+            return;
+        }
+
+        FrameRecord& frame = m_aFrames[queryFrame.uFrameNumber % NUM_FRAMES];
+        const DOUBLE ticksPerTimestamp = static_cast<DOUBLE>(m_frequency) / static_cast<DOUBLE>(disjoint.Frequency);
+        frame.uNumGpuZones = 0u;
+        for (UINT i = 0u; i < queryFrame.uNumZones; ++i)
+        {
+            UINT64 uBegin = 0u;
+            UINT64 uEnd = 0u;
+            if (pImmediateContext->GetData(queryFrame.aBegin[i].Get(), &uBegin, sizeof(uBegin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK
+                || pImmediateContext->GetData(queryFrame.aEnd[i].Get(), &uEnd, sizeof(uEnd), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+            {
+                continue;
+            }
+
+            ProfileZone& zone = frame.aGpuZones[frame.uNumGpuZones++];
+            zone.pszName = queryFrame.apszNames[i];
+            zone.dwThreadId = 0u;
+            zone.BeginTicks = frame.BeginTicks + static_cast<LONGLONG>(static_cast<DOUBLE>(static_cast<INT64>(uBegin - uFrameBegin)) * ticksPerTimestamp);
+            zone.EndTicks = frame.BeginTicks + static_cast<LONGLONG>(static_cast<DOUBLE>(static_cast<INT64>(uEnd - uFrameBegin)) * ticksPerTimestamp);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::getNumCpuZones
+
+      Summary:  Returns the number of CPU zones stored for a frame
+
+      Args:     const FrameRecord& frame
+                  Frame of the ring
+
+      Returns:  UINT
+                  Number of zones, zones dropped for lack of space are
+                  not counted
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Profiler::getNumCpuZones(_In_ const FrameRecord& frame) const
+    {
+        return (std::min)(frame.uNumCpuZones.load(std::memory_order_relaxed), MAX_CPU_ZONES_PER_FRAME);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ProfileScope::ProfileScope
+
+      Summary:  Constructor. Opens a CPU zone
+
+      Args:     PCSTR pszName
+                  Name of the zone, a string literal
+
+      Modifies: [m_pZone].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ProfileScope::ProfileScope(_In_ PCSTR pszName)
+        : m_pZone(Profiler::Get().BeginCpuZone(pszName))
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ProfileScope::~ProfileScope
+
+      Summary:  Destructor. Closes the CPU zone
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ProfileScope::~ProfileScope()
+    {
+        Profiler::Get().EndCpuZone(m_pZone);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GpuProfileScope::GpuProfileScope
+
+      Summary:  Constructor. Opens a GPU zone
+
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  Immediate context to time, nullptr to time nothing
+                PCSTR pszName
+                  Name of the zone, a string literal
+
+      Modifies: [m_pImmediateContext, m_uZone].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    GpuProfileScope::GpuProfileScope(_In_opt_ ID3D11DeviceContext* pImmediateContext, _In_ PCSTR pszName)
+        : m_pImmediateContext(pImmediateContext)
+        , m_uZone(Profiler::INVALID_ZONE)
+    {
+        if (m_pImmediateContext)
+        {
+            m_uZone = Profiler::Get().BeginGpuZone(m_pImmediateContext, pszName);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GpuProfileScope::~GpuProfileScope
+
+      Summary:  Destructor. Closes the GPU zone
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    GpuProfileScope::~GpuProfileScope()
+    {
+        if (m_uZone != Profiler::INVALID_ZONE)
+        {
+            Profiler::Get().EndGpuZone(m_pImmediateContext, m_uZone);
+        }
+    }
+}
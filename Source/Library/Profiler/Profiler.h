@@ -0,0 +1,238 @@
+/*+===================================================================
+  File:      PROFILER.H
+
+  Summary:   Profiler header file contains declarations of Profiler
+             class that times the CPU and GPU work of recent frames,
+             and of the scopes that mark the timed zones.
+
+  Classes: Profiler, ProfileScope, GpuProfileScope
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <atomic>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   ProfileZone
+
+      Summary:  One timed zone of a frame. Ticks are those of
+                QueryPerformanceCounter, GPU zones are converted to
+                them. dwThreadId is 0 for GPU zones
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ProfileZone
+    {
+        PCSTR pszName;
+        DWORD dwThreadId;
+        LONGLONG BeginTicks;
+        LONGLONG EndTicks;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   ProfileSummary
+
+      Summary:  Time of a zone over the recorded frames. A zone that
+                runs several times in a frame counts with the sum of
+                its times, frames it does not run in are left out
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ProfileSummary
+    {
+        PCSTR pszName;
+        BOOL bGpu;
+        UINT uNumFrames;
+        DOUBLE MinMilliseconds;
+        DOUBLE AverageMilliseconds;
+        DOUBLE P99Milliseconds;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    Profiler
+
+      Summary:  Keeps the CPU and GPU zones of the last NUM_FRAMES
+                frames in a ring. CPU zones may be opened from any
+                thread during a frame. GPU zones are timestamp queries
+                on the immediate context, read back NUM_GPU_QUERY_FRAMES
+                frames later without waiting, so the last few frames
+                have no GPU zones yet. While disabled every call returns
+                after one check, so the scopes can stay in the code
+
+      Methods:  Get
+                  Returns the profiler of the process
+                Initialize
+                  Creates the GPU queries
+                SetEnabled
+                  Starts or stops recording
+                IsEnabled
+                  Returns whether frames are recorded
+                BeginFrame
+                  Starts a frame
+                EndFrame
+                  Ends a frame
+                BeginCpuZone
+                  Opens a CPU zone
+                EndCpuZone
+                  Closes a CPU zone
+                BeginGpuZone
+                  Opens a GPU zone
+                EndGpuZone
+                  Closes a GPU zone
+                GetNumFrames
+                  Returns the number of recorded frames
+                Summarize
+                  Computes the min, average and 99th percentile time of
+                  every zone
+                ExportChromeTrace
+                  Writes the recorded frames as a Chrome trace
+                Profiler
+                  Constructor.
+                ~Profiler
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class Profiler final
+    {
+    public:
+        static constexpr const UINT NUM_FRAMES = 128u;
+        static constexpr const UINT MAX_CPU_ZONES_PER_FRAME = 256u;
+        static constexpr const UINT MAX_GPU_ZONES_PER_FRAME = 16u;
+        static constexpr const UINT NUM_GPU_QUERY_FRAMES = 4u;
+        static constexpr const UINT INVALID_ZONE = UINT_MAX;
+
+        static Profiler& Get();
+
+        Profiler();
+        Profiler(const Profiler& other) = delete;
+        Profiler(Profiler&& other) = delete;
+        Profiler& operator=(const Profiler& other) = delete;
+        Profiler& operator=(Profiler&& other) = delete;
+        ~Profiler() = default;
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice);
+        void SetEnabled(_In_ BOOL bEnabled);
+        BOOL IsEnabled() const;
+
+        void BeginFrame(_In_opt_ ID3D11DeviceContext* pImmediateContext);
+        void EndFrame(_In_opt_ ID3D11DeviceContext* pImmediateContext);
+        ProfileZone* BeginCpuZone(_In_ PCSTR pszName);
+        void EndCpuZone(_In_opt_ ProfileZone* pZone);
+        UINT BeginGpuZone(_In_ ID3D11DeviceContext* pImmediateContext, _In_ PCSTR pszName);
+        void EndGpuZone(_In_ ID3D11DeviceContext* pImmediateContext, _In_ UINT uZone);
+
+        UINT GetNumFrames() const;
+        void Summarize(_Out_ std::vector<ProfileSummary>& aSummaries) const;
+        HRESULT ExportChromeTrace(_In_ const std::filesystem::path& filePath) const;
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   FrameRecord
+
+          Summary:  Zones of one frame of the ring. uNumCpuZones is
+                    bumped by every thread that opens a zone and may
+                    exceed MAX_CPU_ZONES_PER_FRAME, the zones past it
+                    are dropped
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct FrameRecord
+        {
+            LONGLONG BeginTicks;
+            LONGLONG EndTicks;
+            DWORD dwThreadId;
+            std::atomic<UINT> uNumCpuZones;
+            UINT uNumGpuZones;
+            ProfileZone aCpuZones[MAX_CPU_ZONES_PER_FRAME];
+            ProfileZone aGpuZones[MAX_GPU_ZONES_PER_FRAME];
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   GpuQueryFrame
+
+          Summary:  Timestamp queries of one frame in flight. The
+                    timestamp at FrameBegin is matched to the CPU begin
+                    of the frame uFrameNumber to place its zones
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct GpuQueryFrame
+        {
+            ComPtr<ID3D11Query> Disjoint;
+            ComPtr<ID3D11Query> FrameBegin;
+            ComPtr<ID3D11Query> aBegin[MAX_GPU_ZONES_PER_FRAME];
+            ComPtr<ID3D11Query> aEnd[MAX_GPU_ZONES_PER_FRAME];
+            PCSTR apszNames[MAX_GPU_ZONES_PER_FRAME];
+            UINT uNumZones;
+            UINT64 uFrameNumber;
+            BOOL bActive;
+            BOOL bPending;
+        };
+
+    private:
+        void resolveGpuQueries(_In_ ID3D11DeviceContext* pImmediateContext, _Inout_ GpuQueryFrame& queryFrame);
+        UINT getNumCpuZones(_In_ const FrameRecord& frame) const;
+
+    private:
+        static Profiler s_profiler;
+
+        BOOL m_bEnabled;
+        BOOL m_bInFrame;
+        BOOL m_bHasGpuQueries;
+        LONGLONG m_frequency;
+        UINT64 m_uFrameNumber;
+        UINT m_uNumFrames;
+        std::unique_ptr<FrameRecord[]> m_aFrames;
+        std::unique_ptr<GpuQueryFrame[]> m_aGpuQueryFrames;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ProfileScope
+
+      Summary:  Times the CPU work from its construction to its
+                destruction as a zone of the profiler of the process.
+                The name must outlive the recorded frames, a string
+                literal is expected
+
+      Methods:  ProfileScope
+                  Constructor. Opens the zone
+                ~ProfileScope
+                  Destructor. Closes the zone
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ProfileScope final
+    {
+    public:
+        explicit ProfileScope(_In_ PCSTR pszName);
+        ProfileScope(const ProfileScope& other) = delete;
+        ProfileScope(ProfileScope&& other) = delete;
+        ProfileScope& operator=(const ProfileScope& other) = delete;
+        ProfileScope& operator=(ProfileScope&& other) = delete;
+        ~ProfileScope();
+
+    private:
+        ProfileZone* m_pZone;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    GpuProfileScope
+
+      Summary:  Times the GPU work issued to the immediate context from
+                its construction to its destruction. Without a context
+                nothing is timed
+
+      Methods:  GpuProfileScope
+                  Constructor. Opens the zone
+                ~GpuProfileScope
+                  Destructor. Closes the zone
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class GpuProfileScope final
+    {
+    public:
+        GpuProfileScope(_In_opt_ ID3D11DeviceContext* pImmediateContext, _In_ PCSTR pszName);
+        GpuProfileScope(const GpuProfileScope& other) = delete;
+        GpuProfileScope(GpuProfileScope&& other) = delete;
+        GpuProfileScope& operator=(const GpuProfileScope& other) = delete;
+        GpuProfileScope& operator=(GpuProfileScope&& other) = delete;
+        ~GpuProfileScope();
+
+    private:
+        ID3D11DeviceContext* m_pImmediateContext;
+        UINT m_uZone;
+    };
+}
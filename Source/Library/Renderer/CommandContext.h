@@ -0,0 +1,234 @@
+/*+===================================================================
+  File:      COMMANDCONTEXT.H
+
+  Summary:   CommandContext header file contains declarations of
+             CommandContext interface that the renderer issues its
+             per-frame commands to. It only depends on the standard
+             library, the objects of the graphics API are passed as
+             opaque handles.
+
+  Classes: CommandContext
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   GpuBuffer ~ GpuSamplerState
+
+      Summary:  Opaque handles of the objects a command refers to. They
+                are never defined: a backend converts its own objects
+                to and from them, and RecordingCommandContext only
+                compares them
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct GpuBuffer;
+    struct GpuResource;
+    struct GpuRenderTargetView;
+    struct GpuDepthStencilView;
+    struct GpuDepthStencilState;
+    struct GpuInputLayout;
+    struct GpuVertexShader;
+    struct GpuPixelShader;
+    struct GpuShaderResourceView;
+    struct GpuSamplerState;
+
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eMapType
+
+      Summary:  Ways a dynamic buffer is mapped for writing
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eMapType : uint8_t
+    {
+        WRITE_DISCARD,
+        WRITE_NO_OVERWRITE,
+    };
+
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eIndexFormat
+
+      Summary:  Formats of the indices of an index buffer
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eIndexFormat : uint8_t
+    {
+        UINT16,
+        UINT32,
+    };
+
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     ePrimitiveTopology
+
+      Summary:  Primitive topologies the renderer draws with
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class ePrimitiveTopology : uint8_t
+    {
+        TRIANGLE_LIST,
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   Viewport
+
+      Summary:  Rectangle of the render target drawn to and its depth
+                range, laid out like D3D11_VIEWPORT
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct Viewport
+    {
+        float TopLeftX;
+        float TopLeftY;
+        float Width;
+        float Height;
+        float MinDepth;
+        float MaxDepth;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    CommandContext
+
+      Summary:  Interface for the binds, uploads and draws of a frame.
+                D3D11CommandContext passes them to a Direct3D 11 device
+                context, RecordingCommandContext only records them so
+                the frame can be run and analyzed without drawing.
+
+                A deferred context of either backend collects its
+                commands into a command list with FinishCommandList,
+                which an immediate context of the same backend runs
+                with ExecuteCommandList. A command list starts with no
+                state bound and leaves none bound after it.
+
+                Map and FinishCommandList return whether they
+                succeeded
+
+      Methods:  ClearRenderTargetView
+                  Pure virtual function that clears a render target
+                ClearDepthStencilView
+                  Pure virtual function that clears a depth stencil
+                OMSetRenderTargets
+                  Pure virtual function that binds render targets
+                OMSetDepthStencilState
+                  Pure virtual function that sets the depth stencil
+                  state
+                RSSetViewport
+                  Pure virtual function that sets the viewport
+                IASetPrimitiveTopology
+                  Pure virtual function that sets the primitive
+                  topology
+                IASetVertexBuffers
+                  Pure virtual function that binds vertex buffers
+                IASetIndexBuffer
+                  Pure virtual function that binds an index buffer
+                IASetInputLayout
+                  Pure virtual function that binds an input layout
+                VSSetShader
+                  Pure virtual function that binds a vertex shader
+                PSSetShader
+                  Pure virtual function that binds a pixel shader
+                VSSetConstantBuffer
+                  Pure virtual function that binds a constant buffer
+                  to the vertex shader
+                PSSetConstantBuffer
+                  Pure virtual function that binds a constant buffer
+                  to the pixel shader
+                VSSetConstantBufferRange
+                  Pure virtual function that binds a range of a
+                  constant buffer to the vertex shader
+                PSSetConstantBufferRange
+                  Pure virtual function that binds a range of a
+                  constant buffer to the pixel shader
+                PSSetShaderResource
+                  Pure virtual function that binds a shader resource
+                  view to the pixel shader
+                PSSetSampler
+                  Pure virtual function that binds a sampler to the
+                  pixel shader
+                UpdateSubresource
+                  Pure virtual function that uploads the contents of a
+                  buffer
+                Map
+                  Pure virtual function that maps a range of a dynamic
+                  buffer
+                Unmap
+                  Pure virtual function that unmaps a dynamic buffer
+                CopySubresource
+                  Pure virtual function that copies a whole
+                  subresource between resources
+                DrawIndexed
+                  Pure virtual function that draws indexed primitives
+                DrawIndexedInstanced
+                  Pure virtual function that draws instances of
+                  indexed primitives
+                FinishCommandList
+                  Pure virtual function that ends the command list of
+                  a deferred context
+                ExecuteCommandList
+                  Pure virtual function that runs the command list of
+                  a deferred context
+                CommandContext
+                  Constructor.
+                ~CommandContext
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class CommandContext
+    {
+    public:
+        static constexpr const uint32_t CLEAR_DEPTH = 1u;
+        static constexpr const uint32_t CLEAR_STENCIL = 2u;
+
+    public:
+        CommandContext() = default;
+        CommandContext(const CommandContext& other) = delete;
+        CommandContext(CommandContext&& other) = delete;
+        CommandContext& operator=(const CommandContext& other) = delete;
+        CommandContext& operator=(CommandContext&& other) = delete;
+        virtual ~CommandContext() = default;
+
+        virtual void ClearRenderTargetView(GpuRenderTargetView* pRenderTargetView, const float aColor[4]) = 0;
+        virtual void ClearDepthStencilView(GpuDepthStencilView* pDepthStencilView, uint32_t uClearFlags, float depth, uint8_t uStencil) = 0;
+        virtual void OMSetRenderTargets(
+            uint32_t uNumViews,
+            GpuRenderTargetView* const* ppRenderTargetViews,
+            GpuDepthStencilView* pDepthStencilView
+        ) = 0;
+        virtual void OMSetDepthStencilState(GpuDepthStencilState* pDepthStencilState, uint32_t uStencilRef) = 0;
+        virtual void RSSetViewport(const Viewport& viewport) = 0;
+        virtual void IASetPrimitiveTopology(ePrimitiveTopology topology) = 0;
+
+        virtual void IASetVertexBuffers(
+            uint32_t uStartSlot,
+            uint32_t uNumBuffers,
+            GpuBuffer* const* ppVertexBuffers,
+            const uint32_t* puStrides,
+            const uint32_t* puOffsets
+        ) = 0;
+        virtual void IASetIndexBuffer(GpuBuffer* pIndexBuffer, eIndexFormat format, uint32_t uOffset) = 0;
+        virtual void IASetInputLayout(GpuInputLayout* pInputLayout) = 0;
+        virtual void VSSetShader(GpuVertexShader* pVertexShader) = 0;
+        virtual void PSSetShader(GpuPixelShader* pPixelShader) = 0;
+        virtual void VSSetConstantBuffer(uint32_t uSlot, GpuBuffer* pConstantBuffer) = 0;
+        virtual void PSSetConstantBuffer(uint32_t uSlot, GpuBuffer* pConstantBuffer) = 0;
+        virtual void VSSetConstantBufferRange(uint32_t uSlot, GpuBuffer* pConstantBuffer, uint32_t uFirstConstant, uint32_t uNumConstants) = 0;
+        virtual void PSSetConstantBufferRange(uint32_t uSlot, GpuBuffer* pConstantBuffer, uint32_t uFirstConstant, uint32_t uNumConstants) = 0;
+        virtual void PSSetShaderResource(uint32_t uSlot, GpuShaderResourceView* pShaderResourceView) = 0;
+        virtual void PSSetSampler(uint32_t uSlot, GpuSamplerState* pSampler) = 0;
+
+        virtual void UpdateSubresource(GpuBuffer* pBuffer, const void* pData, size_t uSize) = 0;
+        virtual bool Map(GpuBuffer* pBuffer, eMapType mapType, uint32_t uFirstByte, uint32_t uNumBytes, void** ppData) = 0;
+        virtual void Unmap(GpuBuffer* pBuffer) = 0;
+        virtual void CopySubresource(GpuResource* pDstResource, uint32_t uDstSubresource, GpuResource* pSrcResource, uint32_t uSrcSubresource) = 0;
+
+        virtual void DrawIndexed(uint32_t uIndexCount, uint32_t uStartIndexLocation, int32_t iBaseVertexLocation) = 0;
+        virtual void DrawIndexedInstanced(
+            uint32_t uIndexCountPerInstance,
+            uint32_t uInstanceCount,
+            uint32_t uStartIndexLocation,
+            int32_t iBaseVertexLocation,
+            uint32_t uStartInstanceLocation
+        ) = 0;
+
+        virtual bool FinishCommandList() = 0;
+        virtual void ExecuteCommandList(CommandContext* pDeferredContext) = 0;
+    };
+}
@@ -0,0 +1,196 @@
+#include "Renderer/CommandStreamAnalyzer.h"
+
+#include <cstring>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandStreamAnalyzer::CommandStreamAnalyzer
+
+      Summary:  Constructor
+
+      Modifies: [m_lastBinds, m_uNumCommands, m_uNumDraws, m_uNumBinds,
+                 m_uNumRedundantBinds, m_uNumUploads,
+                 m_uNumBytesUploaded].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    CommandStreamAnalyzer::CommandStreamAnalyzer()
+        : m_lastBinds()
+        , m_uNumCommands(0u)
+        , m_uNumDraws(0u)
+        , m_uNumBinds(0u)
+        , m_uNumRedundantBinds(0u)
+        , m_uNumUploads(0u)
+        , m_uNumBytesUploaded(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandStreamAnalyzer::Analyze
+
+      Summary:  Summarizes a list of recorded commands. Nothing is
+                assumed to be bound before the first command, so the
+                first bind to each slot is never redundant. The same
+                holds after a command list runs, which leaves nothing
+                bound, and inside the list, which starts from nothing
+
+      Args:     const std::vector<RecordedCommand>& aCommands
+                  Commands of one frame in call order
+
+      Modifies: [m_lastBinds, m_uNumCommands, m_uNumDraws, m_uNumBinds,
+                 m_uNumRedundantBinds, m_uNumUploads,
+                 m_uNumBytesUploaded].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandStreamAnalyzer::Analyze(const std::vector<RecordedCommand>& aCommands)
+    {
+        m_lastBinds.clear();
+        m_uNumCommands = static_cast<uint32_t>(aCommands.size());
+        m_uNumDraws = 0u;
+        m_uNumBinds = 0u;
+        m_uNumRedundantBinds = 0u;
+        m_uNumUploads = 0u;
+        m_uNumBytesUploaded = 0u;
+
+        uint32_t uNumListCommandsLeft = 0u;
+        for (const RecordedCommand& command : aCommands)
+        {
+            switch (command.Type)
+            {
+            case eCommandType::DRAW_INDEXED:
+            case eCommandType::DRAW_INDEXED_INSTANCED:
+                ++m_uNumDraws;
+                break;
+            case eCommandType::UPDATE_SUBRESOURCE:
+            case eCommandType::MAP:
+                ++m_uNumUploads;
+                m_uNumBytesUploaded += command.auArgs[0];
+                break;
+            case eCommandType::EXECUTE_COMMAND_LIST:
+                m_lastBinds.clear();
+                uNumListCommandsLeft = command.auArgs[0];
+                continue;
+            case eCommandType::SET_RENDER_TARGETS:
+            case eCommandType::SET_DEPTH_STENCIL_STATE:
+            case eCommandType::SET_VIEWPORT:
+            case eCommandType::SET_PRIMITIVE_TOPOLOGY:
+            case eCommandType::SET_VERTEX_BUFFER:
+            case eCommandType::SET_INDEX_BUFFER:
+            case eCommandType::SET_INPUT_LAYOUT:
+            case eCommandType::SET_VERTEX_SHADER:
+            case eCommandType::SET_PIXEL_SHADER:
+            case eCommandType::SET_VS_CONSTANT_BUFFER:
+            case eCommandType::SET_PS_CONSTANT_BUFFER:
+            case eCommandType::SET_PS_SHADER_RESOURCE:
+            case eCommandType::SET_PS_SAMPLER:
+            {
+                ++m_uNumBinds;
+
+                const uint64_t uKey = (static_cast<uint64_t>(command.Type) << 32u) | command.uSlot;
+                auto it = m_lastBinds.find(uKey);
+                if (it == m_lastBinds.end())
+                {
+                    m_lastBinds.emplace(uKey, &command);
+                    break;
+                }
+
+                const RecordedCommand& lastBind = *it->second;
+                if (lastBind.pObject == command.pObject
+                    && std::memcmp(lastBind.auArgs, command.auArgs, sizeof(command.auArgs)) == 0)
+                {
+                    ++m_uNumRedundantBinds;
+                }
+                it->second = &command;
+                break;
+            }
+            default:
+                break;
+            }
+
+            // The list leaves nothing bound behind it either
+            if (uNumListCommandsLeft > 0u && --uNumListCommandsLeft == 0u)
+            {
+                m_lastBinds.clear();
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandStreamAnalyzer::GetNumCommands
+
+      Summary:  Returns the number of analyzed commands
+
+      Returns:  uint32_t
+                  Number of commands
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t CommandStreamAnalyzer::GetNumCommands() const
+    {
+        return m_uNumCommands;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandStreamAnalyzer::GetNumDraws
+
+      Summary:  Returns the number of draws
+
+      Returns:  uint32_t
+                  Number of draws
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t CommandStreamAnalyzer::GetNumDraws() const
+    {
+        return m_uNumDraws;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandStreamAnalyzer::GetNumBinds
+
+      Summary:  Returns the number of binds, counting each slot of a
+                vertex buffer bind
+
+      Returns:  uint32_t
+                  Number of binds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t CommandStreamAnalyzer::GetNumBinds() const
+    {
+        return m_uNumBinds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandStreamAnalyzer::GetNumRedundantBinds
+
+      Summary:  Returns the number of binds that rebound what the slot
+                already held
+
+      Returns:  uint32_t
+                  Number of redundant binds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t CommandStreamAnalyzer::GetNumRedundantBinds() const
+    {
+        return m_uNumRedundantBinds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandStreamAnalyzer::GetNumUploads
+
+      Summary:  Returns the number of UpdateSubresource and Map calls
+
+      Returns:  uint32_t
+                  Number of uploads
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t CommandStreamAnalyzer::GetNumUploads() const
+    {
+        return m_uNumUploads;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandStreamAnalyzer::GetNumBytesUploaded
+
+      Summary:  Returns the number of bytes passed to UpdateSubresource
+                plus the number of bytes written to mapped buffers
+
+      Returns:  uint64_t
+                  Number of bytes uploaded
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint64_t CommandStreamAnalyzer::GetNumBytesUploaded() const
+    {
+        return m_uNumBytesUploaded;
+    }
+}
@@ -0,0 +1,78 @@
+/*+===================================================================
+  File:      COMMANDSTREAMANALYZER.H
+
+  Summary:   CommandStreamAnalyzer header file contains declarations
+             of CommandStreamAnalyzer class that summarizes a recorded
+             frame. It only depends on the standard library.
+
+  Classes: CommandStreamAnalyzer
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Renderer/RecordingCommandContext.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    CommandStreamAnalyzer
+
+      Summary:  Counts the draws, binds and uploaded bytes of a recorded
+                command stream. A bind is redundant when the slot it
+                binds to already holds the same object with the same
+                arguments, so it would not change the state of the
+                context
+
+      Methods:  Analyze
+                  Summarizes a list of recorded commands
+                GetNumCommands
+                  Returns the number of commands
+                GetNumDraws
+                  Returns the number of draws
+                GetNumBinds
+                  Returns the number of binds
+                GetNumRedundantBinds
+                  Returns the number of binds that change nothing
+                GetNumUploads
+                  Returns the number of uploads and maps
+                GetNumBytesUploaded
+                  Returns the number of bytes uploaded and mapped
+                CommandStreamAnalyzer
+                  Constructor.
+                ~CommandStreamAnalyzer
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class CommandStreamAnalyzer final
+    {
+    public:
+        CommandStreamAnalyzer();
+        CommandStreamAnalyzer(const CommandStreamAnalyzer& other) = delete;
+        CommandStreamAnalyzer(CommandStreamAnalyzer&& other) = delete;
+        CommandStreamAnalyzer& operator=(const CommandStreamAnalyzer& other) = delete;
+        CommandStreamAnalyzer& operator=(CommandStreamAnalyzer&& other) = delete;
+        ~CommandStreamAnalyzer() = default;
+
+        void Analyze(const std::vector<RecordedCommand>& aCommands);
+
+        uint32_t GetNumCommands() const;
+        uint32_t GetNumDraws() const;
+        uint32_t GetNumBinds() const;
+        uint32_t GetNumRedundantBinds() const;
+        uint32_t GetNumUploads() const;
+        uint64_t GetNumBytesUploaded() const;
+
+    private:
+        std::unordered_map<uint64_t, const RecordedCommand*> m_lastBinds;
+        uint32_t m_uNumCommands;
+        uint32_t m_uNumDraws;
+        uint32_t m_uNumBinds;
+        uint32_t m_uNumRedundantBinds;
+        uint32_t m_uNumUploads;
+        uint64_t m_uNumBytesUploaded;
+    };
+}
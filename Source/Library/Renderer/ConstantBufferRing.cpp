@@ -0,0 +1,246 @@
+#include "Renderer/ConstantBufferRing.h"
+
+#include <algorithm>
+
+#include "Renderer/D3D11CommandContext.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ConstantBufferRing::ConstantBufferRing
+
+      Summary:  Constructor
+
+      Modifies: [m_buffer, m_pMappedData, m_uSize, m_uHead, m_uMapBegin,
+                 m_uMapEnd, m_bNoOverwrite].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ConstantBufferRing::ConstantBufferRing()
+        : m_buffer()
+        , m_pMappedData(nullptr)
+        , m_uSize(0u)
+        , m_uHead(0u)
+        , m_uMapBegin(0u)
+        , m_uMapEnd(0u)
+        , m_bNoOverwrite(FALSE)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ConstantBufferRing::Initialize
+
+      Summary:  Creates the dynamic constant buffer. Binding ranges of
+                a constant buffer needs Direct3D 11.1 constant buffer
+                offsetting
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffer
+                UINT uSize
+                  Size of the buffer in bytes
+
+      Modifies: [m_buffer, m_uSize, m_uHead, m_uMapEnd, m_bNoOverwrite].
+
+      Returns:  HRESULT
+                  Status code, E_NOTIMPL if the device cannot bind
+                  ranges of constant buffers
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT ConstantBufferRing::Initialize(_In_ ID3D11Device* pDevice, _In_ UINT uSize)
+    {
+        assert(!m_pMappedData);
+
+        D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+        HRESULT hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options));
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        if (!options.ConstantBufferOffsetting)
+        {
+            return E_NOTIMPL;
+        }
+
+        D3D11_BUFFER_DESC bd =
+        {
+            .ByteWidth = GetNumConstants(uSize) * CONSTANT_SIZE,
+            .Usage = D3D11_USAGE_DYNAMIC,
+            .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+            .CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+        };
+        m_buffer.Reset();
+        hr = pDevice->CreateBuffer(&bd, nullptr, m_buffer.GetAddressOf());
+        if (FAILED(hr))
+        {
+            m_uSize = 0u;
+            return hr;
+        }
+
+        m_uSize = bd.ByteWidth;
+        m_bNoOverwrite = options.MapNoOverwriteOnDynamicConstantBuffer;
+
+        // A new buffer has to be discarded before it can be mapped
+        // without overwrite, so the first map starts as a wrap
+        m_uHead = m_uSize;
+        m_uMapEnd = m_uSize;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ConstantBufferRing::Map
+
+      Summary:  Reserves space for the constants of a frame and maps
+                it. The space follows the previous frame when it fits,
+                otherwise the ring wraps and the buffer is discarded
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to grow the buffer with
+                CommandContext* pContext
+                  The command context to map the buffer with
+                UINT uSize
+                  Number of bytes to reserve, the sum of the sizes
+                  passed to Allocate rounded up to RANGE_ALIGNMENT
+
+      Modifies: [m_buffer, m_pMappedData, m_uSize, m_uHead, m_uMapBegin,
+                 m_uMapEnd].
+
+      Returns:  HRESULT
+                  Status code, E_FAIL if the buffer cannot be mapped
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT ConstantBufferRing::Map(_In_ ID3D11Device* pDevice, _In_ CommandContext* pContext, _In_ UINT uSize)
+    {
+        assert(!m_pMappedData);
+
+        HRESULT hr = S_OK;
+        uSize = GetNumConstants(uSize) * CONSTANT_SIZE;
+        if (uSize > m_uSize)
+        {
+            hr = Initialize(pDevice, (std::max)(uSize, m_uSize * 2u));
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        eMapType mapType = eMapType::WRITE_NO_OVERWRITE;
+        if (!m_bNoOverwrite || m_uHead + uSize > m_uSize)
+        {
+            mapType = eMapType::WRITE_DISCARD;
+            m_uHead = 0u;
+        }
+
+        void* pData = nullptr;
+        if (!pContext->Map(D3D11CommandContext::ToHandle(m_buffer.Get()), mapType, m_uHead, uSize, &pData))
+        {
+            return E_FAIL;
+        }
+
+        m_pMappedData = static_cast<BYTE*>(pData);
+        m_uMapBegin = m_uHead;
+        m_uMapEnd = m_uHead + uSize;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ConstantBufferRing::Allocate
+
+      Summary:  Returns the next block of the mapped space. The block
+                starts on a RANGE_ALIGNMENT boundary, as the first
+                constant of a bound range must be a multiple of 16. The
+                memory is write-combined, so it should only be written
+                to
+
+      Args:     UINT uSize
+                  Size of the constants in bytes
+                UINT* puFirstConstant
+                  Receives the first constant to bind the block with
+
+      Modifies: [m_uHead].
+
+      Returns:  void*
+                  Memory to write the constants to, null if the block
+                  does not fit in the space reserved by Map
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void* ConstantBufferRing::Allocate(_In_ UINT uSize, _Out_ UINT* puFirstConstant)
+    {
+        const UINT uAlignedSize = GetNumConstants(uSize) * CONSTANT_SIZE;
+        if (!m_pMappedData || m_uHead + uAlignedSize > m_uMapEnd)
+        {
+            *puFirstConstant = 0u;
+            return nullptr;
+        }
+
+        void* pData = m_pMappedData + (m_uHead - m_uMapBegin);
+        *puFirstConstant = m_uHead / CONSTANT_SIZE;
+        m_uHead += uAlignedSize;
+
+        return pData;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ConstantBufferRing::Unmap
+
+      Summary:  Unmaps the buffer. Must be called before a draw reads
+                from it. The next frame continues after the last block
+                that was allocated
+
+      Args:     CommandContext* pContext
+                  The command context the buffer was mapped with
+
+      Modifies: [m_pMappedData].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ConstantBufferRing::Unmap(_In_ CommandContext* pContext)
+    {
+        if (m_pMappedData)
+        {
+            pContext->Unmap(D3D11CommandContext::ToHandle(m_buffer.Get()));
+            m_pMappedData = nullptr;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ConstantBufferRing::GetBuffer
+
+      Summary:  Returns the buffer
+
+      Returns:  ComPtr<ID3D11Buffer>&
+                  Dynamic constant buffer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Buffer>& ConstantBufferRing::GetBuffer()
+    {
+        return m_buffer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ConstantBufferRing::GetSize
+
+      Summary:  Returns the size of the buffer
+
+      Returns:  UINT
+                  Size of the buffer in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ConstantBufferRing::GetSize() const
+    {
+        return m_uSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ConstantBufferRing::GetNumConstants
+
+      Summary:  Returns the number of 16-byte constants a block of the
+                given size takes up, a nonzero multiple of 16 as
+                required for a bound range
+
+      Args:     UINT uSize
+                  Size of the constants in bytes
+
+      Returns:  UINT
+                  Number of constants
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ConstantBufferRing::GetNumConstants(_In_ UINT uSize)
+    {
+        const UINT uNumBlocks = ((std::max)(uSize, 1u) + RANGE_ALIGNMENT - 1u) / RANGE_ALIGNMENT;
+
+        return uNumBlocks * (RANGE_ALIGNMENT / CONSTANT_SIZE);
+    }
+}
@@ -0,0 +1,92 @@
+/*+===================================================================
+  File:      CONSTANTBUFFERRING.H
+
+  Summary:   ConstantBufferRing header file contains declarations of
+             ConstantBufferRing class that streams the per-object
+             constants of a frame through one dynamic buffer.
+
+  Classes: ConstantBufferRing
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/CommandContext.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ConstantBufferRing
+
+      Summary:  Dynamic constant buffer that is written as a ring. Each
+                frame maps the buffer once for the space it needs, packs
+                the constants of every object into it and binds ranges
+                of it with VSSetConstantBuffers1 and
+                PSSetConstantBuffers1.
+
+                A frame is written after the previous one with
+                D3D11_MAP_WRITE_NO_OVERWRITE, so the GPU can still read
+                the earlier ranges. When the rest of the buffer is too
+                small the ring wraps around with
+                D3D11_MAP_WRITE_DISCARD, and the buffer is recreated
+                larger when a frame does not fit at all. Devices that
+                cannot map dynamic constant buffers without overwrite
+                discard on every map
+
+      Methods:  Initialize
+                  Creates the buffer
+                Map
+                  Reserves and maps space for a frame
+                Allocate
+                  Returns space for a block of constants
+                Unmap
+                  Unmaps the buffer before it is drawn with
+                GetBuffer
+                  Returns the buffer
+                GetSize
+                  Returns the size of the buffer in bytes
+                GetNumConstants
+                  Returns the number of constants a range of a given
+                  size is bound with
+                ConstantBufferRing
+                  Constructor.
+                ~ConstantBufferRing
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ConstantBufferRing final
+    {
+    public:
+        static constexpr const UINT CONSTANT_SIZE = 16u;
+        static constexpr const UINT RANGE_ALIGNMENT = 256u;
+        static constexpr const UINT DEFAULT_SIZE = 1u << 20u;
+
+    public:
+        ConstantBufferRing();
+        ConstantBufferRing(const ConstantBufferRing& other) = delete;
+        ConstantBufferRing(ConstantBufferRing&& other) = delete;
+        ConstantBufferRing& operator=(const ConstantBufferRing& other) = delete;
+        ConstantBufferRing& operator=(ConstantBufferRing&& other) = delete;
+        ~ConstantBufferRing() = default;
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ UINT uSize = DEFAULT_SIZE);
+        HRESULT Map(_In_ ID3D11Device* pDevice, _In_ CommandContext* pContext, _In_ UINT uSize);
+        void* Allocate(_In_ UINT uSize, _Out_ UINT* puFirstConstant);
+        void Unmap(_In_ CommandContext* pContext);
+
+        ComPtr<ID3D11Buffer>& GetBuffer();
+        UINT GetSize() const;
+
+        static UINT GetNumConstants(_In_ UINT uSize);
+
+    private:
+        ComPtr<ID3D11Buffer> m_buffer;
+        BYTE* m_pMappedData;
+        UINT m_uSize;
+        UINT m_uHead;
+        UINT m_uMapBegin;
+        UINT m_uMapEnd;
+        BOOL m_bNoOverwrite;
+    };
+}
@@ -0,0 +1,578 @@
+#include "Renderer/D3D11CommandContext.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::D3D11CommandContext
+
+      Summary:  Constructor
+
+      Modifies: [m_pContext, m_pContext1, m_commandList].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    D3D11CommandContext::D3D11CommandContext()
+        : m_pContext(nullptr)
+        , m_pContext1(nullptr)
+        , m_commandList()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::Initialize
+
+      Summary:  Sets the device context the commands are passed to
+
+      Args:     ID3D11DeviceContext* pContext
+                  Device context
+                ID3D11DeviceContext1* pContext1
+                  Direct3D 11.1 interface of the same context, needed
+                  to bind ranges of constant buffers
+
+      Modifies: [m_pContext, m_pContext1].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::Initialize(_In_ ID3D11DeviceContext* pContext, _In_opt_ ID3D11DeviceContext1* pContext1)
+    {
+        m_pContext = pContext;
+        m_pContext1 = pContext1;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::GetViewport
+
+      Summary:  Converts a Direct3D 11 viewport to the viewport of the
+                command interface
+
+      Args:     const D3D11_VIEWPORT& viewport
+                  Direct3D 11 viewport
+
+      Returns:  Viewport
+                  Same viewport
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Viewport D3D11CommandContext::GetViewport(_In_ const D3D11_VIEWPORT& viewport)
+    {
+        return Viewport{
+            .TopLeftX = viewport.TopLeftX,
+            .TopLeftY = viewport.TopLeftY,
+            .Width = viewport.Width,
+            .Height = viewport.Height,
+            .MinDepth = viewport.MinDepth,
+            .MaxDepth = viewport.MaxDepth,
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::ClearRenderTargetView
+
+      Summary:  Clears a render target
+
+      Args:     GpuRenderTargetView* pRenderTargetView
+                  Render target
+                const float aColor[4]
+                  RGBA color to clear to
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::ClearRenderTargetView(_In_ GpuRenderTargetView* pRenderTargetView, _In_ const float aColor[4])
+    {
+        m_pContext->ClearRenderTargetView(fromHandle<ID3D11RenderTargetView>(pRenderTargetView), aColor);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::ClearDepthStencilView
+
+      Summary:  Clears a depth stencil
+
+      Args:     GpuDepthStencilView* pDepthStencilView
+                  Depth stencil
+                uint32_t uClearFlags
+                  CLEAR_DEPTH and / or CLEAR_STENCIL
+                float depth
+                  Depth to clear to
+                uint8_t uStencil
+                  Stencil value to clear to
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::ClearDepthStencilView(_In_ GpuDepthStencilView* pDepthStencilView, _In_ uint32_t uClearFlags, _In_ float depth, _In_ uint8_t uStencil)
+    {
+        UINT uD3D11ClearFlags = 0u;
+        if (uClearFlags & CLEAR_DEPTH)
+        {
+            uD3D11ClearFlags |= D3D11_CLEAR_DEPTH;
+        }
+        if (uClearFlags & CLEAR_STENCIL)
+        {
+            uD3D11ClearFlags |= D3D11_CLEAR_STENCIL;
+        }
+
+        m_pContext->ClearDepthStencilView(fromHandle<ID3D11DepthStencilView>(pDepthStencilView), uD3D11ClearFlags, depth, uStencil);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::OMSetRenderTargets
+
+      Summary:  Binds render targets and a depth stencil
+
+      Args:     uint32_t uNumViews
+                  Number of render targets
+                GpuRenderTargetView* const* ppRenderTargetViews
+                  Render targets
+                GpuDepthStencilView* pDepthStencilView
+                  Depth stencil
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::OMSetRenderTargets(
+        _In_ uint32_t uNumViews,
+        _In_reads_opt_(uNumViews) GpuRenderTargetView* const* ppRenderTargetViews,
+        _In_opt_ GpuDepthStencilView* pDepthStencilView
+    )
+    {
+        assert(uNumViews <= D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT);
+
+        ID3D11RenderTargetView* apRenderTargetViews[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT] = {};
+        for (uint32_t i = 0u; ppRenderTargetViews && i < uNumViews; ++i)
+        {
+            apRenderTargetViews[i] = fromHandle<ID3D11RenderTargetView>(ppRenderTargetViews[i]);
+        }
+
+        m_pContext->OMSetRenderTargets(uNumViews, ppRenderTargetViews ? apRenderTargetViews : nullptr, fromHandle<ID3D11DepthStencilView>(pDepthStencilView));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::OMSetDepthStencilState
+
+      Summary:  Sets the depth stencil state, null for the default one
+
+      Args:     GpuDepthStencilState* pDepthStencilState
+                  Depth stencil state
+                uint32_t uStencilRef
+                  Reference value of the stencil test
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::OMSetDepthStencilState(_In_opt_ GpuDepthStencilState* pDepthStencilState, _In_ uint32_t uStencilRef)
+    {
+        m_pContext->OMSetDepthStencilState(fromHandle<ID3D11DepthStencilState>(pDepthStencilState), uStencilRef);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::RSSetViewport
+
+      Summary:  Sets the viewport
+
+      Args:     const Viewport& viewport
+                  Viewport
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::RSSetViewport(_In_ const Viewport& viewport)
+    {
+        const D3D11_VIEWPORT d3d11Viewport = {
+            .TopLeftX = viewport.TopLeftX,
+            .TopLeftY = viewport.TopLeftY,
+            .Width = viewport.Width,
+            .Height = viewport.Height,
+            .MinDepth = viewport.MinDepth,
+            .MaxDepth = viewport.MaxDepth,
+        };
+        m_pContext->RSSetViewports(1u, &d3d11Viewport);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::IASetPrimitiveTopology
+
+      Summary:  Sets the primitive topology
+
+      Args:     ePrimitiveTopology topology
+                  Primitive topology
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::IASetPrimitiveTopology(_In_ ePrimitiveTopology topology)
+    {
+        assert(topology == ePrimitiveTopology::TRIANGLE_LIST);
+        UNREFERENCED_PARAMETER(topology);
+
+        m_pContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::IASetVertexBuffers
+
+      Summary:  Binds vertex buffers
+
+      Args:     uint32_t uStartSlot
+                  First input slot
+                uint32_t uNumBuffers
+                  Number of buffers
+                GpuBuffer* const* ppVertexBuffers
+                  Vertex buffers
+                const uint32_t* puStrides
+                  Strides of the buffers
+                const uint32_t* puOffsets
+                  Offsets into the buffers
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::IASetVertexBuffers(
+        _In_ uint32_t uStartSlot,
+        _In_ uint32_t uNumBuffers,
+        _In_reads_(uNumBuffers) GpuBuffer* const* ppVertexBuffers,
+        _In_reads_(uNumBuffers) const uint32_t* puStrides,
+        _In_reads_(uNumBuffers) const uint32_t* puOffsets
+    )
+    {
+        assert(uNumBuffers <= D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+
+        ID3D11Buffer* apVertexBuffers[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT] = {};
+        for (uint32_t i = 0u; i < uNumBuffers; ++i)
+        {
+            apVertexBuffers[i] = fromHandle<ID3D11Buffer>(ppVertexBuffers[i]);
+        }
+
+        m_pContext->IASetVertexBuffers(uStartSlot, uNumBuffers, apVertexBuffers, puStrides, puOffsets);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::IASetIndexBuffer
+
+      Summary:  Binds an index buffer
+
+      Args:     GpuBuffer* pIndexBuffer
+                  Index buffer
+                eIndexFormat format
+                  Format of the indices
+                uint32_t uOffset
+                  Offset into the buffer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::IASetIndexBuffer(_In_opt_ GpuBuffer* pIndexBuffer, _In_ eIndexFormat format, _In_ uint32_t uOffset)
+    {
+        m_pContext->IASetIndexBuffer(
+            fromHandle<ID3D11Buffer>(pIndexBuffer),
+            format == eIndexFormat::UINT16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT,
+            uOffset
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::IASetInputLayout
+
+      Summary:  Binds an input layout
+
+      Args:     GpuInputLayout* pInputLayout
+                  Input layout
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::IASetInputLayout(_In_opt_ GpuInputLayout* pInputLayout)
+    {
+        m_pContext->IASetInputLayout(fromHandle<ID3D11InputLayout>(pInputLayout));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::VSSetShader
+
+      Summary:  Binds a vertex shader
+
+      Args:     GpuVertexShader* pVertexShader
+                  Vertex shader
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::VSSetShader(_In_opt_ GpuVertexShader* pVertexShader)
+    {
+        m_pContext->VSSetShader(fromHandle<ID3D11VertexShader>(pVertexShader), nullptr, 0u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::PSSetShader
+
+      Summary:  Binds a pixel shader
+
+      Args:     GpuPixelShader* pPixelShader
+                  Pixel shader
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::PSSetShader(_In_opt_ GpuPixelShader* pPixelShader)
+    {
+        m_pContext->PSSetShader(fromHandle<ID3D11PixelShader>(pPixelShader), nullptr, 0u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::VSSetConstantBuffer
+
+      Summary:  Binds a constant buffer to the vertex shader
+
+      Args:     uint32_t uSlot
+                  Constant buffer slot
+                GpuBuffer* pConstantBuffer
+                  Constant buffer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::VSSetConstantBuffer(_In_ uint32_t uSlot, _In_opt_ GpuBuffer* pConstantBuffer)
+    {
+        ID3D11Buffer* pD3D11ConstantBuffer = fromHandle<ID3D11Buffer>(pConstantBuffer);
+        m_pContext->VSSetConstantBuffers(uSlot, 1u, &pD3D11ConstantBuffer);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::PSSetConstantBuffer
+
+      Summary:  Binds a constant buffer to the pixel shader
+
+      Args:     uint32_t uSlot
+                  Constant buffer slot
+                GpuBuffer* pConstantBuffer
+                  Constant buffer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::PSSetConstantBuffer(_In_ uint32_t uSlot, _In_opt_ GpuBuffer* pConstantBuffer)
+    {
+        ID3D11Buffer* pD3D11ConstantBuffer = fromHandle<ID3D11Buffer>(pConstantBuffer);
+        m_pContext->PSSetConstantBuffers(uSlot, 1u, &pD3D11ConstantBuffer);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::VSSetConstantBufferRange
+
+      Summary:  Binds a range of a constant buffer to the vertex shader
+                with VSSetConstantBuffers1
+
+      Args:     uint32_t uSlot
+                  Constant buffer slot
+                GpuBuffer* pConstantBuffer
+                  Constant buffer
+                uint32_t uFirstConstant
+                  First 16-byte constant of the range
+                uint32_t uNumConstants
+                  Number of constants in the range
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::VSSetConstantBufferRange(_In_ uint32_t uSlot, _In_ GpuBuffer* pConstantBuffer, _In_ uint32_t uFirstConstant, _In_ uint32_t uNumConstants)
+    {
+        assert(m_pContext1);
+
+        ID3D11Buffer* pD3D11ConstantBuffer = fromHandle<ID3D11Buffer>(pConstantBuffer);
+        m_pContext1->VSSetConstantBuffers1(uSlot, 1u, &pD3D11ConstantBuffer, &uFirstConstant, &uNumConstants);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::PSSetConstantBufferRange
+
+      Summary:  Binds a range of a constant buffer to the pixel shader
+                with PSSetConstantBuffers1
+
+      Args:     uint32_t uSlot
+                  Constant buffer slot
+                GpuBuffer* pConstantBuffer
+                  Constant buffer
+                uint32_t uFirstConstant
+                  First 16-byte constant of the range
+                uint32_t uNumConstants
+                  Number of constants in the range
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::PSSetConstantBufferRange(_In_ uint32_t uSlot, _In_ GpuBuffer* pConstantBuffer, _In_ uint32_t uFirstConstant, _In_ uint32_t uNumConstants)
+    {
+        assert(m_pContext1);
+
+        ID3D11Buffer* pD3D11ConstantBuffer = fromHandle<ID3D11Buffer>(pConstantBuffer);
+        m_pContext1->PSSetConstantBuffers1(uSlot, 1u, &pD3D11ConstantBuffer, &uFirstConstant, &uNumConstants);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::PSSetShaderResource
+
+      Summary:  Binds a shader resource view to the pixel shader
+
+      Args:     uint32_t uSlot
+                  Shader resource slot
+                GpuShaderResourceView* pShaderResourceView
+                  Shader resource view
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::PSSetShaderResource(_In_ uint32_t uSlot, _In_opt_ GpuShaderResourceView* pShaderResourceView)
+    {
+        ID3D11ShaderResourceView* pD3D11ShaderResourceView = fromHandle<ID3D11ShaderResourceView>(pShaderResourceView);
+        m_pContext->PSSetShaderResources(uSlot, 1u, &pD3D11ShaderResourceView);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::PSSetSampler
+
+      Summary:  Binds a sampler to the pixel shader
+
+      Args:     uint32_t uSlot
+                  Sampler slot
+                GpuSamplerState* pSampler
+                  Sampler
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::PSSetSampler(_In_ uint32_t uSlot, _In_opt_ GpuSamplerState* pSampler)
+    {
+        ID3D11SamplerState* pD3D11Sampler = fromHandle<ID3D11SamplerState>(pSampler);
+        m_pContext->PSSetSamplers(uSlot, 1u, &pD3D11Sampler);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::UpdateSubresource
+
+      Summary:  Uploads the whole contents of a buffer with default
+                usage
+
+      Args:     GpuBuffer* pBuffer
+                  Buffer
+                const void* pData
+                  New contents of the buffer
+                size_t uSize
+                  Size of the contents in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::UpdateSubresource(_In_ GpuBuffer* pBuffer, _In_reads_bytes_(uSize) const void* pData, _In_ size_t uSize)
+    {
+        UNREFERENCED_PARAMETER(uSize);
+
+        m_pContext->UpdateSubresource(fromHandle<ID3D11Buffer>(pBuffer), 0u, nullptr, pData, 0u, 0u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::Map
+
+      Summary:  Maps a dynamic buffer for writing. Direct3D 11 maps
+                the whole buffer, the returned pointer is offset to
+                the first byte of the range
+
+      Args:     GpuBuffer* pBuffer
+                  Dynamic buffer
+                eMapType mapType
+                  WRITE_DISCARD or WRITE_NO_OVERWRITE
+                uint32_t uFirstByte
+                  First byte of the range the caller writes
+                uint32_t uNumBytes
+                  Number of bytes the caller writes, unused here
+                void** ppData
+                  Receives the address of the first byte
+
+      Returns:  bool
+                  Whether the buffer was mapped
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool D3D11CommandContext::Map(_In_ GpuBuffer* pBuffer, _In_ eMapType mapType, _In_ uint32_t uFirstByte, _In_ uint32_t uNumBytes, _Outptr_ void** ppData)
+    {
+        UNREFERENCED_PARAMETER(uNumBytes);
+
+        D3D11_MAPPED_SUBRESOURCE mappedResource = {};
+        HRESULT hr = m_pContext->Map(
+            fromHandle<ID3D11Buffer>(pBuffer),
+            0u,
+            mapType == eMapType::WRITE_DISCARD ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE,
+            0u,
+            &mappedResource
+        );
+        if (FAILED(hr))
+        {
+            *ppData = nullptr;
+            return false;
+        }
+
+        *ppData = static_cast<BYTE*>(mappedResource.pData) + uFirstByte;
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::Unmap
+
+      Summary:  Unmaps a dynamic buffer
+
+      Args:     GpuBuffer* pBuffer
+                  Dynamic buffer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::Unmap(_In_ GpuBuffer* pBuffer)
+    {
+        m_pContext->Unmap(fromHandle<ID3D11Buffer>(pBuffer), 0u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::CopySubresource
+
+      Summary:  Copies a whole subresource into a subresource of the
+                same size and format. Depth stencil resources can only
+                be copied whole
+
+      Args:     GpuResource* pDstResource
+                  Resource copied to
+                uint32_t uDstSubresource
+                  Subresource copied to
+                GpuResource* pSrcResource
+                  Resource copied from
+                uint32_t uSrcSubresource
+                  Subresource copied from
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::CopySubresource(_In_ GpuResource* pDstResource, _In_ uint32_t uDstSubresource, _In_ GpuResource* pSrcResource, _In_ uint32_t uSrcSubresource)
+    {
+        m_pContext->CopySubresourceRegion(
+            fromHandle<ID3D11Resource>(pDstResource),
+            uDstSubresource,
+            0u,
+            0u,
+            0u,
+            fromHandle<ID3D11Resource>(pSrcResource),
+            uSrcSubresource,
+            nullptr
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::DrawIndexed
+
+      Summary:  Draws indexed primitives
+
+      Args:     uint32_t uIndexCount
+                  Number of indices
+                uint32_t uStartIndexLocation
+                  First index
+                int32_t iBaseVertexLocation
+                  Value added to each index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::DrawIndexed(_In_ uint32_t uIndexCount, _In_ uint32_t uStartIndexLocation, _In_ int32_t iBaseVertexLocation)
+    {
+        m_pContext->DrawIndexed(uIndexCount, uStartIndexLocation, iBaseVertexLocation);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::DrawIndexedInstanced
+
+      Summary:  Draws instances of indexed primitives
+
+      Args:     uint32_t uIndexCountPerInstance
+                  Number of indices per instance
+                uint32_t uInstanceCount
+                  Number of instances
+                uint32_t uStartIndexLocation
+                  First index
+                int32_t iBaseVertexLocation
+                  Value added to each index
+                uint32_t uStartInstanceLocation
+                  Value added to each instance index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::DrawIndexedInstanced(
+        _In_ uint32_t uIndexCountPerInstance,
+        _In_ uint32_t uInstanceCount,
+        _In_ uint32_t uStartIndexLocation,
+        _In_ int32_t iBaseVertexLocation,
+        _In_ uint32_t uStartInstanceLocation
+    )
+    {
+        m_pContext->DrawIndexedInstanced(uIndexCountPerInstance, uInstanceCount, uStartIndexLocation, iBaseVertexLocation, uStartInstanceLocation);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::FinishCommandList
+
+      Summary:  Ends the command list of a deferred context. The
+                context starts recording the next list with no state
+                bound
+
+      Modifies: [m_commandList].
+
+      Returns:  bool
+                  Whether the command list was created
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool D3D11CommandContext::FinishCommandList()
+    {
+        return SUCCEEDED(m_pContext->FinishCommandList(FALSE, m_commandList.ReleaseAndGetAddressOf()));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11CommandContext::ExecuteCommandList
+
+      Summary:  Runs the command list of a deferred context and
+                releases it. The state of this context is cleared
+                afterwards
+
+      Args:     CommandContext* pDeferredContext
+                  Deferred D3D11CommandContext whose list was finished
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11CommandContext::ExecuteCommandList(_In_ CommandContext* pDeferredContext)
+    {
+        D3D11CommandContext* pDeferred = static_cast<D3D11CommandContext*>(pDeferredContext);
+        if (pDeferred->m_commandList)
+        {
+            m_pContext->ExecuteCommandList(pDeferred->m_commandList.Get(), FALSE);
+            pDeferred->m_commandList.Reset();
+        }
+    }
+}
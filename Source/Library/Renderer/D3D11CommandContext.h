@@ -0,0 +1,214 @@
+/*+===================================================================
+  File:      D3D11COMMANDCONTEXT.H
+
+  Summary:   D3D11CommandContext header file contains declarations of
+             D3D11CommandContext class that passes commands to a
+             Direct3D 11 device context. It is the only command
+             context that knows Direct3D, the handles of the interface
+             are converted to and from Direct3D 11 objects here.
+
+  Classes: D3D11CommandContext
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/CommandContext.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   D3D11Handle
+
+      Summary:  Maps a Direct3D 11 interface to the opaque handle of
+                CommandContext it is passed as
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    template <typename T> struct D3D11Handle;
+    template <> struct D3D11Handle<ID3D11Buffer> { using Type = GpuBuffer; };
+    template <> struct D3D11Handle<ID3D11Resource> { using Type = GpuResource; };
+    template <> struct D3D11Handle<ID3D11RenderTargetView> { using Type = GpuRenderTargetView; };
+    template <> struct D3D11Handle<ID3D11DepthStencilView> { using Type = GpuDepthStencilView; };
+    template <> struct D3D11Handle<ID3D11DepthStencilState> { using Type = GpuDepthStencilState; };
+    template <> struct D3D11Handle<ID3D11InputLayout> { using Type = GpuInputLayout; };
+    template <> struct D3D11Handle<ID3D11VertexShader> { using Type = GpuVertexShader; };
+    template <> struct D3D11Handle<ID3D11PixelShader> { using Type = GpuPixelShader; };
+    template <> struct D3D11Handle<ID3D11ShaderResourceView> { using Type = GpuShaderResourceView; };
+    template <> struct D3D11Handle<ID3D11SamplerState> { using Type = GpuSamplerState; };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    D3D11CommandContext
+
+      Summary:  Command context that calls a Direct3D 11 device
+                context, immediate or deferred. Ranges of constant
+                buffers are bound through its Direct3D 11.1 interface
+
+      Methods:  Initialize
+                  Sets the device context to call
+                ToHandle
+                  Converts a Direct3D 11 object to its handle
+                GetViewport
+                  Converts a Direct3D 11 viewport
+                ClearRenderTargetView
+                  Clears a render target
+                ClearDepthStencilView
+                  Clears a depth stencil
+                OMSetRenderTargets
+                  Binds render targets
+                OMSetDepthStencilState
+                  Sets the depth stencil state
+                RSSetViewport
+                  Sets the viewport
+                IASetPrimitiveTopology
+                  Sets the primitive topology
+                IASetVertexBuffers
+                  Binds vertex buffers
+                IASetIndexBuffer
+                  Binds an index buffer
+                IASetInputLayout
+                  Binds an input layout
+                VSSetShader
+                  Binds a vertex shader
+                PSSetShader
+                  Binds a pixel shader
+                VSSetConstantBuffer
+                  Binds a constant buffer to the vertex shader
+                PSSetConstantBuffer
+                  Binds a constant buffer to the pixel shader
+                VSSetConstantBufferRange
+                  Binds a range of a constant buffer to the vertex
+                  shader
+                PSSetConstantBufferRange
+                  Binds a range of a constant buffer to the pixel
+                  shader
+                PSSetShaderResource
+                  Binds a shader resource view to the pixel shader
+                PSSetSampler
+                  Binds a sampler to the pixel shader
+                UpdateSubresource
+                  Uploads the contents of a buffer
+                Map
+                  Maps a dynamic buffer
+                Unmap
+                  Unmaps a dynamic buffer
+                CopySubresource
+                  Copies a whole subresource between resources
+                DrawIndexed
+                  Draws indexed primitives
+                DrawIndexedInstanced
+                  Draws instances of indexed primitives
+                FinishCommandList
+                  Ends the command list of a deferred context
+                ExecuteCommandList
+                  Runs the command list of a deferred context
+                fromHandle
+                  Converts a handle back to its Direct3D 11 object
+                D3D11CommandContext
+                  Constructor.
+                ~D3D11CommandContext
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class D3D11CommandContext final : public CommandContext
+    {
+    public:
+        D3D11CommandContext();
+        D3D11CommandContext(const D3D11CommandContext& other) = delete;
+        D3D11CommandContext(D3D11CommandContext&& other) = delete;
+        D3D11CommandContext& operator=(const D3D11CommandContext& other) = delete;
+        D3D11CommandContext& operator=(D3D11CommandContext&& other) = delete;
+        ~D3D11CommandContext() = default;
+
+        void Initialize(_In_ ID3D11DeviceContext* pContext, _In_opt_ ID3D11DeviceContext1* pContext1);
+
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   D3D11CommandContext::ToHandle
+
+          Summary:  Converts a Direct3D 11 object to the handle it is
+                    passed to a command context as
+
+          Args:     T* pObject
+                      Direct3D 11 object, may be null
+
+          Returns:  D3D11Handle<T>::Type*
+                      Handle of the object
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        template <typename T>
+        static typename D3D11Handle<T>::Type* ToHandle(_In_opt_ T* pObject)
+        {
+            return reinterpret_cast<typename D3D11Handle<T>::Type*>(pObject);
+        }
+
+        static Viewport GetViewport(_In_ const D3D11_VIEWPORT& viewport);
+
+        void ClearRenderTargetView(_In_ GpuRenderTargetView* pRenderTargetView, _In_ const float aColor[4]) override;
+        void ClearDepthStencilView(_In_ GpuDepthStencilView* pDepthStencilView, _In_ uint32_t uClearFlags, _In_ float depth, _In_ uint8_t uStencil) override;
+        void OMSetRenderTargets(
+            _In_ uint32_t uNumViews,
+            _In_reads_opt_(uNumViews) GpuRenderTargetView* const* ppRenderTargetViews,
+            _In_opt_ GpuDepthStencilView* pDepthStencilView
+        ) override;
+        void OMSetDepthStencilState(_In_opt_ GpuDepthStencilState* pDepthStencilState, _In_ uint32_t uStencilRef) override;
+        void RSSetViewport(_In_ const Viewport& viewport) override;
+        void IASetPrimitiveTopology(_In_ ePrimitiveTopology topology) override;
+
+        void IASetVertexBuffers(
+            _In_ uint32_t uStartSlot,
+            _In_ uint32_t uNumBuffers,
+            _In_reads_(uNumBuffers) GpuBuffer* const* ppVertexBuffers,
+            _In_reads_(uNumBuffers) const uint32_t* puStrides,
+            _In_reads_(uNumBuffers) const uint32_t* puOffsets
+        ) override;
+        void IASetIndexBuffer(_In_opt_ GpuBuffer* pIndexBuffer, _In_ eIndexFormat format, _In_ uint32_t uOffset) override;
+        void IASetInputLayout(_In_opt_ GpuInputLayout* pInputLayout) override;
+        void VSSetShader(_In_opt_ GpuVertexShader* pVertexShader) override;
+        void PSSetShader(_In_opt_ GpuPixelShader* pPixelShader) override;
+        void VSSetConstantBuffer(_In_ uint32_t uSlot, _In_opt_ GpuBuffer* pConstantBuffer) override;
+        void PSSetConstantBuffer(_In_ uint32_t uSlot, _In_opt_ GpuBuffer* pConstantBuffer) override;
+        void VSSetConstantBufferRange(_In_ uint32_t uSlot, _In_ GpuBuffer* pConstantBuffer, _In_ uint32_t uFirstConstant, _In_ uint32_t uNumConstants) override;
+        void PSSetConstantBufferRange(_In_ uint32_t uSlot, _In_ GpuBuffer* pConstantBuffer, _In_ uint32_t uFirstConstant, _In_ uint32_t uNumConstants) override;
+        void PSSetShaderResource(_In_ uint32_t uSlot, _In_opt_ GpuShaderResourceView* pShaderResourceView) override;
+        void PSSetSampler(_In_ uint32_t uSlot, _In_opt_ GpuSamplerState* pSampler) override;
+
+        void UpdateSubresource(_In_ GpuBuffer* pBuffer, _In_reads_bytes_(uSize) const void* pData, _In_ size_t uSize) override;
+        bool Map(_In_ GpuBuffer* pBuffer, _In_ eMapType mapType, _In_ uint32_t uFirstByte, _In_ uint32_t uNumBytes, _Outptr_ void** ppData) override;
+        void Unmap(_In_ GpuBuffer* pBuffer) override;
+        void CopySubresource(_In_ GpuResource* pDstResource, _In_ uint32_t uDstSubresource, _In_ GpuResource* pSrcResource, _In_ uint32_t uSrcSubresource) override;
+
+        void DrawIndexed(_In_ uint32_t uIndexCount, _In_ uint32_t uStartIndexLocation, _In_ int32_t iBaseVertexLocation) override;
+        void DrawIndexedInstanced(
+            _In_ uint32_t uIndexCountPerInstance,
+            _In_ uint32_t uInstanceCount,
+            _In_ uint32_t uStartIndexLocation,
+            _In_ int32_t iBaseVertexLocation,
+            _In_ uint32_t uStartInstanceLocation
+        ) override;
+
+        bool FinishCommandList() override;
+        void ExecuteCommandList(_In_ CommandContext* pDeferredContext) override;
+
+    private:
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   D3D11CommandContext::fromHandle
+
+          Summary:  Converts a handle back to the Direct3D 11 object it
+                    was made from by ToHandle
+
+          Args:     D3D11Handle<T>::Type* pHandle
+                      Handle, may be null
+
+          Returns:  T*
+                      Direct3D 11 object
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        template <typename T>
+        static T* fromHandle(_In_opt_ typename D3D11Handle<T>::Type* pHandle)
+        {
+            return reinterpret_cast<T*>(pHandle);
+        }
+
+    private:
+        ID3D11DeviceContext* m_pContext;
+        ID3D11DeviceContext1* m_pContext1;
+        ComPtr<ID3D11CommandList> m_commandList;
+    };
+}
@@ -5,6 +5,8 @@
 namespace library
 {
 #define NUM_LIGHTS (1)
+#define NUM_CASCADES (4)
+#define MAX_NUM_POINT_LIGHTS (1024)
 #define MAX_NUM_BONES (256)
 #define MAX_NUM_BONES_PER_VERTEX (16)
 
@@ -20,6 +22,11 @@ namespace library
 		XMMATRIX Transformation;
 	};
 
+	struct VoxelInstanceData
+	{
+		SHORT GridPosition[4];
+	};
+
 	struct AnimationData
 	{
 		XMUINT4 aBoneIndices;
@@ -59,8 +66,8 @@ namespace library
 	{
 		XMFLOAT4 Position;
 		XMFLOAT4 Color;
-		/*XMMATRIX View;
-		XMMATRIX Projection;*/
+		XMMATRIX View;
+		XMMATRIX Projection;
 		XMFLOAT4 AttenuationDistance;
 	};
 
@@ -83,5 +90,27 @@ namespace library
 		BOOL IsVoxel;
 	};
 
+	struct CBShadowCascades
+	{
+		XMMATRIX ViewProjections[NUM_CASCADES];
+		FLOAT SplitDistances[NUM_CASCADES];
+		XMFLOAT4 LightDirection;
+		XMFLOAT4 LightColor;
+	};
+
+	struct ClusteredLight
+	{
+		XMFLOAT4 PositionRadius;
+		XMFLOAT4 ColorAttenuation;
+	};
+
+	struct CBLightClusters
+	{
+		FLOAT DepthScale;
+		FLOAT DepthBias;
+		FLOAT TileScaleX;
+		FLOAT TileScaleY;
+	};
+
 	
 }
\ No newline at end of file
@@ -0,0 +1,252 @@
+#include "Renderer/FrustumCuller.h"
+
+#include <algorithm>
+
+#include <xmmintrin.h>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::FrustumCuller
+
+      Summary:  Constructor
+
+      Modifies: [m_aCentersX, m_aCentersY, m_aCentersZ, m_aExtentsX,
+                 m_aExtentsY, m_aExtentsZ, m_aVisibility, m_uNumBounds,
+                 m_uNumVisible].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FrustumCuller::FrustumCuller()
+        : m_aCentersX()
+        , m_aCentersY()
+        , m_aCentersZ()
+        , m_aExtentsX()
+        , m_aExtentsY()
+        , m_aExtentsZ()
+        , m_aVisibility()
+        , m_uNumBounds(0u)
+        , m_uNumVisible(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::Clear
+
+      Summary:  Removes all bounding boxes. The arrays keep their
+                memory, so refilling them every frame does not allocate
+
+      Modifies: [m_aCentersX, m_aCentersY, m_aCentersZ, m_aExtentsX,
+                 m_aExtentsY, m_aExtentsZ, m_aVisibility, m_uNumBounds,
+                 m_uNumVisible].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrustumCuller::Clear()
+    {
+        m_aCentersX.clear();
+        m_aCentersY.clear();
+        m_aCentersZ.clear();
+        m_aExtentsX.clear();
+        m_aExtentsY.clear();
+        m_aExtentsZ.clear();
+        m_aVisibility.clear();
+        m_uNumBounds = 0u;
+        m_uNumVisible = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::AddBounds
+
+      Summary:  Adds a bounding box to test. The arrays are padded to a
+                whole batch with empty boxes
+
+      Args:     const BoundingBox& bounds
+                  World space bounding box
+
+      Modifies: [m_aCentersX, m_aCentersY, m_aCentersZ, m_aExtentsX,
+                 m_aExtentsY, m_aExtentsZ, m_aVisibility, m_uNumBounds].
+
+      Returns:  UINT
+                  Index of the bounding box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT FrustumCuller::AddBounds(_In_ const BoundingBox& bounds)
+    {
+        const UINT uIndex = m_uNumBounds++;
+        if (m_aCentersX.size() < m_uNumBounds)
+        {
+            const size_t uPaddedSize = (static_cast<size_t>(m_uNumBounds) + BATCH_SIZE - 1u) / BATCH_SIZE * BATCH_SIZE;
+            m_aCentersX.resize(uPaddedSize, 0.0f);
+            m_aCentersY.resize(uPaddedSize, 0.0f);
+            m_aCentersZ.resize(uPaddedSize, 0.0f);
+            m_aExtentsX.resize(uPaddedSize, 0.0f);
+            m_aExtentsY.resize(uPaddedSize, 0.0f);
+            m_aExtentsZ.resize(uPaddedSize, 0.0f);
+            m_aVisibility.resize(uPaddedSize, FALSE);
+        }
+
+        m_aCentersX[uIndex] = bounds.Center.x;
+        m_aCentersY[uIndex] = bounds.Center.y;
+        m_aCentersZ[uIndex] = bounds.Center.z;
+        m_aExtentsX[uIndex] = bounds.Extents.x;
+        m_aExtentsY[uIndex] = bounds.Extents.y;
+        m_aExtentsZ[uIndex] = bounds.Extents.z;
+
+        return uIndex;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::Cull
+
+      Summary:  Tests every bounding box against the frustum of the
+                given view and projection. A box is outside a plane
+                when its center is farther behind the plane than the
+                projection of its extents onto the plane normal
+
+      Args:     const XMMATRIX& view
+                  View transform
+                const XMMATRIX& projection
+                  Projection transform
+
+      Modifies: [m_aVisibility, m_uNumVisible].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrustumCuller::Cull(_In_ const XMMATRIX& view, _In_ const XMMATRIX& projection)
+    {
+        XMFLOAT4 aPlanes[NUM_PLANES];
+        extractPlanes(XMMatrixMultiply(view, projection), aPlanes);
+
+        __m128 aPlaneX[NUM_PLANES];
+        __m128 aPlaneY[NUM_PLANES];
+        __m128 aPlaneZ[NUM_PLANES];
+        __m128 aPlaneW[NUM_PLANES];
+        __m128 aAbsPlaneX[NUM_PLANES];
+        __m128 aAbsPlaneY[NUM_PLANES];
+        __m128 aAbsPlaneZ[NUM_PLANES];
+        for (UINT uPlaneIdx = 0u; uPlaneIdx < NUM_PLANES; ++uPlaneIdx)
+        {
+            aPlaneX[uPlaneIdx] = _mm_set1_ps(aPlanes[uPlaneIdx].x);
+            aPlaneY[uPlaneIdx] = _mm_set1_ps(aPlanes[uPlaneIdx].y);
+            aPlaneZ[uPlaneIdx] = _mm_set1_ps(aPlanes[uPlaneIdx].z);
+            aPlaneW[uPlaneIdx] = _mm_set1_ps(aPlanes[uPlaneIdx].w);
+            aAbsPlaneX[uPlaneIdx] = _mm_set1_ps(fabsf(aPlanes[uPlaneIdx].x));
+            aAbsPlaneY[uPlaneIdx] = _mm_set1_ps(fabsf(aPlanes[uPlaneIdx].y));
+            aAbsPlaneZ[uPlaneIdx] = _mm_set1_ps(fabsf(aPlanes[uPlaneIdx].z));
+        }
+
+        const __m128 zero = _mm_setzero_ps();
+        m_uNumVisible = 0u;
+        for (UINT i = 0u; i < m_uNumBounds; i += BATCH_SIZE)
+        {
+            const __m128 centerX = _mm_loadu_ps(&m_aCentersX[i]);
+            const __m128 centerY = _mm_loadu_ps(&m_aCentersY[i]);
+            const __m128 centerZ = _mm_loadu_ps(&m_aCentersZ[i]);
+            const __m128 extentX = _mm_loadu_ps(&m_aExtentsX[i]);
+            const __m128 extentY = _mm_loadu_ps(&m_aExtentsY[i]);
+            const __m128 extentZ = _mm_loadu_ps(&m_aExtentsZ[i]);
+
+            __m128 inside = _mm_cmpeq_ps(zero, zero);
+            for (UINT uPlaneIdx = 0u; uPlaneIdx < NUM_PLANES; ++uPlaneIdx)
+            {
+                __m128 distance = _mm_add_ps(_mm_mul_ps(aPlaneX[uPlaneIdx], centerX), aPlaneW[uPlaneIdx]);
+                distance = _mm_add_ps(distance, _mm_mul_ps(aPlaneY[uPlaneIdx], centerY));
+                distance = _mm_add_ps(distance, _mm_mul_ps(aPlaneZ[uPlaneIdx], centerZ));
+
+                __m128 radius = _mm_mul_ps(aAbsPlaneX[uPlaneIdx], extentX);
+                radius = _mm_add_ps(radius, _mm_mul_ps(aAbsPlaneY[uPlaneIdx], extentY));
+                radius = _mm_add_ps(radius, _mm_mul_ps(aAbsPlaneZ[uPlaneIdx], extentZ));
+
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+            }
+
+            const INT iMask = _mm_movemask_ps(inside);
+            const UINT uBatchEnd = (std::min)(i + BATCH_SIZE, m_uNumBounds);
+            for (UINT j = i; j < uBatchEnd; ++j)
+            {
+                const BOOL bVisible = (iMask >> (j - i)) & 1;
+                m_aVisibility[j] = static_cast<BYTE>(bVisible);
+                m_uNumVisible += static_cast<UINT>(bVisible);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::IsVisible
+
+      Summary:  Returns whether a bounding box was in the frustum at
+                the last Cull
+
+      Args:     UINT uIndex
+                  Index returned by AddBounds
+
+      Returns:  BOOL
+                  TRUE if the box intersects the frustum
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL FrustumCuller::IsVisible(_In_ UINT uIndex) const
+    {
+        return uIndex < m_uNumBounds && m_aVisibility[uIndex];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::GetNumBounds
+
+      Summary:  Returns the number of bounding boxes
+
+      Returns:  UINT
+                  Number of bounding boxes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT FrustumCuller::GetNumBounds() const
+    {
+        return m_uNumBounds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::GetNumVisible
+
+      Summary:  Returns the number of boxes in the frustum at the last
+                Cull
+
+      Returns:  UINT
+                  Number of visible boxes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT FrustumCuller::GetNumVisible() const
+    {
+        return m_uNumVisible;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::GetNumCulled
+
+      Summary:  Returns the number of boxes outside the frustum at the
+                last Cull
+
+      Returns:  UINT
+                  Number of culled boxes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT FrustumCuller::GetNumCulled() const
+    {
+        return m_uNumBounds - m_uNumVisible;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrustumCuller::extractPlanes
+
+      Summary:  Extracts the frustum planes from the columns of a
+                view-projection matrix. The normals point into the
+                frustum, the depth range is [0, 1] as in Direct3D.
+                The planes are not normalized, only their sign is used
+
+      Args:     const XMMATRIX& viewProjection
+                  View-projection transform
+                XMFLOAT4* pPlanes
+                  Receives the left, right, bottom, top, near and far
+                  planes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrustumCuller::extractPlanes(_In_ const XMMATRIX& viewProjection, _Out_writes_(NUM_PLANES) XMFLOAT4* pPlanes)
+    {
+        // The rows of the transpose are the columns of the matrix
+        const XMMATRIX columns = XMMatrixTranspose(viewProjection);
+
+        XMStoreFloat4(&pPlanes[0], XMVectorAdd(columns.r[3], columns.r[0]));
+        XMStoreFloat4(&pPlanes[1], XMVectorSubtract(columns.r[3], columns.r[0]));
+        XMStoreFloat4(&pPlanes[2], XMVectorAdd(columns.r[3], columns.r[1]));
+        XMStoreFloat4(&pPlanes[3], XMVectorSubtract(columns.r[3], columns.r[1]));
+        XMStoreFloat4(&pPlanes[4], columns.r[2]);
+        XMStoreFloat4(&pPlanes[5], XMVectorSubtract(columns.r[3], columns.r[2]));
+    }
+}
@@ -0,0 +1,84 @@
+/*+===================================================================
+  File:      FRUSTUMCULLER.H
+
+  Summary:   FrustumCuller header file contains declarations of
+             FrustumCuller class that tests world space bounding boxes
+             against the view frustum.
+
+  Classes: FrustumCuller
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <DirectXCollision.h>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    FrustumCuller
+
+      Summary:  Culls axis-aligned bounding boxes against the six planes
+                of a view frustum. The boxes are kept as separate arrays
+                of centers and extents per axis, so each plane is tested
+                against four boxes at a time with SSE
+
+      Methods:  Clear
+                  Removes all bounding boxes
+                AddBounds
+                  Adds a bounding box to test
+                Cull
+                  Tests every bounding box against the frustum
+                IsVisible
+                  Returns whether a bounding box is in the frustum
+                GetNumBounds
+                  Returns the number of bounding boxes
+                GetNumVisible
+                  Returns the number of boxes in the frustum
+                GetNumCulled
+                  Returns the number of boxes outside the frustum
+                FrustumCuller
+                  Constructor.
+                ~FrustumCuller
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class FrustumCuller
+    {
+    public:
+        static constexpr const UINT NUM_PLANES = 6u;
+        static constexpr const UINT BATCH_SIZE = 4u;
+
+    public:
+        FrustumCuller();
+        FrustumCuller(const FrustumCuller& other) = delete;
+        FrustumCuller(FrustumCuller&& other) = delete;
+        FrustumCuller& operator=(const FrustumCuller& other) = delete;
+        FrustumCuller& operator=(FrustumCuller&& other) = delete;
+        ~FrustumCuller() = default;
+
+        void Clear();
+        UINT AddBounds(_In_ const BoundingBox& bounds);
+        void Cull(_In_ const XMMATRIX& view, _In_ const XMMATRIX& projection);
+
+        BOOL IsVisible(_In_ UINT uIndex) const;
+        UINT GetNumBounds() const;
+        UINT GetNumVisible() const;
+        UINT GetNumCulled() const;
+
+    private:
+        static void extractPlanes(_In_ const XMMATRIX& viewProjection, _Out_writes_(NUM_PLANES) XMFLOAT4* pPlanes);
+
+    private:
+        std::vector<FLOAT> m_aCentersX;
+        std::vector<FLOAT> m_aCentersY;
+        std::vector<FLOAT> m_aCentersZ;
+        std::vector<FLOAT> m_aExtentsX;
+        std::vector<FLOAT> m_aExtentsY;
+        std::vector<FLOAT> m_aExtentsZ;
+        std::vector<BYTE> m_aVisibility;
+        UINT m_uNumBounds;
+        UINT m_uNumVisible;
+    };
+}
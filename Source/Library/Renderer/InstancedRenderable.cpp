@@ -1,5 +1,7 @@
 #include "Renderer/InstancedRenderable.h"
 
+#include <algorithm>
+
 namespace library
 {
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -15,6 +17,10 @@ namespace library
     --------------------------------------------------------------------*/
     InstancedRenderable::InstancedRenderable(_In_ const XMFLOAT4& outputColor)
         : Renderable(outputColor)
+        , m_aDirtyInstanceRanges()
+        , m_uInstanceCapacity(0u)
+        , m_instanceBounds()
+        , m_bHasInstanceBounds(FALSE)
     {
 
     }
@@ -28,7 +34,9 @@ namespace library
                 const XMFLOAT4& outputColor
                   Default color of the renderable
 
-      Modifies: [m_instanceBuffer, m_aInstanceData].
+      Modifies: [m_instanceBuffer, m_aInstanceData,
+                 m_aDirtyInstanceRanges, m_uInstanceCapacity,
+                 m_instanceBounds, m_bHasInstanceBounds].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     /*--------------------------------------------------------------------
       TODO: InstancedRenderable::InstancedRenderable definition (remove the comment)
@@ -37,6 +45,10 @@ namespace library
         : Renderable(outputColor)
         , m_aInstanceData(aInstanceData)
         , m_instanceBuffer(nullptr)
+        , m_aDirtyInstanceRanges()
+        , m_uInstanceCapacity(0u)
+        , m_instanceBounds()
+        , m_bHasInstanceBounds(FALSE)
     {
 
     }
@@ -48,7 +60,8 @@ namespace library
       Args:     std::vector<InstanceData>&& aInstanceData
                   Instance data
 
-      Modifies: [m_aInstanceData].
+      Modifies: [m_aInstanceData, m_instanceBounds,
+                 m_bHasInstanceBounds].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     /*--------------------------------------------------------------------
       TODO: InstancedRenderable::SetInstanceData definition (remove the comment)
@@ -56,6 +69,196 @@ namespace library
     void InstancedRenderable::SetInstanceData(_In_ std::vector<InstanceData>&& aInstanceData)
     {
         m_aInstanceData = aInstanceData;
+        m_bHasInstanceBounds = FALSE;
+        markInstancesDirty(0u, GetNumInstances());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedRenderable::AddInstance
+
+      Summary:  Appends an instance. Only the new instance is uploaded
+                by the next UpdateInstanceBuffer
+
+      Args:     const InstanceData& instanceData
+                  Instance to append
+
+      Modifies: [m_aInstanceData, m_aDirtyInstanceRanges].
+
+      Returns:  UINT
+                  Index of the new instance
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT InstancedRenderable::AddInstance(_In_ const InstanceData& instanceData)
+    {
+        const UINT uIndex = static_cast<UINT>(m_aInstanceData.size());
+        m_aInstanceData.push_back(instanceData);
+        markInstancesDirty(uIndex, uIndex + 1u);
+
+        return uIndex;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedRenderable::SetInstance
+
+      Summary:  Replaces an instance
+
+      Args:     UINT uIndex
+                  Index of the instance
+                const InstanceData& instanceData
+                  New instance data
+
+      Modifies: [m_aInstanceData, m_aDirtyInstanceRanges].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void InstancedRenderable::SetInstance(_In_ UINT uIndex, _In_ const InstanceData& instanceData)
+    {
+        if (uIndex >= m_aInstanceData.size())
+        {
+            return;
+        }
+
+        m_aInstanceData[uIndex] = instanceData;
+        markInstancesDirty(uIndex, uIndex + 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedRenderable::RemoveInstance
+
+      Summary:  Removes an instance by moving the last instance into
+                its slot, so the array stays compact and only a single
+                instance has to be uploaded. The index of the former
+                last instance becomes uIndex
+
+      Args:     UINT uIndex
+                  Index of the instance
+
+      Modifies: [m_aInstanceData, m_aDirtyInstanceRanges].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void InstancedRenderable::RemoveInstance(_In_ UINT uIndex)
+    {
+        if (uIndex >= m_aInstanceData.size())
+        {
+            return;
+        }
+
+        const UINT uLastIndex = static_cast<UINT>(m_aInstanceData.size()) - 1u;
+        if (uIndex != uLastIndex)
+        {
+            m_aInstanceData[uIndex] = m_aInstanceData[uLastIndex];
+            markInstancesDirty(uIndex, uIndex + 1u);
+        }
+        m_aInstanceData.pop_back();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedRenderable::UpdateInstanceBuffer
+
+      Summary:  Uploads the dirty ranges of the instance buffer. The
+                ranges are merged first, so neighboring edits become a
+                single copy. When the instances no longer fit, the
+                buffer is recreated with twice the capacity and filled
+                once
+
+      Args:     ID3D11DeviceContext* pDeviceContext
+                  The Direct3D context to upload with
+
+      Modifies: [m_instanceBuffer, m_aDirtyInstanceRanges,
+                 m_uInstanceCapacity].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT InstancedRenderable::UpdateInstanceBuffer(_In_ ID3D11DeviceContext* pDeviceContext)
+    {
+        if (m_aDirtyInstanceRanges.empty() || !m_instanceBuffer)
+        {
+            return S_OK;
+        }
+
+        const UINT uNumInstances = GetNumInstances();
+        const UINT uStride = GetInstanceStride();
+        const BYTE* pInstanceData = static_cast<const BYTE*>(getInstanceData());
+        if (uNumInstances > m_uInstanceCapacity)
+        {
+            ComPtr<ID3D11Device> device;
+            pDeviceContext->GetDevice(device.GetAddressOf());
+
+            const UINT uCapacity = (std::max)(uNumInstances, m_uInstanceCapacity * 2u);
+            D3D11_BUFFER_DESC bd =
+            {
+                .ByteWidth = uCapacity * uStride,
+                .Usage = D3D11_USAGE_DEFAULT,
+                .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+                .CPUAccessFlags = 0,
+                .MiscFlags = 0,
+            };
+
+            ComPtr<ID3D11Buffer> instanceBuffer;
+            HRESULT hr = device->CreateBuffer(&bd, nullptr, instanceBuffer.GetAddressOf());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            m_instanceBuffer = instanceBuffer;
+            m_uInstanceCapacity = uCapacity;
+            m_aDirtyInstanceRanges.assign(1u, std::make_pair(0u, uNumInstances));
+        }
+
+        std::sort(m_aDirtyInstanceRanges.begin(), m_aDirtyInstanceRanges.end());
+
+        UINT uBegin = m_aDirtyInstanceRanges.front().first;
+        UINT uEnd = m_aDirtyInstanceRanges.front().second;
+        auto uploadRange = [&]()
+        {
+            // Ranges past the end belong to instances removed since
+            uEnd = (std::min)(uEnd, uNumInstances);
+            if (uBegin >= uEnd)
+            {
+                return;
+            }
+
+            const D3D11_BOX box =
+            {
+                .left = uBegin * uStride,
+                .top = 0u,
+                .front = 0u,
+                .right = uEnd * uStride,
+                .bottom = 1u,
+                .back = 1u,
+            };
+            pDeviceContext->UpdateSubresource(m_instanceBuffer.Get(), 0u, &box, pInstanceData + static_cast<size_t>(uBegin) * uStride, 0u, 0u);
+        };
+
+        for (const std::pair<UINT, UINT>& range : m_aDirtyInstanceRanges)
+        {
+            if (range.first <= uEnd)
+            {
+                uEnd = (std::max)(uEnd, range.second);
+                continue;
+            }
+
+            uploadRange();
+            uBegin = range.first;
+            uEnd = range.second;
+        }
+        uploadRange();
+
+        m_aDirtyInstanceRanges.clear();
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedRenderable::HasDirtyInstances
+
+      Summary:  Returns whether instances were changed since the last
+                upload
+
+      Returns:  BOOL
+                  TRUE if UpdateInstanceBuffer has something to upload
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL InstancedRenderable::HasDirtyInstances() const
+    {
+        return !m_aDirtyInstanceRanges.empty();
     }
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   InstancedRenderable::GetInstanceBuffer
@@ -87,6 +290,139 @@ namespace library
     {
         return m_aInstanceData.size();
     }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedRenderable::GetInstanceStride
+
+      Summary:  Returns the size of an instance in the instance buffer
+
+      Returns:  UINT
+                  Size of an instance in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT InstancedRenderable::GetInstanceStride() const
+    {
+        return static_cast<UINT>(sizeof(InstanceData));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedRenderable::GetBounds
+
+      Summary:  Returns the world space bounding box of all instances.
+                An empty renderable has an empty box at its origin
+
+      Returns:  BoundingBox
+                  World space bounding box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BoundingBox InstancedRenderable::GetBounds() const
+    {
+        BoundingBox bounds(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f));
+        if (m_bHasInstanceBounds)
+        {
+            bounds = m_instanceBounds;
+        }
+        bounds.Transform(bounds, m_world);
+
+        return bounds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedRenderable::computeInstanceBounds
+
+      Summary:  Merges the local bounds of the mesh placed by each
+                instance of a range
+
+      Args:     UINT uBegin
+                  Index of the first instance
+                UINT uEnd
+                  One past the index of the last instance
+                BoundingBox& bounds
+                  Receives the bounding box in the space of the
+                  renderable
+
+      Returns:  BOOL
+                  FALSE if the range has no instances
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL InstancedRenderable::computeInstanceBounds(_In_ UINT uBegin, _In_ UINT uEnd, _Out_ BoundingBox& bounds) const
+    {
+        uEnd = (std::min)(uEnd, static_cast<UINT>(m_aInstanceData.size()));
+        if (uBegin >= uEnd)
+        {
+            return FALSE;
+        }
+
+        m_localBounds.Transform(bounds, m_aInstanceData[uBegin].Transformation);
+        for (UINT i = uBegin + 1u; i < uEnd; ++i)
+        {
+            BoundingBox instanceBounds;
+            m_localBounds.Transform(instanceBounds, m_aInstanceData[i].Transformation);
+            BoundingBox::CreateMerged(bounds, bounds, instanceBounds);
+        }
+
+        return TRUE;
+    }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedRenderable::getInstanceData
+
+      Summary:  Returns the instance data uploaded to the instance
+                buffer
+
+      Returns:  const void*
+                  Pointer to the instance data
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const void* InstancedRenderable::getInstanceData() const
+    {
+        return m_aInstanceData.data();
+    }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedRenderable::markInstancesDirty
+
+      Summary:  Records a range of instances to upload. Appending to
+                the previous range is merged right away, as runs of
+                edits usually touch neighboring instances
+
+      Args:     UINT uBegin
+                  First dirty instance
+                UINT uEnd
+                  Instance after the last dirty instance
+
+      Modifies: [m_aDirtyInstanceRanges].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void InstancedRenderable::markInstancesDirty(_In_ UINT uBegin, _In_ UINT uEnd)
+    {
+        if (uBegin >= uEnd)
+        {
+            return;
+        }
+
+        // Edited instances only grow the bounds, removals keep them
+        // conservative until the next initialization
+        BoundingBox bounds;
+        if (m_instanceBuffer && computeInstanceBounds(uBegin, uEnd, bounds))
+        {
+            if (m_bHasInstanceBounds)
+            {
+                BoundingBox::CreateMerged(m_instanceBounds, m_instanceBounds, bounds);
+            }
+            else
+            {
+                m_instanceBounds = bounds;
+                m_bHasInstanceBounds = TRUE;
+            }
+        }
+
+        if (!m_aDirtyInstanceRanges.empty())
+        {
+            std::pair<UINT, UINT>& lastRange = m_aDirtyInstanceRanges.back();
+            if (uBegin <= lastRange.second && uEnd >= lastRange.first)
+            {
+                lastRange.first = (std::min)(lastRange.first, uBegin);
+                lastRange.second = (std::max)(lastRange.second, uEnd);
+                return;
+            }
+        }
+
+        m_aDirtyInstanceRanges.emplace_back(uBegin, uEnd);
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   InstancedRenderable::initializeInstance
 
@@ -95,7 +431,9 @@ namespace library
       Args:     ID3D11Device* pDevice
                   Pointer to a Direct3D 11 device
 
-      Modifies: [m_instanceBuffer].
+      Modifies: [m_instanceBuffer, m_uInstanceCapacity,
+                 m_aDirtyInstanceRanges, m_instanceBounds,
+                 m_bHasInstanceBounds].
 
       Returns:  HRESULT
                   Status code
@@ -107,9 +445,13 @@ namespace library
     {
         HRESULT hr = S_OK;
 
+        // An empty renderable still gets a buffer so that instances
+        // can be added later
+        const UINT uNumInstances = GetNumInstances();
+        m_uInstanceCapacity = (std::max)(uNumInstances, 1u);
 
         D3D11_BUFFER_DESC bd = {
-        .ByteWidth = GetNumInstances() * sizeof(InstanceData),
+        .ByteWidth = m_uInstanceCapacity * GetInstanceStride(),
         .Usage = D3D11_USAGE_DEFAULT,
         .BindFlags = D3D11_BIND_VERTEX_BUFFER,
         .CPUAccessFlags = 0,
@@ -117,16 +459,20 @@ namespace library
         };
 
         D3D11_SUBRESOURCE_DATA initData = {
-            .pSysMem = m_aInstanceData.data(),
+            .pSysMem = getInstanceData(),
             .SysMemPitch = 0,
             .SysMemSlicePitch = 0
         };
 
-        hr = pDevice->CreateBuffer(&bd, &initData, m_instanceBuffer.GetAddressOf());
+        hr = pDevice->CreateBuffer(&bd, uNumInstances > 0u ? &initData : nullptr, m_instanceBuffer.ReleaseAndGetAddressOf());
         if (FAILED(hr))
         {
             return hr;
         }
+
+        m_aDirtyInstanceRanges.clear();
+        m_bHasInstanceBounds = computeInstanceBounds(0u, uNumInstances, m_instanceBounds);
+
         return hr;
     }
 }
\ No newline at end of file
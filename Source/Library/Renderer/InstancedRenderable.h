@@ -25,10 +25,30 @@ namespace library
 
       Methods:  SetInstanceData
                   Sets the instance data
+                AddInstance
+                  Appends an instance
+                SetInstance
+                  Replaces an instance
+                RemoveInstance
+                  Removes an instance, moving the last one into its
+                  place
+                UpdateInstanceBuffer
+                  Uploads the instances changed since the last upload
+                HasDirtyInstances
+                  Returns whether there are instances to upload
                 GetInstanceBuffer
                   Returns a instance buffer
                 GetNumInstances
                   Returns the number of instance data
+                GetInstanceStride
+                  Returns the size of an instance in bytes
+                GetBounds
+                  Returns the world space bounding box of the instances
+                computeInstanceBounds
+                  Computes the local bounding box of a range of
+                  instances
+                markInstancesDirty
+                  Records a range of instances to upload
                 initializeInstance
                   Initialize the instance buffer
                 InstancedRenderable
@@ -51,9 +71,17 @@ namespace library
         virtual void Update(_In_ FLOAT deltaTime) override = 0;
 
         void SetInstanceData(_In_ std::vector<InstanceData>&& aInstanceData);
+        UINT AddInstance(_In_ const InstanceData& instanceData);
+        void SetInstance(_In_ UINT uIndex, _In_ const InstanceData& instanceData);
+        void RemoveInstance(_In_ UINT uIndex);
+
+        HRESULT UpdateInstanceBuffer(_In_ ID3D11DeviceContext* pDeviceContext);
+        BOOL HasDirtyInstances() const;
 
         virtual ComPtr<ID3D11Buffer>& GetInstanceBuffer();
         virtual UINT GetNumInstances() const;
+        virtual UINT GetInstanceStride() const;
+        BoundingBox GetBounds() const override;
 
         UINT GetNumVertices() const override = 0;
         UINT GetNumIndices() const override = 0;
@@ -62,11 +90,18 @@ namespace library
         const SimpleVertex* getVertices() const override = 0;
         const WORD* getIndices() const override = 0;
 
+        virtual const void* getInstanceData() const;
+        virtual BOOL computeInstanceBounds(_In_ UINT uBegin, _In_ UINT uEnd, _Out_ BoundingBox& bounds) const;
+        void markInstancesDirty(_In_ UINT uBegin, _In_ UINT uEnd);
         virtual HRESULT initializeInstance(_In_ ID3D11Device* pDevice);
 
     protected:
         ComPtr<ID3D11Buffer> m_instanceBuffer;
         std::vector<InstanceData> m_aInstanceData;
+        std::vector<std::pair<UINT, UINT>> m_aDirtyInstanceRanges;
+        UINT m_uInstanceCapacity;
+        BoundingBox m_instanceBounds;
+        BOOL m_bHasInstanceBounds;
 
     private:
         BYTE m_padding[8];
@@ -0,0 +1,598 @@
+#include "Renderer/LightClusterer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <xmmintrin.h>
+
+#include "Renderer/D3D11CommandContext.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LightClusterer::LightClusterer
+
+      Summary:  Constructor
+
+      Modifies: [m_constants, m_clusterBoundsKey, m_aLights, m_aLightsX,
+                 m_aLightsY, m_aLightsZ, m_aLightsRadius, m_uNumLights,
+                 m_aSliceNear, m_aSliceFar, m_aClustersMinX,
+                 m_aClustersMaxX, m_aClustersMinY, m_aClustersMaxY,
+                 m_aSlices, m_aClusters, m_uNumLightIndices,
+                 m_lightBuffer, m_lightBufferView, m_clusterBuffer,
+                 m_clusterBufferView, m_lightIndexBuffer,
+                 m_lightIndexBufferView, m_uLightIndexCapacity].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    LightClusterer::LightClusterer()
+        : m_constants()
+        , m_clusterBoundsKey()
+        , m_aLights()
+        , m_aLightsX()
+        , m_aLightsY()
+        , m_aLightsZ()
+        , m_aLightsRadius()
+        , m_uNumLights(0u)
+        , m_aSliceNear()
+        , m_aSliceFar()
+        , m_aClustersMinX(NUM_CLUSTERS)
+        , m_aClustersMaxX(NUM_CLUSTERS)
+        , m_aClustersMinY(NUM_CLUSTERS)
+        , m_aClustersMaxY(NUM_CLUSTERS)
+        , m_aSlices(NUM_CLUSTERS_Z)
+        , m_aClusters(NUM_CLUSTERS)
+        , m_uNumLightIndices(0u)
+        , m_lightBuffer()
+        , m_lightBufferView()
+        , m_clusterBuffer()
+        , m_clusterBufferView()
+        , m_lightIndexBuffer()
+        , m_lightIndexBufferView()
+        , m_uLightIndexCapacity(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LightClusterer::Initialize
+
+      Summary:  Creates the structured buffer of the lights, the typed
+                buffers of the offset and count of each cluster and of
+                the light lists, and their shader resource views. All
+                of them are rewritten every frame
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers with
+
+      Modifies: [m_lightBuffer, m_lightBufferView, m_clusterBuffer,
+                 m_clusterBufferView, m_lightIndexBuffer,
+                 m_lightIndexBufferView, m_uLightIndexCapacity].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT LightClusterer::Initialize(_In_ ID3D11Device* pDevice)
+    {
+        D3D11_BUFFER_DESC bd = {
+            .ByteWidth = static_cast<UINT>(sizeof(ClusteredLight)) * MAX_NUM_POINT_LIGHTS,
+            .Usage = D3D11_USAGE_DYNAMIC,
+            .BindFlags = D3D11_BIND_SHADER_RESOURCE,
+            .CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+            .MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED,
+            .StructureByteStride = static_cast<UINT>(sizeof(ClusteredLight))
+        };
+        HRESULT hr = pDevice->CreateBuffer(&bd, nullptr, m_lightBuffer.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+        srvDesc.Buffer.FirstElement = 0u;
+        srvDesc.Buffer.NumElements = MAX_NUM_POINT_LIGHTS;
+        hr = pDevice->CreateShaderResourceView(m_lightBuffer.Get(), &srvDesc, m_lightBufferView.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        bd.ByteWidth = static_cast<UINT>(sizeof(XMUINT2)) * NUM_CLUSTERS;
+        bd.MiscFlags = 0u;
+        bd.StructureByteStride = 0u;
+        hr = pDevice->CreateBuffer(&bd, nullptr, m_clusterBuffer.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        srvDesc.Format = DXGI_FORMAT_R32G32_UINT;
+        srvDesc.Buffer.NumElements = NUM_CLUSTERS;
+        hr = pDevice->CreateShaderResourceView(m_clusterBuffer.Get(), &srvDesc, m_clusterBufferView.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        return createLightIndexBuffer(pDevice, INITIAL_NUM_LIGHT_INDICES);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LightClusterer::Update
+
+      Summary:  Assigns the point lights to the clusters of the view
+                frustum. The lights are moved to view space, then every
+                depth slice is culled on the thread pool and the lists
+                of the slices are laid out one after another. Upload
+                grows the buffer of the lists when they do not fit
+
+      Args:     const std::vector<std::shared_ptr<PointLight>>& aPointLights
+                  Point lights of the scene, empty entries are skipped
+                const XMMATRIX& view
+                  View matrix of the camera
+                const XMMATRIX& projection
+                  Perspective projection matrix of the camera
+                FLOAT nearPlane
+                  Near plane of the projection
+                FLOAT farPlane
+                  Far plane of the projection
+                FLOAT width
+                  Width of the viewport in pixels
+                FLOAT height
+                  Height of the viewport in pixels
+                ThreadPool& threadPool
+                  Workers the slices are culled on
+
+      Modifies: [m_constants, m_aLights, m_aLightsX, m_aLightsY,
+                 m_aLightsZ, m_aLightsRadius, m_uNumLights, m_aSlices,
+                 m_aClusters, m_uNumLightIndices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void LightClusterer::Update(
+        _In_ const std::vector<std::shared_ptr<PointLight>>& aPointLights,
+        _In_ const XMMATRIX& view,
+        _In_ const XMMATRIX& projection,
+        _In_ FLOAT nearPlane,
+        _In_ FLOAT farPlane,
+        _In_ FLOAT width,
+        _In_ FLOAT height,
+        _In_ ThreadPool& threadPool
+    )
+    {
+        updateClusterBounds(projection, nearPlane, farPlane);
+        m_constants.TileScaleX = static_cast<FLOAT>(NUM_CLUSTERS_X) / width;
+        m_constants.TileScaleY = static_cast<FLOAT>(NUM_CLUSTERS_Y) / height;
+
+        m_aLights.clear();
+        m_aLightsX.clear();
+        m_aLightsY.clear();
+        m_aLightsZ.clear();
+        m_aLightsRadius.clear();
+        for (const std::shared_ptr<PointLight>& pointLight : aPointLights)
+        {
+            if (!pointLight || m_aLights.size() == MAX_NUM_POINT_LIGHTS)
+            {
+                continue;
+            }
+
+            const FLOAT attenuationDistance = pointLight->GetAttenuationDistance();
+            const FLOAT radius = attenuationDistance * LIGHT_RANGE_SCALE;
+            const XMFLOAT4& position = pointLight->GetPosition();
+            const XMFLOAT4& color = pointLight->GetColor();
+            m_aLights.push_back({
+                .PositionRadius = XMFLOAT4(position.x, position.y, position.z, radius),
+                .ColorAttenuation = XMFLOAT4(color.x, color.y, color.z, attenuationDistance * attenuationDistance)
+            });
+
+            XMFLOAT3 viewPosition;
+            XMStoreFloat3(&viewPosition, XMVector3TransformCoord(XMVectorSet(position.x, position.y, position.z, 1.0f), view));
+            m_aLightsX.push_back(viewPosition.x);
+            m_aLightsY.push_back(viewPosition.y);
+            m_aLightsZ.push_back(viewPosition.z);
+            m_aLightsRadius.push_back(radius);
+        }
+        m_uNumLights = static_cast<UINT>(m_aLights.size());
+
+        // Padding lights sit at the eye with no range, so they are in
+        // front of every slice
+        while (m_aLightsZ.size() % BATCH_SIZE != 0u)
+        {
+            m_aLightsX.push_back(0.0f);
+            m_aLightsY.push_back(0.0f);
+            m_aLightsZ.push_back(0.0f);
+            m_aLightsRadius.push_back(0.0f);
+        }
+
+        threadPool.ParallelFor(
+            NUM_CLUSTERS_Z,
+            1u,
+            [this](size_t uBegin, size_t uEnd)
+            {
+                for (size_t uSlice = uBegin; uSlice < uEnd; ++uSlice)
+                {
+                    cullSlice(static_cast<UINT>(uSlice));
+                }
+            }
+        );
+
+        // The offsets of a slice are relative to its own list until the
+        // lists are laid out in slice order
+        UINT uBaseIndex = 0u;
+        for (UINT uSlice = 0u; uSlice < NUM_CLUSTERS_Z; ++uSlice)
+        {
+            for (UINT uCluster = uSlice * NUM_CLUSTERS_X * NUM_CLUSTERS_Y; uCluster < (uSlice + 1u) * NUM_CLUSTERS_X * NUM_CLUSTERS_Y; ++uCluster)
+            {
+                XMUINT2& cluster = m_aClusters[uCluster];
+                cluster.x += uBaseIndex;
+            }
+            uBaseIndex += static_cast<UINT>(m_aSlices[uSlice].aLightIndices.size());
+        }
+        m_uNumLightIndices = uBaseIndex;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LightClusterer::Upload
+
+      Summary:  Writes the lights, the offset and count of the list of
+                each cluster and the light lists to their buffers. The
+                buffer of the lists is recreated twice as large, or as
+                large as needed, when the lists outgrew it
+
+      Args:     CommandContext* pContext
+                  Context to map the buffers with
+
+      Modifies: [m_lightIndexBuffer, m_lightIndexBufferView,
+                 m_uLightIndexCapacity].
+
+      Returns:  HRESULT
+                  Status code, E_FAIL if a buffer cannot be mapped
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT LightClusterer::Upload(_In_ CommandContext* pContext)
+    {
+        void* pData = nullptr;
+        HRESULT hr = S_OK;
+        if (m_uNumLights > 0u)
+        {
+            const UINT uNumBytes = m_uNumLights * static_cast<UINT>(sizeof(ClusteredLight));
+            if (!pContext->Map(D3D11CommandContext::ToHandle(m_lightBuffer.Get()), eMapType::WRITE_DISCARD, 0u, uNumBytes, &pData))
+            {
+                return E_FAIL;
+            }
+            memcpy(pData, m_aLights.data(), uNumBytes);
+            pContext->Unmap(D3D11CommandContext::ToHandle(m_lightBuffer.Get()));
+        }
+
+        const UINT uNumClusterBytes = NUM_CLUSTERS * static_cast<UINT>(sizeof(XMUINT2));
+        if (!pContext->Map(D3D11CommandContext::ToHandle(m_clusterBuffer.Get()), eMapType::WRITE_DISCARD, 0u, uNumClusterBytes, &pData))
+        {
+            return E_FAIL;
+        }
+        memcpy(pData, m_aClusters.data(), uNumClusterBytes);
+        pContext->Unmap(D3D11CommandContext::ToHandle(m_clusterBuffer.Get()));
+
+        if (m_uNumLightIndices > m_uLightIndexCapacity)
+        {
+            ComPtr<ID3D11Device> device;
+            m_lightIndexBuffer->GetDevice(device.GetAddressOf());
+            hr = createLightIndexBuffer(device.Get(), (std::max)(m_uNumLightIndices, m_uLightIndexCapacity * 2u));
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        if (m_uNumLightIndices > 0u)
+        {
+            if (!pContext->Map(D3D11CommandContext::ToHandle(m_lightIndexBuffer.Get()), eMapType::WRITE_DISCARD, 0u, m_uNumLightIndices * static_cast<UINT>(sizeof(UINT)), &pData))
+            {
+                return E_FAIL;
+            }
+
+            UINT* puIndices = static_cast<UINT*>(pData);
+            for (const SliceLists& slice : m_aSlices)
+            {
+                memcpy(puIndices, slice.aLightIndices.data(), slice.aLightIndices.size() * sizeof(UINT));
+                puIndices += slice.aLightIndices.size();
+            }
+            pContext->Unmap(D3D11CommandContext::ToHandle(m_lightIndexBuffer.Get()));
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LightClusterer::GetConstants
+
+      Summary:  Returns the constants the pixel shaders find the
+                cluster of a pixel with
+
+      Returns:  const CBLightClusters&
+                  Depth slicing and tile size of the clusters
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const CBLightClusters& LightClusterer::GetConstants() const
+    {
+        return m_constants;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LightClusterer::GetLightBufferView
+
+      Summary:  Returns the view of the structured buffer of the lights
+
+      Returns:  ComPtr<ID3D11ShaderResourceView>&
+                  Shader resource view of the lights
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11ShaderResourceView>& LightClusterer::GetLightBufferView()
+    {
+        return m_lightBufferView;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LightClusterer::GetClusterBufferView
+
+      Summary:  Returns the view of the offset and count of the light
+                list of each cluster
+
+      Returns:  ComPtr<ID3D11ShaderResourceView>&
+                  Shader resource view of the clusters
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11ShaderResourceView>& LightClusterer::GetClusterBufferView()
+    {
+        return m_clusterBufferView;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LightClusterer::GetLightIndexBufferView
+
+      Summary:  Returns the view of the light lists of all clusters
+
+      Returns:  ComPtr<ID3D11ShaderResourceView>&
+                  Shader resource view of the light indices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11ShaderResourceView>& LightClusterer::GetLightIndexBufferView()
+    {
+        return m_lightIndexBufferView;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LightClusterer::GetNumLights
+
+      Summary:  Returns the number of lights assigned at the last Update
+
+      Returns:  UINT
+                  Number of lights
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT LightClusterer::GetNumLights() const
+    {
+        return m_uNumLights;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LightClusterer::GetNumLightIndices
+
+      Summary:  Returns the length of the light lists of all clusters
+                together, the number of light evaluations a pixel of
+                every cluster would cost
+
+      Returns:  UINT
+                  Number of light indices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT LightClusterer::GetNumLightIndices() const
+    {
+        return m_uNumLightIndices;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LightClusterer::updateClusterBounds
+
+      Summary:  Computes the view space box of every cluster and the
+                constants that map a view depth to a slice. Only does
+                so when the projection or the planes changed
+
+      Args:     const XMMATRIX& projection
+                  Perspective projection matrix of the camera
+                FLOAT nearPlane
+                  Near plane of the projection
+                FLOAT farPlane
+                  Far plane of the projection
+
+      Modifies: [m_constants, m_clusterBoundsKey, m_aSliceNear,
+                 m_aSliceFar, m_aClustersMinX, m_aClustersMaxX,
+                 m_aClustersMinY, m_aClustersMaxY].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void LightClusterer::updateClusterBounds(_In_ const XMMATRIX& projection, _In_ FLOAT nearPlane, _In_ FLOAT farPlane)
+    {
+        const FLOAT scaleX = XMVectorGetX(projection.r[0]);
+        const FLOAT scaleY = XMVectorGetY(projection.r[1]);
+        const XMFLOAT4 key(scaleX, scaleY, nearPlane, farPlane);
+        if (memcmp(&key, &m_clusterBoundsKey, sizeof(key)) == 0)
+        {
+            return;
+        }
+        m_clusterBoundsKey = key;
+
+        // slice = log(z) * DepthScale + DepthBias, so the slices grow
+        // in proportion to their distance
+        const FLOAT logDepthRatio = logf(farPlane / CLUSTER_NEAR_PLANE);
+        m_constants.DepthScale = static_cast<FLOAT>(NUM_CLUSTERS_Z) / logDepthRatio;
+        m_constants.DepthBias = -static_cast<FLOAT>(NUM_CLUSTERS_Z) * logf(CLUSTER_NEAR_PLANE) / logDepthRatio;
+
+        for (UINT uSlice = 0u; uSlice < NUM_CLUSTERS_Z; ++uSlice)
+        {
+            const FLOAT sliceNear = uSlice == 0u
+                ? nearPlane
+                : CLUSTER_NEAR_PLANE * powf(farPlane / CLUSTER_NEAR_PLANE, static_cast<FLOAT>(uSlice) / static_cast<FLOAT>(NUM_CLUSTERS_Z));
+            const FLOAT sliceFar = CLUSTER_NEAR_PLANE * powf(farPlane / CLUSTER_NEAR_PLANE, static_cast<FLOAT>(uSlice + 1u) / static_cast<FLOAT>(NUM_CLUSTERS_Z));
+            m_aSliceNear[uSlice] = sliceNear;
+            m_aSliceFar[uSlice] = sliceFar;
+
+            // A tile spans a range of x / z and y / z, the box of the
+            // cluster spans that range over the depths of the slice.
+            // Rows of tiles go down the screen
+            for (UINT y = 0u; y < NUM_CLUSTERS_Y; ++y)
+            {
+                const FLOAT bottom = (1.0f - 2.0f * static_cast<FLOAT>(y + 1u) / static_cast<FLOAT>(NUM_CLUSTERS_Y)) / scaleY;
+                const FLOAT top = (1.0f - 2.0f * static_cast<FLOAT>(y) / static_cast<FLOAT>(NUM_CLUSTERS_Y)) / scaleY;
+                for (UINT x = 0u; x < NUM_CLUSTERS_X; ++x)
+                {
+                    const FLOAT left = (-1.0f + 2.0f * static_cast<FLOAT>(x) / static_cast<FLOAT>(NUM_CLUSTERS_X)) / scaleX;
+                    const FLOAT right = (-1.0f + 2.0f * static_cast<FLOAT>(x + 1u) / static_cast<FLOAT>(NUM_CLUSTERS_X)) / scaleX;
+
+                    const UINT uCluster = (uSlice * NUM_CLUSTERS_Y + y) * NUM_CLUSTERS_X + x;
+                    m_aClustersMinX[uCluster] = (std::min)(left * sliceNear, left * sliceFar);
+                    m_aClustersMaxX[uCluster] = (std::max)(right * sliceNear, right * sliceFar);
+                    m_aClustersMinY[uCluster] = (std::min)(bottom * sliceNear, bottom * sliceFar);
+                    m_aClustersMaxY[uCluster] = (std::max)(top * sliceNear, top * sliceFar);
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LightClusterer::cullSlice
+
+      Summary:  Lists the lights of the clusters of one depth slice.
+                The lights whose depth range reaches the slice are
+                gathered first, then each cluster tests them four at a
+                time: a light reaches a cluster when the distance from
+                its center to the box of the cluster is within its
+                range. Only writes the lists of the slice, so slices
+                can be culled in parallel
+
+      Args:     UINT uSlice
+                  Index of the depth slice
+
+      Modifies: [m_aSlices, m_aClusters].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void LightClusterer::cullSlice(_In_ UINT uSlice)
+    {
+        SliceLists& slice = m_aSlices[uSlice];
+        slice.aCandidates.clear();
+        slice.aCandidatesX.clear();
+        slice.aCandidatesY.clear();
+        slice.aCandidatesZ.clear();
+        slice.aCandidatesRadiusSquared.clear();
+        slice.aLightIndices.clear();
+
+        const __m128 sliceNear = _mm_set1_ps(m_aSliceNear[uSlice]);
+        const __m128 sliceFar = _mm_set1_ps(m_aSliceFar[uSlice]);
+        for (UINT i = 0u; i < m_uNumLights; i += BATCH_SIZE)
+        {
+            const __m128 z = _mm_loadu_ps(&m_aLightsZ[i]);
+            const __m128 radius = _mm_loadu_ps(&m_aLightsRadius[i]);
+            const __m128 overlaps = _mm_and_ps(
+                _mm_cmpge_ps(_mm_add_ps(z, radius), sliceNear),
+                _mm_cmple_ps(_mm_sub_ps(z, radius), sliceFar)
+            );
+
+            const INT iMask = _mm_movemask_ps(overlaps);
+            const UINT uBatchEnd = (std::min)(i + BATCH_SIZE, m_uNumLights);
+            for (UINT j = i; j < uBatchEnd; ++j)
+            {
+                if ((iMask >> (j - i)) & 1)
+                {
+                    slice.aCandidates.push_back(j);
+                    slice.aCandidatesX.push_back(m_aLightsX[j]);
+                    slice.aCandidatesY.push_back(m_aLightsY[j]);
+                    slice.aCandidatesZ.push_back(m_aLightsZ[j]);
+                    slice.aCandidatesRadiusSquared.push_back(m_aLightsRadius[j] * m_aLightsRadius[j]);
+                }
+            }
+        }
+
+        // Padding candidates have a negative squared range, which no
+        // distance is within
+        const UINT uNumCandidates = static_cast<UINT>(slice.aCandidates.size());
+        while (slice.aCandidatesX.size() % BATCH_SIZE != 0u)
+        {
+            slice.aCandidatesX.push_back(0.0f);
+            slice.aCandidatesY.push_back(0.0f);
+            slice.aCandidatesZ.push_back(0.0f);
+            slice.aCandidatesRadiusSquared.push_back(-1.0f);
+        }
+
+        const __m128 zero = _mm_setzero_ps();
+        for (UINT uCluster = uSlice * NUM_CLUSTERS_X * NUM_CLUSTERS_Y; uCluster < (uSlice + 1u) * NUM_CLUSTERS_X * NUM_CLUSTERS_Y; ++uCluster)
+        {
+            const UINT uOffset = static_cast<UINT>(slice.aLightIndices.size());
+            const __m128 minX = _mm_set1_ps(m_aClustersMinX[uCluster]);
+            const __m128 maxX = _mm_set1_ps(m_aClustersMaxX[uCluster]);
+            const __m128 minY = _mm_set1_ps(m_aClustersMinY[uCluster]);
+            const __m128 maxY = _mm_set1_ps(m_aClustersMaxY[uCluster]);
+            for (UINT i = 0u; i < uNumCandidates; i += BATCH_SIZE)
+            {
+                const __m128 x = _mm_loadu_ps(&slice.aCandidatesX[i]);
+                const __m128 y = _mm_loadu_ps(&slice.aCandidatesY[i]);
+                const __m128 z = _mm_loadu_ps(&slice.aCandidatesZ[i]);
+
+                // Only one side of each axis can be positive
+                const __m128 dx = _mm_add_ps(_mm_max_ps(_mm_sub_ps(minX, x), zero), _mm_max_ps(_mm_sub_ps(x, maxX), zero));
+                const __m128 dy = _mm_add_ps(_mm_max_ps(_mm_sub_ps(minY, y), zero), _mm_max_ps(_mm_sub_ps(y, maxY), zero));
+                const __m128 dz = _mm_add_ps(_mm_max_ps(_mm_sub_ps(sliceNear, z), zero), _mm_max_ps(_mm_sub_ps(z, sliceFar), zero));
+                __m128 distanceSquared = _mm_mul_ps(dx, dx);
+                distanceSquared = _mm_add_ps(distanceSquared, _mm_mul_ps(dy, dy));
+                distanceSquared = _mm_add_ps(distanceSquared, _mm_mul_ps(dz, dz));
+
+                const INT iMask = _mm_movemask_ps(_mm_cmple_ps(distanceSquared, _mm_loadu_ps(&slice.aCandidatesRadiusSquared[i])));
+                const UINT uBatchEnd = (std::min)(i + BATCH_SIZE, uNumCandidates);
+                for (UINT j = i; j < uBatchEnd; ++j)
+                {
+                    if ((iMask >> (j - i)) & 1)
+                    {
+                        slice.aLightIndices.push_back(slice.aCandidates[j]);
+                    }
+                }
+            }
+            m_aClusters[uCluster] = XMUINT2(uOffset, static_cast<UINT>(slice.aLightIndices.size()) - uOffset);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LightClusterer::createLightIndexBuffer
+
+      Summary:  Creates the typed buffer of the light lists and its
+                shader resource view, replacing the previous ones
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffer with
+                UINT uNumIndices
+                  Number of light indices the buffer holds
+
+      Modifies: [m_lightIndexBuffer, m_lightIndexBufferView,
+                 m_uLightIndexCapacity].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT LightClusterer::createLightIndexBuffer(_In_ ID3D11Device* pDevice, _In_ UINT uNumIndices)
+    {
+        const D3D11_BUFFER_DESC bd = {
+            .ByteWidth = static_cast<UINT>(sizeof(UINT)) * uNumIndices,
+            .Usage = D3D11_USAGE_DYNAMIC,
+            .BindFlags = D3D11_BIND_SHADER_RESOURCE,
+            .CPUAccessFlags = D3D11_CPU_ACCESS_WRITE
+        };
+        ComPtr<ID3D11Buffer> lightIndexBuffer;
+        HRESULT hr = pDevice->CreateBuffer(&bd, nullptr, lightIndexBuffer.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = DXGI_FORMAT_R32_UINT;
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+        srvDesc.Buffer.FirstElement = 0u;
+        srvDesc.Buffer.NumElements = uNumIndices;
+        ComPtr<ID3D11ShaderResourceView> lightIndexBufferView;
+        hr = pDevice->CreateShaderResourceView(lightIndexBuffer.Get(), &srvDesc, lightIndexBufferView.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        m_lightIndexBuffer = lightIndexBuffer;
+        m_lightIndexBufferView = lightIndexBufferView;
+        m_uLightIndexCapacity = uNumIndices;
+
+        return S_OK;
+    }
+}
@@ -0,0 +1,155 @@
+/*+===================================================================
+  File:      LIGHTCLUSTERER.H
+
+  Summary:   LightClusterer header file contains declarations of
+             LightClusterer class that assigns point lights to the
+             clusters of the view frustum.
+
+  Classes: LightClusterer
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Light/PointLight.h"
+#include "Renderer/CommandContext.h"
+#include "Renderer/DataTypes.h"
+#include "Thread/ThreadPool.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    LightClusterer
+
+      Summary:  Splits the view frustum into NUM_CLUSTERS_X by
+                NUM_CLUSTERS_Y screen tiles and NUM_CLUSTERS_Z depth
+                slices spaced exponentially, and lists for every
+                cluster the point lights whose range reaches it. Each
+                depth slice is culled on its own thread, testing four
+                lights at a time against the box of each cluster. The
+                lights, the offset and count of the list of each
+                cluster and the lists themselves are uploaded to
+                buffers read by the pixel shaders, so a pixel only
+                shades the lights of its cluster
+
+      Methods:  Initialize
+                  Creates the buffers and their views
+                Update
+                  Assigns the lights to the clusters
+                Upload
+                  Writes the lights and the lists to the buffers
+                GetConstants
+                  Returns the constants to find the cluster of a pixel
+                GetLightBufferView
+                  Returns the view of the lights
+                GetClusterBufferView
+                  Returns the view of the offset and count of the
+                  list of each cluster
+                GetLightIndexBufferView
+                  Returns the view of the light lists
+                GetNumLights
+                  Returns the number of lights
+                GetNumLightIndices
+                  Returns the number of listed lights of all clusters
+                LightClusterer
+                  Constructor.
+                ~LightClusterer
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class LightClusterer final
+    {
+    public:
+        static constexpr const UINT NUM_CLUSTERS_X = 16u;
+        static constexpr const UINT NUM_CLUSTERS_Y = 9u;
+        static constexpr const UINT NUM_CLUSTERS_Z = 24u;
+        static constexpr const UINT NUM_CLUSTERS = NUM_CLUSTERS_X * NUM_CLUSTERS_Y * NUM_CLUSTERS_Z;
+        // The light lists start with room for this many indices and
+        // the buffer grows when a frame lists more. Every light can
+        // reach every cluster at most, so it never needs more than
+        // MAX_NUM_POINT_LIGHTS * NUM_CLUSTERS
+        static constexpr const UINT INITIAL_NUM_LIGHT_INDICES = NUM_CLUSTERS * 32u;
+        static constexpr const UINT BATCH_SIZE = 4u;
+
+        // The first slice reaches from the near plane to here, the
+        // others are spaced exponentially up to the far plane
+        static constexpr const FLOAT CLUSTER_NEAR_PLANE = 1.0f;
+
+        // A light reaches as far as its attenuation falls to 1/64
+        static constexpr const FLOAT LIGHT_RANGE_SCALE = 8.0f;
+
+    public:
+        LightClusterer();
+        LightClusterer(const LightClusterer& other) = delete;
+        LightClusterer(LightClusterer&& other) = delete;
+        LightClusterer& operator=(const LightClusterer& other) = delete;
+        LightClusterer& operator=(LightClusterer&& other) = delete;
+        ~LightClusterer() = default;
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice);
+        void Update(
+            _In_ const std::vector<std::shared_ptr<PointLight>>& aPointLights,
+            _In_ const XMMATRIX& view,
+            _In_ const XMMATRIX& projection,
+            _In_ FLOAT nearPlane,
+            _In_ FLOAT farPlane,
+            _In_ FLOAT width,
+            _In_ FLOAT height,
+            _In_ ThreadPool& threadPool
+        );
+        HRESULT Upload(_In_ CommandContext* pContext);
+
+        const CBLightClusters& GetConstants() const;
+        ComPtr<ID3D11ShaderResourceView>& GetLightBufferView();
+        ComPtr<ID3D11ShaderResourceView>& GetClusterBufferView();
+        ComPtr<ID3D11ShaderResourceView>& GetLightIndexBufferView();
+        UINT GetNumLights() const;
+        UINT GetNumLightIndices() const;
+
+    private:
+        void updateClusterBounds(_In_ const XMMATRIX& projection, _In_ FLOAT nearPlane, _In_ FLOAT farPlane);
+        void cullSlice(_In_ UINT uSlice);
+        HRESULT createLightIndexBuffer(_In_ ID3D11Device* pDevice, _In_ UINT uNumIndices);
+
+    private:
+        struct SliceLists
+        {
+            std::vector<UINT> aCandidates;
+            std::vector<FLOAT> aCandidatesX;
+            std::vector<FLOAT> aCandidatesY;
+            std::vector<FLOAT> aCandidatesZ;
+            std::vector<FLOAT> aCandidatesRadiusSquared;
+            std::vector<UINT> aLightIndices;
+        };
+
+        CBLightClusters m_constants;
+        XMFLOAT4 m_clusterBoundsKey;
+
+        std::vector<ClusteredLight> m_aLights;
+        std::vector<FLOAT> m_aLightsX;
+        std::vector<FLOAT> m_aLightsY;
+        std::vector<FLOAT> m_aLightsZ;
+        std::vector<FLOAT> m_aLightsRadius;
+        UINT m_uNumLights;
+
+        FLOAT m_aSliceNear[NUM_CLUSTERS_Z];
+        FLOAT m_aSliceFar[NUM_CLUSTERS_Z];
+        std::vector<FLOAT> m_aClustersMinX;
+        std::vector<FLOAT> m_aClustersMaxX;
+        std::vector<FLOAT> m_aClustersMinY;
+        std::vector<FLOAT> m_aClustersMaxY;
+
+        std::vector<SliceLists> m_aSlices;
+        std::vector<XMUINT2> m_aClusters;
+        UINT m_uNumLightIndices;
+
+        ComPtr<ID3D11Buffer> m_lightBuffer;
+        ComPtr<ID3D11ShaderResourceView> m_lightBufferView;
+        ComPtr<ID3D11Buffer> m_clusterBuffer;
+        ComPtr<ID3D11ShaderResourceView> m_clusterBufferView;
+        ComPtr<ID3D11Buffer> m_lightIndexBuffer;
+        ComPtr<ID3D11ShaderResourceView> m_lightIndexBufferView;
+        UINT m_uLightIndexCapacity;
+    };
+}
@@ -0,0 +1,654 @@
+#include "Renderer/OcclusionRasterizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include <emmintrin.h>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionRasterizer::OcclusionRasterizer
+
+      Summary:  Constructor. The width is rounded up to a multiple of
+                four so that every row is a whole number of SSE batches
+
+      Args:     uint32_t uWidth
+                  Width of the depth buffer
+                uint32_t uHeight
+                  Height of the depth buffer
+
+      Modifies: [m_uWidth, m_uHeight, m_uNumTilesX, m_uNumTilesY,
+                 m_aViewProjection, m_aDepth, m_aTileMaxDepth,
+                 m_aTriangles, m_aTileBins].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    OcclusionRasterizer::OcclusionRasterizer(uint32_t uWidth, uint32_t uHeight)
+        : m_uWidth(((std::max)(uWidth, 4u) + 3u) & ~3u)
+        , m_uHeight((std::max)(uHeight, 1u))
+        , m_uNumTilesX(0u)
+        , m_uNumTilesY(0u)
+        , m_aViewProjection()
+        , m_aDepth()
+        , m_aTileMaxDepth()
+        , m_aTriangles()
+        , m_aTileBins()
+    {
+        m_uNumTilesX = (m_uWidth + TILE_WIDTH - 1u) / TILE_WIDTH;
+        m_uNumTilesY = (m_uHeight + TILE_HEIGHT - 1u) / TILE_HEIGHT;
+        m_aDepth.resize(static_cast<size_t>(m_uWidth) * m_uHeight, 1.0f);
+        m_aTileMaxDepth.resize(static_cast<size_t>(m_uNumTilesX) * m_uNumTilesY, 1.0f);
+        m_aTileBins.resize(m_aTileMaxDepth.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionRasterizer::Begin
+
+      Summary:  Clears the depth buffer and the binned occluders, and
+                sets the view-projection of the frame
+
+      Args:     const float* pViewProjection
+                  Row-major 4x4 view-projection matrix
+
+      Modifies: [m_aViewProjection, m_aDepth, m_aTileMaxDepth,
+                 m_aTriangles, m_aTileBins].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionRasterizer::Begin(const float* pViewProjection)
+    {
+        std::copy(pViewProjection, pViewProjection + 16, m_aViewProjection);
+        std::fill(m_aDepth.begin(), m_aDepth.end(), 1.0f);
+        std::fill(m_aTileMaxDepth.begin(), m_aTileMaxDepth.end(), 1.0f);
+        m_aTriangles.clear();
+        for (std::vector<uint32_t>& aBin : m_aTileBins)
+        {
+            aBin.clear();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionRasterizer::AddOccluderTriangles
+
+      Summary:  Transforms an indexed triangle list to clip space and
+                bins its triangles
+
+      Args:     const float* pPositions
+                  First position, three floats each
+                size_t uStride
+                  Distance between two positions in bytes
+                const uint16_t* pIndices
+                  Triangle list indices
+                uint32_t uNumIndices
+                  Number of indices
+                const float* pWorld
+                  Row-major 4x4 world matrix, nullptr for identity
+
+      Modifies: [m_aTriangles, m_aTileBins].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionRasterizer::AddOccluderTriangles(
+        const float* pPositions,
+        size_t uStride,
+        const uint16_t* pIndices,
+        uint32_t uNumIndices,
+        const float* pWorld
+    )
+    {
+        if (uNumIndices < 3u)
+        {
+            return;
+        }
+
+        float aMatrix[16];
+        if (pWorld)
+        {
+            for (uint32_t uRow = 0u; uRow < 4u; ++uRow)
+            {
+                for (uint32_t uColumn = 0u; uColumn < 4u; ++uColumn)
+                {
+                    aMatrix[uRow * 4u + uColumn] =
+                        pWorld[uRow * 4u + 0u] * m_aViewProjection[0u * 4u + uColumn] +
+                        pWorld[uRow * 4u + 1u] * m_aViewProjection[1u * 4u + uColumn] +
+                        pWorld[uRow * 4u + 2u] * m_aViewProjection[2u * 4u + uColumn] +
+                        pWorld[uRow * 4u + 3u] * m_aViewProjection[3u * 4u + uColumn];
+                }
+            }
+        }
+        else
+        {
+            std::copy(m_aViewProjection, m_aViewProjection + 16, aMatrix);
+        }
+
+        const uint32_t uNumVertices = static_cast<uint32_t>(*std::max_element(pIndices, pIndices + uNumIndices)) + 1u;
+        std::vector<float> aClipPositions(static_cast<size_t>(uNumVertices) * 4u);
+        const uint8_t* pPosition = reinterpret_cast<const uint8_t*>(pPositions);
+        for (uint32_t i = 0u; i < uNumVertices; ++i)
+        {
+            transformPoint(aMatrix, reinterpret_cast<const float*>(pPosition + i * uStride), &aClipPositions[i * 4u]);
+        }
+
+        for (uint32_t i = 0u; i + 2u < uNumIndices; i += 3u)
+        {
+            addClippedTriangle(
+                &aClipPositions[pIndices[i] * 4u],
+                &aClipPositions[pIndices[i + 1u] * 4u],
+                &aClipPositions[pIndices[i + 2u] * 4u]
+            );
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionRasterizer::AddOccluderBox
+
+      Summary:  Adds the twelve triangles of a world space box
+
+      Args:     const float* pMin
+                  Minimum corner of the box
+                const float* pMax
+                  Maximum corner of the box
+
+      Modifies: [m_aTriangles, m_aTileBins].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionRasterizer::AddOccluderBox(const float* pMin, const float* pMax)
+    {
+        static constexpr const uint16_t BOX_INDICES[] =
+        {
+            0, 1, 3,  0, 3, 2,  // -x
+            4, 6, 7,  4, 7, 5,  // +x
+            0, 4, 5,  0, 5, 1,  // -y
+            2, 3, 7,  2, 7, 6,  // +y
+            0, 2, 6,  0, 6, 4,  // -z
+            1, 5, 7,  1, 7, 3,  // +z
+        };
+
+        // Bit 2 of the corner index selects x, bit 1 y and bit 0 z
+        float aCorners[8][3];
+        for (uint32_t uCornerIdx = 0u; uCornerIdx < 8u; ++uCornerIdx)
+        {
+            aCorners[uCornerIdx][0] = (uCornerIdx & 4u) ? pMax[0] : pMin[0];
+            aCorners[uCornerIdx][1] = (uCornerIdx & 2u) ? pMax[1] : pMin[1];
+            aCorners[uCornerIdx][2] = (uCornerIdx & 1u) ? pMax[2] : pMin[2];
+        }
+
+        AddOccluderTriangles(&aCorners[0][0], sizeof(aCorners[0]), BOX_INDICES, static_cast<uint32_t>(std::size(BOX_INDICES)));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionRasterizer::AddTerrainOccluderBox
+
+      Summary:  Adds the solid box of a terrain chunk. The box only
+                hides what is behind it when seen from outside and
+                above the bottom of the terrain, so it is skipped when
+                the eye is in it (including its faces) or below it
+
+      Args:     const float* pMin
+                  Minimum corner of the box
+                const float* pMax
+                  Maximum corner of the box
+                const float* pEye
+                  World space position of the camera
+
+      Modifies: [m_aTriangles, m_aTileBins].
+
+      Returns:  bool
+                  Whether the box was added
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool OcclusionRasterizer::AddTerrainOccluderBox(const float* pMin, const float* pMax, const float* pEye)
+    {
+        const bool bInside =
+            pMin[0] <= pEye[0] && pEye[0] <= pMax[0] &&
+            pMin[1] <= pEye[1] && pEye[1] <= pMax[1] &&
+            pMin[2] <= pEye[2] && pEye[2] <= pMax[2];
+        if (bInside || pEye[1] < pMin[1])
+        {
+            return false;
+        }
+
+        AddOccluderBox(pMin, pMax);
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionRasterizer::Rasterize
+
+      Summary:  Draws the binned triangles into the depth buffer. Tiles
+                do not share pixels, so they are drawn in parallel
+                without synchronization
+
+      Args:     ThreadPool* pThreadPool
+                  Pool to draw the tiles on, nullptr to draw them on
+                  the calling thread only
+
+      Modifies: [m_aDepth, m_aTileMaxDepth].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionRasterizer::Rasterize(ThreadPool* pThreadPool)
+    {
+        const uint32_t uNumTiles = m_uNumTilesX * m_uNumTilesY;
+        if (!pThreadPool || m_aTriangles.empty())
+        {
+            for (uint32_t uTileIdx = 0u; uTileIdx < uNumTiles; ++uTileIdx)
+            {
+                rasterizeTile(uTileIdx);
+            }
+            return;
+        }
+
+        pThreadPool->ParallelFor(
+            uNumTiles,
+            1u,
+            [this](size_t uBegin, size_t uEnd)
+            {
+                for (size_t uTileIdx = uBegin; uTileIdx < uEnd; ++uTileIdx)
+                {
+                    rasterizeTile(static_cast<uint32_t>(uTileIdx));
+                }
+            }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionRasterizer::IsVisible
+
+      Summary:  Tests a world space box against the depth buffer. The
+                box is visible if any pixel of its screen rectangle is
+                farther than its nearest corner. Tiles whose farthest
+                pixel is nearer than the box are skipped as a whole.
+                Boxes crossing the near plane are always visible, boxes
+                off the screen never are
+
+      Args:     const float* pMin
+                  Minimum corner of the box
+                const float* pMax
+                  Maximum corner of the box
+
+      Returns:  bool
+                  false if the box is hidden behind the occluders
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool OcclusionRasterizer::IsVisible(const float* pMin, const float* pMax) const
+    {
+        float minX = static_cast<float>(m_uWidth);
+        float minY = static_cast<float>(m_uHeight);
+        float maxX = 0.0f;
+        float maxY = 0.0f;
+        float minDepth = 1.0f;
+        for (uint32_t uCornerIdx = 0u; uCornerIdx < 8u; ++uCornerIdx)
+        {
+            const float aCorner[3] =
+            {
+                (uCornerIdx & 4u) ? pMax[0] : pMin[0],
+                (uCornerIdx & 2u) ? pMax[1] : pMin[1],
+                (uCornerIdx & 1u) ? pMax[2] : pMin[2],
+            };
+            float aClip[4];
+            transformPoint(m_aViewProjection, aCorner, aClip);
+            if (aClip[2] < 0.0f || aClip[3] <= 0.0f)
+            {
+                return true;
+            }
+
+            const float invW = 1.0f / aClip[3];
+            const float x = (aClip[0] * invW * 0.5f + 0.5f) * static_cast<float>(m_uWidth);
+            const float y = (0.5f - aClip[1] * invW * 0.5f) * static_cast<float>(m_uHeight);
+            minX = (std::min)(minX, x);
+            minY = (std::min)(minY, y);
+            maxX = (std::max)(maxX, x);
+            maxY = (std::max)(maxY, y);
+            minDepth = (std::min)(minDepth, aClip[2] * invW);
+        }
+
+        const int32_t iBeginX = (std::max)(static_cast<int32_t>(std::floor(minX)), 0);
+        const int32_t iBeginY = (std::max)(static_cast<int32_t>(std::floor(minY)), 0);
+        const int32_t iEndX = (std::min)(static_cast<int32_t>(std::ceil(maxX)), static_cast<int32_t>(m_uWidth));
+        const int32_t iEndY = (std::min)(static_cast<int32_t>(std::ceil(maxY)), static_cast<int32_t>(m_uHeight));
+        if (iBeginX >= iEndX || iBeginY >= iEndY)
+        {
+            return false;
+        }
+
+        const __m128 boxDepth = _mm_set1_ps(minDepth);
+        const __m128 laneOffsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        const __m128 beginX = _mm_set1_ps(static_cast<float>(iBeginX));
+        const __m128 endX = _mm_set1_ps(static_cast<float>(iEndX));
+        for (int32_t iTileY = iBeginY / static_cast<int32_t>(TILE_HEIGHT); iTileY * static_cast<int32_t>(TILE_HEIGHT) < iEndY; ++iTileY)
+        {
+            for (int32_t iTileX = iBeginX / static_cast<int32_t>(TILE_WIDTH); iTileX * static_cast<int32_t>(TILE_WIDTH) < iEndX; ++iTileX)
+            {
+                if (m_aTileMaxDepth[static_cast<size_t>(iTileY) * m_uNumTilesX + iTileX] < minDepth)
+                {
+                    continue;
+                }
+
+                const int32_t iTileBeginX = (std::max)(iBeginX, iTileX * static_cast<int32_t>(TILE_WIDTH)) & ~3;
+                const int32_t iTileEndX = (std::min)(iEndX, (iTileX + 1) * static_cast<int32_t>(TILE_WIDTH));
+                const int32_t iTileBeginY = (std::max)(iBeginY, iTileY * static_cast<int32_t>(TILE_HEIGHT));
+                const int32_t iTileEndY = (std::min)(iEndY, (iTileY + 1) * static_cast<int32_t>(TILE_HEIGHT));
+                for (int32_t y = iTileBeginY; y < iTileEndY; ++y)
+                {
+                    const float* pRow = &m_aDepth[static_cast<size_t>(y) * m_uWidth];
+                    for (int32_t x = iTileBeginX; x < iTileEndX; x += 4)
+                    {
+                        const __m128 pixelX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+                        const __m128 inRect = _mm_and_ps(_mm_cmpge_ps(pixelX, beginX), _mm_cmplt_ps(pixelX, endX));
+                        const __m128 farther = _mm_cmpge_ps(_mm_loadu_ps(pRow + x), boxDepth);
+                        if (_mm_movemask_ps(_mm_and_ps(inRect, farther)) != 0)
+                        {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+
+        return false;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionRasterizer::GetWidth
+
+      Summary:  Returns the width of the depth buffer
+
+      Returns:  uint32_t
+                  Width in pixels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t OcclusionRasterizer::GetWidth() const
+    {
+        return m_uWidth;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionRasterizer::GetHeight
+
+      Summary:  Returns the height of the depth buffer
+
+      Returns:  uint32_t
+                  Height in pixels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t OcclusionRasterizer::GetHeight() const
+    {
+        return m_uHeight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionRasterizer::GetDepthBuffer
+
+      Summary:  Returns the depth buffer, row by row
+
+      Returns:  const float*
+                  Width x height depths
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const float* OcclusionRasterizer::GetDepthBuffer() const
+    {
+        return m_aDepth.data();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionRasterizer::GetNumTriangles
+
+      Summary:  Returns the number of triangles binned since Begin,
+                after clipping
+
+      Returns:  uint32_t
+                  Number of triangles
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t OcclusionRasterizer::GetNumTriangles() const
+    {
+        return static_cast<uint32_t>(m_aTriangles.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionRasterizer::addClippedTriangle
+
+      Summary:  Clips a clip space triangle against the near plane
+                (z = 0) and adds the remaining one or two triangles
+
+      Args:     const float* pClip0
+                  First vertex, x y z w
+                const float* pClip1
+                  Second vertex
+                const float* pClip2
+                  Third vertex
+
+      Modifies: [m_aTriangles, m_aTileBins].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionRasterizer::addClippedTriangle(const float* pClip0, const float* pClip1, const float* pClip2)
+    {
+        const float* apVertices[3] = { pClip0, pClip1, pClip2 };
+        const bool bInside[3] = { pClip0[2] >= 0.0f, pClip1[2] >= 0.0f, pClip2[2] >= 0.0f };
+        if (bInside[0] && bInside[1] && bInside[2])
+        {
+            addTriangle(pClip0, pClip1, pClip2);
+            return;
+        }
+
+        float aPolygon[4][4];
+        uint32_t uNumVertices = 0u;
+        for (uint32_t i = 0u; i < 3u; ++i)
+        {
+            const uint32_t uNext = (i + 1u) % 3u;
+            const float* pCurrent = apVertices[i];
+            const float* pNext = apVertices[uNext];
+            if (bInside[i])
+            {
+                std::copy(pCurrent, pCurrent + 4, aPolygon[uNumVertices++]);
+            }
+
+            if (bInside[i] != bInside[uNext])
+            {
+                const float t = pCurrent[2] / (pCurrent[2] - pNext[2]);
+                for (uint32_t uComponent = 0u; uComponent < 4u; ++uComponent)
+                {
+                    aPolygon[uNumVertices][uComponent] = pCurrent[uComponent] + t * (pNext[uComponent] - pCurrent[uComponent]);
+                }
+                ++uNumVertices;
+            }
+        }
+
+        for (uint32_t i = 2u; i < uNumVertices; ++i)
+        {
+            addTriangle(aPolygon[0], aPolygon[i - 1u], aPolygon[i]);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionRasterizer::addTriangle
+
+      Summary:  Projects a triangle in front of the near plane to the
+                screen and adds it to the bins of the tiles its bounds
+                overlap. Degenerate and off-screen triangles are
+                dropped
+
+      Args:     const float* pClip0
+                  First vertex, x y z w
+                const float* pClip1
+                  Second vertex
+                const float* pClip2
+                  Third vertex
+
+      Modifies: [m_aTriangles, m_aTileBins].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionRasterizer::addTriangle(const float* pClip0, const float* pClip1, const float* pClip2)
+    {
+        const float* apVertices[3] = { pClip0, pClip1, pClip2 };
+        float aX[3];
+        float aY[3];
+        float aZ[3];
+        for (uint32_t i = 0u; i < 3u; ++i)
+        {
+            if (apVertices[i][3] <= 0.0f)
+            {
+                return;
+            }
+
+            const float invW = 1.0f / apVertices[i][3];
+            aX[i] = (apVertices[i][0] * invW * 0.5f + 0.5f) * static_cast<float>(m_uWidth);
+            aY[i] = (0.5f - apVertices[i][1] * invW * 0.5f) * static_cast<float>(m_uHeight);
+            aZ[i] = apVertices[i][2] * invW;
+        }
+
+        float area = (aX[1] - aX[0]) * (aY[2] - aY[0]) - (aY[1] - aY[0]) * (aX[2] - aX[0]);
+        if (std::fabs(area) < 1e-6f)
+        {
+            return;
+        }
+
+        // Both windings are drawn, the edge functions expect a
+        // positive area
+        if (area < 0.0f)
+        {
+            std::swap(aX[1], aX[2]);
+            std::swap(aY[1], aY[2]);
+            std::swap(aZ[1], aZ[2]);
+            area = -area;
+        }
+
+        Triangle triangle =
+        {
+            .X = { aX[0], aX[1], aX[2] },
+            .Y = { aY[0], aY[1], aY[2] },
+            .DepthX = 0.0f,
+            .DepthY = 0.0f,
+            .DepthOffset = 0.0f,
+            .MinX = (std::max)((std::min)({ aX[0], aX[1], aX[2] }), 0.0f),
+            .MinY = (std::max)((std::min)({ aY[0], aY[1], aY[2] }), 0.0f),
+            .MaxX = (std::min)((std::max)({ aX[0], aX[1], aX[2] }), static_cast<float>(m_uWidth)),
+            .MaxY = (std::min)((std::max)({ aY[0], aY[1], aY[2] }), static_cast<float>(m_uHeight)),
+        };
+        if (triangle.MinX >= triangle.MaxX || triangle.MinY >= triangle.MaxY)
+        {
+            return;
+        }
+
+        const float deltaX1 = aX[1] - aX[0];
+        const float deltaY1 = aY[1] - aY[0];
+        const float deltaX2 = aX[2] - aX[0];
+        const float deltaY2 = aY[2] - aY[0];
+        const float deltaZ1 = aZ[1] - aZ[0];
+        const float deltaZ2 = aZ[2] - aZ[0];
+        triangle.DepthX = (deltaZ1 * deltaY2 - deltaZ2 * deltaY1) / area;
+        triangle.DepthY = (deltaZ2 * deltaX1 - deltaZ1 * deltaX2) / area;
+        triangle.DepthOffset = aZ[0] - triangle.DepthX * aX[0] - triangle.DepthY * aY[0];
+
+        const uint32_t uTriangleIdx = static_cast<uint32_t>(m_aTriangles.size());
+        m_aTriangles.push_back(triangle);
+
+        const uint32_t uBeginTileX = static_cast<uint32_t>(triangle.MinX) / TILE_WIDTH;
+        const uint32_t uBeginTileY = static_cast<uint32_t>(triangle.MinY) / TILE_HEIGHT;
+        const uint32_t uEndTileX = (std::min)((static_cast<uint32_t>(std::ceil(triangle.MaxX)) + TILE_WIDTH - 1u) / TILE_WIDTH, m_uNumTilesX);
+        const uint32_t uEndTileY = (std::min)((static_cast<uint32_t>(std::ceil(triangle.MaxY)) + TILE_HEIGHT - 1u) / TILE_HEIGHT, m_uNumTilesY);
+        for (uint32_t uTileY = uBeginTileY; uTileY < uEndTileY; ++uTileY)
+        {
+            for (uint32_t uTileX = uBeginTileX; uTileX < uEndTileX; ++uTileX)
+            {
+                m_aTileBins[static_cast<size_t>(uTileY) * m_uNumTilesX + uTileX].push_back(uTriangleIdx);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionRasterizer::rasterizeTile
+
+      Summary:  Draws the triangles binned to a tile, four pixels of a
+                row at a time, then records the farthest depth of the
+                tile. A pixel is covered when its center is on the
+                inner side of all three edges
+
+      Args:     uint32_t uTileIdx
+                  Index of the tile
+
+      Modifies: [m_aDepth, m_aTileMaxDepth].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionRasterizer::rasterizeTile(uint32_t uTileIdx)
+    {
+        const uint32_t uTileBeginX = (uTileIdx % m_uNumTilesX) * TILE_WIDTH;
+        const uint32_t uTileBeginY = (uTileIdx / m_uNumTilesX) * TILE_HEIGHT;
+        const uint32_t uTileEndX = (std::min)(uTileBeginX + TILE_WIDTH, m_uWidth);
+        const uint32_t uTileEndY = (std::min)(uTileBeginY + TILE_HEIGHT, m_uHeight);
+
+        const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        const __m128 zero = _mm_setzero_ps();
+        for (const uint32_t uTriangleIdx : m_aTileBins[uTileIdx])
+        {
+            const Triangle& triangle = m_aTriangles[uTriangleIdx];
+
+            // Edge ab: E(x, y) = A * x + B * y + C, positive inside
+            __m128 aEdgeA[3];
+            float aEdgeB[3];
+            float aEdgeC[3];
+            for (uint32_t i = 0u; i < 3u; ++i)
+            {
+                const uint32_t uNext = (i + 1u) % 3u;
+                const float deltaX = triangle.X[uNext] - triangle.X[i];
+                const float deltaY = triangle.Y[uNext] - triangle.Y[i];
+                aEdgeA[i] = _mm_set1_ps(-deltaY);
+                aEdgeB[i] = deltaX;
+                aEdgeC[i] = deltaY * triangle.X[i] - deltaX * triangle.Y[i];
+            }
+            const __m128 depthX = _mm_set1_ps(triangle.DepthX);
+
+            const uint32_t uBeginX = (std::max)(static_cast<uint32_t>(triangle.MinX), uTileBeginX) & ~3u;
+            const uint32_t uEndX = (std::min)(static_cast<uint32_t>(std::ceil(triangle.MaxX)), uTileEndX);
+            const uint32_t uBeginY = (std::max)(static_cast<uint32_t>(triangle.MinY), uTileBeginY);
+            const uint32_t uEndY = (std::min)(static_cast<uint32_t>(std::ceil(triangle.MaxY)), uTileEndY);
+            for (uint32_t y = uBeginY; y < uEndY; ++y)
+            {
+                const float pixelY = static_cast<float>(y) + 0.5f;
+                const __m128 rowEdge0 = _mm_set1_ps(aEdgeB[0] * pixelY + aEdgeC[0]);
+                const __m128 rowEdge1 = _mm_set1_ps(aEdgeB[1] * pixelY + aEdgeC[1]);
+                const __m128 rowEdge2 = _mm_set1_ps(aEdgeB[2] * pixelY + aEdgeC[2]);
+                const __m128 rowDepth = _mm_set1_ps(triangle.DepthY * pixelY + triangle.DepthOffset);
+                float* pRow = &m_aDepth[static_cast<size_t>(y) * m_uWidth];
+                for (uint32_t x = uBeginX; x < uEndX; x += 4u)
+                {
+                    const __m128 pixelX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+                    __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(aEdgeA[0], pixelX), rowEdge0), zero);
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(aEdgeA[1], pixelX), rowEdge1), zero));
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(aEdgeA[2], pixelX), rowEdge2), zero));
+                    if (_mm_movemask_ps(inside) == 0)
+                    {
+                        continue;
+                    }
+
+                    const __m128 depth = _mm_add_ps(_mm_mul_ps(depthX, pixelX), rowDepth);
+                    const __m128 oldDepth = _mm_loadu_ps(pRow + x);
+                    const __m128 newDepth = _mm_min_ps(oldDepth, depth);
+                    _mm_storeu_ps(pRow + x, _mm_or_ps(_mm_and_ps(inside, newDepth), _mm_andnot_ps(inside, oldDepth)));
+                }
+            }
+        }
+
+        __m128 maxDepth = zero;
+        for (uint32_t y = uTileBeginY; y < uTileEndY; ++y)
+        {
+            const float* pRow = &m_aDepth[static_cast<size_t>(y) * m_uWidth];
+            for (uint32_t x = uTileBeginX; x < uTileEndX; x += 4u)
+            {
+                maxDepth = _mm_max_ps(maxDepth, _mm_loadu_ps(pRow + x));
+            }
+        }
+        maxDepth = _mm_max_ps(maxDepth, _mm_shuffle_ps(maxDepth, maxDepth, _MM_SHUFFLE(1, 0, 3, 2)));
+        maxDepth = _mm_max_ps(maxDepth, _mm_shuffle_ps(maxDepth, maxDepth, _MM_SHUFFLE(2, 3, 0, 1)));
+        m_aTileMaxDepth[uTileIdx] = _mm_cvtss_f32(maxDepth);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionRasterizer::transformPoint
+
+      Summary:  Multiplies the row vector (x, y, z, 1) by a matrix
+
+      Args:     const float* pMatrix
+                  Row-major 4x4 matrix
+                const float* pPosition
+                  x y z
+                float* pResult
+                  Receives x y z w
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionRasterizer::transformPoint(const float* pMatrix, const float* pPosition, float* pResult)
+    {
+        for (uint32_t uColumn = 0u; uColumn < 4u; ++uColumn)
+        {
+            pResult[uColumn] =
+                pPosition[0] * pMatrix[0u * 4u + uColumn] +
+                pPosition[1] * pMatrix[1u * 4u + uColumn] +
+                pPosition[2] * pMatrix[2u * 4u + uColumn] +
+                pMatrix[3u * 4u + uColumn];
+        }
+    }
+}
@@ -0,0 +1,139 @@
+/*+===================================================================
+  File:      OCCLUSIONRASTERIZER.H
+
+  Summary:   OcclusionRasterizer header file contains declarations of
+             the software depth rasterizer used for occlusion culling.
+             It only depends on the standard library and SSE2, so it
+             builds and runs without Direct3D.
+
+  Classes: OcclusionRasterizer
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Thread/ThreadPool.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    OcclusionRasterizer
+
+      Summary:  Draws occluder triangles into a small depth buffer on
+                the CPU and tests bounding boxes against it. Matrices
+                are 4x4 row-major floats applied to row vectors, the
+                layout of XMFLOAT4X4, and depth is in [0, 1] with 0 at
+                the near plane as in Direct3D.
+
+                Occluders are transformed, clipped against the near
+                plane and binned into screen tiles when they are added.
+                Rasterize then fills the tiles independently, four
+                pixels at a time, on the calling thread or spread over
+                a thread pool. Occluders must lie inside the geometry
+                they stand for, otherwise visible objects get culled
+
+      Methods:  Begin
+                  Clears the depth buffer and sets the view-projection
+                AddOccluderTriangles
+                  Adds an indexed triangle list as an occluder
+                AddOccluderBox
+                  Adds an axis-aligned box as an occluder
+                AddTerrainOccluderBox
+                  Adds the solid box of a terrain chunk unless the eye
+                  is inside or below it
+                Rasterize
+                  Draws the binned occluders into the depth buffer
+                IsVisible
+                  Returns whether any part of a box may be visible
+                GetWidth
+                  Returns the width of the depth buffer
+                GetHeight
+                  Returns the height of the depth buffer
+                GetDepthBuffer
+                  Returns the depth buffer
+                GetNumTriangles
+                  Returns the number of binned occluder triangles
+                OcclusionRasterizer
+                  Constructor.
+                ~OcclusionRasterizer
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class OcclusionRasterizer final
+    {
+    public:
+        static constexpr const uint32_t TILE_WIDTH = 32u;
+        static constexpr const uint32_t TILE_HEIGHT = 16u;
+        static constexpr const uint32_t DEFAULT_WIDTH = 320u;
+        static constexpr const uint32_t DEFAULT_HEIGHT = 192u;
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Triangle
+
+          Summary:  Screen space triangle with counter-clockwise winding
+                    on screen. Depth is a plane over the screen,
+                    Z = DepthX * x + DepthY * y + DepthOffset
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Triangle
+        {
+            float X[3];
+            float Y[3];
+            float DepthX;
+            float DepthY;
+            float DepthOffset;
+            float MinX;
+            float MinY;
+            float MaxX;
+            float MaxY;
+        };
+
+    public:
+        explicit OcclusionRasterizer(uint32_t uWidth = DEFAULT_WIDTH, uint32_t uHeight = DEFAULT_HEIGHT);
+        OcclusionRasterizer(const OcclusionRasterizer& other) = delete;
+        OcclusionRasterizer(OcclusionRasterizer&& other) = delete;
+        OcclusionRasterizer& operator=(const OcclusionRasterizer& other) = delete;
+        OcclusionRasterizer& operator=(OcclusionRasterizer&& other) = delete;
+        ~OcclusionRasterizer() = default;
+
+        void Begin(const float* pViewProjection);
+        void AddOccluderTriangles(
+            const float* pPositions,
+            size_t uStride,
+            const uint16_t* pIndices,
+            uint32_t uNumIndices,
+            const float* pWorld = nullptr
+        );
+        void AddOccluderBox(const float* pMin, const float* pMax);
+        bool AddTerrainOccluderBox(const float* pMin, const float* pMax, const float* pEye);
+        void Rasterize(ThreadPool* pThreadPool = nullptr);
+
+        bool IsVisible(const float* pMin, const float* pMax) const;
+
+        uint32_t GetWidth() const;
+        uint32_t GetHeight() const;
+        const float* GetDepthBuffer() const;
+        uint32_t GetNumTriangles() const;
+
+    private:
+        void addClippedTriangle(const float* pClip0, const float* pClip1, const float* pClip2);
+        void addTriangle(const float* pClip0, const float* pClip1, const float* pClip2);
+        void rasterizeTile(uint32_t uTileIdx);
+
+        static void transformPoint(const float* pMatrix, const float* pPosition, float* pResult);
+
+    private:
+        uint32_t m_uWidth;
+        uint32_t m_uHeight;
+        uint32_t m_uNumTilesX;
+        uint32_t m_uNumTilesY;
+        float m_aViewProjection[16];
+        std::vector<float> m_aDepth;
+        std::vector<float> m_aTileMaxDepth;
+        std::vector<Triangle> m_aTriangles;
+        std::vector<std::vector<uint32_t>> m_aTileBins;
+    };
+}
@@ -0,0 +1,586 @@
+#include "Renderer/RecordingCommandContext.h"
+
+#include <algorithm>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::RecordingCommandContext
+
+      Summary:  Constructor
+
+      Modifies: [m_aCommands, m_mappedMemory].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    RecordingCommandContext::RecordingCommandContext()
+        : m_aCommands()
+        , m_mappedMemory()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::Reset
+
+      Summary:  Removes the recorded commands. The memory of the list
+                and of the mapped buffers is kept for the next frame
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::Reset()
+    {
+        m_aCommands.clear();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::GetCommands
+
+      Summary:  Returns the commands recorded since the last Reset
+
+      Returns:  const std::vector<RecordedCommand>&
+                  Recorded commands in call order
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<RecordedCommand>& RecordingCommandContext::GetCommands() const
+    {
+        return m_aCommands;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::ClearRenderTargetView
+
+      Summary:  Records a render target clear
+
+      Args:     GpuRenderTargetView* pRenderTargetView
+                  Render target
+                const float aColor[4]
+                  RGBA color to clear to
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::ClearRenderTargetView(GpuRenderTargetView* pRenderTargetView, [[maybe_unused]] const float aColor[4])
+    {
+        record(eCommandType::CLEAR_RENDER_TARGET, 0u, pRenderTargetView);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::ClearDepthStencilView
+
+      Summary:  Records a depth stencil clear
+
+      Args:     GpuDepthStencilView* pDepthStencilView
+                  Depth stencil
+                uint32_t uClearFlags
+                  CommandContext::CLEAR_DEPTH and CLEAR_STENCIL bits
+                float depth
+                  Depth to clear to
+                uint8_t uStencil
+                  Stencil value to clear to
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::ClearDepthStencilView(GpuDepthStencilView* pDepthStencilView, uint32_t uClearFlags, [[maybe_unused]] float depth, uint8_t uStencil)
+    {
+        record(eCommandType::CLEAR_DEPTH_STENCIL, 0u, pDepthStencilView, uClearFlags, uStencil);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::OMSetRenderTargets
+
+      Summary:  Records a render target bind. Only the first render
+                target is kept, the renderer never binds more and always
+                binds the same depth stencil
+
+      Args:     uint32_t uNumViews
+                  Number of render targets
+                GpuRenderTargetView* const* ppRenderTargetViews
+                  Render targets
+                GpuDepthStencilView* pDepthStencilView
+                  Depth stencil
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::OMSetRenderTargets(
+        uint32_t uNumViews,
+        GpuRenderTargetView* const* ppRenderTargetViews,
+        [[maybe_unused]] GpuDepthStencilView* pDepthStencilView
+    )
+    {
+        record(eCommandType::SET_RENDER_TARGETS, 0u, uNumViews > 0u && ppRenderTargetViews ? ppRenderTargetViews[0] : nullptr, uNumViews);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::OMSetDepthStencilState
+
+      Summary:  Records a depth stencil state change
+
+      Args:     GpuDepthStencilState* pDepthStencilState
+                  Depth stencil state
+                uint32_t uStencilRef
+                  Reference value of the stencil test
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::OMSetDepthStencilState(GpuDepthStencilState* pDepthStencilState, uint32_t uStencilRef)
+    {
+        record(eCommandType::SET_DEPTH_STENCIL_STATE, 0u, pDepthStencilState, uStencilRef);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::RSSetViewport
+
+      Summary:  Records a viewport change with its size in whole pixels
+
+      Args:     const Viewport& viewport
+                  Viewport
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::RSSetViewport(const Viewport& viewport)
+    {
+        record(eCommandType::SET_VIEWPORT, 0u, nullptr, static_cast<uint32_t>(viewport.Width), static_cast<uint32_t>(viewport.Height));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::IASetPrimitiveTopology
+
+      Summary:  Records a primitive topology change
+
+      Args:     ePrimitiveTopology topology
+                  Primitive topology
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::IASetPrimitiveTopology(ePrimitiveTopology topology)
+    {
+        record(eCommandType::SET_PRIMITIVE_TOPOLOGY, 0u, nullptr, static_cast<uint32_t>(topology));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::IASetVertexBuffers
+
+      Summary:  Records one vertex buffer bind per slot
+
+      Args:     uint32_t uStartSlot
+                  First input slot
+                uint32_t uNumBuffers
+                  Number of buffers
+                GpuBuffer* const* ppVertexBuffers
+                  Vertex buffers
+                const uint32_t* puStrides
+                  Strides of the buffers
+                const uint32_t* puOffsets
+                  Offsets into the buffers
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::IASetVertexBuffers(
+        uint32_t uStartSlot,
+        uint32_t uNumBuffers,
+        GpuBuffer* const* ppVertexBuffers,
+        const uint32_t* puStrides,
+        const uint32_t* puOffsets
+    )
+    {
+        for (uint32_t i = 0u; i < uNumBuffers; ++i)
+        {
+            record(eCommandType::SET_VERTEX_BUFFER, uStartSlot + i, ppVertexBuffers[i], puStrides[i], puOffsets[i]);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::IASetIndexBuffer
+
+      Summary:  Records an index buffer bind
+
+      Args:     GpuBuffer* pIndexBuffer
+                  Index buffer
+                eIndexFormat format
+                  Format of the indices
+                uint32_t uOffset
+                  Offset into the buffer
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::IASetIndexBuffer(GpuBuffer* pIndexBuffer, eIndexFormat format, uint32_t uOffset)
+    {
+        record(eCommandType::SET_INDEX_BUFFER, 0u, pIndexBuffer, static_cast<uint32_t>(format), uOffset);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::IASetInputLayout
+
+      Summary:  Records an input layout bind
+
+      Args:     GpuInputLayout* pInputLayout
+                  Input layout
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::IASetInputLayout(GpuInputLayout* pInputLayout)
+    {
+        record(eCommandType::SET_INPUT_LAYOUT, 0u, pInputLayout);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::VSSetShader
+
+      Summary:  Records a vertex shader bind
+
+      Args:     GpuVertexShader* pVertexShader
+                  Vertex shader
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::VSSetShader(GpuVertexShader* pVertexShader)
+    {
+        record(eCommandType::SET_VERTEX_SHADER, 0u, pVertexShader);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::PSSetShader
+
+      Summary:  Records a pixel shader bind
+
+      Args:     GpuPixelShader* pPixelShader
+                  Pixel shader
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::PSSetShader(GpuPixelShader* pPixelShader)
+    {
+        record(eCommandType::SET_PIXEL_SHADER, 0u, pPixelShader);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::VSSetConstantBuffer
+
+      Summary:  Records a whole constant buffer bound to the vertex
+                shader, as a range of 0 constants
+
+      Args:     uint32_t uSlot
+                  Constant buffer slot
+                GpuBuffer* pConstantBuffer
+                  Constant buffer
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::VSSetConstantBuffer(uint32_t uSlot, GpuBuffer* pConstantBuffer)
+    {
+        record(eCommandType::SET_VS_CONSTANT_BUFFER, uSlot, pConstantBuffer);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::PSSetConstantBuffer
+
+      Summary:  Records a whole constant buffer bound to the pixel
+                shader, as a range of 0 constants
+
+      Args:     uint32_t uSlot
+                  Constant buffer slot
+                GpuBuffer* pConstantBuffer
+                  Constant buffer
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::PSSetConstantBuffer(uint32_t uSlot, GpuBuffer* pConstantBuffer)
+    {
+        record(eCommandType::SET_PS_CONSTANT_BUFFER, uSlot, pConstantBuffer);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::VSSetConstantBufferRange
+
+      Summary:  Records a range of a constant buffer bound to the vertex
+                shader
+
+      Args:     uint32_t uSlot
+                  Constant buffer slot
+                GpuBuffer* pConstantBuffer
+                  Constant buffer
+                uint32_t uFirstConstant
+                  First 16-byte constant of the range
+                uint32_t uNumConstants
+                  Number of constants in the range
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::VSSetConstantBufferRange(uint32_t uSlot, GpuBuffer* pConstantBuffer, uint32_t uFirstConstant, uint32_t uNumConstants)
+    {
+        record(eCommandType::SET_VS_CONSTANT_BUFFER, uSlot, pConstantBuffer, uFirstConstant, uNumConstants);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::PSSetConstantBufferRange
+
+      Summary:  Records a range of a constant buffer bound to the pixel
+                shader
+
+      Args:     uint32_t uSlot
+                  Constant buffer slot
+                GpuBuffer* pConstantBuffer
+                  Constant buffer
+                uint32_t uFirstConstant
+                  First 16-byte constant of the range
+                uint32_t uNumConstants
+                  Number of constants in the range
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::PSSetConstantBufferRange(uint32_t uSlot, GpuBuffer* pConstantBuffer, uint32_t uFirstConstant, uint32_t uNumConstants)
+    {
+        record(eCommandType::SET_PS_CONSTANT_BUFFER, uSlot, pConstantBuffer, uFirstConstant, uNumConstants);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::PSSetShaderResource
+
+      Summary:  Records a shader resource view bound to the pixel
+                shader
+
+      Args:     uint32_t uSlot
+                  Shader resource slot
+                GpuShaderResourceView* pShaderResourceView
+                  Shader resource view
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::PSSetShaderResource(uint32_t uSlot, GpuShaderResourceView* pShaderResourceView)
+    {
+        record(eCommandType::SET_PS_SHADER_RESOURCE, uSlot, pShaderResourceView);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::PSSetSampler
+
+      Summary:  Records a sampler bound to the pixel shader
+
+      Args:     uint32_t uSlot
+                  Sampler slot
+                GpuSamplerState* pSampler
+                  Sampler
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::PSSetSampler(uint32_t uSlot, GpuSamplerState* pSampler)
+    {
+        record(eCommandType::SET_PS_SAMPLER, uSlot, pSampler);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::UpdateSubresource
+
+      Summary:  Records an upload and its size. The data is not copied
+
+      Args:     GpuBuffer* pBuffer
+                  Buffer
+                const void* pData
+                  New contents of the buffer
+                size_t uSize
+                  Size of the contents in bytes
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::UpdateSubresource(GpuBuffer* pBuffer, [[maybe_unused]] const void* pData, size_t uSize)
+    {
+        record(eCommandType::UPDATE_SUBRESOURCE, 0u, pBuffer, static_cast<uint32_t>(uSize));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::Map
+
+      Summary:  Records a map and returns scratch memory for the range,
+                so the caller can write as it would to the mapped
+                buffer. The scratch memory of a buffer grows to the end
+                of the largest range mapped and is kept between maps
+
+      Args:     GpuBuffer* pBuffer
+                  Dynamic buffer
+                eMapType mapType
+                  WRITE_DISCARD or WRITE_NO_OVERWRITE
+                uint32_t uFirstByte
+                  First byte of the range the caller writes
+                uint32_t uNumBytes
+                  Number of bytes the caller writes
+                void** ppData
+                  Receives the scratch memory of the first byte
+
+      Modifies: [m_aCommands, m_mappedMemory].
+
+      Returns:  bool
+                  Always true
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool RecordingCommandContext::Map(GpuBuffer* pBuffer, eMapType mapType, uint32_t uFirstByte, uint32_t uNumBytes, void** ppData)
+    {
+        std::vector<uint8_t>& aMemory = m_mappedMemory[pBuffer];
+        aMemory.resize((std::max)(aMemory.size(), static_cast<size_t>(uFirstByte) + uNumBytes));
+        *ppData = aMemory.data() + uFirstByte;
+
+        record(eCommandType::MAP, 0u, pBuffer, uNumBytes, static_cast<uint32_t>(mapType), uFirstByte);
+
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::Unmap
+
+      Summary:  Records an unmap
+
+      Args:     GpuBuffer* pBuffer
+                  Dynamic buffer
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::Unmap(GpuBuffer* pBuffer)
+    {
+        record(eCommandType::UNMAP, 0u, pBuffer);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::CopySubresource
+
+      Summary:  Records a copy of a whole subresource. The source is
+                kept as an argument only by its subresource
+
+      Args:     GpuResource* pDstResource
+                  Resource copied to
+                uint32_t uDstSubresource
+                  Subresource copied to
+                GpuResource* pSrcResource
+                  Resource copied from
+                uint32_t uSrcSubresource
+                  Subresource copied from
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::CopySubresource(GpuResource* pDstResource, uint32_t uDstSubresource, [[maybe_unused]] GpuResource* pSrcResource, uint32_t uSrcSubresource)
+    {
+        record(eCommandType::COPY_SUBRESOURCE, 0u, pDstResource, uDstSubresource, uSrcSubresource);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::DrawIndexed
+
+      Summary:  Records a draw of indexed primitives
+
+      Args:     uint32_t uIndexCount
+                  Number of indices
+                uint32_t uStartIndexLocation
+                  First index
+                int32_t iBaseVertexLocation
+                  Value added to each index
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::DrawIndexed(uint32_t uIndexCount, uint32_t uStartIndexLocation, int32_t iBaseVertexLocation)
+    {
+        record(eCommandType::DRAW_INDEXED, 0u, nullptr, uIndexCount, 1u, uStartIndexLocation, static_cast<uint32_t>(iBaseVertexLocation));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::DrawIndexedInstanced
+
+      Summary:  Records a draw of instances of indexed primitives
+
+      Args:     uint32_t uIndexCountPerInstance
+                  Number of indices per instance
+                uint32_t uInstanceCount
+                  Number of instances
+                uint32_t uStartIndexLocation
+                  First index
+                int32_t iBaseVertexLocation
+                  Value added to each index
+                uint32_t uStartInstanceLocation
+                  Value added to each instance index
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::DrawIndexedInstanced(
+        uint32_t uIndexCountPerInstance,
+        uint32_t uInstanceCount,
+        uint32_t uStartIndexLocation,
+        int32_t iBaseVertexLocation,
+        uint32_t uStartInstanceLocation
+    )
+    {
+        record(
+            eCommandType::DRAW_INDEXED_INSTANCED,
+            0u,
+            nullptr,
+            uIndexCountPerInstance,
+            uInstanceCount,
+            uStartIndexLocation,
+            static_cast<uint32_t>(iBaseVertexLocation),
+            uStartInstanceLocation
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::FinishCommandList
+
+      Summary:  Does nothing. The commands recorded since the last
+                Reset are the command list
+
+      Returns:  bool
+                  Always true
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool RecordingCommandContext::FinishCommandList()
+    {
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::ExecuteCommandList
+
+      Summary:  Records a command list marker followed by the commands
+                of another recording context, then resets it
+
+      Args:     CommandContext* pDeferredContext
+                  Deferred RecordingCommandContext
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::ExecuteCommandList(CommandContext* pDeferredContext)
+    {
+        RecordingCommandContext* pDeferred = static_cast<RecordingCommandContext*>(pDeferredContext);
+
+        record(eCommandType::EXECUTE_COMMAND_LIST, 0u, pDeferred, static_cast<uint32_t>(pDeferred->m_aCommands.size()));
+        m_aCommands.insert(m_aCommands.end(), pDeferred->m_aCommands.begin(), pDeferred->m_aCommands.end());
+        pDeferred->Reset();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingCommandContext::record
+
+      Summary:  Appends a command to the list
+
+      Args:     eCommandType type
+                  Kind of command
+                uint32_t uSlot
+                  Slot the command binds to
+                const void* pObject
+                  Bound or written object
+                uint32_t uArg0 ~ uArg4
+                  Remaining arguments
+
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingCommandContext::record(
+        eCommandType type,
+        uint32_t uSlot,
+        const void* pObject,
+        uint32_t uArg0,
+        uint32_t uArg1,
+        uint32_t uArg2,
+        uint32_t uArg3,
+        uint32_t uArg4
+    )
+    {
+        m_aCommands.push_back(
+            RecordedCommand
+            {
+                .Type = type,
+                .uSlot = uSlot,
+                .pObject = pObject,
+                .auArgs = { uArg0, uArg1, uArg2, uArg3, uArg4 },
+            }
+        );
+    }
+}
@@ -0,0 +1,229 @@
+/*+===================================================================
+  File:      RECORDINGCOMMANDCONTEXT.H
+
+  Summary:   RecordingCommandContext header file contains declarations
+             of RecordingCommandContext class that records commands
+             instead of drawing them. It only depends on the standard
+             library, so a frame can be recorded and analyzed without
+             Direct3D.
+
+  Classes: RecordingCommandContext
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Renderer/CommandContext.h"
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eCommandType
+
+      Summary:  Kinds of recorded commands
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eCommandType : uint8_t
+    {
+        CLEAR_RENDER_TARGET,
+        CLEAR_DEPTH_STENCIL,
+        SET_RENDER_TARGETS,
+        SET_DEPTH_STENCIL_STATE,
+        SET_VIEWPORT,
+        SET_PRIMITIVE_TOPOLOGY,
+        SET_VERTEX_BUFFER,
+        SET_INDEX_BUFFER,
+        SET_INPUT_LAYOUT,
+        SET_VERTEX_SHADER,
+        SET_PIXEL_SHADER,
+        SET_VS_CONSTANT_BUFFER,
+        SET_PS_CONSTANT_BUFFER,
+        SET_PS_SHADER_RESOURCE,
+        SET_PS_SAMPLER,
+        UPDATE_SUBRESOURCE,
+        MAP,
+        UNMAP,
+        COPY_SUBRESOURCE,
+        DRAW_INDEXED,
+        DRAW_INDEXED_INSTANCED,
+        EXECUTE_COMMAND_LIST,
+        COUNT,
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   RecordedCommand
+
+      Summary:  One recorded command. pObject is the handle of the
+                bound or written object and auArgs hold the remaining
+                arguments in call order: stride and offset of a vertex
+                buffer, format and offset of an index buffer, first and
+                number of constants of a constant buffer range, the
+                number of bytes of an upload or map followed by the map
+                type and the first mapped byte, the stencil reference
+                of a depth stencil state, the source and subresources
+                of a copy, and the arguments of a draw.
+                Binding several vertex buffers records one command per
+                slot. EXECUTE_COMMAND_LIST marks where the commands of
+                a deferred context were appended
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct RecordedCommand
+    {
+        static constexpr const uint32_t NUM_ARGS = 5u;
+
+        eCommandType Type;
+        uint32_t uSlot;
+        const void* pObject;
+        uint32_t auArgs[NUM_ARGS];
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    RecordingCommandContext
+
+      Summary:  Null command context that appends every command to a
+                list and never touches a device context, so a frame
+                can be run without a GPU. Mapped buffers are backed by
+                scratch memory that grows to the largest mapped range
+                of the buffer. Executing the
+                command list of another recording context appends its
+                commands
+
+      Methods:  Reset
+                  Removes the recorded commands
+                GetCommands
+                  Returns the recorded commands
+                ClearRenderTargetView
+                  Records a render target clear
+                ClearDepthStencilView
+                  Records a depth stencil clear
+                OMSetRenderTargets
+                  Records a render target bind
+                OMSetDepthStencilState
+                  Records a depth stencil state change
+                RSSetViewport
+                  Records a viewport change
+                IASetPrimitiveTopology
+                  Records a primitive topology change
+                IASetVertexBuffers
+                  Records vertex buffer binds
+                IASetIndexBuffer
+                  Records an index buffer bind
+                IASetInputLayout
+                  Records an input layout bind
+                VSSetShader
+                  Records a vertex shader bind
+                PSSetShader
+                  Records a pixel shader bind
+                VSSetConstantBuffer
+                  Records a vertex shader constant buffer bind
+                PSSetConstantBuffer
+                  Records a pixel shader constant buffer bind
+                VSSetConstantBufferRange
+                  Records a vertex shader constant buffer range bind
+                PSSetConstantBufferRange
+                  Records a pixel shader constant buffer range bind
+                PSSetShaderResource
+                  Records a shader resource view bind
+                PSSetSampler
+                  Records a sampler bind
+                UpdateSubresource
+                  Records an upload
+                Map
+                  Records a map and returns scratch memory for the
+                  range
+                Unmap
+                  Records an unmap
+                CopySubresource
+                  Records a copy
+                DrawIndexed
+                  Records a draw
+                DrawIndexedInstanced
+                  Records an instanced draw
+                FinishCommandList
+                  Does nothing, the recorded commands are the list
+                ExecuteCommandList
+                  Appends the commands of another recording context
+                RecordingCommandContext
+                  Constructor.
+                ~RecordingCommandContext
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class RecordingCommandContext final : public CommandContext
+    {
+    public:
+        RecordingCommandContext();
+        RecordingCommandContext(const RecordingCommandContext& other) = delete;
+        RecordingCommandContext(RecordingCommandContext&& other) = delete;
+        RecordingCommandContext& operator=(const RecordingCommandContext& other) = delete;
+        RecordingCommandContext& operator=(RecordingCommandContext&& other) = delete;
+        ~RecordingCommandContext() = default;
+
+        void Reset();
+        const std::vector<RecordedCommand>& GetCommands() const;
+
+        void ClearRenderTargetView(GpuRenderTargetView* pRenderTargetView, const float aColor[4]) override;
+        void ClearDepthStencilView(GpuDepthStencilView* pDepthStencilView, uint32_t uClearFlags, float depth, uint8_t uStencil) override;
+        void OMSetRenderTargets(
+            uint32_t uNumViews,
+            GpuRenderTargetView* const* ppRenderTargetViews,
+            GpuDepthStencilView* pDepthStencilView
+        ) override;
+        void OMSetDepthStencilState(GpuDepthStencilState* pDepthStencilState, uint32_t uStencilRef) override;
+        void RSSetViewport(const Viewport& viewport) override;
+        void IASetPrimitiveTopology(ePrimitiveTopology topology) override;
+
+        void IASetVertexBuffers(
+            uint32_t uStartSlot,
+            uint32_t uNumBuffers,
+            GpuBuffer* const* ppVertexBuffers,
+            const uint32_t* puStrides,
+            const uint32_t* puOffsets
+        ) override;
+        void IASetIndexBuffer(GpuBuffer* pIndexBuffer, eIndexFormat format, uint32_t uOffset) override;
+        void IASetInputLayout(GpuInputLayout* pInputLayout) override;
+        void VSSetShader(GpuVertexShader* pVertexShader) override;
+        void PSSetShader(GpuPixelShader* pPixelShader) override;
+        void VSSetConstantBuffer(uint32_t uSlot, GpuBuffer* pConstantBuffer) override;
+        void PSSetConstantBuffer(uint32_t uSlot, GpuBuffer* pConstantBuffer) override;
+        void VSSetConstantBufferRange(uint32_t uSlot, GpuBuffer* pConstantBuffer, uint32_t uFirstConstant, uint32_t uNumConstants) override;
+        void PSSetConstantBufferRange(uint32_t uSlot, GpuBuffer* pConstantBuffer, uint32_t uFirstConstant, uint32_t uNumConstants) override;
+        void PSSetShaderResource(uint32_t uSlot, GpuShaderResourceView* pShaderResourceView) override;
+        void PSSetSampler(uint32_t uSlot, GpuSamplerState* pSampler) override;
+
+        void UpdateSubresource(GpuBuffer* pBuffer, const void* pData, size_t uSize) override;
+        bool Map(GpuBuffer* pBuffer, eMapType mapType, uint32_t uFirstByte, uint32_t uNumBytes, void** ppData) override;
+        void Unmap(GpuBuffer* pBuffer) override;
+        void CopySubresource(GpuResource* pDstResource, uint32_t uDstSubresource, GpuResource* pSrcResource, uint32_t uSrcSubresource) override;
+
+        void DrawIndexed(uint32_t uIndexCount, uint32_t uStartIndexLocation, int32_t iBaseVertexLocation) override;
+        void DrawIndexedInstanced(
+            uint32_t uIndexCountPerInstance,
+            uint32_t uInstanceCount,
+            uint32_t uStartIndexLocation,
+            int32_t iBaseVertexLocation,
+            uint32_t uStartInstanceLocation
+        ) override;
+
+        bool FinishCommandList() override;
+        void ExecuteCommandList(CommandContext* pDeferredContext) override;
+
+    private:
+        void record(
+            eCommandType type,
+            uint32_t uSlot,
+            const void* pObject,
+            uint32_t uArg0 = 0u,
+            uint32_t uArg1 = 0u,
+            uint32_t uArg2 = 0u,
+            uint32_t uArg3 = 0u,
+            uint32_t uArg4 = 0u
+        );
+
+    private:
+        std::vector<RecordedCommand> m_aCommands;
+        std::unordered_map<GpuBuffer*, std::vector<uint8_t>> m_mappedMemory;
+    };
+}
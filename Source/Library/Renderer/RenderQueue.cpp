@@ -0,0 +1,286 @@
+#include "Renderer/RenderQueue.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::RenderQueue
+
+      Summary:  Constructor
+
+      Modifies: [m_aItems, m_aSortedItems, m_stateIds,
+                 m_uNumStateChanges, m_uNumUnsortedStateChanges].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    RenderQueue::RenderQueue()
+        : m_aItems()
+        , m_aSortedItems()
+        , m_stateIds()
+        , m_uNumStateChanges(0u)
+        , m_uNumUnsortedStateChanges(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::Clear
+
+      Summary:  Removes all items and forgets the state ids. Streamed
+                resources come and go and a freed address can be reused
+                by a new object, so ids only live for a frame. The
+                scene is walked in the same order every frame, so the
+                same states still get the same ids
+
+      Modifies: [m_aItems, m_stateIds, m_uNumStateChanges,
+                 m_uNumUnsortedStateChanges].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RenderQueue::Clear()
+    {
+        m_aItems.clear();
+        m_stateIds.clear();
+        m_uNumStateChanges = 0u;
+        m_uNumUnsortedStateChanges = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::Add
+
+      Summary:  Adds a draw with its sort key
+
+      Args:     UINT64 uKey
+                  Sort key built with MakeKey
+                UINT uIndex
+                  Index of the draw in the caller's list of draws
+
+      Modifies: [m_aItems].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RenderQueue::Add(_In_ UINT64 uKey, _In_ UINT uIndex)
+    {
+        m_aItems.push_back(Item{ .Key = uKey, .Index = uIndex });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::Sort
+
+      Summary:  Sorts the items by key with a least significant digit
+                radix sort, 8 bits per pass. The histograms of all
+                passes are built in one walk over the items, and passes
+                whose digit is the same for every item are skipped.
+                Items with equal keys keep the order they were added in
+
+      Modifies: [m_aItems, m_aSortedItems, m_uNumStateChanges,
+                 m_uNumUnsortedStateChanges].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RenderQueue::Sort()
+    {
+        m_uNumUnsortedStateChanges = countStateChanges();
+
+        UINT aHistograms[NUM_RADIX_PASSES][RADIX_SIZE] = {};
+        for (const Item& item : m_aItems)
+        {
+            for (UINT uPassIdx = 0u; uPassIdx < NUM_RADIX_PASSES; ++uPassIdx)
+            {
+                ++aHistograms[uPassIdx][(item.Key >> (uPassIdx * RADIX_BITS)) & (RADIX_SIZE - 1u)];
+            }
+        }
+
+        m_aSortedItems.resize(m_aItems.size());
+        for (UINT uPassIdx = 0u; uPassIdx < NUM_RADIX_PASSES; ++uPassIdx)
+        {
+            UINT* aHistogram = aHistograms[uPassIdx];
+            if (std::find(aHistogram, aHistogram + RADIX_SIZE, static_cast<UINT>(m_aItems.size())) != aHistogram + RADIX_SIZE)
+            {
+                continue;
+            }
+
+            UINT uOffset = 0u;
+            for (UINT uDigit = 0u; uDigit < RADIX_SIZE; ++uDigit)
+            {
+                const UINT uCount = aHistogram[uDigit];
+                aHistogram[uDigit] = uOffset;
+                uOffset += uCount;
+            }
+
+            for (const Item& item : m_aItems)
+            {
+                m_aSortedItems[aHistogram[(item.Key >> (uPassIdx * RADIX_BITS)) & (RADIX_SIZE - 1u)]++] = item;
+            }
+            m_aItems.swap(m_aSortedItems);
+        }
+
+        m_uNumStateChanges = countStateChanges();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::GetNumItems
+
+      Summary:  Returns the number of items
+
+      Returns:  UINT
+                  Number of items
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT RenderQueue::GetNumItems() const
+    {
+        return static_cast<UINT>(m_aItems.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::GetIndex
+
+      Summary:  Returns the draw index of an item
+
+      Args:     UINT uItemIdx
+                  Position of the item in sorted order
+
+      Returns:  UINT
+                  Index passed to Add
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT RenderQueue::GetIndex(_In_ UINT uItemIdx) const
+    {
+        return m_aItems[uItemIdx].Index;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::GetKey
+
+      Summary:  Returns the sort key of an item
+
+      Args:     UINT uItemIdx
+                  Position of the item in sorted order
+
+      Returns:  UINT64
+                  Sort key passed to Add
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 RenderQueue::GetKey(_In_ UINT uItemIdx) const
+    {
+        return m_aItems[uItemIdx].Key;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::GetStateId
+
+      Summary:  Returns a small id for a shader, material or texture.
+                Ids are handed out in the order the states are first
+                seen since the last Clear, null always gets 0
+
+      Args:     const void* pState
+                  Address of the state object
+
+      Modifies: [m_stateIds].
+
+      Returns:  UINT
+                  Id of the state
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT RenderQueue::GetStateId(_In_opt_ const void* pState)
+    {
+        if (!pState)
+        {
+            return 0u;
+        }
+
+        return m_stateIds.try_emplace(pState, static_cast<UINT>(m_stateIds.size()) + 1u).first->second;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::GetNumStateChanges
+
+      Summary:  Returns the number of times the pass, a shader, the
+                material or the texture changes between consecutive
+                items after the last Sort
+
+      Returns:  UINT
+                  Number of state changes in sorted order
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT RenderQueue::GetNumStateChanges() const
+    {
+        return m_uNumStateChanges;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::GetNumUnsortedStateChanges
+
+      Summary:  Returns the number of state changes the items had in
+                the order they were added, before the last Sort
+
+      Returns:  UINT
+                  Number of state changes in the order of Add
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT RenderQueue::GetNumUnsortedStateChanges() const
+    {
+        return m_uNumUnsortedStateChanges;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::MakeKey
+
+      Summary:  Builds a sort key. Ids are truncated to the width of
+                their field and the depth is clamped to [0, 1]
+
+      Args:     eRenderPass pass
+                  Pass of the draw
+                UINT uVertexShaderId
+                  Id of the vertex shader
+                UINT uPixelShaderId
+                  Id of the pixel shader
+                UINT uMaterialId
+                  Id of the material
+                UINT uTextureId
+                  Id of the diffuse texture
+                FLOAT depth
+                  Distance to the camera divided by the far plane
+
+      Returns:  UINT64
+                  Sort key
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 RenderQueue::MakeKey(
+        _In_ eRenderPass pass,
+        _In_ UINT uVertexShaderId,
+        _In_ UINT uPixelShaderId,
+        _In_ UINT uMaterialId,
+        _In_ UINT uTextureId,
+        _In_ FLOAT depth
+    )
+    {
+        const UINT64 uDepth = static_cast<UINT64>((std::clamp)(depth, 0.0f, 1.0f) * static_cast<FLOAT>((1u << DEPTH_BITS) - 1u));
+
+        return (static_cast<UINT64>(pass) & ((1ull << PASS_BITS) - 1ull)) << PASS_SHIFT
+            | (static_cast<UINT64>(uVertexShaderId) & ((1ull << SHADER_BITS) - 1ull)) << VERTEX_SHADER_SHIFT
+            | (static_cast<UINT64>(uPixelShaderId) & ((1ull << SHADER_BITS) - 1ull)) << PIXEL_SHADER_SHIFT
+            | (static_cast<UINT64>(uMaterialId) & ((1ull << MATERIAL_BITS) - 1ull)) << MATERIAL_SHIFT
+            | (static_cast<UINT64>(uTextureId) & ((1ull << TEXTURE_BITS) - 1ull)) << TEXTURE_SHIFT
+            | uDepth << DEPTH_SHIFT;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderQueue::countStateChanges
+
+      Summary:  Counts the changed state fields between consecutive
+                items, including the state of the first item
+
+      Returns:  UINT
+                  Number of state changes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT RenderQueue::countStateChanges() const
+    {
+        static constexpr const UINT aShifts[] = { PASS_SHIFT, VERTEX_SHADER_SHIFT, PIXEL_SHADER_SHIFT, MATERIAL_SHIFT, TEXTURE_SHIFT };
+        static constexpr const UINT aBits[] = { PASS_BITS, SHADER_BITS, SHADER_BITS, MATERIAL_BITS, TEXTURE_BITS };
+
+        UINT uNumChanges = 0u;
+        UINT64 uPreviousKey = 0u;
+        for (size_t i = 0u; i < m_aItems.size(); ++i)
+        {
+            const UINT64 uKey = m_aItems[i].Key;
+            for (UINT uFieldIdx = 0u; uFieldIdx < std::size(aShifts); ++uFieldIdx)
+            {
+                const UINT64 uFieldMask = ((1ull << aBits[uFieldIdx]) - 1ull) << aShifts[uFieldIdx];
+                if (i == 0u || (uKey & uFieldMask) != (uPreviousKey & uFieldMask))
+                {
+                    ++uNumChanges;
+                }
+            }
+            uPreviousKey = uKey;
+        }
+
+        return uNumChanges;
+    }
+}
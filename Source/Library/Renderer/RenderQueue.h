@@ -0,0 +1,137 @@
+/*+===================================================================
+  File:      RENDERQUEUE.H
+
+  Summary:   RenderQueue header file contains declarations of
+             RenderQueue class that orders the draws of a frame by
+             their render state.
+
+  Classes: RenderQueue
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eRenderPass
+
+      Summary:  Passes of a frame, drawn in the order of their values
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eRenderPass : BYTE
+    {
+        GEOMETRY = 0,
+        SKYBOX,
+        COUNT,
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    RenderQueue
+
+      Summary:  Collects the draws of a frame with a 64-bit sort key
+                and radix sorts them before submission. From the most
+                to the least significant bits the key holds the pass,
+                the vertex shader, the pixel shader, the material, the
+                texture and the quantized depth, so draws that share
+                state end up next to each other and are drawn front to
+                back within the same state.
+
+                Shaders, materials and textures enter the key as small
+                ids handed out by GetStateId. Ids past the width of a
+                field wrap around, which only costs some grouping
+
+      Methods:  Clear
+                  Removes all items
+                Add
+                  Adds a draw with its sort key
+                Sort
+                  Sorts the items by key
+                GetNumItems
+                  Returns the number of items
+                GetIndex
+                  Returns the draw index of a sorted item
+                GetKey
+                  Returns the key of a sorted item
+                GetStateId
+                  Returns the id of a shader, material or texture
+                GetNumStateChanges
+                  Returns the number of state changes in sorted order
+                GetNumUnsortedStateChanges
+                  Returns the number of state changes in the order the
+                  items were added
+                MakeKey
+                  Builds a sort key
+                RenderQueue
+                  Constructor.
+                ~RenderQueue
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class RenderQueue final
+    {
+    public:
+        static constexpr const UINT PASS_BITS = 4u;
+        static constexpr const UINT SHADER_BITS = 10u;
+        static constexpr const UINT MATERIAL_BITS = 12u;
+        static constexpr const UINT TEXTURE_BITS = 12u;
+        static constexpr const UINT DEPTH_BITS = 16u;
+        static constexpr const UINT DEPTH_SHIFT = 0u;
+        static constexpr const UINT TEXTURE_SHIFT = DEPTH_SHIFT + DEPTH_BITS;
+        static constexpr const UINT MATERIAL_SHIFT = TEXTURE_SHIFT + TEXTURE_BITS;
+        static constexpr const UINT PIXEL_SHADER_SHIFT = MATERIAL_SHIFT + MATERIAL_BITS;
+        static constexpr const UINT VERTEX_SHADER_SHIFT = PIXEL_SHADER_SHIFT + SHADER_BITS;
+        static constexpr const UINT PASS_SHIFT = VERTEX_SHADER_SHIFT + SHADER_BITS;
+
+        static_assert(PASS_SHIFT + PASS_BITS == 64u, "Sort key fields must fill 64 bits");
+
+    private:
+        static constexpr const UINT RADIX_BITS = 8u;
+        static constexpr const UINT RADIX_SIZE = 1u << RADIX_BITS;
+        static constexpr const UINT NUM_RADIX_PASSES = 64u / RADIX_BITS;
+
+        struct Item
+        {
+            UINT64 Key;
+            UINT Index;
+        };
+
+    public:
+        RenderQueue();
+        RenderQueue(const RenderQueue& other) = delete;
+        RenderQueue(RenderQueue&& other) = delete;
+        RenderQueue& operator=(const RenderQueue& other) = delete;
+        RenderQueue& operator=(RenderQueue&& other) = delete;
+        ~RenderQueue() = default;
+
+        void Clear();
+        void Add(_In_ UINT64 uKey, _In_ UINT uIndex);
+        void Sort();
+
+        UINT GetNumItems() const;
+        UINT GetIndex(_In_ UINT uItemIdx) const;
+        UINT64 GetKey(_In_ UINT uItemIdx) const;
+        UINT GetStateId(_In_opt_ const void* pState);
+        UINT GetNumStateChanges() const;
+        UINT GetNumUnsortedStateChanges() const;
+
+        static UINT64 MakeKey(
+            _In_ eRenderPass pass,
+            _In_ UINT uVertexShaderId,
+            _In_ UINT uPixelShaderId,
+            _In_ UINT uMaterialId,
+            _In_ UINT uTextureId,
+            _In_ FLOAT depth
+        );
+
+    private:
+        UINT countStateChanges() const;
+
+    private:
+        std::vector<Item> m_aItems;
+        std::vector<Item> m_aSortedItems;
+        std::unordered_map<const void*, UINT> m_stateIds;
+        UINT m_uNumStateChanges;
+        UINT m_uNumUnsortedStateChanges;
+    };
+}
@@ -1,5 +1,7 @@
 #include "Renderer/Renderable.h"
 
+#include <tuple>
+
 #include "assimp/Importer.hpp"	// C++ importer interface
 #include "assimp/scene.h"		// output data structure
 #include "assimp/postprocess.h"	// post processing flags
@@ -20,7 +22,8 @@ namespace library
       Modifies: [m_vertexBuffer, m_indexBuffer, m_constantBuffer,
                  m_normalBuffer, m_aMeshes, m_aMaterials, m_vertexShader,
                  m_pixelShader, m_outputColor, m_world, m_bHasNormalMap
-                 m_aNormalData].
+                 m_aNormalData, m_localBounds, m_bIsOccluder,
+                 m_bIsStatic, m_uGeometryHash].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     /*--------------------------------------------------------------------
       TODO: Renderable::Renderable definition (remove the comment)
@@ -36,6 +39,10 @@ namespace library
         , m_pixelShader(nullptr)
         , m_padding()
         , m_bHasNormalMap(FALSE)
+        , m_localBounds()
+        , m_bIsOccluder(FALSE)
+        , m_bIsStatic(FALSE)
+        , m_uGeometryHash(0u)
     {
 
     }
@@ -53,7 +60,7 @@ namespace library
                   File name of the texture to usen
 
       Modifies: [m_vertexBuffer, m_normalBuffer, m_indexBuffer
-                 m_constantBuffer].
+                 m_constantBuffer, m_localBounds, m_uGeometryHash].
 
       Returns:  HRESULT
                   Status code
@@ -119,6 +126,33 @@ namespace library
             return hr;
         }
 
+        if (GetNumVertices() > 0u)
+        {
+            BoundingBox::CreateFromPoints(m_localBounds, GetNumVertices(), &getVertices()->Position, sizeof(SimpleVertex));
+        }
+
+        // 64-bit FNV-1a of the vertices, tangent frames and indices, so
+        // copies of the same shape can be found without comparing their
+        // buffers first
+        constexpr UINT64 FNV_OFFSET_BASIS = 14695981039346656037ull;
+        constexpr UINT64 FNV_PRIME = 1099511628211ull;
+        m_uGeometryHash = FNV_OFFSET_BASIS ^ (static_cast<UINT64>(GetNumVertices()) << 32u | GetNumIndices());
+        const BYTE* pVertexBytes = reinterpret_cast<const BYTE*>(getVertices());
+        for (size_t i = 0u; i < GetNumVertices() * sizeof(SimpleVertex); ++i)
+        {
+            m_uGeometryHash = (m_uGeometryHash ^ pVertexBytes[i]) * FNV_PRIME;
+        }
+        const BYTE* pNormalBytes = reinterpret_cast<const BYTE*>(m_aNormalData.data());
+        for (size_t i = 0u; i < m_aNormalData.size() * sizeof(NormalData); ++i)
+        {
+            m_uGeometryHash = (m_uGeometryHash ^ pNormalBytes[i]) * FNV_PRIME;
+        }
+        const BYTE* pIndexBytes = reinterpret_cast<const BYTE*>(getIndices());
+        for (size_t i = 0u; i < GetNumIndices() * sizeof(WORD); ++i)
+        {
+            m_uGeometryHash = (m_uGeometryHash ^ pIndexBytes[i]) * FNV_PRIME;
+        }
+
         return hr;
     }
 
@@ -379,6 +413,16 @@ namespace library
     {
         return m_pixelShader->PixelShader::GetPixelShader();
     }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetInstancedVertexShader
+      Summary:  Returns the instanced variant of the vertex shader
+      Returns:  const std::shared_ptr<VertexShader>&
+                  Instanced vertex shader. Could be a nullptr
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::shared_ptr<VertexShader>& Renderable::GetInstancedVertexShader() const
+    {
+        return m_vertexShader->GetInstancedVertexShader();
+    }
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::GetVertexLayout
       Summary:  Returns the vertex input layout
@@ -444,6 +488,112 @@ namespace library
     {
         return m_world;
     }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetBounds
+      Summary:  Returns the world space bounding box. The local box is
+                computed from the vertices when the renderable is
+                initialized and moved along with the world matrix
+      Returns:  BoundingBox
+                  World space bounding box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BoundingBox Renderable::GetBounds() const
+    {
+        BoundingBox bounds;
+        m_localBounds.Transform(bounds, m_world);
+
+        return bounds;
+    }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::SetOccluder
+      Summary:  Sets whether the renderable is drawn into the occlusion
+                depth buffer. Only large, solid and closed meshes make
+                good occluders
+      Args:     BOOL bIsOccluder
+                  Whether the renderable is an occluder
+      Modifies: [m_bIsOccluder].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::SetOccluder(_In_ BOOL bIsOccluder)
+    {
+        m_bIsOccluder = bIsOccluder;
+    }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::IsOccluder
+      Summary:  Returns whether the renderable is an occluder
+      Returns:  BOOL
+                  Whether the renderable is an occluder
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Renderable::IsOccluder() const
+    {
+        return m_bIsOccluder;
+    }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::SetStatic
+      Summary:  Sets whether the renderable never moves once it is
+                added to a scene. The shadows of static renderables
+                are cached with the terrain instead of being drawn
+                every frame
+      Args:     BOOL bIsStatic
+                  Whether the renderable is static
+      Modifies: [m_bIsStatic].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::SetStatic(_In_ BOOL bIsStatic)
+    {
+        m_bIsStatic = bIsStatic;
+    }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::IsStatic
+      Summary:  Returns whether the renderable never moves
+      Returns:  BOOL
+                  Whether the renderable is static
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Renderable::IsStatic() const
+    {
+        return m_bIsStatic;
+    }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::AddOccluderTo
+      Summary:  Adds the triangles of the renderable, moved by the
+                world matrix, to an occlusion rasterizer. The vertices
+                are the ones given at initialization, so animated
+                meshes occlude in their bind pose
+      Args:     OcclusionRasterizer& occlusionRasterizer
+                  Rasterizer to draw the triangles into
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::AddOccluderTo(_Inout_ OcclusionRasterizer& occlusionRasterizer) const
+    {
+        if (GetNumIndices() == 0u)
+        {
+            return;
+        }
+
+        XMFLOAT4X4 world;
+        XMStoreFloat4x4(&world, m_world);
+        if (m_aMeshes.empty())
+        {
+            occlusionRasterizer.AddOccluderTriangles(
+                &getVertices()->Position.x,
+                sizeof(SimpleVertex),
+                getIndices(),
+                GetNumIndices(),
+                &world.m[0][0]
+            );
+
+            return;
+        }
+
+        // Indices of each mesh are relative to its base vertex
+        for (const BasicMeshEntry& mesh : m_aMeshes)
+        {
+            occlusionRasterizer.AddOccluderTriangles(
+                &getVertices()[mesh.uBaseVertex].Position.x,
+                sizeof(SimpleVertex),
+                getIndices() + mesh.uBaseIndex,
+                mesh.uNumIndices,
+                &world.m[0][0]
+            );
+        }
+    }
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::GetOutputColor
       Summary:  Returns the output color
@@ -458,6 +608,110 @@ namespace library
         return m_outputColor;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetGeometryHash
+
+      Summary:  Returns the hash of the vertices, tangent frames and
+                indices
+
+      Returns:  UINT64
+                  Geometry hash, 0 before initialization
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 Renderable::GetGeometryHash() const
+    {
+        return m_uGeometryHash;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::CompareInstancingKey
+
+      Summary:  Orders renderables by everything CanInstanceWith
+                requires to match except the geometry itself, which is
+                ordered by its hash. Sorting by this key puts every
+                group of renderables that can be instanced together
+                next to each other
+
+      Args:     const Renderable& other
+                  Renderable to compare to
+
+      Returns:  INT
+                  Negative if this renderable comes first, positive if
+                  the other one does, 0 if the keys are equal
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    INT Renderable::CompareInstancingKey(_In_ const Renderable& other) const
+    {
+        const auto key = std::make_tuple(
+            m_uGeometryHash, GetNumVertices(), GetNumIndices(), m_vertexShader.get(), m_pixelShader.get(),
+            m_bHasNormalMap, m_aMaterials.size(), m_aMeshes.size()
+        );
+        const auto otherKey = std::make_tuple(
+            other.m_uGeometryHash, other.GetNumVertices(), other.GetNumIndices(), other.m_vertexShader.get(), other.m_pixelShader.get(),
+            other.m_bHasNormalMap, other.m_aMaterials.size(), other.m_aMeshes.size()
+        );
+        if (key != otherKey)
+        {
+            return key < otherKey ? -1 : 1;
+        }
+
+        for (size_t i = 0u; i < m_aMaterials.size(); ++i)
+        {
+            if (m_aMaterials[i] != other.m_aMaterials[i])
+            {
+                return m_aMaterials[i] < other.m_aMaterials[i] ? -1 : 1;
+            }
+        }
+
+        for (size_t i = 0u; i < m_aMeshes.size(); ++i)
+        {
+            const BasicMeshEntry& mesh = m_aMeshes[i];
+            const BasicMeshEntry& otherMesh = other.m_aMeshes[i];
+            const auto meshKey = std::make_tuple(mesh.uNumIndices, mesh.uBaseVertex, mesh.uBaseIndex, mesh.uMaterialIndex);
+            const auto otherMeshKey = std::make_tuple(otherMesh.uNumIndices, otherMesh.uBaseVertex, otherMesh.uBaseIndex, otherMesh.uMaterialIndex);
+            if (meshKey != otherMeshKey)
+            {
+                return meshKey < otherMeshKey ? -1 : 1;
+            }
+        }
+
+        return memcmp(&m_outputColor, &other.m_outputColor, sizeof(m_outputColor));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::CanInstanceWith
+
+      Summary:  Returns whether the other renderable only differs in
+                its world matrix, so one instanced draw of this
+                renderable's buffers can draw both. Renderables that
+                share their buffers have the same geometry, otherwise
+                equal hashes are confirmed by comparing the vertices,
+                tangent frames and indices
+
+      Args:     const Renderable& other
+                  Renderable to compare to
+
+      Returns:  BOOL
+                  TRUE if both can be drawn as instances
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Renderable::CanInstanceWith(_In_ const Renderable& other) const
+    {
+        if (CompareInstancingKey(other) != 0)
+        {
+            return FALSE;
+        }
+
+        if (m_vertexBuffer && m_vertexBuffer == other.m_vertexBuffer
+            && m_normalBuffer == other.m_normalBuffer
+            && m_indexBuffer == other.m_indexBuffer)
+        {
+            return TRUE;
+        }
+
+        return m_aNormalData.size() == other.m_aNormalData.size()
+            && memcmp(getVertices(), other.getVertices(), GetNumVertices() * sizeof(SimpleVertex)) == 0
+            && memcmp(m_aNormalData.data(), other.m_aNormalData.data(), m_aNormalData.size() * sizeof(NormalData)) == 0
+            && memcmp(getIndices(), other.getIndices(), GetNumIndices() * sizeof(WORD)) == 0;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::HasTexture
       Summary:  Returns whether the renderable has texture
@@ -13,7 +13,10 @@
 
 #include "Common.h"
 
+#include <DirectXCollision.h>
+
 #include "Renderer/DataTypes.h"
+#include "Renderer/OcclusionRasterizer.h"
 #include "Shader/PixelShader.h"
 #include "Shader/VertexShader.h"
 #include "Texture/Material.h"
@@ -39,6 +42,29 @@ namespace library
                   Returns the constant buffer
                 GetWorldMatrix
                   Returns the world matrix
+                GetBounds
+                  Returns the world space bounding box
+                SetOccluder
+                  Sets whether the renderable hides what is behind it
+                IsOccluder
+                  Returns whether the renderable is an occluder
+                AddOccluderTo
+                  Adds the triangles to an occlusion rasterizer
+                SetStatic
+                  Sets whether the renderable never moves
+                IsStatic
+                  Returns whether the renderable never moves
+                GetInstancedVertexShader
+                  Returns the instanced variant of the vertex shader
+                GetGeometryHash
+                  Returns the hash of the vertices, tangent frames and
+                  indices
+                CompareInstancingKey
+                  Orders renderables so the ones that can be instanced
+                  together are next to each other
+                CanInstanceWith
+                  Returns whether both renderables can be drawn by one
+                  instanced draw
                 GetNumVertices
                   Pure virtual function that returns the number of
                   vertices
@@ -92,12 +118,22 @@ namespace library
         ComPtr<ID3D11VertexShader>& GetVertexShader();
         ComPtr<ID3D11PixelShader>& GetPixelShader();
         ComPtr<ID3D11InputLayout>& GetVertexLayout();
+        const std::shared_ptr<VertexShader>& GetInstancedVertexShader() const;
         ComPtr<ID3D11Buffer>& GetVertexBuffer();
         ComPtr<ID3D11Buffer>& GetIndexBuffer();
         ComPtr<ID3D11Buffer>& GetConstantBuffer();
         ComPtr<ID3D11Buffer>& GetNormalBuffer();
 
         const XMMATRIX& GetWorldMatrix() const;
+        virtual BoundingBox GetBounds() const;
+        void SetOccluder(_In_ BOOL bIsOccluder);
+        BOOL IsOccluder() const;
+        void AddOccluderTo(_Inout_ OcclusionRasterizer& occlusionRasterizer) const;
+        void SetStatic(_In_ BOOL bIsStatic);
+        BOOL IsStatic() const;
+        UINT64 GetGeometryHash() const;
+        INT CompareInstancingKey(_In_ const Renderable& other) const;
+        BOOL CanInstanceWith(_In_ const Renderable& other) const;
         const XMFLOAT4& GetOutputColor() const;
         BOOL HasTexture() const;
         const std::shared_ptr<Material>& GetMaterial(UINT uIndex) const;
@@ -145,5 +181,9 @@ namespace library
         BYTE m_padding[8];
         XMMATRIX m_world;
         BOOL m_bHasNormalMap;
+        BoundingBox m_localBounds;
+        BOOL m_bIsOccluder;
+        BOOL m_bIsStatic;
+        UINT64 m_uGeometryHash;
     };
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Renderer/Renderer.h"
 
+#include <algorithm>
+
 namespace library
 {
 
@@ -11,10 +13,26 @@ namespace library
       Modifies: [m_driverType, m_featureLevel, m_d3dDevice, m_d3dDevice1,
                   m_immediateContext, m_immediateContext1, m_swapChain,
                   m_swapChain1, m_renderTargetView, m_depthStencil,
-                  m_depthStencilView, m_cbChangeOnResize, m_cbShadowMatrix,
-                  m_pszMainSceneName, m_camera, m_projection, m_scenes
-                  m_invalidTexture, m_shadowMapTexture, m_shadowVertexShader,
-                  m_shadowPixelShader].
+                  m_depthStencilView, m_viewport, m_cbChangeOnResize,
+                  m_cbShadowMatrix, m_cbShadowCascades,
+                  m_pszMainSceneName, m_camera, m_projection, m_scenes,
+                  m_mainScene,
+                  m_invalidTexture, m_shadowMap, m_staticShadowMap,
+                  m_uShadowMapSize, m_shadowMapFormat,
+                  m_shadowVertexShader, m_shadowQuantizedVertexShader,
+                  m_shadowCascades, m_shadowCuller, m_staticShadowCuller,
+                  m_staticShadowView, m_aStaticShadowProjections,
+                  m_uStaticShadowVersion, m_bStaticShadowValid,
+                  m_lightClusterer, m_cbLightClusters,
+                  m_depthEqualState, m_bDepthPrepass,
+                  m_frustumCuller, m_occlusionRasterizer,
+                  m_threadPool, m_uNumOccluded, m_renderQueue, m_aDrawCalls,
+                  m_stateCache, m_constantBufferRing, m_d3d11CommandContext,
+                  m_recordingCommandContext, m_pCommandContext,
+                  m_commandStreamAnalyzer, m_aRecordingWorkers,
+                  m_uNumCommandLists, m_instanceBuffer,
+                  m_uInstanceBufferCapacity, m_aInstanceCandidates,
+                  m_aInstances].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     /*--------------------------------------------------------------------
       TODO: Renderer::Renderer definition (remove the comment)
@@ -31,18 +49,53 @@ namespace library
         , m_renderTargetView()
         , m_depthStencil()
         , m_depthStencilView()
+        , m_viewport()
         , m_cbChangeOnResize()
         , m_cbLights()
         , m_cbShadowMatrix()
+        , m_cbShadowCascades()
+        , m_cbLightClusters()
         , m_pszMainSceneName(nullptr)
         , m_padding{ '\0' }
+        , m_frustumCuller()
+        , m_occlusionRasterizer()
+        , m_threadPool()
+        , m_uNumOccluded(0u)
+        , m_renderQueue()
+        , m_aDrawCalls()
+        , m_stateCache()
+        , m_constantBufferRing()
+        , m_d3d11CommandContext()
+        , m_recordingCommandContext()
+        , m_pCommandContext(nullptr)
+        , m_commandStreamAnalyzer()
+        , m_aRecordingWorkers()
+        , m_uNumCommandLists(0u)
+        , m_instanceBuffer()
+        , m_uInstanceBufferCapacity(0u)
+        , m_aInstanceCandidates()
+        , m_aInstances()
         , m_camera(XMVectorSet(0.0f, 3.0f, -6.0f, 0.0f))
         , m_projection()
         , m_scenes()
+        , m_mainScene()
         , m_invalidTexture(std::make_shared<Texture>(L"Content/Common/InvalidTexture.png"))
-        , m_shadowMapTexture()
-        , m_shadowPixelShader()
+        , m_shadowMap()
+        , m_staticShadowMap()
+        , m_uShadowMapSize(DEFAULT_SHADOW_MAP_SIZE)
+        , m_shadowMapFormat(DEFAULT_SHADOW_MAP_FORMAT)
         , m_shadowVertexShader()
+        , m_shadowQuantizedVertexShader()
+        , m_shadowCascades()
+        , m_shadowCuller()
+        , m_staticShadowCuller()
+        , m_staticShadowView(XMMatrixIdentity())
+        , m_aStaticShadowProjections()
+        , m_uStaticShadowVersion(0u)
+        , m_bStaticShadowValid(FALSE)
+        , m_lightClusterer()
+        , m_depthEqualState()
+        , m_bDepthPrepass(FALSE)
     {
     }
 
@@ -58,7 +111,9 @@ namespace library
                   m_d3dDevice1, m_immediateContext1, m_swapChain1,
                   m_swapChain, m_renderTargetView, m_vertexShader,
                   m_vertexLayout, m_pixelShader, m_vertexBuffer
-                  m_cbShadowMatrix].
+                  m_cbShadowMatrix, m_constantBufferRing,
+                  m_d3d11CommandContext, m_pCommandContext,
+                  m_aRecordingWorkers].
 
       Returns:  HRESULT
                   Status code
@@ -68,13 +123,72 @@ namespace library
     --------------------------------------------------------------------*/
     HRESULT Renderer::Initialize(_In_ HWND hWnd)
     {
-        HRESULT hr = S_OK;
-
         RECT rc;
         GetClientRect(hWnd, &rc);
         UINT uWidth = static_cast<UINT>(rc.right - rc.left);
         UINT uHeight = static_cast<UINT>(rc.bottom - rc.top);
 
+        return initialize(hWnd, uWidth, uHeight);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::InitializeHeadless
+
+      Summary:  Creates a Direct3D device without a window. The null
+                driver is tried first, then WARP. Scene resources are
+                created on the device as usual, but the binds, uploads
+                and draws of each frame only go to a recording command
+                context, so Render measures the CPU side of the frame
+
+      Args:     UINT uWidth
+                  Width of the frame
+                UINT uHeight
+                  Height of the frame
+
+      Modifies: [m_d3dDevice, m_featureLevel, m_immediateContext,
+                  m_d3dDevice1, m_immediateContext1, m_renderTargetView,
+                  m_cbShadowMatrix, m_constantBufferRing,
+                  m_pCommandContext, m_aRecordingWorkers].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Renderer::InitializeHeadless(_In_ UINT uWidth, _In_ UINT uHeight)
+    {
+        return initialize(nullptr, uWidth, uHeight);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::initialize
+
+      Summary:  Creates Direct3D device, and a swap chain when there is
+                a window. Without a window the frame is drawn to an
+                offscreen texture through the recording command context
+
+      Args:     HWND hWnd
+                  Handle to the window, null when headless
+                UINT uWidth
+                  Width of the frame
+                UINT uHeight
+                  Height of the frame
+
+      Modifies: [m_d3dDevice, m_featureLevel, m_immediateContext,
+                  m_d3dDevice1, m_immediateContext1, m_swapChain1,
+                  m_swapChain, m_renderTargetView, m_viewport,
+                  m_cbShadowMatrix, m_cbShadowCascades,
+                  m_cbLightClusters, m_lightClusterer,
+                  m_depthEqualState, m_constantBufferRing, m_d3d11CommandContext,
+                  m_pCommandContext, m_aRecordingWorkers, m_shadowMap,
+                  m_staticShadowMap,
+                  m_shadowVertexShader, m_shadowQuantizedVertexShader].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Renderer::initialize(_In_opt_ HWND hWnd, _In_ UINT uWidth, _In_ UINT uHeight)
+    {
+        HRESULT hr = S_OK;
+
         UINT uCreateDeviceFlags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
 #if defined(DEBUG) || defined(_DEBUG)
         uCreateDeviceFlags |= D3D11_CREATE_DEVICE_DEBUG;
@@ -87,6 +201,12 @@ namespace library
             D3D_DRIVER_TYPE_REFERENCE,
         };
         UINT numDriverTypes = ARRAYSIZE(driverTypes);
+        if (!hWnd)
+        {
+            // Nothing is drawn, so no GPU is needed
+            driverTypes[0] = D3D_DRIVER_TYPE_NULL;
+            numDriverTypes = 2u;
+        }
 
         D3D_FEATURE_LEVEL featureLevels[] =
         {
@@ -120,84 +240,54 @@ namespace library
             return hr;
         }
 
-        // Obtain DXGI factory from device (since we used nullptr for pAdapter above)
-        ComPtr<IDXGIFactory1> dxgiFactory;
+        // DirectX 11.1 or later
+        if (SUCCEEDED(m_d3dDevice.As(&m_d3dDevice1)))
         {
-            ComPtr<IDXGIDevice> dxgiDevice;
-            hr = m_d3dDevice.As(&dxgiDevice);
-            if (SUCCEEDED(hr))
-            {
-                ComPtr<IDXGIAdapter> adapter;
-                hr = dxgiDevice->GetAdapter(&adapter);
-                if (SUCCEEDED(hr))
-                {
-                    hr = adapter->GetParent(IID_PPV_ARGS(&dxgiFactory));
-                }
-            }
+            m_immediateContext.As(&m_immediateContext1);
         }
-        if (FAILED(hr))
+
+        m_d3d11CommandContext.Initialize(m_immediateContext.Get(), m_immediateContext1.Get());
+        m_pCommandContext = &m_d3d11CommandContext;
+
+        // Nothing runs on the GPU when headless, so there is nothing to
+        // time. A device that cannot create the timestamp queries only
+        // loses the GPU zones of the profiler
+        if (hWnd)
         {
-            return hr;
+            Profiler::Get().Initialize(m_d3dDevice.Get());
         }
 
-        // Create swap chain
-        ComPtr<IDXGIFactory2> dxgiFactory2;
-        hr = dxgiFactory.As(&dxgiFactory2);
-        if (SUCCEEDED(hr))
+        ComPtr<ID3D11Texture2D> pBackBuffer;
+        if (!hWnd)
         {
-            // DirectX 11.1 or later
-            hr = m_d3dDevice.As(&m_d3dDevice1);
-            if (SUCCEEDED(hr))
-            {
-                m_immediateContext.As(&m_immediateContext1);
-            }
+            m_pCommandContext = &m_recordingCommandContext;
 
-            DXGI_SWAP_CHAIN_DESC1 sd =
+            D3D11_TEXTURE2D_DESC descBackBuffer =
             {
                 .Width = uWidth,
                 .Height = uHeight,
+                .MipLevels = 1u,
+                .ArraySize = 1u,
                 .Format = DXGI_FORMAT_R8G8B8A8_UNORM,
                 .SampleDesc = {.Count = 1u, .Quality = 0u },
-                .BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT,
-                .BufferCount = 1u
+                .Usage = D3D11_USAGE_DEFAULT,
+                .BindFlags = D3D11_BIND_RENDER_TARGET,
+                .CPUAccessFlags = 0u,
+                .MiscFlags = 0u
             };
-
-            hr = dxgiFactory2->CreateSwapChainForHwnd(m_d3dDevice.Get(), hWnd, &sd, nullptr, nullptr, m_swapChain1.GetAddressOf());
-            if (SUCCEEDED(hr))
+            hr = m_d3dDevice->CreateTexture2D(&descBackBuffer, nullptr, pBackBuffer.GetAddressOf());
+            if (FAILED(hr))
             {
-                hr = m_swapChain1.As(&m_swapChain);
+                return hr;
             }
         }
         else
         {
-            // DirectX 11.0 systems
-            DXGI_SWAP_CHAIN_DESC sd =
+            hr = createSwapChain(hWnd, uWidth, uHeight, pBackBuffer.GetAddressOf());
+            if (FAILED(hr))
             {
-                .BufferDesc = {.Width = uWidth, .Height = uHeight, .RefreshRate = {.Numerator = 60, .Denominator = 1 }, .Format = DXGI_FORMAT_R8G8B8A8_UNORM },
-                .SampleDesc = {.Count = 1, .Quality = 0 },
-                .BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT,
-                .BufferCount = 1u,
-                .OutputWindow = hWnd,
-                .Windowed = TRUE
-            };
-
-            hr = dxgiFactory->CreateSwapChain(m_d3dDevice.Get(), &sd, m_swapChain.GetAddressOf());
-        }
-
-        // Note this tutorial doesn't handle full-screen swapchains so we block the ALT+ENTER shortcut
-        dxgiFactory->MakeWindowAssociation(hWnd, DXGI_MWA_NO_ALT_ENTER);
-
-        if (FAILED(hr))
-        {
-            return hr;
-        }
-
-        // Create a render target view
-        ComPtr<ID3D11Texture2D> pBackBuffer;
-        hr = m_swapChain->GetBuffer(0, IID_PPV_ARGS(&pBackBuffer));
-        if (FAILED(hr))
-        {
-            return hr;
+                return hr;
+            }
         }
 
         hr = m_d3dDevice->CreateRenderTargetView(pBackBuffer.Get(), nullptr, m_renderTargetView.GetAddressOf());
@@ -239,10 +329,10 @@ namespace library
             return hr;
         }
 
-        m_immediateContext->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), m_depthStencilView.Get());
-
-        // Setup the viewport
-        D3D11_VIEWPORT vp =
+        // Setup the viewport. It is set with the render targets at the
+        // start of every frame and every command list, as executing a
+        // command list clears the state of the immediate context
+        m_viewport =
         {
             .TopLeftX = 0.0f,
             .TopLeftY = 0.0f,
@@ -251,11 +341,6 @@ namespace library
             .MinDepth = 0.0f,
             .MaxDepth = 1.0f,
         };
-        
-        m_immediateContext->RSSetViewports(1, &vp);
-
-        // Set primitive topology
-        m_immediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
         // Create the constant buffers
         D3D11_BUFFER_DESC bd =
@@ -272,7 +357,7 @@ namespace library
         }
 
         // Initialize the projection matrix
-        m_projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, static_cast<FLOAT>(uWidth) / static_cast<FLOAT>(uHeight), 0.01f, 1000.0f);
+        m_projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, static_cast<FLOAT>(uWidth) / static_cast<FLOAT>(uHeight), NEAR_PLANE, FAR_PLANE);
 
         CBChangeOnResize cbChangesOnResize =
         {
@@ -298,7 +383,63 @@ namespace library
             return hr;
         }
 
-        m_shadowMapTexture = std::make_shared<RenderTexture>(uWidth, uHeight);
+        bd.ByteWidth = sizeof(CBShadowCascades);
+        hr = m_d3dDevice->CreateBuffer(&bd, nullptr, m_cbShadowCascades.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        bd.ByteWidth = sizeof(CBLightClusters);
+        hr = m_d3dDevice->CreateBuffer(&bd, nullptr, m_cbLightClusters.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        hr = m_lightClusterer.Initialize(m_d3dDevice.Get());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        // After the depth pre-pass the main pass only shades the
+        // surface whose depth is already in the buffer
+        D3D11_DEPTH_STENCIL_DESC depthStencilDesc = {
+            .DepthEnable = TRUE,
+            .DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO,
+            .DepthFunc = D3D11_COMPARISON_EQUAL,
+            .StencilEnable = FALSE
+        };
+        hr = m_d3dDevice->CreateDepthStencilState(&depthStencilDesc, m_depthEqualState.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        // The per-object constants are streamed through a ring when the
+        // device can bind ranges of a constant buffer. Otherwise every
+        // object keeps uploading its own constant buffers
+        if (m_immediateContext1)
+        {
+            hr = m_constantBufferRing.Initialize(m_d3dDevice.Get());
+            if (FAILED(hr) && hr != E_NOTIMPL)
+            {
+                return hr;
+            }
+        }
+
+        hr = createRecordingWorkers();
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        // The shadow map is sized on its own, the size of the window
+        // does not change the resolution of the shadows. The static
+        // layer is kept in a second one and copied into the first
+        m_shadowMap = std::make_shared<ShadowMap>(m_uShadowMapSize, m_shadowMapFormat, NUM_CASCADES);
+        m_staticShadowMap = std::make_shared<ShadowMap>(m_uShadowMapSize, m_shadowMapFormat, NUM_CASCADES);
         m_camera.Initialize(m_d3dDevice.Get());
 
         if (!m_scenes.contains(m_pszMainSceneName))
@@ -306,7 +447,7 @@ namespace library
             return E_FAIL;
         }
 
-        hr = m_scenes[m_pszMainSceneName]->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
+        hr = m_mainScene->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
         if (FAILED(hr))
         {
             return hr;
@@ -318,108 +459,397 @@ namespace library
             return hr;
         }
 
-        hr = m_shadowMapTexture->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
+        hr = m_shadowMap->Initialize(m_d3dDevice.Get());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        hr = m_staticShadowMap->Initialize(m_d3dDevice.Get());
         if (FAILED(hr))
         {
             return hr;
         }
-        
-        /*for (UINT i = 0; i < NUM_LIGHTS; i++)
+
+        if (m_shadowVertexShader)
+        {
+            hr = m_shadowVertexShader->Initialize(m_d3dDevice.Get());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        if (m_shadowQuantizedVertexShader)
         {
-            m_scenes[m_pszMainSceneName]->GetPointLight(i)->Initialize(uWidth, uHeight);
-        }*/
-        
+            hr = m_shadowQuantizedVertexShader->Initialize(m_d3dDevice.Get());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
         return S_OK;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Renderer::SetShadowMapShaders
+      Method:   Renderer::createSwapChain
 
-      Summary:  Set shaders for the shadow mapping
+      Summary:  Creates the swap chain of the window
 
-      Args:     std::shared_ptr<ShadowVertexShader>
-                  vertex shader
-                std::shared_ptr<PixelShader>
-                  pixel shader
+      Args:     HWND hWnd
+                  Handle to the window
+                UINT uWidth
+                  Width of the back buffer
+                UINT uHeight
+                  Height of the back buffer
+                ID3D11Texture2D** ppBackBuffer
+                  Receives the back buffer
 
-      Modifies: [m_shadowVertexShader, m_shadowPixelShader].
-    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void Renderer::SetShadowMapShaders(_In_ std::shared_ptr<ShadowVertexShader> vertexShader, _In_ std::shared_ptr<PixelShader> pixelShader)
-    {
-        m_shadowVertexShader = move(vertexShader);
-        m_shadowPixelShader = move(pixelShader);
-    }
+      Modifies: [m_swapChain, m_swapChain1].
 
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Renderer::AddScene
-      Summary:  Add scene to renderer
-      Args:     PCWSTR pszSceneName
-                  The name of the scene
-                const std::shared_ptr<Scene>&
-                  The shared pointer to Scene
-      Modifies: [m_scenes].
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Renderer::AddScene(_In_ PCWSTR pszSceneName, _In_ const std::shared_ptr<Scene>& scene)
+    HRESULT Renderer::createSwapChain(_In_ HWND hWnd, _In_ UINT uWidth, _In_ UINT uHeight, _Outptr_ ID3D11Texture2D** ppBackBuffer)
     {
-        if (m_scenes.contains(pszSceneName))
+        HRESULT hr = S_OK;
+
+        // Obtain DXGI factory from device (since we used nullptr for pAdapter above)
+        ComPtr<IDXGIFactory1> dxgiFactory;
         {
-            return E_FAIL;
+            ComPtr<IDXGIDevice> dxgiDevice;
+            hr = m_d3dDevice.As(&dxgiDevice);
+            if (SUCCEEDED(hr))
+            {
+                ComPtr<IDXGIAdapter> adapter;
+                hr = dxgiDevice->GetAdapter(&adapter);
+                if (SUCCEEDED(hr))
+                {
+                    hr = adapter->GetParent(IID_PPV_ARGS(&dxgiFactory));
+                }
+            }
+        }
+        if (FAILED(hr))
+        {
+            return hr;
         }
 
-        m_scenes[pszSceneName] = scene;
+        // Create swap chain
+        ComPtr<IDXGIFactory2> dxgiFactory2;
+        hr = dxgiFactory.As(&dxgiFactory2);
+        if (SUCCEEDED(hr))
+        {
+            // DirectX 11.1 or later
+            DXGI_SWAP_CHAIN_DESC1 sd =
+            {
+                .Width = uWidth,
+                .Height = uHeight,
+                .Format = DXGI_FORMAT_R8G8B8A8_UNORM,
+                .SampleDesc = {.Count = 1u, .Quality = 0u },
+                .BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT,
+                .BufferCount = 1u
+            };
 
-        return S_OK;
-    }
+            hr = dxgiFactory2->CreateSwapChainForHwnd(m_d3dDevice.Get(), hWnd, &sd, nullptr, nullptr, m_swapChain1.GetAddressOf());
+            if (SUCCEEDED(hr))
+            {
+                hr = m_swapChain1.As(&m_swapChain);
+            }
+        }
+        else
+        {
+            // DirectX 11.0 systems
+            DXGI_SWAP_CHAIN_DESC sd =
+            {
+                .BufferDesc = {.Width = uWidth, .Height = uHeight, .RefreshRate = {.Numerator = 60, .Denominator = 1 }, .Format = DXGI_FORMAT_R8G8B8A8_UNORM },
+                .SampleDesc = {.Count = 1, .Quality = 0 },
+                .BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT,
+                .BufferCount = 1u,
+                .OutputWindow = hWnd,
+                .Windowed = TRUE
+            };
 
+            hr = dxgiFactory->CreateSwapChain(m_d3dDevice.Get(), &sd, m_swapChain.GetAddressOf());
+        }
 
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Renderer::GetSceneOrNull
-      Summary:  Return scene with the given name or null
-      Args:     PCWSTR pszSceneName
-                  The name of the scene
-      Returns:  std::shared_ptr<Scene>
-                  The shared pointer to Scene
-    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    std::shared_ptr<Scene> Renderer::GetSceneOrNull(_In_ PCWSTR pszSceneName)
-    {
-        if (m_scenes.contains(pszSceneName))
+        // Note this tutorial doesn't handle full-screen swapchains so we block the ALT+ENTER shortcut
+        dxgiFactory->MakeWindowAssociation(hWnd, DXGI_MWA_NO_ALT_ENTER);
+
+        if (FAILED(hr))
         {
-            return m_scenes[pszSceneName];
+            return hr;
         }
 
-        return nullptr;
+        return m_swapChain->GetBuffer(0, IID_PPV_ARGS(ppBackBuffer));
     }
 
-
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Renderer::SetMainScene
-      Summary:  Set the main scene
-      Args:     PCWSTR pszSceneName
-                  The name of the scene
-      Modifies: [m_pszMainSceneName].
+      Method:   Renderer::createRecordingWorkers
+
+      Summary:  Creates a recording worker for every thread that runs
+                batches of the thread pool, including the calling
+                thread. Each gets its own deferred context, or records
+                into its own list of commands when headless. When the
+                device cannot create deferred contexts no worker is
+                created and the draws are recorded on the immediate
+                context
+
+      Modifies: [m_aRecordingWorkers].
+
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Renderer::SetMainScene(_In_ PCWSTR pszSceneName)
+    HRESULT Renderer::createRecordingWorkers()
     {
-        if (!m_scenes.contains(pszSceneName))
+        m_aRecordingWorkers.clear();
+
+        const UINT uNumWorkers = m_threadPool.GetNumThreads() + 1u;
+        for (UINT i = 0u; i < uNumWorkers; ++i)
         {
-            return E_FAIL;
-        }
+            std::unique_ptr<RecordingWorker> worker = std::make_unique<RecordingWorker>();
+            worker->pContext = &worker->RecordingContext;
+            if (!IsHeadless())
+            {
+                if (FAILED(m_d3dDevice->CreateDeferredContext(0u, worker->DeferredContext.GetAddressOf())))
+                {
+                    m_aRecordingWorkers.clear();
+                    return S_OK;
+                }
+                worker->DeferredContext.As(&worker->DeferredContext1);
+                worker->D3D11Context.Initialize(worker->DeferredContext.Get(), worker->DeferredContext1.Get());
+                worker->pContext = &worker->D3D11Context;
+            }
 
-        m_pszMainSceneName = pszSceneName;
+            m_aRecordingWorkers.push_back(std::move(worker));
+        }
 
         return S_OK;
     }
 
-
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Renderer::HandleInput
-      Summary:  Handle user mouse input
-      Args:     DirectionsInput& directions
-                MouseRelativeMovement& mouseRelativeMovement
+      Method:   Renderer::reserveInstanceBuffer
+
+      Summary:  Makes the instance buffer hold at least the given
+                number of world matrices. The buffer is rewritten
+                every frame, so it is dynamic and grows to twice its
+                capacity when it is too small
+
+      Args:     UINT uNumInstances
+                  Number of instances of the frame
+
+      Modifies: [m_instanceBuffer, m_uInstanceBufferCapacity].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Renderer::reserveInstanceBuffer(_In_ UINT uNumInstances)
+    {
+        if (uNumInstances <= m_uInstanceBufferCapacity)
+        {
+            return S_OK;
+        }
+
+        const UINT uCapacity = (std::max)(uNumInstances, m_uInstanceBufferCapacity * 2u);
+        D3D11_BUFFER_DESC bd =
+        {
+            .ByteWidth = uCapacity * static_cast<UINT>(sizeof(InstanceData)),
+            .Usage = D3D11_USAGE_DYNAMIC,
+            .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+            .CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+            .MiscFlags = 0,
+        };
+
+        ComPtr<ID3D11Buffer> instanceBuffer;
+        HRESULT hr = m_d3dDevice->CreateBuffer(&bd, nullptr, instanceBuffer.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        m_instanceBuffer = std::move(instanceBuffer);
+        m_uInstanceBufferCapacity = uCapacity;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::SetShadowMapShaders
+
+      Summary:  Set shaders for the shadow mapping. The shadow pass
+                only writes depth, so it has no pixel shader. Must be
+                called before the renderer is initialized, without
+                them the shadow map stays clear and nothing is shadowed
+
+      Args:     std::shared_ptr<ShadowVertexShader> vertexShader
+                  Vertex shader of the renderables, models and voxels
+                  with transformation matrices
+                std::shared_ptr<VertexShader> quantizedVertexShader
+                  Vertex shader of the voxels on the grid, with the
+                  input layout of the voxel vertex shader
+
+      Modifies: [m_shadowVertexShader, m_shadowQuantizedVertexShader].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::SetShadowMapShaders(_In_ std::shared_ptr<ShadowVertexShader> vertexShader, _In_ std::shared_ptr<VertexShader> quantizedVertexShader)
+    {
+        m_shadowVertexShader = move(vertexShader);
+        m_shadowQuantizedVertexShader = move(quantizedVertexShader);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::SetShadowMapSize
+
+      Summary:  Sets the width and height of the square shadow map.
+                Must be called before the renderer is initialized
+
+      Args:     UINT uSize
+                  Size of the shadow map in texels
+
+      Modifies: [m_uShadowMapSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::SetShadowMapSize(_In_ UINT uSize)
+    {
+        m_uShadowMapSize = uSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::SetShadowMapFormat
+
+      Summary:  Sets the depth format of the shadow map. 16 bits halve
+                the memory and bandwidth of 32 bits at the cost of
+                depth precision. Must be called before the renderer is
+                initialized
+
+      Args:     DXGI_FORMAT depthFormat
+                  DXGI_FORMAT_D32_FLOAT or DXGI_FORMAT_D16_UNORM
+
+      Modifies: [m_shadowMapFormat].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::SetShadowMapFormat(_In_ DXGI_FORMAT depthFormat)
+    {
+        m_shadowMapFormat = depthFormat;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::SetShadowDistance
+
+      Summary:  Sets the view distance the cascaded shadows end at.
+                Nothing further away is shadowed
+
+      Args:     FLOAT shadowDistance
+                  View depth of the end of the last cascade
+
+      Modifies: [m_shadowCascades].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::SetShadowDistance(_In_ FLOAT shadowDistance)
+    {
+        m_shadowCascades.SetShadowDistance(shadowDistance);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::SetDepthPrepass
+
+      Summary:  Turns the depth pre-pass on or off from the next frame.
+                With it the depth of the visible draws is rendered
+                first with no pixel shader, and the main pass shades
+                each pixel once. It pays off when the pixel shaders
+                are heavy and the geometry is drawn over itself often
+
+      Args:     BOOL bDepthPrepass
+                  Whether the depth pre-pass is rendered
+
+      Modifies: [m_bDepthPrepass].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::SetDepthPrepass(_In_ BOOL bDepthPrepass)
+    {
+        m_bDepthPrepass = bDepthPrepass;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::IsDepthPrepassEnabled
+
+      Summary:  Returns whether the depth pre-pass is rendered
+
+      Returns:  BOOL
+                  Whether the depth pre-pass is on
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Renderer::IsDepthPrepassEnabled() const
+    {
+        return m_bDepthPrepass;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::AddScene
+      Summary:  Add scene to renderer
+      Args:     PCWSTR pszSceneName
+                  The name of the scene
+                const std::shared_ptr<Scene>&
+                  The shared pointer to Scene
+      Modifies: [m_scenes].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Renderer::AddScene(_In_ PCWSTR pszSceneName, _In_ const std::shared_ptr<Scene>& scene)
+    {
+        if (m_scenes.contains(pszSceneName))
+        {
+            return E_FAIL;
+        }
+
+        m_scenes[pszSceneName] = scene;
+
+        return S_OK;
+    }
+
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetSceneOrNull
+      Summary:  Return scene with the given name or null
+      Args:     PCWSTR pszSceneName
+                  The name of the scene
+      Returns:  std::shared_ptr<Scene>
+                  The shared pointer to Scene
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::shared_ptr<Scene> Renderer::GetSceneOrNull(_In_ PCWSTR pszSceneName)
+    {
+        if (m_scenes.contains(pszSceneName))
+        {
+            return m_scenes[pszSceneName];
+        }
+
+        return nullptr;
+    }
+
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::SetMainScene
+      Summary:  Set the main scene. The scene is kept by pointer too,
+                so the frame does not look it up by name
+      Args:     PCWSTR pszSceneName
+                  The name of the scene
+      Modifies: [m_pszMainSceneName, m_mainScene].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Renderer::SetMainScene(_In_ PCWSTR pszSceneName)
+    {
+        if (!m_scenes.contains(pszSceneName))
+        {
+            return E_FAIL;
+        }
+
+        m_pszMainSceneName = pszSceneName;
+        m_mainScene = m_scenes[pszSceneName];
+
+        return S_OK;
+    }
+
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::HandleInput
+      Summary:  Handle user mouse input
+      Args:     DirectionsInput& directions
+                MouseRelativeMovement& mouseRelativeMovement
                 FLOAT deltaTime
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Renderer::HandleInput(_In_ const DirectionsInput& directions, _In_ const MouseRelativeMovement& mouseRelativeMovement, _In_ FLOAT deltaTime)
@@ -436,7 +866,7 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Renderer::Update(_In_ FLOAT deltaTime)
     {
-        m_scenes[m_pszMainSceneName]->Update(deltaTime);
+        m_mainScene->Update(deltaTime);
 
         m_camera.Update(deltaTime);
     }
@@ -445,382 +875,1028 @@ namespace library
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderer::Render
 
-      Summary:  Render the frame
+      Summary:  Render the frame. A headless renderer records the
+                commands of the frame and analyzes them instead of
+                presenting
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     /*--------------------------------------------------------------------
       TODO: Renderer::Render definition (remove the comment)
     --------------------------------------------------------------------*/
     void Renderer::Render()
     {
-        //RenderSceneToTexture();
+        // Terrain edits and streamed tiles are uploaded before anything
+        // is drawn
+        {
+            ProfileScope terrainProfileScope("Terrain upload");
+            m_mainScene->UpdateTerrainStreaming(m_d3dDevice.Get(), m_immediateContext.Get(), m_camera.GetEye(), m_camera.GetForward());
+            m_mainScene->UpdateTerrainBuffers(m_d3dDevice.Get(), m_immediateContext.Get());
+        }
+
+        m_recordingCommandContext.Reset();
+        m_stateCache.BeginFrame(m_pCommandContext);
+        RenderSceneToTexture();
+
+        // The shadow pass has zones of its own, the main pass starts
+        // after it so its time is not counted twice
+        ProfileScope profileScope("Main pass");
+        GpuProfileScope gpuProfileScope(GetProfiledContext(), "Main pass");
         float ClearColor[4] = { 0.0f, 0.125f, 0.6f, 1.0f }; // RGBA
-        m_immediateContext->ClearRenderTargetView(m_renderTargetView.Get(), ClearColor);
-        m_immediateContext->ClearDepthStencilView(m_depthStencilView.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0);
+        m_pCommandContext->ClearRenderTargetView(D3D11CommandContext::ToHandle(m_renderTargetView.Get()), ClearColor);
+        m_pCommandContext->ClearDepthStencilView(D3D11CommandContext::ToHandle(m_depthStencilView.Get()), CommandContext::CLEAR_DEPTH, 1.0f, 0u);
         CBChangeOnResize cbChangesOnResize =
         {
             .Projection = XMMatrixTranspose(m_projection)
         };
-        m_immediateContext->UpdateSubresource(m_cbChangeOnResize.Get(), 0, nullptr, &cbChangesOnResize, 0, 0);
-        m_immediateContext->VSSetConstantBuffers(1u, 1u, m_cbChangeOnResize.GetAddressOf());
-        UINT uStride[2] = {
-            sizeof(SimpleVertex),
-            sizeof(NormalData)
-        };
-        UINT uOffset[2] = { 0, 0 };
-        CBChangeOnCameraMovement Vcb;
+        m_stateCache.UpdateConstantBuffer(m_cbChangeOnResize.Get(), &cbChangesOnResize, sizeof(cbChangesOnResize));
+        CBChangeOnCameraMovement Vcb = {};
         Vcb.View = XMMatrixTranspose(m_camera.GetView());
         XMStoreFloat4(&Vcb.CameraPosition, m_camera.GetEye());
-        m_immediateContext->UpdateSubresource(m_camera.GetConstantBuffer().Get(), 0, NULL, &Vcb, 0, 0);
-        m_immediateContext->VSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
-        CBLights Lcb;
-        for (auto i : m_scenes)
+        m_stateCache.UpdateConstantBuffer(m_camera.GetConstantBuffer().Get(), &Vcb, sizeof(Vcb));
+        // The lights of cbLights are still read by the shaders that do
+        // not go through the clusters
+        CBLights Lcb = {};
+        const std::vector<std::shared_ptr<PointLight>>& aPointLights = m_mainScene->GetPointLights();
+        for (size_t j = 0u; j < (std::min)(aPointLights.size(), static_cast<size_t>(NUM_LIGHTS)); ++j)
+        {
+            const std::shared_ptr<PointLight>& pointLight = aPointLights[j];
+            if (!pointLight)
+            {
+                continue;
+            }
+            FLOAT attenuationDistance = pointLight->GetAttenuationDistance();
+            FLOAT attenuationDistanceSquared = attenuationDistance * attenuationDistance;
+            Lcb.PointLights[j].Position = pointLight->GetPosition();
+            Lcb.PointLights[j].Color = pointLight->GetColor();
+            Lcb.PointLights[j].View = XMMatrixTranspose(pointLight->GetViewMatrix());
+            Lcb.PointLights[j].Projection = XMMatrixTranspose(pointLight->GetProjectionMatrix());
+            Lcb.PointLights[j].AttenuationDistance = XMFLOAT4(
+                attenuationDistance,
+                attenuationDistance,
+                attenuationDistanceSquared,
+                attenuationDistanceSquared);
+        }
+        m_stateCache.UpdateConstantBuffer(m_cbLights.Get(), &Lcb, sizeof(Lcb));
+
+        ProfileZone* pClusteringZone = Profiler::Get().BeginCpuZone("Light clustering");
+        m_lightClusterer.Update(
+            aPointLights,
+            m_camera.GetView(),
+            m_projection,
+            NEAR_PLANE,
+            FAR_PLANE,
+            m_viewport.Width,
+            m_viewport.Height,
+            m_threadPool
+        );
+        m_lightClusterer.Upload(m_pCommandContext);
+        m_stateCache.UpdateConstantBuffer(m_cbLightClusters.Get(), &m_lightClusterer.GetConstants(), sizeof(CBLightClusters));
+        Profiler::Get().EndCpuZone(pClusteringZone);
+
+        bindFrameState(m_stateCache, m_pCommandContext);
+
+        const std::shared_ptr<Skybox>& skybox = m_mainScene->GetSkyBox();
+
+        // Bounds are added in the order the objects are queued below:
+        // renderables, voxels, voxel chunks, then models
+        ProfileZone* pCullingZone = Profiler::Get().BeginCpuZone("Culling");
+        const std::shared_ptr<Scene>& mainScene = m_mainScene;
+        m_frustumCuller.Clear();
+        for (const std::shared_ptr<Renderable>& renderable : mainScene->GetRenderables())
+        {
+            m_frustumCuller.AddBounds(renderable->GetBounds());
+        }
+        for (const std::shared_ptr<Voxel>& voxel : mainScene->GetVoxels())
+        {
+            m_frustumCuller.AddBounds(voxel->GetBounds());
+        }
+        for (const std::shared_ptr<VoxelChunk>& chunk : mainScene->GetVoxelChunks())
+        {
+            m_frustumCuller.AddBounds(chunk->GetBounds());
+        }
+        for (const std::shared_ptr<Model>& model : mainScene->GetModels())
+        {
+            m_frustumCuller.AddBounds(model->GetBounds());
+        }
+        m_frustumCuller.Cull(m_camera.GetView(), m_projection);
+        UINT uBoundsIdx = 0u;
+
+        // Occluders are the solid parts of the voxel chunks and the
+        // renderables and models marked as occluders, if they are in
+        // the frustum. Chunks and models are then tested against them
+        XMFLOAT3 occlusionEye;
+        XMStoreFloat3(&occlusionEye, m_camera.GetEye());
+        XMFLOAT4X4 viewProjection;
+        XMStoreFloat4x4(&viewProjection, XMMatrixMultiply(m_camera.GetView(), m_projection));
+        m_occlusionRasterizer.Begin(&viewProjection.m[0][0]);
+        for (const std::shared_ptr<Renderable>& renderable : mainScene->GetRenderables())
+        {
+            if (m_frustumCuller.IsVisible(uBoundsIdx++) && renderable->IsOccluder())
+            {
+                renderable->AddOccluderTo(m_occlusionRasterizer);
+            }
+        }
+        uBoundsIdx += static_cast<UINT>(mainScene->GetVoxels().size());
+        for (const std::shared_ptr<VoxelChunk>& chunk : mainScene->GetVoxelChunks())
+        {
+            if (m_frustumCuller.IsVisible(uBoundsIdx++) && chunk->HasOccluder())
+            {
+                const BoundingBox& occluderBounds = chunk->GetOccluderBounds();
+                XMFLOAT3 minimum;
+                XMFLOAT3 maximum;
+                XMStoreFloat3(&minimum, XMVectorSubtract(XMLoadFloat3(&occluderBounds.Center), XMLoadFloat3(&occluderBounds.Extents)));
+                XMStoreFloat3(&maximum, XMVectorAdd(XMLoadFloat3(&occluderBounds.Center), XMLoadFloat3(&occluderBounds.Extents)));
+                m_occlusionRasterizer.AddTerrainOccluderBox(&minimum.x, &maximum.x, &occlusionEye.x);
+            }
+        }
+        for (const std::shared_ptr<Model>& model : mainScene->GetModels())
+        {
+            if (m_frustumCuller.IsVisible(uBoundsIdx++) && model->IsOccluder())
+            {
+                model->AddOccluderTo(m_occlusionRasterizer);
+            }
+        }
+        m_occlusionRasterizer.Rasterize(&m_threadPool);
+        Profiler::Get().EndCpuZone(pCullingZone);
+        uBoundsIdx = 0u;
+
+        m_uNumOccluded = 0u;
+        auto isOccluded = [&](const BoundingBox& bounds)
+        {
+            XMFLOAT3 minimum;
+            XMFLOAT3 maximum;
+            XMStoreFloat3(&minimum, XMVectorSubtract(XMLoadFloat3(&bounds.Center), XMLoadFloat3(&bounds.Extents)));
+            XMStoreFloat3(&maximum, XMVectorAdd(XMLoadFloat3(&bounds.Center), XMLoadFloat3(&bounds.Extents)));
+            if (m_occlusionRasterizer.IsVisible(&minimum.x, &maximum.x))
+            {
+                return FALSE;
+            }
+
+            ++m_uNumOccluded;
+            return TRUE;
+        };
+
+        // Every draw is queued with a sort key and submitted in key
+        // order, so draws sharing shaders, materials and textures run
+        // back to back and their state is only bound when it changes
+        ProfileZone* pQueueZone = Profiler::Get().BeginCpuZone("Queue draws");
+        m_renderQueue.Clear();
+        m_aDrawCalls.clear();
+        const XMVECTOR eye = m_camera.GetEye();
+        auto queueDraw = [&](eRenderPass pass, eDrawCallType type, Renderable* pRenderable, UINT uMeshIndex, const Material* pMaterial, const BoundingBox& bounds)
+        {
+            const FLOAT distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&bounds.Center), eye)));
+            const Texture* pTexture = pMaterial ? pMaterial->pDiffuse.get() : nullptr;
+            ID3D11VertexShader* pVertexShader = pRenderable->GetVertexShader().Get();
+            if (type == eDrawCallType::INSTANCED_RENDERABLE)
+            {
+                pVertexShader = pRenderable->GetInstancedVertexShader()->GetVertexShader().Get();
+            }
+            m_renderQueue.Add(
+                RenderQueue::MakeKey(
+                    pass,
+                    m_renderQueue.GetStateId(pVertexShader),
+                    m_renderQueue.GetStateId(pRenderable->GetPixelShader().Get()),
+                    m_renderQueue.GetStateId(pMaterial),
+                    m_renderQueue.GetStateId(pTexture),
+                    distance / FAR_PLANE
+                ),
+                static_cast<UINT>(m_aDrawCalls.size())
+            );
+            m_aDrawCalls.push_back(
+                DrawCall
+                {
+                    .Type = type,
+                    .pRenderable = pRenderable,
+                    .pMaterial = pMaterial,
+                    .uMeshIndex = uMeshIndex,
+                    .uFirstConstant = 0u,
+                    .uFirstSkinningConstant = 0u,
+                    .uFirstInstance = 0u,
+                    .uNumInstances = 1u,
+                }
+            );
+        };
+        auto queueMeshes = [&](eRenderPass pass, eDrawCallType type, Renderable* pRenderable, const BoundingBox& bounds)
+        {
+            if (!pRenderable->HasTexture())
+            {
+                queueDraw(pass, type, pRenderable, DrawCall::ALL_MESHES, nullptr, bounds);
+                return;
+            }
+
+            for (UINT k = 0u; k < pRenderable->GetNumMeshes(); ++k)
+            {
+                queueDraw(pass, type, pRenderable, k, pRenderable->GetMaterial(pRenderable->GetMesh(k).uMaterialIndex).get(), bounds);
+            }
+        };
+
+        // Renderables whose vertex shader has an instanced variant are
+        // held back, and copies that only differ in their world matrix
+        // are drawn with one instanced draw per mesh
+        m_aInstanceCandidates.clear();
+        for (const std::shared_ptr<Renderable>& renderable : mainScene->GetRenderables())
         {
-            if (i.first == m_pszMainSceneName)
+            if (!m_frustumCuller.IsVisible(uBoundsIdx++))
+            {
+                continue;
+            }
+
+            if (renderable->GetInstancedVertexShader())
+            {
+                m_aInstanceCandidates.push_back(renderable.get());
+                continue;
+            }
+            queueMeshes(eRenderPass::GEOMETRY, eDrawCallType::RENDERABLE, renderable.get(), renderable->GetBounds());
+        }
+        std::sort(
+            m_aInstanceCandidates.begin(),
+            m_aInstanceCandidates.end(),
+            [](const Renderable* pLeft, const Renderable* pRight)
             {
-                for (int j = 0; j < NUM_LIGHTS; j++)
+                const INT result = pLeft->CompareInstancingKey(*pRight);
+                if (result != 0)
                 {
-                    
-                    FLOAT attenuationDistance = i.second->GetPointLight(j)->GetAttenuationDistance();
-                    FLOAT attenuationDistanceSquared = attenuationDistance * attenuationDistance;
-                    Lcb.PointLights[j].Position = i.second->GetPointLight(j)->GetPosition();
-                    Lcb.PointLights[j].Color = i.second->GetPointLight(j)->GetColor();
-                    /*Lcb.PointLights->View = i.second->GetPointLight(j)->GetViewMatrix();
-                    Lcb.PointLights->Projection = i.second->GetPointLight(j)->GetProjectionMatrix();*/
-                    Lcb.PointLights[j].AttenuationDistance = XMFLOAT4(
-                        attenuationDistance,
-                        attenuationDistance,
-                        attenuationDistanceSquared,
-                        attenuationDistanceSquared);
+                    return result < 0;
                 }
+                return pLeft < pRight;
+            }
+        );
+        auto findRunEnd = [&](size_t uRunBegin)
+        {
+            size_t uRunEnd = uRunBegin + 1u;
+            while (uRunEnd < m_aInstanceCandidates.size() && m_aInstanceCandidates[uRunBegin]->CanInstanceWith(*m_aInstanceCandidates[uRunEnd]))
+            {
+                ++uRunEnd;
+            }
+            return uRunEnd;
+        };
+
+        // The world matrices of all groups are written to the instance
+        // buffer in one map. If that fails every candidate is drawn on
+        // its own
+        m_aInstances.clear();
+        for (size_t uRunBegin = 0u, uRunEnd = 0u; uRunBegin < m_aInstanceCandidates.size(); uRunBegin = uRunEnd)
+        {
+            uRunEnd = findRunEnd(uRunBegin);
+            if (uRunEnd - uRunBegin < MIN_INSTANCES_PER_DRAW)
+            {
+                continue;
+            }
+
+            for (size_t i = uRunBegin; i < uRunEnd; ++i)
+            {
+                m_aInstances.push_back(InstanceData{ .Transformation = m_aInstanceCandidates[i]->GetWorldMatrix() });
+            }
+        }
+        BOOL bUseInstancing = !m_aInstances.empty();
+        if (bUseInstancing)
+        {
+            const UINT uNumInstances = static_cast<UINT>(m_aInstances.size());
+            void* pInstanceData = nullptr;
+            bUseInstancing = SUCCEEDED(reserveInstanceBuffer(uNumInstances))
+                && m_pCommandContext->Map(D3D11CommandContext::ToHandle(m_instanceBuffer.Get()), eMapType::WRITE_DISCARD, 0u, uNumInstances * static_cast<UINT>(sizeof(InstanceData)), &pInstanceData);
+            if (bUseInstancing)
+            {
+                memcpy(pInstanceData, m_aInstances.data(), m_aInstances.size() * sizeof(InstanceData));
+                m_pCommandContext->Unmap(D3D11CommandContext::ToHandle(m_instanceBuffer.Get()));
             }
-            
         }
-        m_immediateContext->UpdateSubresource(m_cbLights.Get(), 0, NULL, &Lcb, 0, 0);
-        m_immediateContext->VSSetConstantBuffers(3u, 1u, m_cbLights.GetAddressOf());
-        m_immediateContext->PSSetConstantBuffers(3u, 1u, m_cbLights.GetAddressOf());
+        UINT uFirstInstance = 0u;
+        for (size_t uRunBegin = 0u, uRunEnd = 0u; uRunBegin < m_aInstanceCandidates.size(); uRunBegin = uRunEnd)
+        {
+            uRunEnd = findRunEnd(uRunBegin);
+            const UINT uNumInstances = static_cast<UINT>(uRunEnd - uRunBegin);
+            if (!bUseInstancing || uNumInstances < MIN_INSTANCES_PER_DRAW)
+            {
+                for (size_t i = uRunBegin; i < uRunEnd; ++i)
+                {
+                    queueMeshes(eRenderPass::GEOMETRY, eDrawCallType::RENDERABLE, m_aInstanceCandidates[i], m_aInstanceCandidates[i]->GetBounds());
+                }
+                continue;
+            }
 
-        const auto& skybox = m_scenes[m_pszMainSceneName]->GetSkyBox();
-        if (skybox)
+            // The group is sorted by the distance to the middle of all
+            // of its copies
+            BoundingBox bounds = m_aInstanceCandidates[uRunBegin]->GetBounds();
+            for (size_t i = uRunBegin + 1u; i < uRunEnd; ++i)
+            {
+                BoundingBox::CreateMerged(bounds, bounds, m_aInstanceCandidates[i]->GetBounds());
+            }
+
+            const size_t uFirstDrawCall = m_aDrawCalls.size();
+            queueMeshes(eRenderPass::GEOMETRY, eDrawCallType::INSTANCED_RENDERABLE, m_aInstanceCandidates[uRunBegin], bounds);
+            for (size_t i = uFirstDrawCall; i < m_aDrawCalls.size(); ++i)
+            {
+                m_aDrawCalls[i].uFirstInstance = uFirstInstance;
+                m_aDrawCalls[i].uNumInstances = uNumInstances;
+            }
+            uFirstInstance += uNumInstances;
+        }
+        for (const std::shared_ptr<Voxel>& voxel : mainScene->GetVoxels())
         {
-            eTextureSamplerType environSamplerType = skybox->GetMaterial(0u)->pDiffuse->GetSamplerType();
-            m_immediateContext->PSSetShaderResources(3u, 1u, skybox->GetMaterial(0u)->pDiffuse->GetTextureResourceView().GetAddressOf());
-            m_immediateContext->PSSetSamplers(3u, 1u, Texture::s_samplers[static_cast<size_t>(environSamplerType)].GetAddressOf());
+            if (m_frustumCuller.IsVisible(uBoundsIdx++))
+            {
+                queueDraw(eRenderPass::GEOMETRY, eDrawCallType::VOXEL, voxel.get(), DrawCall::ALL_MESHES, voxel->HasTexture() ? voxel->GetMaterial(0u).get() : nullptr, voxel->GetBounds());
+            }
         }
-        
+        for (const std::shared_ptr<VoxelChunk>& chunk : mainScene->GetVoxelChunks())
+        {
+            if (!m_frustumCuller.IsVisible(uBoundsIdx++) || isOccluded(chunk->GetBounds()))
+            {
+                continue;
+            }
+
+            for (const std::shared_ptr<Voxel>& voxel : chunk->GetVoxels())
+            {
+                queueDraw(eRenderPass::GEOMETRY, eDrawCallType::VOXEL, voxel.get(), DrawCall::ALL_MESHES, voxel->HasTexture() ? voxel->GetMaterial(0u).get() : nullptr, chunk->GetBounds());
+            }
 
-        for (auto i : m_scenes) {
-            if (i.first == m_pszMainSceneName)
+            const std::shared_ptr<VoxelMesh>& voxelMesh = chunk->GetVoxelMesh();
+            if (voxelMesh && voxelMesh->GetNumIndices() > 0u)
             {
-                for (auto j : i.second->GetRenderables())
+                for (UINT k = 0u; k < voxelMesh->GetNumMeshes(); ++k)
                 {
-                    ID3D11Buffer* aBuffers[2] = { j.second->GetVertexBuffer().Get(), j.second->GetNormalBuffer().Get() };
-                    m_immediateContext->IASetVertexBuffers(0u, 2u, aBuffers, uStride, uOffset);
-                    m_immediateContext->IASetIndexBuffer(j.second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
-                    m_immediateContext->IASetInputLayout(j.second->GetVertexLayout().Get());
-                    CBChangesEveryFrame Wcb;
-                    Wcb.World = XMMatrixTranspose(j.second->GetWorldMatrix());
-                    Wcb.OutputColor = j.second->GetOutputColor();
-                    Wcb.HasNormalMap = j.second->HasNormalMap();
-                    m_immediateContext->UpdateSubresource(j.second->GetConstantBuffer().Get(), 0, NULL, &Wcb, 0, 0);
-                    m_immediateContext->VSSetShader(j.second->GetVertexShader().Get(), nullptr, 0);
-                    m_immediateContext->VSSetConstantBuffers(2u, 1u, j.second->GetConstantBuffer().GetAddressOf());
-                    m_immediateContext->PSSetShader(j.second->GetPixelShader().Get(), nullptr, 0);
-                    m_immediateContext->PSSetConstantBuffers(2u, 1u, j.second->GetConstantBuffer().GetAddressOf());
-                    m_immediateContext->PSSetShaderResources(2u, 1u, m_shadowMapTexture->GetShaderResourceView().GetAddressOf());
-                    m_immediateContext->PSSetSamplers(2u, 1u, m_shadowMapTexture->GetSamplerState().GetAddressOf());
-                    m_immediateContext->PSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
-                    if (j.second->HasTexture())
-                    {
-                        
-                        for (UINT k = 0; k < j.second->GetNumMeshes(); k++)
-                        {
-                            const UINT MaterialIndex = j.second->GetMesh(k).uMaterialIndex;
-
-                            if (j.second->GetMaterial(MaterialIndex)->pDiffuse)
-                            {
-                                eTextureSamplerType textureSamplerType = j.second->GetMaterial(MaterialIndex)->pDiffuse->GetSamplerType();
-                                m_immediateContext->PSSetShaderResources(0u, 1u, j.second->GetMaterial(MaterialIndex)->pDiffuse->GetTextureResourceView().GetAddressOf());
-                                m_immediateContext->PSSetSamplers(0u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
-                            }
-                            if (j.second->GetMaterial(MaterialIndex)->pNormal)
-                            {
-                                eTextureSamplerType textureSamplerType = j.second->GetMaterial(MaterialIndex)->pNormal->GetSamplerType();
-                                m_immediateContext->PSSetShaderResources(1u, 1u, j.second->GetMaterial(MaterialIndex)->pNormal->GetTextureResourceView().GetAddressOf());
-                                m_immediateContext->PSSetSamplers(1u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
-                            }
-                            m_immediateContext->DrawIndexed(j.second->GetMesh(k).uNumIndices, j.second->GetMesh(k).uBaseIndex, j.second->GetMesh(k).uBaseVertex);
-                        }
-                    }
-                    else
-                    {
-                        m_immediateContext->DrawIndexed(j.second->GetNumIndices(), 0, 0);
-                    }
+                    queueDraw(eRenderPass::GEOMETRY, eDrawCallType::VOXEL_MESH, voxelMesh.get(), k, nullptr, chunk->GetBounds());
                 }
             }
         }
-        UINT strides[3] = { sizeof(SimpleVertex), sizeof(NormalData), sizeof(InstanceData) };
-        UINT offsets[3] = { 0u, 0u, 0u };
+        for (const std::shared_ptr<Model>& model : mainScene->GetModels())
+        {
+            if (!m_frustumCuller.IsVisible(uBoundsIdx++) || isOccluded(model->GetBounds()))
+            {
+                continue;
+            }
 
-        for (auto i : m_scenes)
+            queueMeshes(eRenderPass::GEOMETRY, eDrawCallType::MODEL, model.get(), model->GetBounds());
+        }
+        if (skybox)
+        {
+            queueMeshes(eRenderPass::SKYBOX, eDrawCallType::SKYBOX, skybox.get(), BoundingBox(XMFLOAT3(), XMFLOAT3()));
+        }
+        m_renderQueue.Sort();
+
+        // The per-object constants of all queued draws are written to
+        // the ring in one map. Draws of the same renderable are queued
+        // together and share one block, except for the voxel mesh draws
+        // that differ in color. Skinned models add their bones
+        BOOL bUseRing = m_constantBufferRing.GetBuffer() != nullptr;
+        if (bUseRing)
         {
-            if (i.first == m_pszMainSceneName)
+            const UINT uObjectSize = ConstantBufferRing::GetNumConstants(sizeof(CBChangesEveryFrame)) * ConstantBufferRing::CONSTANT_SIZE;
+            const UINT uSkinningSize = ConstantBufferRing::GetNumConstants(sizeof(CBSkinning)) * ConstantBufferRing::CONSTANT_SIZE;
+            UINT uRingSize = 0u;
+            const Renderable* pPrevRenderable = nullptr;
+            for (const DrawCall& drawCall : m_aDrawCalls)
             {
-                for (auto j : i.second->GetVoxels())
+                if (drawCall.pRenderable != pPrevRenderable || drawCall.Type == eDrawCallType::VOXEL_MESH)
                 {
-                    ID3D11Buffer* buffers[3] = { j->GetVertexBuffer().Get(), j->GetNormalBuffer().Get(), j->GetInstanceBuffer().Get() };
-                    m_immediateContext->IASetVertexBuffers(0u, 3u, buffers, strides, offsets);
-                    m_immediateContext->IASetIndexBuffer(j->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
-                    m_immediateContext->IASetInputLayout(j->GetVertexLayout().Get());
-                    CBChangesEveryFrame Wcb;
-                    Wcb.World = XMMatrixTranspose(j->GetWorldMatrix());
-                    Wcb.OutputColor = j->GetOutputColor();
-                    Wcb.HasNormalMap = j->HasNormalMap();
-                    m_immediateContext->UpdateSubresource(j->GetConstantBuffer().Get(), 0, NULL, &Wcb, 0, 0);
-                    m_immediateContext->VSSetShader(j->GetVertexShader().Get(), nullptr, 0);
-                    m_immediateContext->VSSetConstantBuffers(2u, 1u, j->GetConstantBuffer().GetAddressOf());
-                    m_immediateContext->PSSetShader(j->GetPixelShader().Get(), nullptr, 0);
-                    m_immediateContext->PSSetConstantBuffers(2u, 1u, j->GetConstantBuffer().GetAddressOf());
-                    if (j->HasTexture())
+                    uRingSize += uObjectSize;
+                    if (drawCall.Type == eDrawCallType::MODEL)
                     {
-                        m_immediateContext->PSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
-                        if (j->GetMaterial(0u)->pDiffuse)
-                        {
-                            eTextureSamplerType textureSamplerType = j->GetMaterial(0u)->pDiffuse->GetSamplerType();
-                            m_immediateContext->PSSetShaderResources(0u, 1u, j->GetMaterial(0u)->pDiffuse->GetTextureResourceView().GetAddressOf());
-                            m_immediateContext->PSSetSamplers(0u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
-                        }
-                        if (j->GetMaterial(0u)->pNormal)
-                        {
-                            eTextureSamplerType textureSamplerType = j->GetMaterial(0u)->pDiffuse->GetSamplerType();
-                            m_immediateContext->PSSetShaderResources(1u, 1u, j->GetMaterial(0u)->pNormal->GetTextureResourceView().GetAddressOf());
-                            m_immediateContext->PSSetSamplers(1u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
-                        }
+                        uRingSize += uSkinningSize;
                     }
-
-                    m_immediateContext->PSSetShaderResources(2u, 1u, m_shadowMapTexture->GetShaderResourceView().GetAddressOf());
-                    m_immediateContext->PSSetSamplers(2u, 1u, m_shadowMapTexture->GetSamplerState().GetAddressOf());
-                    m_immediateContext->DrawIndexedInstanced(j->GetNumIndices(), j->GetNumInstances(), 0, 0, 0);
                 }
+                pPrevRenderable = drawCall.pRenderable;
             }
+
+            bUseRing = uRingSize == 0u || SUCCEEDED(m_constantBufferRing.Map(m_d3dDevice.Get(), m_pCommandContext, uRingSize));
         }
-        UINT aStrides[3] = {
-            static_cast<UINT>(sizeof(SimpleVertex)),
-            static_cast<UINT>(sizeof(NormalData)),
-            static_cast<UINT>(sizeof(AnimationData))
-        };
-        UINT aOffsets[3] = { 0u, 0u, 0u };
-        for (auto i : m_scenes)
+        if (bUseRing && !m_aDrawCalls.empty())
         {
-            if (i.first == m_pszMainSceneName)
+            const DrawCall* pPrevDrawCall = nullptr;
+            for (DrawCall& drawCall : m_aDrawCalls)
             {
-                for (auto j : i.second->GetModels())
+                Renderable* pRenderable = drawCall.pRenderable;
+                if (pPrevDrawCall && pPrevDrawCall->pRenderable == pRenderable && drawCall.Type != eDrawCallType::VOXEL_MESH)
                 {
-                    ID3D11Buffer* aBuffers[3] = {
-                    j.second->GetVertexBuffer().Get(),
-                    j.second->GetNormalBuffer().Get(),
-                    j.second->GetAnimationBuffer().Get()
-                    };
-                    m_immediateContext->IASetVertexBuffers(0u, 3u, aBuffers, aStrides, aOffsets);
-                    m_immediateContext->IASetIndexBuffer(j.second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
-                    m_immediateContext->IASetInputLayout(j.second->GetVertexLayout().Get());
-                    CBChangesEveryFrame Wcb;
-                    Wcb.World = XMMatrixTranspose(j.second->GetWorldMatrix());
-                    Wcb.OutputColor = j.second->GetOutputColor();
-                    Wcb.HasNormalMap = j.second->HasNormalMap();
-                    CBSkinning Scb;
-                    for (UINT k = 0u; k < j.second->GetBoneTransforms().size(); ++k)
-                    {
-                        Scb.BoneTransforms[k] = XMMatrixTranspose(j.second->GetBoneTransforms()[k]);
-                    }
+                    drawCall.uFirstConstant = pPrevDrawCall->uFirstConstant;
+                    drawCall.uFirstSkinningConstant = pPrevDrawCall->uFirstSkinningConstant;
+                    pPrevDrawCall = &drawCall;
+                    continue;
+                }
+                pPrevDrawCall = &drawCall;
 
-                    m_immediateContext->UpdateSubresource(j.second->GetConstantBuffer().Get(), 0, NULL, &Wcb, 0, 0);
-                    m_immediateContext->UpdateSubresource(j.second->GetSkinningConstantBuffer().Get(), 0, NULL, &Scb, 0, 0);
-                    m_immediateContext->VSSetShader(j.second->GetVertexShader().Get(), nullptr, 0);
-                    m_immediateContext->VSSetConstantBuffers(2u, 1u, j.second->GetConstantBuffer().GetAddressOf());
-                    m_immediateContext->VSSetConstantBuffers(4u, 1u, j.second->GetSkinningConstantBuffer().GetAddressOf());
-                    m_immediateContext->PSSetShader(j.second->GetPixelShader().Get(), nullptr, 0);
-                    m_immediateContext->PSSetConstantBuffers(2u, 1u, j.second->GetConstantBuffer().GetAddressOf());
-                    m_immediateContext->PSSetShaderResources(2u, 1u, m_shadowMapTexture->GetShaderResourceView().GetAddressOf());
-                    m_immediateContext->PSSetSamplers(2u, 1u, m_shadowMapTexture->GetSamplerState().GetAddressOf());
-                    if (j.second->HasTexture())
-                    {
-                        m_immediateContext->PSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
-                        for (UINT k = 0; k < j.second->GetNumMeshes(); k++)
-                        {
-                            const UINT MaterialIndex = j.second->GetMesh(k).uMaterialIndex;
-
-                            if (j.second->GetMaterial(MaterialIndex)->pDiffuse)
-                            {
-                                eTextureSamplerType textureSamplerType = j.second->GetMaterial(MaterialIndex)->pDiffuse->GetSamplerType();
-                                m_immediateContext->PSSetShaderResources(0u, 1u, j.second->GetMaterial(MaterialIndex)->pDiffuse->GetTextureResourceView().GetAddressOf());
-                                m_immediateContext->PSSetSamplers(0u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
-                            }
-                            if (j.second->GetMaterial(MaterialIndex)->pNormal)
-                            {
-                                eTextureSamplerType textureSamplerType = j.second->GetMaterial(MaterialIndex)->pDiffuse->GetSamplerType();
-                                m_immediateContext->PSSetShaderResources(1u, 1u, j.second->GetMaterial(MaterialIndex)->pNormal->GetTextureResourceView().GetAddressOf());
-                                m_immediateContext->PSSetSamplers(1u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
-                            }
-                            m_immediateContext->DrawIndexed(j.second->GetMesh(k).uNumIndices, j.second->GetMesh(k).uBaseIndex, j.second->GetMesh(k).uBaseVertex);
-                        }
-                    }
-                    else
+                CBChangesEveryFrame Wcb = {};
+                Wcb.World = XMMatrixTranspose(pRenderable->GetWorldMatrix());
+                Wcb.OutputColor = pRenderable->GetOutputColor();
+                Wcb.HasNormalMap = pRenderable->HasNormalMap();
+                if (drawCall.Type == eDrawCallType::SKYBOX)
+                {
+                    Wcb.World = XMMatrixTranspose(pRenderable->GetWorldMatrix() * XMMatrixTranslationFromVector(eye));
+                }
+                else if (drawCall.Type == eDrawCallType::VOXEL_MESH)
+                {
+                    Wcb.OutputColor = static_cast<VoxelMesh*>(pRenderable)->GetMeshColor(drawCall.uMeshIndex);
+                }
+                memcpy(m_constantBufferRing.Allocate(sizeof(Wcb), &drawCall.uFirstConstant), &Wcb, sizeof(Wcb));
+
+                if (drawCall.Type == eDrawCallType::MODEL)
+                {
+                    // Only the bones the model has are written, the rest
+                    // of the block is never read
+                    Model* pModel = static_cast<Model*>(pRenderable);
+                    XMMATRIX* pBoneTransforms = static_cast<XMMATRIX*>(m_constantBufferRing.Allocate(sizeof(CBSkinning), &drawCall.uFirstSkinningConstant));
+                    for (UINT k = 0u; k < pModel->GetBoneTransforms().size(); ++k)
                     {
-                        m_immediateContext->DrawIndexed(j.second->GetNumIndices(), 0, 0);
+                        pBoneTransforms[k] = XMMatrixTranspose(pModel->GetBoneTransforms()[k]);
                     }
                 }
             }
         }
-        UINT aStride = static_cast<UINT>(sizeof(SimpleVertex));
-        UINT aOffset = 0u;
-        for (auto i : m_scenes)
-        {
-            if (i.first == m_pszMainSceneName)
-            {
-                auto it = i.second->GetSkyBox();
-                m_immediateContext->IASetVertexBuffers(0u, 1u, it->GetVertexBuffer().GetAddressOf(), &aStride, &aOffset);
-                m_immediateContext->IASetIndexBuffer(it->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
-                m_immediateContext->IASetInputLayout(it->GetVertexLayout().Get());
-                CBChangesEveryFrame Wcb;
-                Wcb.World = XMMatrixTranspose(it->GetWorldMatrix() * XMMatrixTranslationFromVector(m_camera.GetEye()));
-                Wcb.OutputColor = it->GetOutputColor();
-                Wcb.HasNormalMap = it->HasNormalMap();
-                m_immediateContext->UpdateSubresource(it->GetConstantBuffer().Get(), 0, NULL, &Wcb, 0, 0);
-                m_immediateContext->VSSetShader(it->GetVertexShader().Get(), nullptr, 0);
-                m_immediateContext->PSSetShader(it->GetPixelShader().Get(), nullptr, 0);
-                m_immediateContext->VSSetConstantBuffers(2u, 1u, it->GetConstantBuffer().GetAddressOf());
-                m_immediateContext->PSSetConstantBuffers(2u, 1u, it->GetConstantBuffer().GetAddressOf());
-                
-                if (it->HasTexture())
+        m_constantBufferRing.Unmap(m_pCommandContext);
+        Profiler::Get().EndCpuZone(pQueueZone);
+
+        // The pre-pass draws the same sorted list with the same vertex
+        // shaders, so its depths match the main pass exactly. It is
+        // recorded whole before the main pass, whose draws may be
+        // spread over several command lists
+        const UINT uNumItems = m_renderQueue.GetNumItems();
+        if (m_bDepthPrepass)
+        {
+            ProfileScope prepassProfileScope("Depth pre-pass");
+            GpuProfileScope prepassGpuProfileScope(GetProfiledContext(), "Depth pre-pass");
+            recordDraws(m_stateCache, 0u, uNumItems, bUseRing, TRUE);
+        }
+
+        // With the per-object constants in the ring the draws only bind,
+        // so the sorted list is split into contiguous slices recorded on
+        // the workers in parallel. The command lists run in slice order,
+        // which keeps the sorted order of the draws
+        ProfileZone* pRecordZone = Profiler::Get().BeginCpuZone("Record draws");
+        m_uNumCommandLists = 0u;
+        if (bUseRing)
+        {
+            m_uNumCommandLists = (std::min)(static_cast<UINT>(m_aRecordingWorkers.size()), uNumItems / MIN_DRAWS_PER_COMMAND_LIST);
+        }
+        if (m_uNumCommandLists > 1u)
+        {
+            const UINT uNumItemsPerList = (uNumItems + m_uNumCommandLists - 1u) / m_uNumCommandLists;
+            m_threadPool.ParallelFor(
+                m_uNumCommandLists,
+                1u,
+                [&](size_t uBegin, size_t uEnd)
                 {
-                    m_immediateContext->PSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
-                    for (UINT j = 0u; j < it->GetNumMeshes(); j++)
+                    for (size_t uListIdx = uBegin; uListIdx < uEnd; ++uListIdx)
                     {
-                        const UINT MaterialIndex = it->GetMesh(j).uMaterialIndex;
-                        if (it->GetMaterial(MaterialIndex)->pDiffuse)
-                        {
-                            eTextureSamplerType textureSamplerType = it->GetMaterial(MaterialIndex)->pDiffuse->GetSamplerType();
-                            m_immediateContext->PSSetShaderResources(0u, 1u, it->GetMaterial(MaterialIndex)->pDiffuse->GetTextureResourceView().GetAddressOf());
-                            m_immediateContext->PSSetSamplers(0u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
-                        }
-                        
-                        m_immediateContext->DrawIndexed(it->GetMesh(j).uNumIndices, it->GetMesh(j).uBaseIndex, it->GetMesh(j).uBaseVertex);
+                        RecordingWorker& worker = *m_aRecordingWorkers[uListIdx];
+                        const UINT uBeginItem = static_cast<UINT>(uListIdx) * uNumItemsPerList;
+                        const UINT uEndItem = (std::min)(uBeginItem + uNumItemsPerList, uNumItems);
+
+                        worker.Cache.BeginFrame(worker.pContext);
+                        bindFrameState(worker.Cache, worker.pContext);
+                        recordDraws(worker.Cache, uBeginItem, uEndItem, TRUE, FALSE);
+                        worker.pContext->FinishCommandList();
                     }
                 }
+            );
+
+            for (UINT uListIdx = 0u; uListIdx < m_uNumCommandLists; ++uListIdx)
+            {
+                m_pCommandContext->ExecuteCommandList(m_aRecordingWorkers[uListIdx]->pContext);
+            }
+            m_stateCache.Invalidate();
+        }
+        else
+        {
+            m_uNumCommandLists = 0u;
+            recordDraws(m_stateCache, 0u, uNumItems, bUseRing, FALSE);
+        }
+        Profiler::Get().EndCpuZone(pRecordZone);
+
+        if (IsHeadless())
+        {
+            m_commandStreamAnalyzer.Analyze(m_recordingCommandContext.GetCommands());
+            return;
+        }
+        ProfileScope presentProfileScope("Present");
+        m_swapChain->Present(0, 0);
+    }
+
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::bindFrameState
+
+      Summary:  Binds what every draw of the frame shares: the render
+                targets, viewport and topology, the camera, projection
+                and light constants, the clustered point lights, and
+                the environment map of the skybox. A command list
+                starts with none of it bound
+
+      Args:     StateCache& stateCache
+                  State cache of the context
+                CommandContext* pContext
+                  Context the state cache passes its calls to
+
+      Modifies: [stateCache].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::bindFrameState(_In_ StateCache& stateCache, _In_ CommandContext* pContext)
+    {
+        GpuRenderTargetView* pRenderTargetView = D3D11CommandContext::ToHandle(m_renderTargetView.Get());
+        pContext->OMSetRenderTargets(1u, &pRenderTargetView, D3D11CommandContext::ToHandle(m_depthStencilView.Get()));
+        pContext->RSSetViewport(D3D11CommandContext::GetViewport(m_viewport));
+        pContext->IASetPrimitiveTopology(ePrimitiveTopology::TRIANGLE_LIST);
+
+        stateCache.VSSetConstantBuffer(0u, m_camera.GetConstantBuffer().Get());
+        stateCache.VSSetConstantBuffer(1u, m_cbChangeOnResize.Get());
+        stateCache.VSSetConstantBuffer(3u, m_cbLights.Get());
+        stateCache.PSSetConstantBuffer(3u, m_cbLights.Get());
+        stateCache.PSSetConstantBuffer(5u, m_cbShadowCascades.Get());
+        stateCache.PSSetConstantBuffer(6u, m_cbLightClusters.Get());
+        stateCache.PSSetShaderResource(4u, m_lightClusterer.GetLightBufferView().Get());
+        stateCache.PSSetShaderResource(5u, m_lightClusterer.GetClusterBufferView().Get());
+        stateCache.PSSetShaderResource(6u, m_lightClusterer.GetLightIndexBufferView().Get());
+
+        const std::shared_ptr<Skybox>& skybox = m_mainScene->GetSkyBox();
+        if (skybox)
+        {
+            eTextureSamplerType environSamplerType = skybox->GetMaterial(0u)->pDiffuse->GetSamplerType();
+            stateCache.PSSetShaderResource(3u, skybox->GetMaterial(0u)->pDiffuse->GetTextureResourceView().Get());
+            stateCache.PSSetSampler(3u, Texture::s_samplers[static_cast<size_t>(environSamplerType)].Get());
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::recordDraws
+
+      Summary:  Binds and draws a range of the sorted render queue.
+                Without the constant buffer ring the per-object
+                constants are uploaded through the state cache, which
+                must then be the one of the immediate context.
+
+                A depth-only range is drawn with the vertex shaders and
+                vertex buffers of the draws but no pixel shader, and
+                skips the skybox. When the depth pre-pass is on, the
+                other draws only pass where their depth equals the
+                depth of the pre-pass
+
+      Args:     StateCache& stateCache
+                  State cache of the context the draws are recorded on
+                UINT uBeginItem
+                  First item of the render queue
+                UINT uEndItem
+                  Item of the render queue past the last one
+                BOOL bUseRing
+                  Whether the per-object constants are in the ring
+                BOOL bDepthOnly
+                  Whether only the depth of the draws is written
+
+      Modifies: [stateCache].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::recordDraws(_In_ StateCache& stateCache, _In_ UINT uBeginItem, _In_ UINT uEndItem, _In_ BOOL bUseRing, _In_ BOOL bDepthOnly)
+    {
+        const XMVECTOR eye = m_camera.GetEye();
+        UINT aStrides[3] = { 0u, 0u, 0u };
+        UINT aOffsets[3] = { 0u, 0u, 0u };
+        auto bindRenderable = [&](const DrawCall& drawCall)
+        {
+            Renderable* pRenderable = drawCall.pRenderable;
+            ID3D11InputLayout* pVertexLayout = pRenderable->GetVertexLayout().Get();
+            CBChangesEveryFrame Wcb = {};
+            Wcb.World = XMMatrixTranspose(pRenderable->GetWorldMatrix());
+            Wcb.OutputColor = pRenderable->GetOutputColor();
+            Wcb.HasNormalMap = pRenderable->HasNormalMap();
+
+            ID3D11Buffer* aBuffers[3] = { pRenderable->GetVertexBuffer().Get(), pRenderable->GetNormalBuffer().Get(), nullptr };
+            UINT uNumBuffers = 2u;
+            aStrides[0] = static_cast<UINT>(sizeof(SimpleVertex));
+            aStrides[1] = static_cast<UINT>(sizeof(NormalData));
+            switch (drawCall.Type)
+            {
+            case eDrawCallType::VOXEL:
+                aBuffers[2] = static_cast<Voxel*>(pRenderable)->GetInstanceBuffer().Get();
+                aStrides[2] = static_cast<Voxel*>(pRenderable)->GetInstanceStride();
+                uNumBuffers = 3u;
+                break;
+            case eDrawCallType::MODEL:
+            {
+                Model* pModel = static_cast<Model*>(pRenderable);
+                aBuffers[2] = pModel->GetAnimationBuffer().Get();
+                aStrides[2] = static_cast<UINT>(sizeof(AnimationData));
+                uNumBuffers = 3u;
+                if (bUseRing)
+                {
+                    break;
+                }
+
+                CBSkinning Scb = {};
+                for (UINT k = 0u; k < pModel->GetBoneTransforms().size(); ++k)
+                {
+                    Scb.BoneTransforms[k] = XMMatrixTranspose(pModel->GetBoneTransforms()[k]);
+                }
+                stateCache.UpdateConstantBuffer(pModel->GetSkinningConstantBuffer().Get(), &Scb, sizeof(Scb));
+                stateCache.VSSetConstantBuffer(4u, pModel->GetSkinningConstantBuffer().Get());
+                break;
+            }
+            case eDrawCallType::INSTANCED_RENDERABLE:
+                aBuffers[2] = m_instanceBuffer.Get();
+                aStrides[2] = static_cast<UINT>(sizeof(InstanceData));
+                uNumBuffers = 3u;
+                pVertexLayout = pRenderable->GetInstancedVertexShader()->GetVertexLayout().Get();
+                break;
+            case eDrawCallType::SKYBOX:
+                uNumBuffers = 1u;
+                Wcb.World = XMMatrixTranspose(pRenderable->GetWorldMatrix() * XMMatrixTranslationFromVector(eye));
+                break;
+            default:
+                break;
+            }
+
+            stateCache.IASetVertexBuffers(0u, uNumBuffers, aBuffers, aStrides, aOffsets);
+            stateCache.IASetIndexBuffer(pRenderable->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+            stateCache.IASetInputLayout(pVertexLayout);
+            if (!bUseRing)
+            {
+                if (drawCall.Type != eDrawCallType::VOXEL_MESH)
+                {
+                    // Voxel meshes upload their constants per mesh color
+                    stateCache.UpdateConstantBuffer(pRenderable->GetConstantBuffer().Get(), &Wcb, sizeof(Wcb));
+                }
+                stateCache.VSSetConstantBuffer(2u, pRenderable->GetConstantBuffer().Get());
+                stateCache.PSSetConstantBuffer(2u, pRenderable->GetConstantBuffer().Get());
+            }
+            if (bDepthOnly)
+            {
+                return;
+            }
+            stateCache.PSSetConstantBuffer(0u, m_camera.GetConstantBuffer().Get());
+            if (drawCall.Type != eDrawCallType::SKYBOX)
+            {
+                stateCache.PSSetShaderResource(2u, m_shadowMap->GetShaderResourceView().Get());
+                stateCache.PSSetSampler(2u, m_shadowMap->GetSamplerState().Get());
+            }
+        };
+        auto bindMaterial = [&](const Material* pMaterial)
+        {
+            if (pMaterial->pDiffuse)
+            {
+                eTextureSamplerType textureSamplerType = pMaterial->pDiffuse->GetSamplerType();
+                stateCache.PSSetShaderResource(0u, pMaterial->pDiffuse->GetTextureResourceView().Get());
+                stateCache.PSSetSampler(0u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].Get());
+            }
+            if (pMaterial->pNormal)
+            {
+                eTextureSamplerType textureSamplerType = pMaterial->pNormal->GetSamplerType();
+                stateCache.PSSetShaderResource(1u, pMaterial->pNormal->GetTextureResourceView().Get());
+                stateCache.PSSetSampler(1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].Get());
+            }
+        };
+
+        const Renderable* pBoundRenderable = nullptr;
+        const Material* pBoundMaterial = nullptr;
+        for (UINT uItemIdx = uBeginItem; uItemIdx < uEndItem; ++uItemIdx)
+        {
+            const DrawCall& drawCall = m_aDrawCalls[m_renderQueue.GetIndex(uItemIdx)];
+            Renderable* pRenderable = drawCall.pRenderable;
+            if (bDepthOnly && drawCall.Type == eDrawCallType::SKYBOX)
+            {
+                continue;
+            }
+
+            // The skybox is drawn with the default depth test either way
+            const BOOL bDepthEqual = m_bDepthPrepass && !bDepthOnly && drawCall.Type != eDrawCallType::SKYBOX;
+            stateCache.OMSetDepthStencilState(bDepthEqual ? m_depthEqualState.Get() : nullptr);
+            if (drawCall.Type == eDrawCallType::INSTANCED_RENDERABLE)
+            {
+                stateCache.VSSetShader(pRenderable->GetInstancedVertexShader()->GetVertexShader().Get());
+            }
+            else
+            {
+                stateCache.VSSetShader(pRenderable->GetVertexShader().Get());
+            }
+            stateCache.PSSetShader(bDepthOnly ? nullptr : pRenderable->GetPixelShader().Get());
+            if (pRenderable != pBoundRenderable)
+            {
+                bindRenderable(drawCall);
+                pBoundRenderable = pRenderable;
+            }
+            if (!bDepthOnly && drawCall.pMaterial && drawCall.pMaterial != pBoundMaterial)
+            {
+                bindMaterial(drawCall.pMaterial);
+                pBoundMaterial = drawCall.pMaterial;
+            }
+            if (bUseRing)
+            {
+                ID3D11Buffer* pRingBuffer = m_constantBufferRing.GetBuffer().Get();
+                const UINT uNumObjectConstants = ConstantBufferRing::GetNumConstants(sizeof(CBChangesEveryFrame));
+                stateCache.VSSetConstantBufferRange(2u, pRingBuffer, drawCall.uFirstConstant, uNumObjectConstants);
+                if (!bDepthOnly)
+                {
+                    stateCache.PSSetConstantBufferRange(2u, pRingBuffer, drawCall.uFirstConstant, uNumObjectConstants);
+                }
+                if (drawCall.Type == eDrawCallType::MODEL)
+                {
+                    stateCache.VSSetConstantBufferRange(4u, pRingBuffer, drawCall.uFirstSkinningConstant, ConstantBufferRing::GetNumConstants(sizeof(CBSkinning)));
+                }
+            }
+
+            if (drawCall.Type == eDrawCallType::VOXEL)
+            {
+                stateCache.DrawIndexedInstanced(pRenderable->GetNumIndices(), static_cast<Voxel*>(pRenderable)->GetNumInstances(), 0, 0, 0);
+            }
+            else if (drawCall.Type == eDrawCallType::VOXEL_MESH)
+            {
+                VoxelMesh* pVoxelMesh = static_cast<VoxelMesh*>(pRenderable);
+                if (!bUseRing)
+                {
+                    CBChangesEveryFrame Wcb = {};
+                    Wcb.World = XMMatrixTranspose(pVoxelMesh->GetWorldMatrix());
+                    Wcb.OutputColor = pVoxelMesh->GetMeshColor(drawCall.uMeshIndex);
+                    Wcb.HasNormalMap = pVoxelMesh->HasNormalMap();
+                    stateCache.UpdateConstantBuffer(pVoxelMesh->GetConstantBuffer().Get(), &Wcb, sizeof(Wcb));
+                }
+                stateCache.DrawIndexed(pVoxelMesh->GetMesh(drawCall.uMeshIndex).uNumIndices, pVoxelMesh->GetMesh(drawCall.uMeshIndex).uBaseIndex, pVoxelMesh->GetMesh(drawCall.uMeshIndex).uBaseVertex);
+            }
+            else if (drawCall.Type == eDrawCallType::INSTANCED_RENDERABLE)
+            {
+                if (drawCall.uMeshIndex == DrawCall::ALL_MESHES)
+                {
+                    stateCache.DrawIndexedInstanced(pRenderable->GetNumIndices(), drawCall.uNumInstances, 0, 0, drawCall.uFirstInstance);
+                }
                 else
                 {
-                    m_immediateContext->DrawIndexed(it->GetNumIndices(), 0, 0);
+                    stateCache.DrawIndexedInstanced(
+                        pRenderable->GetMesh(drawCall.uMeshIndex).uNumIndices,
+                        drawCall.uNumInstances,
+                        pRenderable->GetMesh(drawCall.uMeshIndex).uBaseIndex,
+                        pRenderable->GetMesh(drawCall.uMeshIndex).uBaseVertex,
+                        drawCall.uFirstInstance
+                    );
                 }
             }
+            else if (drawCall.uMeshIndex == DrawCall::ALL_MESHES)
+            {
+                stateCache.DrawIndexed(pRenderable->GetNumIndices(), 0, 0);
+            }
+            else
+            {
+                stateCache.DrawIndexed(pRenderable->GetMesh(drawCall.uMeshIndex).uNumIndices, pRenderable->GetMesh(drawCall.uMeshIndex).uBaseIndex, pRenderable->GetMesh(drawCall.uMeshIndex).uBaseVertex);
+            }
         }
-        m_swapChain->Present(0, 0);
     }
 
-
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderer::RenderSceneToTexture
 
-      Summary:  Render scene to the texture
+      Summary:  Renders the cascaded shadow map of the directional
+                light. The cascades are fitted to the camera, then the
+                depth of the casters is rendered into each slice of the
+                shadow map. Only a depth stencil view is bound and no
+                pixel shader, so nothing but depth is written.
+
+                Shadows are rendered in two layers. The static layer
+                holds the voxels, the terrain chunks and the static
+                renderables in a shadow map of its own, and a slice of
+                it is rendered again only when the static geometry, the
+                light or the projection of its cascade changed. The
+                cascades move in steps of an eighth of their width, so
+                a moving camera re-renders a slice only every few
+                units and the far cascades hardly ever. Every
+                frame the static slices are copied into the shadow map
+                and the dynamic casters are drawn over them, so a still
+                camera draws no terrain at all.
+
+                Casters are culled against the box of each cascade, so
+                a cascade only draws what lies in it or between it and
+                the light. The render targets and viewport of the frame
+                are bound again by bindFrameState
+
+      Modifies: [m_shadowCascades, m_shadowCuller, m_staticShadowCuller,
+                 m_staticShadowView, m_aStaticShadowProjections,
+                 m_uStaticShadowVersion, m_bStaticShadowValid].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    /*--------------------------------------------------------------------
-      TODO: Renderer::RenderSceneToTexture definition (remove the comment)
-    --------------------------------------------------------------------*/
     void Renderer::RenderSceneToTexture()
     {
-        ID3D11ShaderResourceView* const pSRV[2] = { NULL, NULL };
-        m_immediateContext->PSSetShaderResources(0, 2, pSRV);
-        m_immediateContext->PSSetShaderResources(2, 1, pSRV);
+        ProfileScope profileScope("Shadow pass");
+        GpuProfileScope gpuProfileScope(GetProfiledContext(), "Shadow pass");
+
+        // The draws of the last frame left the shadow map bound as a
+        // shader resource, it cannot be written while it is. They may
+        // also have left the depth test of the main pass after a
+        // depth pre-pass
+        m_stateCache.PSSetShaderResource(2u, nullptr);
+        m_stateCache.OMSetDepthStencilState(nullptr);
+
+        m_pCommandContext->RSSetViewport(D3D11CommandContext::GetViewport(m_shadowMap->GetViewport()));
+        m_pCommandContext->IASetPrimitiveTopology(ePrimitiveTopology::TRIANGLE_LIST);
+
+        // Without a directional light the light color is zero and the
+        // cleared shadow map shadows nothing
+        const std::shared_ptr<DirectionalLight>& directionalLight = m_mainScene->GetDirectionalLight();
+        CBShadowCascades cbCascades = {};
+        if (directionalLight)
+        {
+            m_shadowCascades.Update(m_camera.GetView(), m_projection, NEAR_PLANE, FAR_PLANE, directionalLight->GetDirection(), m_shadowMap->GetSize());
+            for (UINT uCascade = 0u; uCascade < NUM_CASCADES; ++uCascade)
+            {
+                cbCascades.ViewProjections[uCascade] = XMMatrixTranspose(XMMatrixMultiply(m_shadowCascades.GetView(), m_shadowCascades.GetProjection(uCascade)));
+                cbCascades.SplitDistances[uCascade] = m_shadowCascades.GetSplitDistance(uCascade);
+            }
+            cbCascades.LightDirection = directionalLight->GetDirection();
+            cbCascades.LightColor = directionalLight->GetColor();
+        }
+        m_stateCache.UpdateConstantBuffer(m_cbShadowCascades.Get(), &cbCascades, sizeof(cbCascades));
+        if (!directionalLight || !m_shadowVertexShader)
+        {
+            for (UINT uCascade = 0u; uCascade < NUM_CASCADES; ++uCascade)
+            {
+                m_pCommandContext->ClearDepthStencilView(D3D11CommandContext::ToHandle(m_shadowMap->GetDepthStencilView(uCascade).Get()), CommandContext::CLEAR_DEPTH, 1.0f, 0u);
+            }
+            m_bStaticShadowValid = FALSE;
+            return;
+        }
 
-        m_immediateContext->OMSetRenderTargets(1, m_shadowMapTexture->GetRenderTargetView().GetAddressOf(), m_depthStencilView.Get());
-        m_immediateContext->ClearRenderTargetView(m_shadowMapTexture->GetRenderTargetView().Get(), Colors::White);
-        m_immediateContext->ClearDepthStencilView(m_depthStencilView.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0);
-        
-        for (auto i : m_scenes) {
-            if (i.first == m_pszMainSceneName)
+        // Static casters only change with the static version, so their
+        // bounds are gathered again only then. Bounds are added in the
+        // order the casters are drawn below: static renderables,
+        // voxels, then voxel chunks
+        const UINT64 uStaticVersion = m_mainScene->GetStaticVersion();
+        if (!m_bStaticShadowValid || uStaticVersion != m_uStaticShadowVersion)
+        {
+            m_staticShadowCuller.Clear();
+            for (const std::shared_ptr<Renderable>& renderable : m_mainScene->GetRenderables())
             {
-                for (auto j : i.second->GetRenderables())
+                if (renderable->IsStatic())
                 {
-                    UINT uStride = static_cast<UINT>(sizeof(SimpleVertex));
-                    UINT uOffset = 0u;
-                    m_immediateContext->IASetVertexBuffers(0u, 1u, j.second->GetVertexBuffer().GetAddressOf(), &uStride, &uOffset);
-                    m_immediateContext->IASetIndexBuffer(j.second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
-                    m_immediateContext->IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
-                    
-                    CBShadowMatrix cb = {
-                        .World = XMMatrixTranspose(j.second->GetWorldMatrix()),
-                        //.View = XMMatrixTranspose(i.second->GetPointLight(0)->GetViewMatrix()),
-                        //.Projection = XMMatrixTranspose(i.second->GetPointLight(0)->GetProjectionMatrix()),
-                        .IsVoxel = false
-                    };
-                    
-                    m_immediateContext->UpdateSubresource(m_cbShadowMatrix.Get(), 0, NULL, &cb, 0, 0);
-                    m_immediateContext->VSSetShader(m_shadowVertexShader->GetVertexShader().Get(), nullptr, 0);
-                    m_immediateContext->VSSetConstantBuffers(0u, 1u, m_cbShadowMatrix.GetAddressOf());
-                    m_immediateContext->PSSetShader(m_shadowPixelShader->GetPixelShader().Get(), nullptr, 0);
-                    m_immediateContext->PSSetConstantBuffers(0u, 1u, m_cbShadowMatrix.GetAddressOf());
-                    m_immediateContext->DrawIndexed(j.second->GetNumIndices(), 0, 0);
+                    m_staticShadowCuller.AddBounds(renderable->GetBounds());
                 }
             }
+            for (const std::shared_ptr<Voxel>& voxel : m_mainScene->GetVoxels())
+            {
+                m_staticShadowCuller.AddBounds(voxel->GetBounds());
+            }
+            for (const std::shared_ptr<VoxelChunk>& chunk : m_mainScene->GetVoxelChunks())
+            {
+                m_staticShadowCuller.AddBounds(chunk->GetBounds());
+            }
+        }
+        const BOOL bStaticLayerDirty = !m_bStaticShadowValid
+            || uStaticVersion != m_uStaticShadowVersion
+            || memcmp(&m_staticShadowView, &m_shadowCascades.GetView(), sizeof(XMMATRIX)) != 0;
+        m_uStaticShadowVersion = uStaticVersion;
+        m_staticShadowView = m_shadowCascades.GetView();
+        m_bStaticShadowValid = TRUE;
+
+        // Dynamic renderables, then models
+        m_shadowCuller.Clear();
+        for (const std::shared_ptr<Renderable>& renderable : m_mainScene->GetRenderables())
+        {
+            if (!renderable->IsStatic())
+            {
+                m_shadowCuller.AddBounds(renderable->GetBounds());
+            }
+        }
+        for (const std::shared_ptr<Model>& model : m_mainScene->GetModels())
+        {
+            m_shadowCuller.AddBounds(model->GetBounds());
         }
 
-        for (auto i : m_scenes)
+        m_stateCache.PSSetShader(nullptr);
+        m_stateCache.VSSetConstantBuffer(0u, m_cbShadowMatrix.Get());
+
+        const XMMATRIX view = XMMatrixTranspose(m_shadowCascades.GetView());
+        XMMATRIX projection = XMMatrixIdentity();
+        UINT aStrides[3] = { static_cast<UINT>(sizeof(SimpleVertex)), static_cast<UINT>(sizeof(NormalData)), 0u };
+        UINT aOffsets[3] = { 0u, 0u, 0u };
+        auto bindCaster = [&](Renderable* pRenderable, BOOL bIsVoxel)
+        {
+            CBShadowMatrix cb = {
+                .World = XMMatrixTranspose(pRenderable->GetWorldMatrix()),
+                .View = view,
+                .Projection = projection,
+                .IsVoxel = bIsVoxel
+            };
+            m_stateCache.UpdateConstantBuffer(m_cbShadowMatrix.Get(), &cb, sizeof(cb));
+            m_stateCache.IASetIndexBuffer(pRenderable->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+        };
+        auto drawRenderable = [&](Renderable* pRenderable)
+        {
+            m_stateCache.IASetVertexBuffers(0u, 1u, pRenderable->GetVertexBuffer().GetAddressOf(), aStrides, aOffsets);
+            m_stateCache.IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
+            m_stateCache.VSSetShader(m_shadowVertexShader->GetVertexShader().Get());
+            bindCaster(pRenderable, FALSE);
+            m_stateCache.DrawIndexed(pRenderable->GetNumIndices(), 0, 0);
+        };
+        auto drawMeshes = [&](Renderable* pRenderable)
+        {
+            m_stateCache.IASetVertexBuffers(0u, 1u, pRenderable->GetVertexBuffer().GetAddressOf(), aStrides, aOffsets);
+            m_stateCache.IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
+            m_stateCache.VSSetShader(m_shadowVertexShader->GetVertexShader().Get());
+            bindCaster(pRenderable, FALSE);
+            for (UINT k = 0u; k < pRenderable->GetNumMeshes(); ++k)
+            {
+                m_stateCache.DrawIndexed(pRenderable->GetMesh(k).uNumIndices, pRenderable->GetMesh(k).uBaseIndex, pRenderable->GetMesh(k).uBaseVertex);
+            }
+        };
+        auto drawVoxel = [&](Voxel* pVoxel)
         {
-            if (i.first == m_pszMainSceneName)
+            if (pVoxel->GetNumInstances() == 0u)
             {
-                for (auto j : i.second->GetVoxels())
+                return;
+            }
+
+            if (pVoxel->IsQuantized())
+            {
+                // Grid positions are read with the layout of the voxel
+                // vertex shader, which also takes the normal buffer
+                if (!m_shadowQuantizedVertexShader)
                 {
-                    UINT uStride = static_cast<UINT>(sizeof(SimpleVertex));
-                    UINT uOffset = 0u;
-                    m_immediateContext->IASetVertexBuffers(0u, 1u, j->GetVertexBuffer().GetAddressOf(), &uStride, &uOffset);
-                    m_immediateContext->IASetIndexBuffer(j->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
-                    m_immediateContext->IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
-                    CBShadowMatrix cb = {
-                        .World = XMMatrixTranspose(j->GetWorldMatrix()),
-                        //.View = XMMatrixTranspose(i.second->GetPointLight(0)->GetViewMatrix()),
-                        //.Projection = XMMatrixTranspose(i.second->GetPointLight(0)->GetProjectionMatrix()),
-                        .IsVoxel = true
-                    };
-                    m_immediateContext->UpdateSubresource(m_cbShadowMatrix.Get(), 0, NULL, &cb, 0, 0);
-                    m_immediateContext->VSSetShader(m_shadowVertexShader->GetVertexShader().Get(), nullptr, 0);
-                    m_immediateContext->VSSetConstantBuffers(0u, 1u, m_cbShadowMatrix.GetAddressOf());
-                    m_immediateContext->PSSetShader(m_shadowPixelShader->GetPixelShader().Get(), nullptr, 0);
-                    m_immediateContext->PSSetConstantBuffers(0u, 1u, m_cbShadowMatrix.GetAddressOf());
-
-                    m_immediateContext->DrawIndexedInstanced(j->GetNumIndices(), j->GetNumInstances(), 0, 0, 0);
+                    return;
                 }
+                ID3D11Buffer* aBuffers[3] = { pVoxel->GetVertexBuffer().Get(), pVoxel->GetNormalBuffer().Get(), pVoxel->GetInstanceBuffer().Get() };
+                aStrides[2] = pVoxel->GetInstanceStride();
+                m_stateCache.IASetVertexBuffers(0u, 3u, aBuffers, aStrides, aOffsets);
+                m_stateCache.IASetInputLayout(m_shadowQuantizedVertexShader->GetVertexLayout().Get());
+                m_stateCache.VSSetShader(m_shadowQuantizedVertexShader->GetVertexShader().Get());
             }
-        }
-        for (auto i : m_scenes)
+            else
+            {
+                ID3D11Buffer* aBuffers[2] = { pVoxel->GetVertexBuffer().Get(), pVoxel->GetInstanceBuffer().Get() };
+                UINT aVoxelStrides[2] = { aStrides[0], pVoxel->GetInstanceStride() };
+                m_stateCache.IASetVertexBuffers(0u, 2u, aBuffers, aVoxelStrides, aOffsets);
+                m_stateCache.IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
+                m_stateCache.VSSetShader(m_shadowVertexShader->GetVertexShader().Get());
+            }
+            bindCaster(pVoxel, TRUE);
+            m_stateCache.DrawIndexedInstanced(pVoxel->GetNumIndices(), pVoxel->GetNumInstances(), 0, 0, 0);
+        };
+
+        for (UINT uCascade = 0u; uCascade < NUM_CASCADES; ++uCascade)
         {
-            if (i.first == m_pszMainSceneName)
+            const XMMATRIX& cascadeProjection = m_shadowCascades.GetProjection(uCascade);
+            projection = XMMatrixTranspose(cascadeProjection);
+
+            // The snapped projection of a cascade only moves when the
+            // camera has moved by a step of the cascade
+            if (bStaticLayerDirty || memcmp(&m_aStaticShadowProjections[uCascade], &cascadeProjection, sizeof(XMMATRIX)) != 0)
             {
-                for (auto j : i.second->GetModels())
+                m_aStaticShadowProjections[uCascade] = cascadeProjection;
+                m_pCommandContext->OMSetRenderTargets(0u, nullptr, D3D11CommandContext::ToHandle(m_staticShadowMap->GetDepthStencilView(uCascade).Get()));
+                m_pCommandContext->ClearDepthStencilView(D3D11CommandContext::ToHandle(m_staticShadowMap->GetDepthStencilView(uCascade).Get()), CommandContext::CLEAR_DEPTH, 1.0f, 0u);
+                m_staticShadowCuller.Cull(m_shadowCascades.GetView(), cascadeProjection);
+
+                UINT uBoundsIdx = 0u;
+                for (const std::shared_ptr<Renderable>& renderable : m_mainScene->GetRenderables())
+                {
+                    if (renderable->IsStatic() && m_staticShadowCuller.IsVisible(uBoundsIdx++))
+                    {
+                        drawRenderable(renderable.get());
+                    }
+                }
+                for (const std::shared_ptr<Voxel>& voxel : m_mainScene->GetVoxels())
                 {
-                    UINT uStride = static_cast<UINT>(sizeof(SimpleVertex));
-                    UINT uOffset = 0u;
-                    m_immediateContext->IASetVertexBuffers(0u, 1u, j.second->GetVertexBuffer().GetAddressOf(), &uStride, &uOffset);
-                    m_immediateContext->IASetIndexBuffer(j.second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
-                    m_immediateContext->IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
-                    CBShadowMatrix cb = {
-                        .World = XMMatrixTranspose(j.second->GetWorldMatrix()),
-                        //.View = XMMatrixTranspose(i.second->GetPointLight(0)->GetViewMatrix()),
-                        //.Projection = XMMatrixTranspose(i.second->GetPointLight(0)->GetProjectionMatrix()),
-                        .IsVoxel = false
-                    };
-
-                    m_immediateContext->UpdateSubresource(m_cbShadowMatrix.Get(), 0, NULL, &cb, 0, 0);
-                    m_immediateContext->VSSetShader(m_shadowVertexShader->GetVertexShader().Get(), nullptr, 0);
-                    m_immediateContext->VSSetConstantBuffers(0u, 1u, m_cbShadowMatrix.GetAddressOf());
-                    m_immediateContext->PSSetShader(m_shadowPixelShader->GetPixelShader().Get(), nullptr, 0);
-                    m_immediateContext->PSSetConstantBuffers(0u, 1u, m_cbShadowMatrix.GetAddressOf());
-                    for (UINT k = 0; k < j.second->GetNumMeshes(); k++)
+                    if (m_staticShadowCuller.IsVisible(uBoundsIdx++))
                     {
-                        m_immediateContext->DrawIndexed(j.second->GetMesh(k).uNumIndices, j.second->GetMesh(k).uBaseIndex, j.second->GetMesh(k).uBaseVertex);
+                        drawVoxel(voxel.get());
                     }
                 }
+                for (const std::shared_ptr<VoxelChunk>& chunk : m_mainScene->GetVoxelChunks())
+                {
+                    if (!m_staticShadowCuller.IsVisible(uBoundsIdx++))
+                    {
+                        continue;
+                    }
+                    for (const std::shared_ptr<Voxel>& voxel : chunk->GetVoxels())
+                    {
+                        drawVoxel(voxel.get());
+                    }
+
+                    const std::shared_ptr<VoxelMesh>& voxelMesh = chunk->GetVoxelMesh();
+                    if (voxelMesh && voxelMesh->GetNumIndices() > 0u)
+                    {
+                        drawMeshes(voxelMesh.get());
+                    }
+                }
+            }
+
+            // The slice is unbound before it is copied from
+            m_pCommandContext->OMSetRenderTargets(0u, nullptr, nullptr);
+            m_pCommandContext->CopySubresource(
+                D3D11CommandContext::ToHandle<ID3D11Resource>(m_shadowMap->GetTexture2D().Get()),
+                m_shadowMap->GetSubresource(uCascade),
+                D3D11CommandContext::ToHandle<ID3D11Resource>(m_staticShadowMap->GetTexture2D().Get()),
+                m_staticShadowMap->GetSubresource(uCascade)
+            );
+
+            m_pCommandContext->OMSetRenderTargets(0u, nullptr, D3D11CommandContext::ToHandle(m_shadowMap->GetDepthStencilView(uCascade).Get()));
+            m_shadowCuller.Cull(m_shadowCascades.GetView(), cascadeProjection);
+
+            UINT uBoundsIdx = 0u;
+            for (const std::shared_ptr<Renderable>& renderable : m_mainScene->GetRenderables())
+            {
+                if (!renderable->IsStatic() && m_shadowCuller.IsVisible(uBoundsIdx++))
+                {
+                    drawRenderable(renderable.get());
+                }
+            }
+            for (const std::shared_ptr<Model>& model : m_mainScene->GetModels())
+            {
+                // Models cast the shadow of their bind pose
+                if (m_shadowCuller.IsVisible(uBoundsIdx++))
+                {
+                    drawMeshes(model.get());
+                }
             }
         }
-        m_immediateContext->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), m_depthStencilView.Get());
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -833,4 +1909,192 @@ namespace library
     {
         return m_driverType;
     }
-}
\ No newline at end of file
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetNumVisibleObjects
+      Summary:  Returns the number of renderables, models, voxels and
+                voxel chunks that passed frustum and occlusion culling
+                in the last frame
+      Returns:  UINT
+                  Number of visible objects
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderer::GetNumVisibleObjects() const
+    {
+        return m_frustumCuller.GetNumVisible() - m_uNumOccluded;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetNumCulledObjects
+      Summary:  Returns the number of renderables, models, voxels and
+                voxel chunks skipped by frustum culling in the last
+                frame
+      Returns:  UINT
+                  Number of culled objects
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderer::GetNumCulledObjects() const
+    {
+        return m_frustumCuller.GetNumCulled();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetNumOccludedObjects
+      Summary:  Returns the number of voxel chunks and models that were
+                in the frustum but hidden behind occluders in the last
+                frame
+      Returns:  UINT
+                  Number of occluded objects
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderer::GetNumOccludedObjects() const
+    {
+        return m_uNumOccluded;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetNumStateChanges
+      Summary:  Returns the number of pass, shader, material and texture
+                changes between the sorted draws of the last frame
+      Returns:  UINT
+                  Number of state changes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderer::GetNumStateChanges() const
+    {
+        return m_renderQueue.GetNumStateChanges();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetNumStateChangesSaved
+      Summary:  Returns how many state changes sorting the draws of the
+                last frame removed, compared to drawing them in the
+                order the scene stores them
+      Returns:  UINT
+                  Number of state changes removed by sorting
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderer::GetNumStateChangesSaved() const
+    {
+        return m_renderQueue.GetNumUnsortedStateChanges() - m_renderQueue.GetNumStateChanges();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetNumIssuedCalls
+      Summary:  Returns the number of bind, upload and draw calls that
+                reached the immediate context or a command list in the
+                last frame
+      Returns:  UINT
+                  Number of issued calls
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderer::GetNumIssuedCalls() const
+    {
+        UINT uNumIssuedCalls = m_stateCache.GetNumIssuedCalls();
+        for (UINT i = 0u; i < m_uNumCommandLists; ++i)
+        {
+            uNumIssuedCalls += m_aRecordingWorkers[i]->Cache.GetNumIssuedCalls();
+        }
+
+        return uNumIssuedCalls;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetNumSkippedCalls
+      Summary:  Returns the number of bind calls and constant buffer
+                uploads dropped as redundant in the last frame
+      Returns:  UINT
+                  Number of skipped calls
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderer::GetNumSkippedCalls() const
+    {
+        UINT uNumSkippedCalls = m_stateCache.GetNumSkippedCalls();
+        for (UINT i = 0u; i < m_uNumCommandLists; ++i)
+        {
+            uNumSkippedCalls += m_aRecordingWorkers[i]->Cache.GetNumSkippedCalls();
+        }
+
+        return uNumSkippedCalls;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetNumCommandLists
+      Summary:  Returns the number of command lists the draws of the
+                last frame were recorded into in parallel, 0 when they
+                were recorded on the immediate context
+      Returns:  UINT
+                  Number of command lists
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderer::GetNumCommandLists() const
+    {
+        return m_uNumCommandLists;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetNumClusteredLights
+      Summary:  Returns the number of point lights assigned to the
+                clusters of the view in the last frame
+      Returns:  UINT
+                  Number of clustered lights
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderer::GetNumClusteredLights() const
+    {
+        return m_lightClusterer.GetNumLights();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetNumLightIndices
+      Summary:  Returns the total length of the light lists of the
+                clusters in the last frame. Divided by the number of
+                clusters it is the average number of lights a pixel
+                shades
+      Returns:  UINT
+                  Number of light indices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderer::GetNumLightIndices() const
+    {
+        return m_lightClusterer.GetNumLightIndices();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::IsHeadless
+      Summary:  Returns whether the renderer was initialized without a
+                window, so frames are recorded instead of drawn
+      Returns:  BOOL
+                  Whether the renderer is headless
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Renderer::IsHeadless() const
+    {
+        return m_pCommandContext == &m_recordingCommandContext;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetRecordedCommands
+      Summary:  Returns the binds, uploads and draws recorded in the
+                last frame of a headless renderer
+      Returns:  const std::vector<RecordedCommand>&
+                  Recorded commands in call order
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<RecordedCommand>& Renderer::GetRecordedCommands() const
+    {
+        return m_recordingCommandContext.GetCommands();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetCommandStreamAnalyzer
+      Summary:  Returns the draw, bind and upload counts of the last
+                frame of a headless renderer
+      Returns:  const CommandStreamAnalyzer&
+                  Summary of the last recorded frame
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const CommandStreamAnalyzer& Renderer::GetCommandStreamAnalyzer() const
+    {
+        return m_commandStreamAnalyzer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetProfiledContext
+      Summary:  Returns the immediate context the GPU zones of the
+                profiler are timed on
+      Returns:  ID3D11DeviceContext*
+                  Immediate context, nullptr when headless
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ID3D11DeviceContext* Renderer::GetProfiledContext() const
+    {
+        return IsHeadless() ? nullptr : m_immediateContext.Get();
+    }
+}
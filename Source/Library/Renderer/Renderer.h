@@ -16,14 +16,27 @@
 #include "Camera/Camera.h"
 #include "Light/PointLight.h"
 #include "Model/Model.h"
+#include "Profiler/Profiler.h"
+#include "Renderer/CommandContext.h"
+#include "Renderer/CommandStreamAnalyzer.h"
+#include "Renderer/ConstantBufferRing.h"
+#include "Renderer/D3D11CommandContext.h"
 #include "Renderer/DataTypes.h"
+#include "Renderer/FrustumCuller.h"
+#include "Renderer/LightClusterer.h"
+#include "Renderer/OcclusionRasterizer.h"
+#include "Renderer/RecordingCommandContext.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/RenderQueue.h"
+#include "Renderer/ShadowCascades.h"
+#include "Renderer/StateCache.h"
 #include "Scene/Scene.h"
 #include "Shader/PixelShader.h"
 #include "Shader/VertexShader.h"
 #include "Window/MainWindow.h"
-#include "Texture/RenderTexture.h"
+#include "Texture/ShadowMap.h"
 #include "Shader/ShadowVertexShader.h"
+#include "Thread/ThreadPool.h"
 
 namespace library
 {
@@ -35,14 +48,68 @@ namespace library
 
       Methods:  Initialize
                   Creates Direct3D device and swap chain
+                InitializeHeadless
+                  Creates a Direct3D device that does not draw, and
+                  records the commands of each frame instead
                 AddRenderable
                   Add a renderable object and initialize the object
+                SetShadowMapShaders
+                  Sets the vertex shaders of the shadow pass
+                SetShadowMapSize
+                  Sets the width and height of the shadow map
+                SetShadowMapFormat
+                  Sets the depth format of the shadow map
+                SetShadowDistance
+                  Sets the view distance the cascaded shadows end at
+                SetDepthPrepass
+                  Turns the depth pre-pass on or off
+                IsDepthPrepassEnabled
+                  Returns whether the depth pre-pass is on
                 Update
                   Update the renderables each frame
                 Render
                   Renders the frame
                 GetDriverType
                   Returns the Direct3D driver type
+                GetNumVisibleObjects
+                  Returns the number of objects drawn in the last frame
+                GetNumCulledObjects
+                  Returns the number of objects culled in the last
+                  frame
+                GetNumOccludedObjects
+                  Returns the number of objects hidden behind
+                  occluders in the last frame
+                GetNumStateChanges
+                  Returns the number of state changes in the last
+                  frame
+                GetNumStateChangesSaved
+                  Returns the number of state changes removed by
+                  sorting the draws in the last frame
+                GetNumIssuedCalls
+                  Returns the number of calls that reached the device
+                  context in the last frame
+                GetNumSkippedCalls
+                  Returns the number of redundant calls dropped in the
+                  last frame
+                GetNumCommandLists
+                  Returns the number of command lists the draws of the
+                  last frame were recorded into
+                GetNumClusteredLights
+                  Returns the number of point lights assigned to the
+                  clusters in the last frame
+                GetNumLightIndices
+                  Returns the total length of the light lists of the
+                  clusters in the last frame
+                IsHeadless
+                  Returns whether the frames are recorded instead of
+                  drawn
+                GetRecordedCommands
+                  Returns the commands recorded in the last frame
+                GetCommandStreamAnalyzer
+                  Returns the summary of the last recorded frame
+                GetProfiledContext
+                  Returns the context the GPU zones of the profiler
+                  are timed on
                 Renderer
                   Constructor.
                 ~Renderer
@@ -59,11 +126,17 @@ namespace library
         ~Renderer() = default;
 
         HRESULT Initialize(_In_ HWND hWnd);
+        HRESULT InitializeHeadless(_In_ UINT uWidth, _In_ UINT uHeight);
 
         HRESULT AddScene(_In_ PCWSTR pszSceneName, _In_ const std::shared_ptr<Scene>& scene);
         std::shared_ptr<Scene> GetSceneOrNull(_In_ PCWSTR pszSceneName);
         HRESULT SetMainScene(_In_ PCWSTR pszSceneName);
-        void SetShadowMapShaders(_In_ std::shared_ptr<ShadowVertexShader> vertexShader, _In_ std::shared_ptr<PixelShader> pixelShader);
+        void SetShadowMapShaders(_In_ std::shared_ptr<ShadowVertexShader> vertexShader, _In_ std::shared_ptr<VertexShader> quantizedVertexShader);
+        void SetShadowMapSize(_In_ UINT uSize);
+        void SetShadowMapFormat(_In_ DXGI_FORMAT depthFormat);
+        void SetShadowDistance(_In_ FLOAT shadowDistance);
+        void SetDepthPrepass(_In_ BOOL bDepthPrepass);
+        BOOL IsDepthPrepassEnabled() const;
 
         void HandleInput(_In_ const DirectionsInput& directions, _In_ const MouseRelativeMovement& mouseRelativeMovement, _In_ FLOAT deltaTime);
         void Update(_In_ FLOAT deltaTime);
@@ -71,6 +144,95 @@ namespace library
         void RenderSceneToTexture();
 
         D3D_DRIVER_TYPE GetDriverType() const;
+        UINT GetNumVisibleObjects() const;
+        UINT GetNumCulledObjects() const;
+        UINT GetNumOccludedObjects() const;
+        UINT GetNumStateChanges() const;
+        UINT GetNumStateChangesSaved() const;
+        UINT GetNumIssuedCalls() const;
+        UINT GetNumSkippedCalls() const;
+        UINT GetNumCommandLists() const;
+        UINT GetNumClusteredLights() const;
+        UINT GetNumLightIndices() const;
+        BOOL IsHeadless() const;
+        const std::vector<RecordedCommand>& GetRecordedCommands() const;
+        const CommandStreamAnalyzer& GetCommandStreamAnalyzer() const;
+        ID3D11DeviceContext* GetProfiledContext() const;
+
+    private:
+        static constexpr const FLOAT NEAR_PLANE = 0.01f;
+        static constexpr const FLOAT FAR_PLANE = 1000.0f;
+        static constexpr const UINT MIN_DRAWS_PER_COMMAND_LIST = 64u;
+        static constexpr const UINT MIN_INSTANCES_PER_DRAW = 2u;
+        static constexpr const UINT DEFAULT_SHADOW_MAP_SIZE = 2048u;
+        static constexpr const DXGI_FORMAT DEFAULT_SHADOW_MAP_FORMAT = DXGI_FORMAT_D32_FLOAT;
+
+        /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+          Enum:     eDrawCallType
+
+          Summary:  Kinds of objects a queued draw comes from, they
+                    differ in their vertex streams and constants
+        E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+        enum class eDrawCallType : BYTE
+        {
+            RENDERABLE,
+            VOXEL,
+            VOXEL_MESH,
+            MODEL,
+            SKYBOX,
+            INSTANCED_RENDERABLE,
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   DrawCall
+
+          Summary:  Draw of one mesh of a renderable, or of all of its
+                    indices when uMeshIndex is ALL_MESHES. The first
+                    constants locate its per-object constants in the
+                    constant buffer ring. An instanced draw draws
+                    uNumInstances copies of pRenderable with the world
+                    matrices from uFirstInstance of the instance buffer
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct DrawCall
+        {
+            static constexpr const UINT ALL_MESHES = UINT_MAX;
+
+            eDrawCallType Type;
+            Renderable* pRenderable;
+            const Material* pMaterial;
+            UINT uMeshIndex;
+            UINT uFirstConstant;
+            UINT uFirstSkinningConstant;
+            UINT uFirstInstance;
+            UINT uNumInstances;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   RecordingWorker
+
+          Summary:  Deferred context that records one slice of the
+                    sorted draws into a command list, with the state
+                    cache filtering its binds. pContext is D3D11Context
+                    on a deferred device context, or RecordingContext
+                    when headless
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct RecordingWorker
+        {
+            ComPtr<ID3D11DeviceContext> DeferredContext;
+            ComPtr<ID3D11DeviceContext1> DeferredContext1;
+            D3D11CommandContext D3D11Context;
+            RecordingCommandContext RecordingContext;
+            CommandContext* pContext;
+            StateCache Cache;
+        };
+
+    private:
+        HRESULT initialize(_In_opt_ HWND hWnd, _In_ UINT uWidth, _In_ UINT uHeight);
+        HRESULT createSwapChain(_In_ HWND hWnd, _In_ UINT uWidth, _In_ UINT uHeight, _Outptr_ ID3D11Texture2D** ppBackBuffer);
+        HRESULT createRecordingWorkers();
+        HRESULT reserveInstanceBuffer(_In_ UINT uNumInstances);
+        void bindFrameState(_In_ StateCache& stateCache, _In_ CommandContext* pContext);
+        void recordDraws(_In_ StateCache& stateCache, _In_ UINT uBeginItem, _In_ UINT uEndItem, _In_ BOOL bUseRing, _In_ BOOL bDepthOnly);
 
     private:
         D3D_DRIVER_TYPE m_driverType;
@@ -84,18 +246,53 @@ namespace library
         ComPtr<ID3D11RenderTargetView> m_renderTargetView;
         ComPtr<ID3D11Texture2D> m_depthStencil;
         ComPtr<ID3D11DepthStencilView> m_depthStencilView;
+        D3D11_VIEWPORT m_viewport;
         ComPtr<ID3D11Buffer> m_cbChangeOnResize;
         ComPtr<ID3D11Buffer> m_cbLights;
         ComPtr<ID3D11Buffer> m_cbShadowMatrix;
+        ComPtr<ID3D11Buffer> m_cbShadowCascades;
+        ComPtr<ID3D11Buffer> m_cbLightClusters;
         PCWSTR m_pszMainSceneName;
         BYTE m_padding[8];
         Camera m_camera;
         XMMATRIX m_projection;
 
         std::unordered_map<std::wstring, std::shared_ptr<Scene>> m_scenes;
+        std::shared_ptr<Scene> m_mainScene;
         std::shared_ptr<Texture> m_invalidTexture;
-        std::shared_ptr<RenderTexture> m_shadowMapTexture;
+        std::shared_ptr<ShadowMap> m_shadowMap;
+        std::shared_ptr<ShadowMap> m_staticShadowMap;
+        UINT m_uShadowMapSize;
+        DXGI_FORMAT m_shadowMapFormat;
         std::shared_ptr<ShadowVertexShader> m_shadowVertexShader;
-        std::shared_ptr<PixelShader> m_shadowPixelShader;
+        std::shared_ptr<VertexShader> m_shadowQuantizedVertexShader;
+        ShadowCascades m_shadowCascades;
+        FrustumCuller m_shadowCuller;
+        FrustumCuller m_staticShadowCuller;
+        XMMATRIX m_staticShadowView;
+        XMMATRIX m_aStaticShadowProjections[NUM_CASCADES];
+        UINT64 m_uStaticShadowVersion;
+        BOOL m_bStaticShadowValid;
+        LightClusterer m_lightClusterer;
+        ComPtr<ID3D11DepthStencilState> m_depthEqualState;
+        BOOL m_bDepthPrepass;
+        FrustumCuller m_frustumCuller;
+        OcclusionRasterizer m_occlusionRasterizer;
+        ThreadPool m_threadPool;
+        UINT m_uNumOccluded;
+        RenderQueue m_renderQueue;
+        std::vector<DrawCall> m_aDrawCalls;
+        StateCache m_stateCache;
+        ConstantBufferRing m_constantBufferRing;
+        D3D11CommandContext m_d3d11CommandContext;
+        RecordingCommandContext m_recordingCommandContext;
+        CommandContext* m_pCommandContext;
+        CommandStreamAnalyzer m_commandStreamAnalyzer;
+        std::vector<std::unique_ptr<RecordingWorker>> m_aRecordingWorkers;
+        UINT m_uNumCommandLists;
+        ComPtr<ID3D11Buffer> m_instanceBuffer;
+        UINT m_uInstanceBufferCapacity;
+        std::vector<Renderable*> m_aInstanceCandidates;
+        std::vector<InstanceData> m_aInstances;
     };
 }
\ No newline at end of file
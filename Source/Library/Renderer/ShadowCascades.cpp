@@ -0,0 +1,207 @@
+#include "Renderer/ShadowCascades.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShadowCascades::ShadowCascades
+
+      Summary:  Constructor
+
+      Modifies: [m_view, m_aProjections, m_aSplitDistances,
+                 m_shadowDistance].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ShadowCascades::ShadowCascades()
+        : m_view(XMMatrixIdentity())
+        , m_aProjections()
+        , m_aSplitDistances()
+        , m_shadowDistance(DEFAULT_SHADOW_DISTANCE)
+    {
+        for (UINT i = 0u; i < NUM_CASCADES; ++i)
+        {
+            m_aProjections[i] = XMMatrixIdentity();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShadowCascades::SetShadowDistance
+
+      Summary:  Sets the view distance the shadows end at. A shorter
+                distance gives every cascade more texels per unit
+
+      Args:     FLOAT shadowDistance
+                  View depth of the end of the last cascade
+
+      Modifies: [m_shadowDistance].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ShadowCascades::SetShadowDistance(_In_ FLOAT shadowDistance)
+    {
+        m_shadowDistance = shadowDistance;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShadowCascades::Update
+
+      Summary:  Fits the cascades to the view frustum. The light view
+                only rotates, so a cascade moves in whole texels when
+                its center is snapped. The center, its depth included,
+                is snapped to a STEPS_PER_CASCADE-th of the width of
+                the cascade, so a projection stays exactly the same
+                until the camera has moved by such a step. The static
+                shadow layer shares the projections and is rendered
+                again only then. Each projection reaches
+                CASTER_DISTANCE further toward the light than its slice
+                so casters outside the view still throw their shadows
+                into it
+
+      Args:     const XMMATRIX& view
+                  View matrix of the camera
+                const XMMATRIX& projection
+                  Perspective projection matrix of the camera
+                FLOAT nearPlane
+                  Near plane of the projection
+                FLOAT farPlane
+                  Far plane of the projection
+                const XMFLOAT4& lightDirection
+                  Direction the light travels in
+                UINT uShadowMapSize
+                  Width and height of a slice of the shadow map
+
+      Modifies: [m_view, m_aProjections, m_aSplitDistances].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ShadowCascades::Update(
+        _In_ const XMMATRIX& view,
+        _In_ const XMMATRIX& projection,
+        _In_ FLOAT nearPlane,
+        _In_ FLOAT farPlane,
+        _In_ const XMFLOAT4& lightDirection,
+        _In_ UINT uShadowMapSize
+    )
+    {
+        static constexpr const FLOAT s_aCornersX[4] = { -1.0f, 1.0f, 1.0f, -1.0f };
+        static constexpr const FLOAT s_aCornersY[4] = { 1.0f, 1.0f, -1.0f, -1.0f };
+
+        // Corners of the near and far planes of the view frustum in
+        // world space. A point at a view depth lies on the line between
+        // a near and a far corner at the same fraction of the depth
+        const XMMATRIX inverseViewProjection = XMMatrixInverse(nullptr, XMMatrixMultiply(view, projection));
+        XMVECTOR aNearCorners[4];
+        XMVECTOR aFarCorners[4];
+        for (UINT i = 0u; i < 4u; ++i)
+        {
+            aNearCorners[i] = XMVector3TransformCoord(XMVectorSet(s_aCornersX[i], s_aCornersY[i], 0.0f, 1.0f), inverseViewProjection);
+            aFarCorners[i] = XMVector3TransformCoord(XMVectorSet(s_aCornersX[i], s_aCornersY[i], 1.0f, 1.0f), inverseViewProjection);
+        }
+
+        const XMVECTOR direction = XMVector3Normalize(XMVectorSetW(XMLoadFloat4(&lightDirection), 0.0f));
+        const XMVECTOR up = fabsf(XMVectorGetY(direction)) > 0.99f ? VERTICAL_UP : DEFAULT_UP;
+        m_view = XMMatrixLookToLH(XMVectorZero(), direction, up);
+
+        const FLOAT shadowDistance = (std::min)(m_shadowDistance, farPlane);
+        const FLOAT depthRange = farPlane - nearPlane;
+        FLOAT splitBegin = nearPlane;
+        for (UINT uCascade = 0u; uCascade < NUM_CASCADES; ++uCascade)
+        {
+            const FLOAT fraction = static_cast<FLOAT>(uCascade + 1u) / static_cast<FLOAT>(NUM_CASCADES);
+            const FLOAT logSplit = nearPlane * powf(shadowDistance / nearPlane, fraction);
+            const FLOAT uniformSplit = nearPlane + (shadowDistance - nearPlane) * fraction;
+            const FLOAT splitEnd = SPLIT_LAMBDA * logSplit + (1.0f - SPLIT_LAMBDA) * uniformSplit;
+            m_aSplitDistances[uCascade] = splitEnd;
+
+            XMVECTOR aCorners[8];
+            XMVECTOR center = XMVectorZero();
+            for (UINT i = 0u; i < 4u; ++i)
+            {
+                aCorners[i] = XMVectorLerp(aNearCorners[i], aFarCorners[i], (splitBegin - nearPlane) / depthRange);
+                aCorners[i + 4u] = XMVectorLerp(aNearCorners[i], aFarCorners[i], (splitEnd - nearPlane) / depthRange);
+                center = XMVectorAdd(center, XMVectorAdd(aCorners[i], aCorners[i + 4u]));
+            }
+            center = XMVectorScale(center, 1.0f / 8.0f);
+
+            // The sphere does not change size as the camera turns, and
+            // is rounded so it does not change with rounding errors
+            // either. The size of a texel stays the same with it
+            FLOAT radius = 0.0f;
+            for (UINT i = 0u; i < 8u; ++i)
+            {
+                radius = (std::max)(radius, XMVectorGetX(XMVector3Length(XMVectorSubtract(aCorners[i], center))));
+            }
+            radius = ceilf(radius * 16.0f) / 16.0f;
+
+            // The snapped center is up to half a step away from the
+            // sphere, so the cascade is widened by half a step. A step
+            // is a whole number of texels of the widened cascade
+            const UINT uStepTexels = (std::max)(uShadowMapSize / STEPS_PER_CASCADE, 1u);
+            const FLOAT halfWidth = radius * static_cast<FLOAT>(uShadowMapSize) / static_cast<FLOAT>(uShadowMapSize - uStepTexels);
+            const FLOAT stepSize = 2.0f * halfWidth * static_cast<FLOAT>(uStepTexels) / static_cast<FLOAT>(uShadowMapSize);
+            XMFLOAT3 lightCenter;
+            XMStoreFloat3(&lightCenter, XMVector3TransformCoord(center, m_view));
+            lightCenter.x = roundf(lightCenter.x / stepSize) * stepSize;
+            lightCenter.y = roundf(lightCenter.y / stepSize) * stepSize;
+            lightCenter.z = roundf(lightCenter.z / stepSize) * stepSize;
+
+            m_aProjections[uCascade] = XMMatrixOrthographicOffCenterLH(
+                lightCenter.x - halfWidth,
+                lightCenter.x + halfWidth,
+                lightCenter.y - halfWidth,
+                lightCenter.y + halfWidth,
+                lightCenter.z - halfWidth - CASTER_DISTANCE,
+                lightCenter.z + halfWidth
+            );
+
+            splitBegin = splitEnd;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShadowCascades::GetView
+
+      Summary:  Returns the view matrix of the light, shared by all
+                cascades
+
+      Returns:  const XMMATRIX&
+                  View matrix of the light
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMMATRIX& ShadowCascades::GetView() const
+    {
+        return m_view;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShadowCascades::GetProjection
+
+      Summary:  Returns the orthographic projection matrix of a cascade
+
+      Args:     UINT uCascade
+                  Index of the cascade
+
+      Returns:  const XMMATRIX&
+                  Projection matrix of the cascade
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMMATRIX& ShadowCascades::GetProjection(_In_ UINT uCascade) const
+    {
+        assert(uCascade < NUM_CASCADES);
+
+        return m_aProjections[uCascade];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShadowCascades::GetSplitDistance
+
+      Summary:  Returns the view depth a cascade ends at
+
+      Args:     UINT uCascade
+                  Index of the cascade
+
+      Returns:  FLOAT
+                  View depth of the far end of the cascade
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT ShadowCascades::GetSplitDistance(_In_ UINT uCascade) const
+    {
+        assert(uCascade < NUM_CASCADES);
+
+        return m_aSplitDistances[uCascade];
+    }
+}
@@ -0,0 +1,87 @@
+/*+===================================================================
+  File:      SHADOWCASCADES.H
+
+  Summary:   ShadowCascades header file contains declarations of
+             ShadowCascades class that splits the view frustum into
+             the cascades of the shadow map of a directional light.
+
+  Classes: ShadowCascades
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ShadowCascades
+
+      Summary:  Splits the view frustum up to the shadow distance into
+                NUM_CASCADES slices, each shadowed by its own slice of
+                the shadow map. The splits blend logarithmic and
+                uniform spacing. Every cascade is an orthographic
+                projection around the bounding sphere of its slice,
+                with the sphere rounded and its center snapped to
+                steps of whole texels, so the shadows do not shimmer
+                as the camera moves or turns and the cascades only
+                move every few units
+
+      Methods:  SetShadowDistance
+                  Sets the view distance the shadows end at
+                Update
+                  Fits the cascades to the view frustum
+                GetView
+                  Returns the view matrix of the light
+                GetProjection
+                  Returns the projection matrix of a cascade
+                GetSplitDistance
+                  Returns the view depth a cascade ends at
+                ShadowCascades
+                  Constructor.
+                ~ShadowCascades
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ShadowCascades final
+    {
+    public:
+        static constexpr const FLOAT DEFAULT_SHADOW_DISTANCE = 300.0f;
+        static constexpr const FLOAT SPLIT_LAMBDA = 0.75f;
+        static constexpr const FLOAT CASTER_DISTANCE = 500.0f;
+        static constexpr const UINT STEPS_PER_CASCADE = 8u;
+
+    public:
+        ShadowCascades();
+        ShadowCascades(const ShadowCascades& other) = delete;
+        ShadowCascades(ShadowCascades&& other) = delete;
+        ShadowCascades& operator=(const ShadowCascades& other) = delete;
+        ShadowCascades& operator=(ShadowCascades&& other) = delete;
+        ~ShadowCascades() = default;
+
+        void SetShadowDistance(_In_ FLOAT shadowDistance);
+        void Update(
+            _In_ const XMMATRIX& view,
+            _In_ const XMMATRIX& projection,
+            _In_ FLOAT nearPlane,
+            _In_ FLOAT farPlane,
+            _In_ const XMFLOAT4& lightDirection,
+            _In_ UINT uShadowMapSize
+        );
+
+        const XMMATRIX& GetView() const;
+        const XMMATRIX& GetProjection(_In_ UINT uCascade) const;
+        FLOAT GetSplitDistance(_In_ UINT uCascade) const;
+
+    private:
+        static constexpr const XMVECTORF32 DEFAULT_UP = { 0.0f, 1.0f, 0.0f, 0.0f };
+        static constexpr const XMVECTORF32 VERTICAL_UP = { 0.0f, 0.0f, 1.0f, 0.0f };
+
+        XMMATRIX m_view;
+        XMMATRIX m_aProjections[NUM_CASCADES];
+        FLOAT m_aSplitDistances[NUM_CASCADES];
+        FLOAT m_shadowDistance;
+    };
+}
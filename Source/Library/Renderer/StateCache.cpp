@@ -0,0 +1,623 @@
+#include "Renderer/StateCache.h"
+
+#include "Renderer/D3D11CommandContext.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::StateCache
+
+      Summary:  Constructor
+
+      Modifies: [m_pContext, m_bindings, m_uploads, m_uNumIssuedCalls,
+                 m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    StateCache::StateCache()
+        : m_pContext(nullptr)
+        , m_bindings()
+        , m_uploads()
+        , m_uNumIssuedCalls(0u)
+        , m_uNumSkippedCalls(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::BeginFrame
+
+      Summary:  Starts a frame on a command context. The bindings and
+                the call counters are reset, and upload hashes of
+                buffers nobody else references anymore are dropped
+
+      Args:     CommandContext* pContext
+                  Context the calls are passed to
+
+      Modifies: [m_pContext, m_bindings, m_uploads, m_uNumIssuedCalls,
+                 m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateCache::BeginFrame(_In_ CommandContext* pContext)
+    {
+        m_pContext = pContext;
+        m_uNumIssuedCalls = 0u;
+        m_uNumSkippedCalls = 0u;
+        Invalidate();
+
+        std::erase_if(
+            m_uploads,
+            [](const auto& upload)
+            {
+                // Only the cache and this call hold the buffer
+                const ULONG uRefCount = upload.second.Buffer->AddRef();
+                upload.second.Buffer->Release();
+                return uRefCount <= 2u;
+            }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::Invalidate
+
+      Summary:  Forgets the tracked bindings, so the next bind of every
+                slot reaches the context
+
+      Modifies: [m_bindings].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateCache::Invalidate()
+    {
+        m_bindings = {};
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::IASetVertexBuffers
+
+      Summary:  Binds vertex buffers. The call is dropped only when
+                every slot in the range already holds the same buffer,
+                stride and offset
+
+      Args:     UINT uStartSlot
+                  First input slot
+                UINT uNumBuffers
+                  Number of buffers
+                ID3D11Buffer* const* ppVertexBuffers
+                  Vertex buffers
+                const UINT* puStrides
+                  Strides of the buffers
+                const UINT* puOffsets
+                  Offsets into the buffers
+
+      Modifies: [m_bindings, m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateCache::IASetVertexBuffers(
+        _In_ UINT uStartSlot,
+        _In_ UINT uNumBuffers,
+        _In_reads_(uNumBuffers) ID3D11Buffer* const* ppVertexBuffers,
+        _In_reads_(uNumBuffers) const UINT* puStrides,
+        _In_reads_(uNumBuffers) const UINT* puOffsets
+    )
+    {
+        BOOL bRedundant = uStartSlot + uNumBuffers <= NUM_VERTEX_BUFFER_SLOTS;
+        for (UINT i = 0u; i < uNumBuffers && bRedundant; ++i)
+        {
+            const UINT uSlot = uStartSlot + i;
+            bRedundant = (m_bindings.uKnownVertexBuffers & (1u << uSlot))
+                && m_bindings.apVertexBuffers[uSlot] == ppVertexBuffers[i]
+                && m_bindings.auStrides[uSlot] == puStrides[i]
+                && m_bindings.auOffsets[uSlot] == puOffsets[i];
+        }
+        if (filter(bRedundant))
+        {
+            return;
+        }
+
+        assert(uNumBuffers <= D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+
+        GpuBuffer* apVertexBuffers[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT] = {};
+        for (UINT i = 0u; i < uNumBuffers; ++i)
+        {
+            apVertexBuffers[i] = D3D11CommandContext::ToHandle(ppVertexBuffers[i]);
+        }
+
+        m_pContext->IASetVertexBuffers(uStartSlot, uNumBuffers, apVertexBuffers, puStrides, puOffsets);
+        for (UINT i = 0u; i < uNumBuffers && uStartSlot + i < NUM_VERTEX_BUFFER_SLOTS; ++i)
+        {
+            const UINT uSlot = uStartSlot + i;
+            m_bindings.apVertexBuffers[uSlot] = ppVertexBuffers[i];
+            m_bindings.auStrides[uSlot] = puStrides[i];
+            m_bindings.auOffsets[uSlot] = puOffsets[i];
+            m_bindings.uKnownVertexBuffers |= 1u << uSlot;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::IASetIndexBuffer
+
+      Summary:  Binds an index buffer
+
+      Args:     ID3D11Buffer* pIndexBuffer
+                  Index buffer
+                DXGI_FORMAT format
+                  Format of the indices
+                UINT uOffset
+                  Offset into the buffer
+
+      Modifies: [m_bindings, m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateCache::IASetIndexBuffer(_In_opt_ ID3D11Buffer* pIndexBuffer, _In_ DXGI_FORMAT format, _In_ UINT uOffset)
+    {
+        if (filter(m_bindings.bKnownIndexBuffer
+            && m_bindings.pIndexBuffer == pIndexBuffer
+            && m_bindings.indexFormat == format
+            && m_bindings.uIndexOffset == uOffset))
+        {
+            return;
+        }
+
+        assert(format == DXGI_FORMAT_R16_UINT || format == DXGI_FORMAT_R32_UINT);
+
+        m_pContext->IASetIndexBuffer(
+            D3D11CommandContext::ToHandle(pIndexBuffer),
+            format == DXGI_FORMAT_R16_UINT ? eIndexFormat::UINT16 : eIndexFormat::UINT32,
+            uOffset
+        );
+        m_bindings.pIndexBuffer = pIndexBuffer;
+        m_bindings.indexFormat = format;
+        m_bindings.uIndexOffset = uOffset;
+        m_bindings.bKnownIndexBuffer = TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::IASetInputLayout
+
+      Summary:  Binds an input layout
+
+      Args:     ID3D11InputLayout* pInputLayout
+                  Input layout
+
+      Modifies: [m_bindings, m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateCache::IASetInputLayout(_In_opt_ ID3D11InputLayout* pInputLayout)
+    {
+        if (filter(m_bindings.bKnownInputLayout && m_bindings.pInputLayout == pInputLayout))
+        {
+            return;
+        }
+
+        m_pContext->IASetInputLayout(D3D11CommandContext::ToHandle(pInputLayout));
+        m_bindings.pInputLayout = pInputLayout;
+        m_bindings.bKnownInputLayout = TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::VSSetShader
+
+      Summary:  Binds a vertex shader without class instances
+
+      Args:     ID3D11VertexShader* pVertexShader
+                  Vertex shader
+
+      Modifies: [m_bindings, m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateCache::VSSetShader(_In_opt_ ID3D11VertexShader* pVertexShader)
+    {
+        if (filter(m_bindings.bKnownVertexShader && m_bindings.pVertexShader == pVertexShader))
+        {
+            return;
+        }
+
+        m_pContext->VSSetShader(D3D11CommandContext::ToHandle(pVertexShader));
+        m_bindings.pVertexShader = pVertexShader;
+        m_bindings.bKnownVertexShader = TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::PSSetShader
+
+      Summary:  Binds a pixel shader without class instances
+
+      Args:     ID3D11PixelShader* pPixelShader
+                  Pixel shader
+
+      Modifies: [m_bindings, m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateCache::PSSetShader(_In_opt_ ID3D11PixelShader* pPixelShader)
+    {
+        if (filter(m_bindings.bKnownPixelShader && m_bindings.pPixelShader == pPixelShader))
+        {
+            return;
+        }
+
+        m_pContext->PSSetShader(D3D11CommandContext::ToHandle(pPixelShader));
+        m_bindings.pPixelShader = pPixelShader;
+        m_bindings.bKnownPixelShader = TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::VSSetConstantBuffer
+
+      Summary:  Binds a constant buffer to the vertex shader
+
+      Args:     UINT uSlot
+                  Constant buffer slot
+                ID3D11Buffer* pConstantBuffer
+                  Constant buffer
+
+      Modifies: [m_bindings, m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateCache::VSSetConstantBuffer(_In_ UINT uSlot, _In_opt_ ID3D11Buffer* pConstantBuffer)
+    {
+        if (filter(uSlot < NUM_CONSTANT_BUFFER_SLOTS
+            && (m_bindings.uKnownVSConstantBuffers & (1u << uSlot))
+            && m_bindings.apVSConstantBuffers[uSlot] == pConstantBuffer
+            && m_bindings.auVSNumConstants[uSlot] == 0u))
+        {
+            return;
+        }
+
+        m_pContext->VSSetConstantBuffer(uSlot, D3D11CommandContext::ToHandle(pConstantBuffer));
+        if (uSlot < NUM_CONSTANT_BUFFER_SLOTS)
+        {
+            m_bindings.apVSConstantBuffers[uSlot] = pConstantBuffer;
+            m_bindings.auVSFirstConstants[uSlot] = 0u;
+            m_bindings.auVSNumConstants[uSlot] = 0u;
+            m_bindings.uKnownVSConstantBuffers |= 1u << uSlot;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::PSSetConstantBuffer
+
+      Summary:  Binds a constant buffer to the pixel shader
+
+      Args:     UINT uSlot
+                  Constant buffer slot
+                ID3D11Buffer* pConstantBuffer
+                  Constant buffer
+
+      Modifies: [m_bindings, m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateCache::PSSetConstantBuffer(_In_ UINT uSlot, _In_opt_ ID3D11Buffer* pConstantBuffer)
+    {
+        if (filter(uSlot < NUM_CONSTANT_BUFFER_SLOTS
+            && (m_bindings.uKnownPSConstantBuffers & (1u << uSlot))
+            && m_bindings.apPSConstantBuffers[uSlot] == pConstantBuffer
+            && m_bindings.auPSNumConstants[uSlot] == 0u))
+        {
+            return;
+        }
+
+        m_pContext->PSSetConstantBuffer(uSlot, D3D11CommandContext::ToHandle(pConstantBuffer));
+        if (uSlot < NUM_CONSTANT_BUFFER_SLOTS)
+        {
+            m_bindings.apPSConstantBuffers[uSlot] = pConstantBuffer;
+            m_bindings.auPSFirstConstants[uSlot] = 0u;
+            m_bindings.auPSNumConstants[uSlot] = 0u;
+            m_bindings.uKnownPSConstantBuffers |= 1u << uSlot;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::VSSetConstantBufferRange
+
+      Summary:  Binds a range of a constant buffer to the vertex shader.
+                Direct3D 11 contexts need the Direct3D 11.1 interface
+
+      Args:     UINT uSlot
+                  Constant buffer slot
+                ID3D11Buffer* pConstantBuffer
+                  Constant buffer
+                UINT uFirstConstant
+                  First 16-byte constant of the range, a multiple of 16
+                UINT uNumConstants
+                  Number of constants in the range, a multiple of 16
+
+      Modifies: [m_bindings, m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateCache::VSSetConstantBufferRange(_In_ UINT uSlot, _In_ ID3D11Buffer* pConstantBuffer, _In_ UINT uFirstConstant, _In_ UINT uNumConstants)
+    {
+        if (filter(uSlot < NUM_CONSTANT_BUFFER_SLOTS
+            && (m_bindings.uKnownVSConstantBuffers & (1u << uSlot))
+            && m_bindings.apVSConstantBuffers[uSlot] == pConstantBuffer
+            && m_bindings.auVSFirstConstants[uSlot] == uFirstConstant
+            && m_bindings.auVSNumConstants[uSlot] == uNumConstants))
+        {
+            return;
+        }
+
+        m_pContext->VSSetConstantBufferRange(uSlot, D3D11CommandContext::ToHandle(pConstantBuffer), uFirstConstant, uNumConstants);
+        if (uSlot < NUM_CONSTANT_BUFFER_SLOTS)
+        {
+            m_bindings.apVSConstantBuffers[uSlot] = pConstantBuffer;
+            m_bindings.auVSFirstConstants[uSlot] = uFirstConstant;
+            m_bindings.auVSNumConstants[uSlot] = uNumConstants;
+            m_bindings.uKnownVSConstantBuffers |= 1u << uSlot;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::PSSetConstantBufferRange
+
+      Summary:  Binds a range of a constant buffer to the pixel shader.
+                Direct3D 11 contexts need the Direct3D 11.1 interface
+
+      Args:     UINT uSlot
+                  Constant buffer slot
+                ID3D11Buffer* pConstantBuffer
+                  Constant buffer
+                UINT uFirstConstant
+                  First 16-byte constant of the range, a multiple of 16
+                UINT uNumConstants
+                  Number of constants in the range, a multiple of 16
+
+      Modifies: [m_bindings, m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateCache::PSSetConstantBufferRange(_In_ UINT uSlot, _In_ ID3D11Buffer* pConstantBuffer, _In_ UINT uFirstConstant, _In_ UINT uNumConstants)
+    {
+        if (filter(uSlot < NUM_CONSTANT_BUFFER_SLOTS
+            && (m_bindings.uKnownPSConstantBuffers & (1u << uSlot))
+            && m_bindings.apPSConstantBuffers[uSlot] == pConstantBuffer
+            && m_bindings.auPSFirstConstants[uSlot] == uFirstConstant
+            && m_bindings.auPSNumConstants[uSlot] == uNumConstants))
+        {
+            return;
+        }
+
+        m_pContext->PSSetConstantBufferRange(uSlot, D3D11CommandContext::ToHandle(pConstantBuffer), uFirstConstant, uNumConstants);
+        if (uSlot < NUM_CONSTANT_BUFFER_SLOTS)
+        {
+            m_bindings.apPSConstantBuffers[uSlot] = pConstantBuffer;
+            m_bindings.auPSFirstConstants[uSlot] = uFirstConstant;
+            m_bindings.auPSNumConstants[uSlot] = uNumConstants;
+            m_bindings.uKnownPSConstantBuffers |= 1u << uSlot;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::PSSetShaderResource
+
+      Summary:  Binds a shader resource view to the pixel shader
+
+      Args:     UINT uSlot
+                  Shader resource slot
+                ID3D11ShaderResourceView* pShaderResourceView
+                  Shader resource view
+
+      Modifies: [m_bindings, m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateCache::PSSetShaderResource(_In_ UINT uSlot, _In_opt_ ID3D11ShaderResourceView* pShaderResourceView)
+    {
+        if (filter(uSlot < NUM_SHADER_RESOURCE_SLOTS
+            && (m_bindings.uKnownPSShaderResources & (1u << uSlot))
+            && m_bindings.apPSShaderResources[uSlot] == pShaderResourceView))
+        {
+            return;
+        }
+
+        m_pContext->PSSetShaderResource(uSlot, D3D11CommandContext::ToHandle(pShaderResourceView));
+        if (uSlot < NUM_SHADER_RESOURCE_SLOTS)
+        {
+            m_bindings.apPSShaderResources[uSlot] = pShaderResourceView;
+            m_bindings.uKnownPSShaderResources |= 1u << uSlot;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::PSSetSampler
+
+      Summary:  Binds a sampler to the pixel shader
+
+      Args:     UINT uSlot
+                  Sampler slot
+                ID3D11SamplerState* pSampler
+                  Sampler
+
+      Modifies: [m_bindings, m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateCache::PSSetSampler(_In_ UINT uSlot, _In_opt_ ID3D11SamplerState* pSampler)
+    {
+        if (filter(uSlot < NUM_SAMPLER_SLOTS
+            && (m_bindings.uKnownPSSamplers & (1u << uSlot))
+            && m_bindings.apPSSamplers[uSlot] == pSampler))
+        {
+            return;
+        }
+
+        m_pContext->PSSetSampler(uSlot, D3D11CommandContext::ToHandle(pSampler));
+        if (uSlot < NUM_SAMPLER_SLOTS)
+        {
+            m_bindings.apPSSamplers[uSlot] = pSampler;
+            m_bindings.uKnownPSSamplers |= 1u << uSlot;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::OMSetDepthStencilState
+
+      Summary:  Sets the depth stencil state, null for the default one.
+                The stencil is never used, its reference is 0
+
+      Args:     ID3D11DepthStencilState* pDepthStencilState
+                  Depth stencil state
+
+      Modifies: [m_bindings, m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateCache::OMSetDepthStencilState(_In_opt_ ID3D11DepthStencilState* pDepthStencilState)
+    {
+        if (filter(m_bindings.bKnownDepthStencilState && m_bindings.pDepthStencilState == pDepthStencilState))
+        {
+            return;
+        }
+
+        m_pContext->OMSetDepthStencilState(D3D11CommandContext::ToHandle(pDepthStencilState), 0u);
+        m_bindings.pDepthStencilState = pDepthStencilState;
+        m_bindings.bKnownDepthStencilState = TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::UpdateConstantBuffer
+
+      Summary:  Uploads the whole contents of a constant buffer with
+                UpdateSubresource, unless the data equals the last
+                upload to the buffer. The hash is compared first and
+                the stored contents confirm a match
+
+      Args:     ID3D11Buffer* pConstantBuffer
+                  Constant buffer with default usage
+                const void* pData
+                  New contents of the buffer
+                size_t uSize
+                  Size of the contents in bytes
+
+      Modifies: [m_uploads, m_uNumIssuedCalls, m_uNumSkippedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateCache::UpdateConstantBuffer(_In_ ID3D11Buffer* pConstantBuffer, _In_reads_bytes_(uSize) const void* pData, _In_ size_t uSize)
+    {
+        const UINT64 uHash = hash(pData, uSize);
+        auto it = m_uploads.find(pConstantBuffer);
+        if (filter(it != m_uploads.end() &&
+            it->second.uHash == uHash &&
+            it->second.aContents.size() == uSize &&
+            memcmp(it->second.aContents.data(), pData, uSize) == 0))
+        {
+            return;
+        }
+
+        m_pContext->UpdateSubresource(D3D11CommandContext::ToHandle(pConstantBuffer), pData, uSize);
+        if (it == m_uploads.end())
+        {
+            it = m_uploads.emplace(pConstantBuffer, Upload{ .Buffer = pConstantBuffer, .uHash = 0ull }).first;
+        }
+        it->second.uHash = uHash;
+        it->second.aContents.assign(static_cast<const BYTE*>(pData), static_cast<const BYTE*>(pData) + uSize);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::DrawIndexed
+
+      Summary:  Draws indexed primitives with the current state
+
+      Args:     UINT uIndexCount
+                  Number of indices
+                UINT uStartIndexLocation
+                  First index
+                INT iBaseVertexLocation
+                  Value added to each index
+
+      Modifies: [m_uNumIssuedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateCache::DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndexLocation, _In_ INT iBaseVertexLocation)
+    {
+        ++m_uNumIssuedCalls;
+        m_pContext->DrawIndexed(uIndexCount, uStartIndexLocation, iBaseVertexLocation);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::DrawIndexedInstanced
+
+      Summary:  Draws instances of indexed primitives with the current
+                state
+
+      Args:     UINT uIndexCountPerInstance
+                  Number of indices per instance
+                UINT uInstanceCount
+                  Number of instances
+                UINT uStartIndexLocation
+                  First index
+                INT iBaseVertexLocation
+                  Value added to each index
+                UINT uStartInstanceLocation
+                  Value added to each instance index
+
+      Modifies: [m_uNumIssuedCalls].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StateCache::DrawIndexedInstanced(
+        _In_ UINT uIndexCountPerInstance,
+        _In_ UINT uInstanceCount,
+        _In_ UINT uStartIndexLocation,
+        _In_ INT iBaseVertexLocation,
+        _In_ UINT uStartInstanceLocation
+    )
+    {
+        ++m_uNumIssuedCalls;
+        m_pContext->DrawIndexedInstanced(uIndexCountPerInstance, uInstanceCount, uStartIndexLocation, iBaseVertexLocation, uStartInstanceLocation);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::GetNumIssuedCalls
+
+      Summary:  Returns the number of state and draw calls passed to
+                the context since BeginFrame
+
+      Returns:  UINT
+                  Number of issued calls
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT StateCache::GetNumIssuedCalls() const
+    {
+        return m_uNumIssuedCalls;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::GetNumSkippedCalls
+
+      Summary:  Returns the number of bind calls and constant buffer
+                uploads dropped since BeginFrame
+
+      Returns:  UINT
+                  Number of skipped calls
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT StateCache::GetNumSkippedCalls() const
+    {
+        return m_uNumSkippedCalls;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::filter
+
+      Summary:  Counts a call as skipped or issued
+
+      Args:     BOOL bRedundant
+                  Whether the call would change nothing
+
+      Modifies: [m_uNumIssuedCalls, m_uNumSkippedCalls].
+
+      Returns:  BOOL
+                  TRUE if the call must be dropped
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL StateCache::filter(_In_ BOOL bRedundant)
+    {
+        if (bRedundant)
+        {
+            ++m_uNumSkippedCalls;
+            return TRUE;
+        }
+
+        ++m_uNumIssuedCalls;
+        return FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StateCache::hash
+
+      Summary:  Hashes bytes with 64-bit FNV-1a, the size included
+
+      Args:     const void* pData
+                  Bytes to hash
+                size_t uSize
+                  Number of bytes
+
+      Returns:  UINT64
+                  Hash of the bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 StateCache::hash(_In_reads_bytes_(uSize) const void* pData, _In_ size_t uSize)
+    {
+        constexpr UINT64 FNV_OFFSET_BASIS = 14695981039346656037ull;
+        constexpr UINT64 FNV_PRIME = 1099511628211ull;
+
+        UINT64 uHash = FNV_OFFSET_BASIS ^ static_cast<UINT64>(uSize);
+        const BYTE* pBytes = static_cast<const BYTE*>(pData);
+        for (size_t i = 0u; i < uSize; ++i)
+        {
+            uHash = (uHash ^ pBytes[i]) * FNV_PRIME;
+        }
+
+        return uHash;
+    }
+}
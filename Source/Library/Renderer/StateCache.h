@@ -0,0 +1,202 @@
+/*+===================================================================
+  File:      STATECACHE.H
+
+  Summary:   StateCache header file contains declarations of
+             StateCache class that filters redundant state changes in
+             front of a command context.
+
+  Classes: StateCache
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/CommandContext.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    StateCache
+
+      Summary:  Remembers what is bound to the input assembler, to the
+                vertex and pixel shader stages and the depth stencil
+                state of a command context, and drops bind calls that
+                would not change anything. Constant buffer uploads are
+                skipped when the new contents equal the last upload to
+                the same buffer.
+
+                The bindings are forgotten at BeginFrame and whenever
+                Invalidate is called, which must be done after the
+                context is used directly. The upload hashes are kept
+                across frames, so constants that rarely change are
+                rarely uploaded
+
+      Methods:  BeginFrame
+                  Starts a frame on a command context
+                Invalidate
+                  Forgets the tracked bindings
+                IASetVertexBuffers
+                  Binds vertex buffers
+                IASetIndexBuffer
+                  Binds an index buffer
+                IASetInputLayout
+                  Binds an input layout
+                VSSetShader
+                  Binds a vertex shader
+                PSSetShader
+                  Binds a pixel shader
+                VSSetConstantBuffer
+                  Binds a constant buffer to the vertex shader
+                PSSetConstantBuffer
+                  Binds a constant buffer to the pixel shader
+                VSSetConstantBufferRange
+                  Binds a range of a constant buffer to the vertex
+                  shader
+                PSSetConstantBufferRange
+                  Binds a range of a constant buffer to the pixel
+                  shader
+                PSSetShaderResource
+                  Binds a shader resource view to the pixel shader
+                PSSetSampler
+                  Binds a sampler to the pixel shader
+                OMSetDepthStencilState
+                  Sets the depth stencil state
+                UpdateConstantBuffer
+                  Uploads the contents of a constant buffer
+                DrawIndexed
+                  Draws indexed primitives
+                DrawIndexedInstanced
+                  Draws instances of indexed primitives
+                GetNumIssuedCalls
+                  Returns the number of calls passed to the context
+                GetNumSkippedCalls
+                  Returns the number of calls dropped as redundant
+                StateCache
+                  Constructor.
+                ~StateCache
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class StateCache final
+    {
+    public:
+        static constexpr const UINT NUM_VERTEX_BUFFER_SLOTS = 8u;
+        static constexpr const UINT NUM_CONSTANT_BUFFER_SLOTS = D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT;
+        static constexpr const UINT NUM_SHADER_RESOURCE_SLOTS = 16u;
+        static constexpr const UINT NUM_SAMPLER_SLOTS = D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT;
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Bindings
+
+          Summary:  Objects bound to the context as far as the cache
+                    knows. A binding only counts when its bit in the
+                    matching mask is set, so a null binding can be told
+                    apart from an unknown one. A whole constant buffer
+                    is bound with a range of 0 constants
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Bindings
+        {
+            ID3D11Buffer* apVertexBuffers[NUM_VERTEX_BUFFER_SLOTS];
+            UINT auStrides[NUM_VERTEX_BUFFER_SLOTS];
+            UINT auOffsets[NUM_VERTEX_BUFFER_SLOTS];
+            ID3D11Buffer* pIndexBuffer;
+            DXGI_FORMAT indexFormat;
+            UINT uIndexOffset;
+            ID3D11InputLayout* pInputLayout;
+            ID3D11VertexShader* pVertexShader;
+            ID3D11PixelShader* pPixelShader;
+            ID3D11Buffer* apVSConstantBuffers[NUM_CONSTANT_BUFFER_SLOTS];
+            ID3D11Buffer* apPSConstantBuffers[NUM_CONSTANT_BUFFER_SLOTS];
+            UINT auVSFirstConstants[NUM_CONSTANT_BUFFER_SLOTS];
+            UINT auVSNumConstants[NUM_CONSTANT_BUFFER_SLOTS];
+            UINT auPSFirstConstants[NUM_CONSTANT_BUFFER_SLOTS];
+            UINT auPSNumConstants[NUM_CONSTANT_BUFFER_SLOTS];
+            ID3D11ShaderResourceView* apPSShaderResources[NUM_SHADER_RESOURCE_SLOTS];
+            ID3D11SamplerState* apPSSamplers[NUM_SAMPLER_SLOTS];
+            ID3D11DepthStencilState* pDepthStencilState;
+            UINT uKnownVertexBuffers;
+            UINT uKnownVSConstantBuffers;
+            UINT uKnownPSConstantBuffers;
+            UINT uKnownPSShaderResources;
+            UINT uKnownPSSamplers;
+            BOOL bKnownIndexBuffer;
+            BOOL bKnownInputLayout;
+            BOOL bKnownVertexShader;
+            BOOL bKnownPixelShader;
+            BOOL bKnownDepthStencilState;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Upload
+
+          Summary:  Last upload to a constant buffer. The buffer is
+                    referenced so its address is not reused while the
+                    upload is kept. The hash rejects most changes and
+                    a copy of the contents confirms a match, so a hash
+                    collision cannot drop an upload
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Upload
+        {
+            ComPtr<ID3D11Buffer> Buffer;
+            UINT64 uHash;
+            std::vector<BYTE> aContents;
+        };
+
+    public:
+        StateCache();
+        StateCache(const StateCache& other) = delete;
+        StateCache(StateCache&& other) = delete;
+        StateCache& operator=(const StateCache& other) = delete;
+        StateCache& operator=(StateCache&& other) = delete;
+        ~StateCache() = default;
+
+        void BeginFrame(_In_ CommandContext* pContext);
+        void Invalidate();
+
+        void IASetVertexBuffers(
+            _In_ UINT uStartSlot,
+            _In_ UINT uNumBuffers,
+            _In_reads_(uNumBuffers) ID3D11Buffer* const* ppVertexBuffers,
+            _In_reads_(uNumBuffers) const UINT* puStrides,
+            _In_reads_(uNumBuffers) const UINT* puOffsets
+        );
+        void IASetIndexBuffer(_In_opt_ ID3D11Buffer* pIndexBuffer, _In_ DXGI_FORMAT format, _In_ UINT uOffset);
+        void IASetInputLayout(_In_opt_ ID3D11InputLayout* pInputLayout);
+        void VSSetShader(_In_opt_ ID3D11VertexShader* pVertexShader);
+        void PSSetShader(_In_opt_ ID3D11PixelShader* pPixelShader);
+        void VSSetConstantBuffer(_In_ UINT uSlot, _In_opt_ ID3D11Buffer* pConstantBuffer);
+        void PSSetConstantBuffer(_In_ UINT uSlot, _In_opt_ ID3D11Buffer* pConstantBuffer);
+        void VSSetConstantBufferRange(_In_ UINT uSlot, _In_ ID3D11Buffer* pConstantBuffer, _In_ UINT uFirstConstant, _In_ UINT uNumConstants);
+        void PSSetConstantBufferRange(_In_ UINT uSlot, _In_ ID3D11Buffer* pConstantBuffer, _In_ UINT uFirstConstant, _In_ UINT uNumConstants);
+        void PSSetShaderResource(_In_ UINT uSlot, _In_opt_ ID3D11ShaderResourceView* pShaderResourceView);
+        void PSSetSampler(_In_ UINT uSlot, _In_opt_ ID3D11SamplerState* pSampler);
+        void OMSetDepthStencilState(_In_opt_ ID3D11DepthStencilState* pDepthStencilState);
+        void UpdateConstantBuffer(_In_ ID3D11Buffer* pConstantBuffer, _In_reads_bytes_(uSize) const void* pData, _In_ size_t uSize);
+
+        void DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndexLocation, _In_ INT iBaseVertexLocation);
+        void DrawIndexedInstanced(
+            _In_ UINT uIndexCountPerInstance,
+            _In_ UINT uInstanceCount,
+            _In_ UINT uStartIndexLocation,
+            _In_ INT iBaseVertexLocation,
+            _In_ UINT uStartInstanceLocation
+        );
+
+        UINT GetNumIssuedCalls() const;
+        UINT GetNumSkippedCalls() const;
+
+    private:
+        BOOL filter(_In_ BOOL bRedundant);
+
+        static UINT64 hash(_In_reads_bytes_(uSize) const void* pData, _In_ size_t uSize);
+
+    private:
+        CommandContext* m_pContext;
+        Bindings m_bindings;
+        std::unordered_map<ID3D11Buffer*, Upload> m_uploads;
+        UINT m_uNumIssuedCalls;
+        UINT m_uNumSkippedCalls;
+    };
+}
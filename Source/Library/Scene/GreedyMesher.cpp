@@ -0,0 +1,412 @@
+#include "Scene/GreedyMesher.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GreedyMesher::MeshChunk
+
+      Summary:  Meshes a rectangle of columns of the grid. Every
+                exposed face is put into a 2D mask (one per height
+                level for the top faces, one per slice for the side
+                faces) and the masks are merged into rectangles of the
+                same block type
+
+      Args:     const VoxelGridView& grid
+                  Block / height grid to mesh
+                uint32_t uOriginX
+                  First column of the chunk along the x-axis
+                uint32_t uOriginZ
+                  First column of the chunk along the z-axis
+                uint32_t uSizeX
+                  Number of columns of the chunk along the x-axis
+                uint32_t uSizeZ
+                  Number of columns of the chunk along the z-axis
+                GreedyMeshData& outMeshData
+                  Vertices, indices and per block type sections of the
+                  chunk
+
+      Returns:  bool
+                  False if the chunk does not fit in the grid
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool GreedyMesher::MeshChunk(
+        const VoxelGridView& grid,
+        uint32_t uOriginX,
+        uint32_t uOriginZ,
+        uint32_t uSizeX,
+        uint32_t uSizeZ,
+        GreedyMeshData& outMeshData
+    )
+    {
+        outMeshData.Vertices.clear();
+        outMeshData.Indices.clear();
+        outMeshData.Sections.clear();
+
+        if (static_cast<uint64_t>(uOriginX) + uSizeX > grid.Width ||
+            static_cast<uint64_t>(uOriginZ) + uSizeZ > grid.Depth)
+        {
+            return false;
+        }
+
+        if (uSizeX == 0u || uSizeZ == 0u)
+        {
+            return true;
+        }
+
+        if (!grid.BlockTypes || !grid.ColumnHeights)
+        {
+            return false;
+        }
+
+        std::vector<std::vector<Quad>> aQuadsPerType(grid.NumBlockTypes);
+
+        const int64_t originX = static_cast<int64_t>(uOriginX);
+        const int64_t originZ = static_cast<int64_t>(uOriginZ);
+
+        uint32_t uMaxHeight = 0u;
+        for (uint32_t z = 0u; z < uSizeZ; ++z)
+        {
+            for (uint32_t x = 0u; x < uSizeX; ++x)
+            {
+                const uint32_t uColumnHeight = grid.GetColumnHeight(originX + x, originZ + z);
+                uMaxHeight = uColumnHeight > uMaxHeight ? uColumnHeight : uMaxHeight;
+            }
+        }
+
+        if (uMaxHeight == 0u)
+        {
+            return true;
+        }
+
+        // Top faces, every height level has its own plane
+        {
+            std::vector<uint32_t> aMask(static_cast<size_t>(uSizeX) * uSizeZ, 0u);
+            for (uint32_t z = 0u; z < uSizeZ; ++z)
+            {
+                for (uint32_t x = 0u; x < uSizeX; ++x)
+                {
+                    const uint32_t uColumnHeight = grid.GetColumnHeight(originX + x, originZ + z);
+                    if (uColumnHeight > 0u)
+                    {
+                        aMask[static_cast<size_t>(z) * uSizeX + x] = ((uColumnHeight << 8u) | grid.GetBlockType(uOriginX + x, uOriginZ + z)) + 1u;
+                    }
+                }
+            }
+
+            const int32_t aOrigin[3] = { static_cast<int32_t>(uOriginX), 0, static_cast<int32_t>(uOriginZ) };
+            const int32_t aAxisU[3] = { 1, 0, 0 };
+            const int32_t aAxisV[3] = { 0, 0, 1 };
+            const int32_t aPlaneAxis[3] = { 0, 1, 0 };
+            const int32_t aNormal[3] = { 0, 1, 0 };
+            mergeMask(aMask, uSizeX, uSizeZ, aQuadsPerType.data(), grid.NumBlockTypes, aOrigin, aAxisU, aAxisV, aPlaneAxis, aNormal);
+        }
+
+        // Side faces facing -x / +x, one slice per column of the chunk
+        {
+            std::vector<uint32_t> aMask(static_cast<size_t>(uSizeZ) * uMaxHeight);
+            for (int32_t direction = -1; direction <= 1; direction += 2)
+            {
+                for (uint32_t x = 0u; x < uSizeX; ++x)
+                {
+                    const uint32_t uPlane = uOriginX + x + (direction > 0 ? 1u : 0u);
+
+                    std::fill(aMask.begin(), aMask.end(), 0u);
+                    for (uint32_t z = 0u; z < uSizeZ; ++z)
+                    {
+                        const uint32_t uColumnHeight = grid.GetColumnHeight(originX + x, originZ + z);
+                        const uint32_t uNeighborHeight = grid.GetColumnHeight(originX + x + direction, originZ + z);
+                        if (uNeighborHeight >= uColumnHeight)
+                        {
+                            continue;
+                        }
+
+                        const uint32_t uValue = ((uPlane << 8u) | grid.GetBlockType(uOriginX + x, uOriginZ + z)) + 1u;
+                        for (uint32_t y = uNeighborHeight; y < uColumnHeight; ++y)
+                        {
+                            aMask[static_cast<size_t>(y) * uSizeZ + z] = uValue;
+                        }
+                    }
+
+                    const int32_t aOrigin[3] = { 0, 0, static_cast<int32_t>(uOriginZ) };
+                    const int32_t aAxisU[3] = { 0, 0, 1 };
+                    const int32_t aAxisV[3] = { 0, 1, 0 };
+                    const int32_t aPlaneAxis[3] = { 1, 0, 0 };
+                    const int32_t aNormal[3] = { direction, 0, 0 };
+                    mergeMask(aMask, uSizeZ, uMaxHeight, aQuadsPerType.data(), grid.NumBlockTypes, aOrigin, aAxisU, aAxisV, aPlaneAxis, aNormal);
+                }
+            }
+        }
+
+        // Side faces facing -z / +z, one slice per row of the chunk
+        {
+            std::vector<uint32_t> aMask(static_cast<size_t>(uSizeX) * uMaxHeight);
+            for (int32_t direction = -1; direction <= 1; direction += 2)
+            {
+                for (uint32_t z = 0u; z < uSizeZ; ++z)
+                {
+                    const uint32_t uPlane = uOriginZ + z + (direction > 0 ? 1u : 0u);
+
+                    std::fill(aMask.begin(), aMask.end(), 0u);
+                    for (uint32_t x = 0u; x < uSizeX; ++x)
+                    {
+                        const uint32_t uColumnHeight = grid.GetColumnHeight(originX + x, originZ + z);
+                        const uint32_t uNeighborHeight = grid.GetColumnHeight(originX + x, originZ + z + direction);
+                        if (uNeighborHeight >= uColumnHeight)
+                        {
+                            continue;
+                        }
+
+                        const uint32_t uValue = ((uPlane << 8u) | grid.GetBlockType(uOriginX + x, uOriginZ + z)) + 1u;
+                        for (uint32_t y = uNeighborHeight; y < uColumnHeight; ++y)
+                        {
+                            aMask[static_cast<size_t>(y) * uSizeX + x] = uValue;
+                        }
+                    }
+
+                    const int32_t aOrigin[3] = { static_cast<int32_t>(uOriginX), 0, 0 };
+                    const int32_t aAxisU[3] = { 1, 0, 0 };
+                    const int32_t aAxisV[3] = { 0, 1, 0 };
+                    const int32_t aPlaneAxis[3] = { 0, 0, 1 };
+                    const int32_t aNormal[3] = { 0, 0, direction };
+                    mergeMask(aMask, uSizeX, uMaxHeight, aQuadsPerType.data(), grid.NumBlockTypes, aOrigin, aAxisU, aAxisV, aPlaneAxis, aNormal);
+                }
+            }
+        }
+
+        size_t uNumQuads = 0u;
+        for (const std::vector<Quad>& aQuads : aQuadsPerType)
+        {
+            uNumQuads += aQuads.size();
+        }
+        outMeshData.Vertices.reserve(uNumQuads * 4u);
+        outMeshData.Indices.reserve(uNumQuads * 6u);
+
+        for (uint32_t uBlockType = 0u; uBlockType < grid.NumBlockTypes; ++uBlockType)
+        {
+            if (aQuadsPerType[uBlockType].empty())
+            {
+                continue;
+            }
+
+            GreedyMeshSection section =
+            {
+                .BlockType = uBlockType,
+                .BaseVertex = static_cast<uint32_t>(outMeshData.Vertices.size()),
+                .BaseIndex = static_cast<uint32_t>(outMeshData.Indices.size()),
+                .NumIndices = 0u,
+            };
+
+            for (const Quad& quad : aQuadsPerType[uBlockType])
+            {
+                // Side faces are split by the neighboring columns, so
+                // the number of quads has no useful bound. A section
+                // that runs out of 16-bit indices is closed and the
+                // next one starts at a new base vertex
+                if (outMeshData.Vertices.size() - section.BaseVertex + 4u > MAX_SECTION_VERTICES)
+                {
+                    section.NumIndices = static_cast<uint32_t>(outMeshData.Indices.size()) - section.BaseIndex;
+                    outMeshData.Sections.push_back(section);
+
+                    section.BaseVertex = static_cast<uint32_t>(outMeshData.Vertices.size());
+                    section.BaseIndex = static_cast<uint32_t>(outMeshData.Indices.size());
+                }
+
+                emitQuad(quad, section.BaseVertex, outMeshData.Vertices, outMeshData.Indices);
+            }
+
+            section.NumIndices = static_cast<uint32_t>(outMeshData.Indices.size()) - section.BaseIndex;
+            outMeshData.Sections.push_back(section);
+        }
+
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GreedyMesher::mergeMask
+
+      Summary:  Greedily covers the non-zero cells of a mask with
+                rectangles of equal values and clears the mask. A cell
+                value is ((plane << 8) | block type) + 1
+
+      Args:     std::vector<uint32_t>& aMask
+                  uWidth x uHeight cells, row by row
+                uint32_t uWidth
+                  Number of cells along the u-axis
+                uint32_t uHeight
+                  Number of cells along the v-axis
+                std::vector<Quad>* aQuadsPerType
+                  Quads of each block type, the merged quads are
+                  appended here
+                uint32_t uNumBlockTypes
+                  Number of block types
+                const int32_t aOrigin[3]
+                  Grid position of the cell (0, 0) on the plane 0
+                const int32_t aAxisU[3]
+                  Grid direction of the u-axis of the mask
+                const int32_t aAxisV[3]
+                  Grid direction of the v-axis of the mask
+                const int32_t aPlaneAxis[3]
+                  Grid direction the plane of a cell is measured along
+                const int32_t aNormal[3]
+                  Normal of the emitted quads
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void GreedyMesher::mergeMask(
+        std::vector<uint32_t>& aMask,
+        uint32_t uWidth,
+        uint32_t uHeight,
+        std::vector<Quad>* aQuadsPerType,
+        uint32_t uNumBlockTypes,
+        const int32_t aOrigin[3],
+        const int32_t aAxisU[3],
+        const int32_t aAxisV[3],
+        const int32_t aPlaneAxis[3],
+        const int32_t aNormal[3]
+    )
+    {
+        for (uint32_t v = 0u; v < uHeight; ++v)
+        {
+            for (uint32_t u = 0u; u < uWidth; ++u)
+            {
+                const uint32_t uValue = aMask[static_cast<size_t>(v) * uWidth + u];
+                if (uValue == 0u)
+                {
+                    continue;
+                }
+
+                uint32_t uQuadWidth = 1u;
+                while (u + uQuadWidth < uWidth && aMask[static_cast<size_t>(v) * uWidth + u + uQuadWidth] == uValue)
+                {
+                    ++uQuadWidth;
+                }
+
+                uint32_t uQuadHeight = 1u;
+                for (; v + uQuadHeight < uHeight; ++uQuadHeight)
+                {
+                    const uint32_t* pRow = &aMask[static_cast<size_t>(v + uQuadHeight) * uWidth + u];
+                    bool bSameRow = true;
+                    for (uint32_t i = 0u; i < uQuadWidth; ++i)
+                    {
+                        if (pRow[i] != uValue)
+                        {
+                            bSameRow = false;
+                            break;
+                        }
+                    }
+
+                    if (!bSameRow)
+                    {
+                        break;
+                    }
+                }
+
+                for (uint32_t j = 0u; j < uQuadHeight; ++j)
+                {
+                    uint32_t* pRow = &aMask[static_cast<size_t>(v + j) * uWidth + u];
+                    for (uint32_t i = 0u; i < uQuadWidth; ++i)
+                    {
+                        pRow[i] = 0u;
+                    }
+                }
+
+                const uint32_t uBlockType = (uValue - 1u) & 0xFFu;
+                const int32_t plane = static_cast<int32_t>((uValue - 1u) >> 8u);
+                assert(uBlockType < uNumBlockTypes);
+
+                Quad quad;
+                for (uint32_t axis = 0u; axis < 3u; ++axis)
+                {
+                    const int32_t base = aOrigin[axis] + static_cast<int32_t>(u) * aAxisU[axis] + static_cast<int32_t>(v) * aAxisV[axis] + plane * aPlaneAxis[axis];
+                    const int32_t du = static_cast<int32_t>(uQuadWidth) * aAxisU[axis];
+                    const int32_t dv = static_cast<int32_t>(uQuadHeight) * aAxisV[axis];
+
+                    quad.aCorners[0][axis] = base;
+                    quad.aCorners[1][axis] = base + du;
+                    quad.aCorners[2][axis] = base + du + dv;
+                    quad.aCorners[3][axis] = base + dv;
+                    quad.aNormal[axis] = aNormal[axis];
+                }
+
+                const float width = static_cast<float>(uQuadWidth);
+                const float height = static_cast<float>(uQuadHeight);
+                quad.aTexCoords[0][0] = 0.0f;
+                quad.aTexCoords[0][1] = height;
+                quad.aTexCoords[1][0] = width;
+                quad.aTexCoords[1][1] = height;
+                quad.aTexCoords[2][0] = width;
+                quad.aTexCoords[2][1] = 0.0f;
+                quad.aTexCoords[3][0] = 0.0f;
+                quad.aTexCoords[3][1] = 0.0f;
+
+                aQuadsPerType[uBlockType].push_back(quad);
+
+                u += uQuadWidth - 1u;
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GreedyMesher::emitQuad
+
+      Summary:  Appends the 4 vertices and 6 indices of a quad. The
+                corners are reordered if needed so that the triangles
+                are clockwise when seen from the side the normal
+                points to
+
+      Args:     const Quad& quad
+                  Quad to emit
+                uint32_t uSectionBaseVertex
+                  First vertex of the current section, the indices are
+                  relative to it
+                std::vector<GreedyMeshVertex>& aVertices
+                  Vertex list to append to
+                std::vector<uint16_t>& aIndices
+                  Index list to append to
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void GreedyMesher::emitQuad(const Quad& quad, uint32_t uSectionBaseVertex, std::vector<GreedyMeshVertex>& aVertices, std::vector<uint16_t>& aIndices)
+    {
+        int64_t aEdge1[3];
+        int64_t aEdge2[3];
+        for (uint32_t axis = 0u; axis < 3u; ++axis)
+        {
+            aEdge1[axis] = quad.aCorners[1][axis] - quad.aCorners[0][axis];
+            aEdge2[axis] = quad.aCorners[2][axis] - quad.aCorners[0][axis];
+        }
+
+        const int64_t facing =
+            (aEdge1[1] * aEdge2[2] - aEdge1[2] * aEdge2[1]) * quad.aNormal[0] +
+            (aEdge1[2] * aEdge2[0] - aEdge1[0] * aEdge2[2]) * quad.aNormal[1] +
+            (aEdge1[0] * aEdge2[1] - aEdge1[1] * aEdge2[0]) * quad.aNormal[2];
+
+        static constexpr const uint32_t aFrontOrder[4] = { 0u, 1u, 2u, 3u };
+        static constexpr const uint32_t aBackOrder[4] = { 0u, 3u, 2u, 1u };
+        const uint32_t* aOrder = facing >= 0 ? aFrontOrder : aBackOrder;
+
+        assert(aVertices.size() - uSectionBaseVertex + 4u <= MAX_SECTION_VERTICES);
+        const uint16_t uBaseVertex = static_cast<uint16_t>(aVertices.size() - uSectionBaseVertex);
+
+        for (uint32_t i = 0u; i < 4u; ++i)
+        {
+            const uint32_t uCorner = aOrder[i];
+
+            GreedyMeshVertex vertex;
+            for (uint32_t axis = 0u; axis < 3u; ++axis)
+            {
+                vertex.Position[axis] = static_cast<float>(quad.aCorners[uCorner][axis]);
+                vertex.Normal[axis] = static_cast<float>(quad.aNormal[axis]);
+            }
+            vertex.TexCoord[0] = quad.aTexCoords[uCorner][0];
+            vertex.TexCoord[1] = quad.aTexCoords[uCorner][1];
+
+            aVertices.push_back(vertex);
+        }
+
+        aIndices.push_back(uBaseVertex);
+        aIndices.push_back(static_cast<uint16_t>(uBaseVertex + 1u));
+        aIndices.push_back(static_cast<uint16_t>(uBaseVertex + 2u));
+        aIndices.push_back(uBaseVertex);
+        aIndices.push_back(static_cast<uint16_t>(uBaseVertex + 2u));
+        aIndices.push_back(static_cast<uint16_t>(uBaseVertex + 3u));
+    }
+}
@@ -0,0 +1,149 @@
+/*+===================================================================
+  File:      GREEDYMESHER.H
+
+  Summary:   GreedyMesher header file contains declarations of the
+             greedy mesher that turns a block / height grid into
+             merged quads. It only depends on the standard library so
+             it can be run and measured without Direct3D.
+
+  Classes: GreedyMesher
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelGridView
+
+      Summary:  Non-owning view of a block / height grid. Both arrays
+                hold Width x Depth elements, row by row (x fastest).
+                A column is empty when its block type is not smaller
+                than NumBlockTypes or its height is 0
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelGridView
+    {
+        uint32_t Width;
+        uint32_t Depth;
+        uint32_t NumBlockTypes;
+        const uint8_t* BlockTypes;
+        const uint16_t* ColumnHeights;
+
+        uint32_t GetColumnHeight(int64_t x, int64_t z) const
+        {
+            if (x < 0 || z < 0 || x >= static_cast<int64_t>(Width) || z >= static_cast<int64_t>(Depth))
+            {
+                return 0u;
+            }
+
+            const size_t uColumnIdx = static_cast<size_t>(z) * Width + static_cast<size_t>(x);
+            return BlockTypes[uColumnIdx] < NumBlockTypes ? ColumnHeights[uColumnIdx] : 0u;
+        }
+
+        uint8_t GetBlockType(uint32_t x, uint32_t z) const
+        {
+            return BlockTypes[static_cast<size_t>(z) * Width + x];
+        }
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   GreedyMeshVertex
+
+      Summary:  Vertex of a merged quad. The position is in grid units,
+                a cube at the column (x, z) and the height index h
+                spans [x, x + 1] x [h, h + 1] x [z, z + 1]. The texture
+                coordinates repeat once per cube
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct GreedyMeshVertex
+    {
+        float Position[3];
+        float TexCoord[2];
+        float Normal[3];
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   GreedyMeshSection
+
+      Summary:  Range of indices that belongs to a single block type.
+                The indices are relative to BaseVertex and a block type
+                with more vertices than 16-bit indices can address is
+                split into several sections
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct GreedyMeshSection
+    {
+        uint32_t BlockType;
+        uint32_t BaseVertex;
+        uint32_t BaseIndex;
+        uint32_t NumIndices;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   GreedyMeshData
+
+      Summary:  Output of the greedy mesher, one vertex / index list of
+                a chunk grouped into a section per block type
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct GreedyMeshData
+    {
+        std::vector<GreedyMeshVertex> Vertices;
+        std::vector<uint16_t> Indices;
+        std::vector<GreedyMeshSection> Sections;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    GreedyMesher
+
+      Summary:  Merges coplanar faces of the same block type into as
+                few quads as possible. Top faces are merged per height
+                level, side faces per slice of the chunk; faces hidden
+                by a neighboring column (inside or outside of the
+                chunk) and the bottom faces are never emitted
+
+      Methods:  MeshChunk
+                  Meshes a rectangle of columns of the grid
+                MAX_SECTION_VERTICES
+                  Number of vertices a section can address with
+                  16-bit indices
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class GreedyMesher
+    {
+    public:
+        static constexpr const uint32_t MAX_SECTION_VERTICES = 0x10000u;
+
+        static bool MeshChunk(
+            const VoxelGridView& grid,
+            uint32_t uOriginX,
+            uint32_t uOriginZ,
+            uint32_t uSizeX,
+            uint32_t uSizeZ,
+            GreedyMeshData& outMeshData
+        );
+
+    private:
+        struct Quad
+        {
+            int32_t aCorners[4][3];
+            float aTexCoords[4][2];
+            int32_t aNormal[3];
+        };
+
+        static void mergeMask(
+            std::vector<uint32_t>& aMask,
+            uint32_t uWidth,
+            uint32_t uHeight,
+            std::vector<Quad>* aQuadsPerType,
+            uint32_t uNumBlockTypes,
+            const int32_t aOrigin[3],
+            const int32_t aAxisU[3],
+            const int32_t aAxisV[3],
+            const int32_t aPlaneAxis[3],
+            const int32_t aNormal[3]
+        );
+        static void emitQuad(const Quad& quad, uint32_t uSectionBaseVertex, std::vector<GreedyMeshVertex>& aVertices, std::vector<uint16_t>& aIndices);
+    };
+}
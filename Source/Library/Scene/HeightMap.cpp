@@ -0,0 +1,543 @@
+#include "Scene/HeightMap.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::HeightMap
+
+      Summary:  Constructor
+
+      Modifies: [m_uWidth, m_uHeight, m_uDepth, m_aColors,
+                 m_aBlockTypes, m_aColumnHeights, m_hFile,
+                 m_hFileMapping, m_pMappedView, m_pBlockTypes,
+                 m_pColumnHeights].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HeightMap::HeightMap()
+        : m_uWidth(0u)
+        , m_uHeight(0u)
+        , m_uDepth(0u)
+        , m_aColors()
+        , m_aBlockTypes()
+        , m_aColumnHeights()
+        , m_hFile(INVALID_HANDLE_VALUE)
+        , m_hFileMapping(nullptr)
+        , m_pMappedView(nullptr)
+        , m_pBlockTypes(nullptr)
+        , m_pColumnHeights(nullptr)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::~HeightMap
+
+      Summary:  Destructor. Unmaps the binary height map if mapped
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HeightMap::~HeightMap()
+    {
+        release();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::Load
+
+      Summary:  Loads the height map. Files with the .vxm extension are
+                memory-mapped, everything else is imported as text
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the height map
+                ThreadPool* pThreadPool
+                  Pool to parse text height maps on, nullptr to parse
+                  on the calling thread only
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HeightMap::Load(_In_ const std::filesystem::path& filePath, _In_opt_ ThreadPool* pThreadPool)
+    {
+        if (filePath.extension() == L".vxm")
+        {
+            return LoadBinary(filePath);
+        }
+
+        return ImportText(filePath, pThreadPool);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::LoadBinary
+
+      Summary:  Memory-maps a binary height map. The block type and
+                column height arrays are used directly from the mapped
+                view, so no parse step is needed
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the binary height map
+
+      Modifies: [m_uWidth, m_uHeight, m_uDepth, m_aColors, m_hFile,
+                 m_hFileMapping, m_pMappedView, m_pBlockTypes,
+                 m_pColumnHeights].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HeightMap::LoadBinary(_In_ const std::filesystem::path& filePath)
+    {
+        release();
+
+        m_hFile = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_hFile == INVALID_HANDLE_VALUE)
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(m_hFile, &fileSize))
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            release();
+            return hr;
+        }
+
+        if (static_cast<UINT64>(fileSize.QuadPart) < sizeof(FileHeader))
+        {
+            release();
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+
+        m_hFileMapping = CreateFileMappingW(m_hFile, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+        if (!m_hFileMapping)
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            release();
+            return hr;
+        }
+
+        m_pMappedView = MapViewOfFile(m_hFileMapping, FILE_MAP_READ, 0u, 0u, 0u);
+        if (!m_pMappedView)
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            release();
+            return hr;
+        }
+
+        const BYTE* pBase = static_cast<const BYTE*>(m_pMappedView);
+        const FileHeader* pHeader = reinterpret_cast<const FileHeader*>(pBase);
+
+        const UINT64 ullFileSize = static_cast<UINT64>(fileSize.QuadPart);
+        const UINT64 ullNumColumns = static_cast<UINT64>(pHeader->uWidth) * static_cast<UINT64>(pHeader->uDepth);
+        const UINT64 ullPaletteEnd = sizeof(FileHeader) + static_cast<UINT64>(pHeader->uNumColors) * sizeof(XMFLOAT4);
+
+        // Offsets and sizes come from the file, so they are compared
+        // with what is left of it instead of being added up, which
+        // could overflow
+        if (pHeader->dwMagic != FILE_MAGIC ||
+            pHeader->dwVersion != FILE_VERSION ||
+            ullPaletteEnd > ullFileSize ||
+            pHeader->ullBlockTypesOffset > ullFileSize ||
+            ullNumColumns > (ullFileSize - pHeader->ullBlockTypesOffset) / sizeof(BYTE) ||
+            pHeader->ullColumnHeightsOffset > ullFileSize ||
+            ullNumColumns > (ullFileSize - pHeader->ullColumnHeightsOffset) / sizeof(WORD) ||
+            pHeader->ullColumnHeightsOffset % alignof(WORD) != 0u)
+        {
+            release();
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+
+        m_uWidth = pHeader->uWidth;
+        m_uHeight = pHeader->uHeight;
+        m_uDepth = pHeader->uDepth;
+
+        const XMFLOAT4* pPalette = reinterpret_cast<const XMFLOAT4*>(pBase + sizeof(FileHeader));
+        m_aColors.assign(pPalette, pPalette + pHeader->uNumColors);
+
+        m_pBlockTypes = pBase + pHeader->ullBlockTypesOffset;
+        m_pColumnHeights = reinterpret_cast<const WORD*>(pBase + pHeader->ullColumnHeightsOffset);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::ImportText
+
+      Summary:  Reads a text height map and parses it with
+                HeightMapText. The result does not depend on the number
+                of threads of the pool
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the text height map
+                ThreadPool* pThreadPool
+                  Pool to parse the columns on, nullptr to parse on the
+                  calling thread only
+
+      Modifies: [m_uWidth, m_uHeight, m_uDepth, m_aColors,
+                 m_aBlockTypes, m_aColumnHeights, m_pBlockTypes,
+                 m_pColumnHeights].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HeightMap::ImportText(_In_ const std::filesystem::path& filePath, _In_opt_ ThreadPool* pThreadPool)
+    {
+        release();
+
+        std::ifstream inputFile(filePath, std::ios::binary | std::ios::ate);
+        if (!inputFile.is_open())
+        {
+            return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+        }
+
+        std::string text(static_cast<size_t>(inputFile.tellg()), '\0');
+        inputFile.seekg(0, std::ios::beg);
+        inputFile.read(text.data(), static_cast<std::streamsize>(text.size()));
+        inputFile.close();
+
+        HeightMapTextData data;
+        HeightMapText::Parse(
+            text.data(),
+            text.data() + text.size(),
+            static_cast<CHAR>(eBlockType::GRASSLAND),
+            static_cast<UINT>(eBlockType::COUNT) - static_cast<UINT>(eBlockType::GRASSLAND),
+            pThreadPool,
+            data
+        );
+
+        m_uWidth = data.Width;
+        m_uHeight = data.Height;
+        m_uDepth = data.Depth;
+        m_aColors.reserve(data.Colors.size());
+        for (const std::array<FLOAT, 3>& color : data.Colors)
+        {
+            m_aColors.push_back(XMFLOAT4(color[0], color[1], color[2], 1.0f));
+        }
+        m_aBlockTypes = std::move(data.BlockTypes);
+        m_aColumnHeights = std::move(data.ColumnHeights);
+
+        m_pBlockTypes = m_aBlockTypes.data();
+        m_pColumnHeights = m_aColumnHeights.data();
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::Create
+
+      Summary:  Takes over a block type / column height grid built in
+                memory, e.g. by the terrain generator, so that no file
+                has to be written and parsed
+
+      Args:     UINT uWidth
+                  Number of columns along the x-axis
+                UINT uHeight
+                  Height scale of the map
+                UINT uDepth
+                  Number of columns along the z-axis
+                std::vector<XMFLOAT4>&& aColors
+                  Palette, one color per block type
+                std::vector<BYTE>&& aBlockTypes
+                  Row-major palette index of every column,
+                  INVALID_BLOCK_TYPE for empty columns
+                std::vector<WORD>&& aColumnHeights
+                  Row-major number of voxels of every column
+
+      Modifies: [m_uWidth, m_uHeight, m_uDepth, m_aColors,
+                 m_aBlockTypes, m_aColumnHeights, m_pBlockTypes,
+                 m_pColumnHeights].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the grids do not have
+                  uWidth * uDepth entries
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HeightMap::Create(
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _In_ UINT uDepth,
+        _In_ std::vector<XMFLOAT4>&& aColors,
+        _In_ std::vector<BYTE>&& aBlockTypes,
+        _In_ std::vector<WORD>&& aColumnHeights
+    )
+    {
+        const size_t uNumColumns = static_cast<size_t>(uWidth) * static_cast<size_t>(uDepth);
+        if (aBlockTypes.size() != uNumColumns || aColumnHeights.size() != uNumColumns)
+        {
+            return E_INVALIDARG;
+        }
+
+        release();
+
+        m_uWidth = uWidth;
+        m_uHeight = uHeight;
+        m_uDepth = uDepth;
+        m_aColors = std::move(aColors);
+        m_aBlockTypes = std::move(aBlockTypes);
+        m_aColumnHeights = std::move(aColumnHeights);
+        m_pBlockTypes = m_aBlockTypes.data();
+        m_pColumnHeights = m_aColumnHeights.data();
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::SaveBinary
+
+      Summary:  Writes the height map in the binary format
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the binary height map to write
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HeightMap::SaveBinary(_In_ const std::filesystem::path& filePath) const
+    {
+        const UINT64 ullNumColumns = static_cast<UINT64>(m_uWidth) * static_cast<UINT64>(m_uDepth);
+        if (ullNumColumns > 0u && (!m_pBlockTypes || !m_pColumnHeights))
+        {
+            return E_FAIL;
+        }
+
+        FileHeader header =
+        {
+            .dwMagic = FILE_MAGIC,
+            .dwVersion = FILE_VERSION,
+            .uWidth = m_uWidth,
+            .uHeight = m_uHeight,
+            .uDepth = m_uDepth,
+            .uNumColors = static_cast<UINT>(m_aColors.size()),
+            .ullBlockTypesOffset = sizeof(FileHeader) + m_aColors.size() * sizeof(XMFLOAT4),
+        };
+        header.ullColumnHeightsOffset = (header.ullBlockTypesOffset + ullNumColumns * sizeof(BYTE) + alignof(WORD) - 1u) & ~static_cast<UINT64>(alignof(WORD) - 1u);
+
+        std::ofstream outputFile(filePath, std::ios::binary | std::ios::trunc);
+        if (!outputFile.is_open())
+        {
+            return HRESULT_FROM_WIN32(ERROR_CANNOT_MAKE);
+        }
+
+        outputFile.write(reinterpret_cast<const CHAR*>(&header), sizeof(header));
+        outputFile.write(reinterpret_cast<const CHAR*>(m_aColors.data()), static_cast<std::streamsize>(m_aColors.size() * sizeof(XMFLOAT4)));
+        outputFile.write(reinterpret_cast<const CHAR*>(m_pBlockTypes), static_cast<std::streamsize>(ullNumColumns * sizeof(BYTE)));
+
+        const CHAR padding[alignof(WORD)] = { 0, };
+        outputFile.write(padding, static_cast<std::streamsize>(header.ullColumnHeightsOffset - header.ullBlockTypesOffset - ullNumColumns * sizeof(BYTE)));
+        outputFile.write(reinterpret_cast<const CHAR*>(m_pColumnHeights), static_cast<std::streamsize>(ullNumColumns * sizeof(WORD)));
+
+        if (outputFile.fail())
+        {
+            return HRESULT_FROM_WIN32(ERROR_WRITE_FAULT);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::ConvertTextToBinary
+
+      Summary:  Imports a text height map and writes it in the binary
+                format
+
+      Args:     const std::filesystem::path& textFilePath
+                  Path to the text height map to import
+                const std::filesystem::path& binaryFilePath
+                  Path to the binary height map to write
+                ThreadPool* pThreadPool
+                  Pool to parse the text on, nullptr to parse on the
+                  calling thread only
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HeightMap::ConvertTextToBinary(_In_ const std::filesystem::path& textFilePath, _In_ const std::filesystem::path& binaryFilePath, _In_opt_ ThreadPool* pThreadPool)
+    {
+        HeightMap heightMap;
+        HRESULT hr = heightMap.ImportText(textFilePath, pThreadPool);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        return heightMap.SaveBinary(binaryFilePath);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::GetWidth
+
+      Summary:  Returns the number of columns along the x-axis
+
+      Returns:  UINT
+                  Width of the map
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT HeightMap::GetWidth() const
+    {
+        return m_uWidth;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::GetHeight
+
+      Summary:  Returns the height scale, the number of voxels of a
+                column with the normalized height of 1
+
+      Returns:  UINT
+                  Height scale of the map
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT HeightMap::GetHeight() const
+    {
+        return m_uHeight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::GetDepth
+
+      Summary:  Returns the number of columns along the z-axis
+
+      Returns:  UINT
+                  Depth of the map
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT HeightMap::GetDepth() const
+    {
+        return m_uDepth;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::GetNumColors
+
+      Summary:  Returns the number of palette colors
+
+      Returns:  UINT
+                  Number of palette colors
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT HeightMap::GetNumColors() const
+    {
+        return static_cast<UINT>(m_aColors.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::GetColor
+
+      Summary:  Returns the palette color of the given block type
+
+      Args:     UINT uIndex
+                  Block type index, relative to eBlockType::GRASSLAND
+
+      Returns:  const XMFLOAT4&
+                  Palette color
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMFLOAT4& HeightMap::GetColor(_In_ UINT uIndex) const
+    {
+        assert(uIndex < m_aColors.size());
+
+        return m_aColors[uIndex];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::GetBlockTypes
+
+      Summary:  Returns the block type of every column, row by row
+                (x fastest). INVALID_BLOCK_TYPE marks an empty column
+
+      Returns:  const BYTE*
+                  Block type array of uWidth x uDepth elements
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BYTE* HeightMap::GetBlockTypes() const
+    {
+        return m_pBlockTypes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::GetColumnHeights
+
+      Summary:  Returns the number of voxels of every column, row by row
+                (x fastest)
+
+      Returns:  const WORD*
+                  Column height array of uWidth x uDepth elements
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const WORD* HeightMap::GetColumnHeights() const
+    {
+        return m_pColumnHeights;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::GetBlockType
+
+      Summary:  Returns the block type of a column
+
+      Args:     UINT uX
+                  Column index along the x-axis
+                UINT uZ
+                  Column index along the z-axis
+
+      Returns:  BYTE
+                  Block type index, relative to eBlockType::GRASSLAND
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BYTE HeightMap::GetBlockType(_In_ UINT uX, _In_ UINT uZ) const
+    {
+        assert(uX < m_uWidth && uZ < m_uDepth);
+
+        return m_pBlockTypes[static_cast<size_t>(uZ) * m_uWidth + uX];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::GetColumnHeight
+
+      Summary:  Returns the number of voxels of a column
+
+      Args:     UINT uX
+                  Column index along the x-axis
+                UINT uZ
+                  Column index along the z-axis
+
+      Returns:  UINT
+                  Number of voxels stacked in the column
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT HeightMap::GetColumnHeight(_In_ UINT uX, _In_ UINT uZ) const
+    {
+        assert(uX < m_uWidth && uZ < m_uDepth);
+
+        return m_pColumnHeights[static_cast<size_t>(uZ) * m_uWidth + uX];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::release
+
+      Summary:  Unmaps the mapped view, closes the file handles and
+                clears the owned arrays
+
+      Modifies: [m_uWidth, m_uHeight, m_uDepth, m_aColors,
+                 m_aBlockTypes, m_aColumnHeights, m_hFile,
+                 m_hFileMapping, m_pMappedView, m_pBlockTypes,
+                 m_pColumnHeights].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HeightMap::release()
+    {
+        if (m_pMappedView)
+        {
+            UnmapViewOfFile(m_pMappedView);
+            m_pMappedView = nullptr;
+        }
+
+        if (m_hFileMapping)
+        {
+            CloseHandle(m_hFileMapping);
+            m_hFileMapping = nullptr;
+        }
+
+        if (m_hFile != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_hFile);
+            m_hFile = INVALID_HANDLE_VALUE;
+        }
+
+        m_uWidth = 0u;
+        m_uHeight = 0u;
+        m_uDepth = 0u;
+        m_aColors.clear();
+        m_aBlockTypes.clear();
+        m_aColumnHeights.clear();
+        m_pBlockTypes = nullptr;
+        m_pColumnHeights = nullptr;
+    }
+}
\ No newline at end of file
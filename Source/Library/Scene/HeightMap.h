@@ -0,0 +1,147 @@
+/*+===================================================================
+  File:      HEIGHTMAP.H
+
+  Summary:   HeightMap header file contains declarations of HeightMap
+             class used to load the block / height grid of a voxel
+             scene.
+
+  Classes: HeightMap
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Scene/HeightMapText.h"
+#include "Thread/ThreadPool.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    HeightMap
+
+      Summary:  Block type / column height grid of a voxel map.
+                Binary height maps (.vxm) are memory-mapped and used
+                in place, text height maps are imported and can be
+                converted to the binary format.
+
+      Methods:  Load
+                  Loads a binary or text height map depending on the
+                  file extension
+                LoadBinary
+                  Memory-maps a binary height map
+                ImportText
+                  Parses a text height map
+                Create
+                  Takes over a grid built in memory
+                SaveBinary
+                  Writes the height map in the binary format
+                ConvertTextToBinary
+                  Converts a text height map file into a binary one
+                GetWidth
+                  Returns the number of columns along the x-axis
+                GetHeight
+                  Returns the height scale of the map
+                GetDepth
+                  Returns the number of columns along the z-axis
+                GetNumColors
+                  Returns the number of palette colors
+                GetColor
+                  Returns the palette color of the given block type
+                GetBlockTypes
+                  Returns the packed block type array
+                GetColumnHeights
+                  Returns the packed column height array
+                GetBlockType
+                  Returns the block type of a column
+                GetColumnHeight
+                  Returns the number of voxels of a column
+                HeightMap
+                  Constructor.
+                ~HeightMap
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class HeightMap
+    {
+    public:
+        static constexpr const DWORD FILE_MAGIC = 0x4D485856u; // "VXHM"
+        static constexpr const DWORD FILE_VERSION = 1u;
+        static constexpr const BYTE INVALID_BLOCK_TYPE = 0xFFu;
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   FileHeader
+
+          Summary:  Header of a binary height map. The palette
+                    (XMFLOAT4 x uNumColors) follows the header, the
+                    block type (BYTE x uWidth x uDepth) and column
+                    height (WORD x uWidth x uDepth) arrays are found at
+                    the given offsets.
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct FileHeader
+        {
+            DWORD dwMagic;
+            DWORD dwVersion;
+            UINT uWidth;
+            UINT uHeight;
+            UINT uDepth;
+            UINT uNumColors;
+            UINT64 ullBlockTypesOffset;
+            UINT64 ullColumnHeightsOffset;
+        };
+
+    public:
+        HeightMap();
+        HeightMap(const HeightMap& other) = delete;
+        HeightMap(HeightMap&& other) = delete;
+        HeightMap& operator=(const HeightMap& other) = delete;
+        HeightMap& operator=(HeightMap&& other) = delete;
+        ~HeightMap();
+
+        HRESULT Load(_In_ const std::filesystem::path& filePath, _In_opt_ ThreadPool* pThreadPool = nullptr);
+        HRESULT LoadBinary(_In_ const std::filesystem::path& filePath);
+        HRESULT ImportText(_In_ const std::filesystem::path& filePath, _In_opt_ ThreadPool* pThreadPool = nullptr);
+        HRESULT Create(
+            _In_ UINT uWidth,
+            _In_ UINT uHeight,
+            _In_ UINT uDepth,
+            _In_ std::vector<XMFLOAT4>&& aColors,
+            _In_ std::vector<BYTE>&& aBlockTypes,
+            _In_ std::vector<WORD>&& aColumnHeights
+        );
+        HRESULT SaveBinary(_In_ const std::filesystem::path& filePath) const;
+
+        static HRESULT ConvertTextToBinary(_In_ const std::filesystem::path& textFilePath, _In_ const std::filesystem::path& binaryFilePath, _In_opt_ ThreadPool* pThreadPool = nullptr);
+
+        UINT GetWidth() const;
+        UINT GetHeight() const;
+        UINT GetDepth() const;
+        UINT GetNumColors() const;
+        const XMFLOAT4& GetColor(_In_ UINT uIndex) const;
+
+        const BYTE* GetBlockTypes() const;
+        const WORD* GetColumnHeights() const;
+        BYTE GetBlockType(_In_ UINT uX, _In_ UINT uZ) const;
+        UINT GetColumnHeight(_In_ UINT uX, _In_ UINT uZ) const;
+
+    private:
+        void release();
+
+    private:
+        UINT m_uWidth;
+        UINT m_uHeight;
+        UINT m_uDepth;
+        std::vector<XMFLOAT4> m_aColors;
+
+        std::vector<BYTE> m_aBlockTypes;
+        std::vector<WORD> m_aColumnHeights;
+
+        HANDLE m_hFile;
+        HANDLE m_hFileMapping;
+        LPVOID m_pMappedView;
+
+        const BYTE* m_pBlockTypes;
+        const WORD* m_pColumnHeights;
+    };
+}
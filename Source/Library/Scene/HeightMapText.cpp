@@ -0,0 +1,333 @@
+#include "Scene/HeightMapText.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <type_traits>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapText::Parse
+
+      Summary:  Parses a text height map. The column entries are split
+                into line ranges that are parsed on the thread pool and
+                copied to their final place by prefix sums
+
+      Args:     const char* pBegin
+                  Start of the text
+                const char* pEnd
+                  End of the text
+                char firstBlockType
+                  Character of the first block type
+                uint32_t uNumBlockTypes
+                  Number of block types, columns of other characters
+                  are skipped
+                ThreadPool* pThreadPool
+                  Pool to parse the columns on, nullptr to parse on the
+                  calling thread only
+                HeightMapTextData& outData
+                  Parsed height map
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HeightMapText::Parse(
+        const char* pBegin,
+        const char* pEnd,
+        char firstBlockType,
+        uint32_t uNumBlockTypes,
+        ThreadPool* pThreadPool,
+        HeightMapTextData& outData
+    )
+    {
+        const char* pCursor = pBegin;
+
+        uint32_t aDimension[4] = { 0u, };
+        uint32_t uDimensionIdx = 0u;
+        while (uDimensionIdx < 4u && skipWhitespace(pCursor, pEnd))
+        {
+            if (parseNumber(pCursor, pEnd, aDimension[uDimensionIdx]))
+            {
+                ++uDimensionIdx;
+            }
+            else
+            {
+                skipToken(pCursor, pEnd);
+            }
+        }
+
+        outData.Width = aDimension[0];
+        outData.Height = aDimension[1];
+        outData.Depth = aDimension[2];
+
+        outData.Colors.clear();
+        while (outData.Colors.size() < aDimension[3] && skipWhitespace(pCursor, pEnd))
+        {
+            std::array<float, 3> color = { 0.0f, 0.0f, 0.0f };
+            if (parseNumber(pCursor, pEnd, color[0]) && parseNumber(pCursor, pEnd, color[1]) && parseNumber(pCursor, pEnd, color[2]))
+            {
+                outData.Colors.push_back(color);
+            }
+            else
+            {
+                skipToken(pCursor, pEnd);
+            }
+        }
+
+        // Split the column entries at line breaks, a few ranges per
+        // thread so that uneven lines still balance. An entry never
+        // spans a line break, so every range parses on its own
+        const size_t uNumRanges = pThreadPool ? (static_cast<size_t>(pThreadPool->GetNumThreads()) + 1u) * 4u : 1u;
+        const size_t uBodySize = static_cast<size_t>(pEnd - pCursor);
+        std::vector<const char*> aRangeBounds(uNumRanges + 1u, pEnd);
+        aRangeBounds[0] = pCursor;
+        for (size_t uRangeIdx = 1u; uRangeIdx < uNumRanges; ++uRangeIdx)
+        {
+            const char* pBound = (std::max)(pCursor + uBodySize * uRangeIdx / uNumRanges, aRangeBounds[uRangeIdx - 1u]);
+            while (pBound < pEnd && *pBound != '\n')
+            {
+                ++pBound;
+            }
+            aRangeBounds[uRangeIdx] = pBound < pEnd ? pBound + 1 : pEnd;
+        }
+
+        const uint32_t uHeight = outData.Height;
+        std::vector<std::vector<uint8_t>> aRangeBlockTypes(uNumRanges);
+        std::vector<std::vector<uint16_t>> aRangeColumnHeights(uNumRanges);
+        auto parseRanges = [&](size_t uBegin, size_t uEnd)
+        {
+            for (size_t uRangeIdx = uBegin; uRangeIdx < uEnd; ++uRangeIdx)
+            {
+                const char* pRangeCursor = aRangeBounds[uRangeIdx];
+                const char* const pRangeEnd = aRangeBounds[uRangeIdx + 1u];
+                std::vector<uint8_t>& aBlockTypes = aRangeBlockTypes[uRangeIdx];
+                std::vector<uint16_t>& aColumnHeights = aRangeColumnHeights[uRangeIdx];
+
+                while (skipWhitespace(pRangeCursor, pRangeEnd))
+                {
+                    const char voxelType = *pRangeCursor++;
+
+                    // An entry without a height on its line is dropped,
+                    // the next line starts a new entry
+                    if (!skipBlanks(pRangeCursor, pRangeEnd))
+                    {
+                        continue;
+                    }
+
+                    float height;
+                    if (!parseNumber(pRangeCursor, pRangeEnd, height))
+                    {
+                        skipToken(pRangeCursor, pRangeEnd);
+                        continue;
+                    }
+
+                    const uint32_t uBlockType = static_cast<uint32_t>(static_cast<int32_t>(voxelType) - static_cast<int32_t>(firstBlockType));
+                    if (uBlockType < uNumBlockTypes)
+                    {
+                        aBlockTypes.push_back(static_cast<uint8_t>(uBlockType));
+                        aColumnHeights.push_back(toColumnHeight(uHeight, height));
+                    }
+                }
+            }
+        };
+
+        if (pThreadPool)
+        {
+            pThreadPool->ParallelFor(uNumRanges, 1u, parseRanges);
+        }
+        else
+        {
+            parseRanges(0u, uNumRanges);
+        }
+
+        const size_t uNumColumns = static_cast<size_t>(outData.Width) * static_cast<size_t>(outData.Depth);
+        std::vector<size_t> aRangeOffsets(uNumRanges + 1u, 0u);
+        for (size_t uRangeIdx = 0u; uRangeIdx < uNumRanges; ++uRangeIdx)
+        {
+            aRangeOffsets[uRangeIdx + 1u] = aRangeOffsets[uRangeIdx] + aRangeBlockTypes[uRangeIdx].size();
+        }
+
+        outData.BlockTypes.assign(uNumColumns, INVALID_BLOCK_TYPE);
+        outData.ColumnHeights.assign(uNumColumns, 0u);
+        auto copyRanges = [&](size_t uBegin, size_t uEnd)
+        {
+            for (size_t uRangeIdx = uBegin; uRangeIdx < uEnd; ++uRangeIdx)
+            {
+                if (aRangeOffsets[uRangeIdx] >= uNumColumns)
+                {
+                    continue;
+                }
+
+                const size_t uNumCopied = (std::min)(aRangeBlockTypes[uRangeIdx].size(), uNumColumns - aRangeOffsets[uRangeIdx]);
+                std::copy_n(aRangeBlockTypes[uRangeIdx].begin(), uNumCopied, outData.BlockTypes.begin() + aRangeOffsets[uRangeIdx]);
+                std::copy_n(aRangeColumnHeights[uRangeIdx].begin(), uNumCopied, outData.ColumnHeights.begin() + aRangeOffsets[uRangeIdx]);
+            }
+        };
+
+        if (pThreadPool)
+        {
+            pThreadPool->ParallelFor(uNumRanges, 1u, copyRanges);
+        }
+        else
+        {
+            copyRanges(0u, uNumRanges);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapText::toColumnHeight
+
+      Summary:  Converts a normalized height into a number of voxels
+
+      Args:     uint32_t uHeight
+                  Height scale of the map
+                float height
+                  Normalized height of the column
+
+      Returns:  uint16_t
+                  Number of voxels of the column
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint16_t HeightMapText::toColumnHeight(uint32_t uHeight, float height)
+    {
+        float columnHeight = static_cast<float>(uHeight) * height;
+        columnHeight = columnHeight < 0.0f ? 0.0f : columnHeight;
+        columnHeight = columnHeight > static_cast<float>(0xFFFF) ? static_cast<float>(0xFFFF) : columnHeight;
+
+        return static_cast<uint16_t>(columnHeight);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapText::isWhitespace
+
+      Summary:  Returns whether the character is white space, the same
+                set istream skips in the "C" locale
+
+      Args:     char character
+                  Character to test
+
+      Returns:  bool
+                  Whether the character is white space
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool HeightMapText::isWhitespace(char character)
+    {
+        return character == ' ' || character == '\t' || character == '\r' || character == '\n' || character == '\v' || character == '\f';
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapText::skipWhitespace
+
+      Summary:  Advances the cursor past white space
+
+      Args:     const char*& pCursor
+                  Cursor into the text
+                const char* pEnd
+                  End of the text
+
+      Returns:  bool
+                  Whether there is anything left to parse
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool HeightMapText::skipWhitespace(const char*& pCursor, const char* pEnd)
+    {
+        while (pCursor < pEnd && isWhitespace(*pCursor))
+        {
+            ++pCursor;
+        }
+
+        return pCursor < pEnd;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapText::skipBlanks
+
+      Summary:  Advances the cursor past white space on the current
+                line. A CR is a blank, so CRLF line endings end a line
+                at the LF
+
+      Args:     const char*& pCursor
+                  Cursor into the text
+                const char* pEnd
+                  End of the text
+
+      Returns:  bool
+                  Whether there is anything left to parse on the line
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool HeightMapText::skipBlanks(const char*& pCursor, const char* pEnd)
+    {
+        while (pCursor < pEnd && *pCursor != '\n' && isWhitespace(*pCursor))
+        {
+            ++pCursor;
+        }
+
+        return pCursor < pEnd && *pCursor != '\n';
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapText::skipToken
+
+      Summary:  Advances the cursor past the next token, the same way
+                the istream loader discarded unreadable input
+
+      Args:     const char*& pCursor
+                  Cursor into the text
+                const char* pEnd
+                  End of the text
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HeightMapText::skipToken(const char*& pCursor, const char* pEnd)
+    {
+        skipWhitespace(pCursor, pEnd);
+        while (pCursor < pEnd && !isWhitespace(*pCursor))
+        {
+            ++pCursor;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapText::parseNumber
+
+      Summary:  Parses a number after optional white space and advances
+                the cursor past it. A leading '+' is accepted like
+                istream does, infinities and NaNs are not
+
+      Args:     const char*& pCursor
+                  Cursor into the text
+                const char* pEnd
+                  End of the text
+                T& value
+                  Parsed number
+
+      Returns:  bool
+                  Whether a number was parsed. The cursor is left at the
+                  start of the unreadable token otherwise
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <typename T>
+    bool HeightMapText::parseNumber(const char*& pCursor, const char* pEnd, T& value)
+    {
+        value = T();
+        if (!skipWhitespace(pCursor, pEnd))
+        {
+            return false;
+        }
+
+        const char* pNumber = *pCursor == '+' ? pCursor + 1 : pCursor;
+        if (pNumber != pCursor && pNumber < pEnd && *pNumber == '-')
+        {
+            return false;
+        }
+
+        const std::from_chars_result result = std::from_chars(pNumber, pEnd, value);
+        if (result.ec != std::errc())
+        {
+            return false;
+        }
+
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            if (!std::isfinite(value))
+            {
+                value = T();
+                return false;
+            }
+        }
+
+        pCursor = result.ptr;
+        return true;
+    }
+}
@@ -0,0 +1,82 @@
+/*+===================================================================
+  File:      HEIGHTMAPTEXT.H
+
+  Summary:   HeightMapText header file contains declarations of the
+             parser of text height maps. It only depends on the
+             standard library so it can be tested without Direct3D.
+
+  Classes: HeightMapText
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Thread/ThreadPool.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   HeightMapTextData
+
+      Summary:  Contents of a text height map. BlockTypes and
+                ColumnHeights hold Width x Depth elements, row by row
+                (x fastest). Columns missing from the text have an
+                invalid block type and a height of 0
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct HeightMapTextData
+    {
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t Depth;
+        std::vector<std::array<float, 3>> Colors;
+        std::vector<uint8_t> BlockTypes;
+        std::vector<uint16_t> ColumnHeights;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    HeightMapText
+
+      Summary:  Parses the dimensions and the number of colors, the
+                palette, then a block type character and a normalized
+                height for every column. Unreadable tokens are skipped
+                the way the istream loader skipped them. A column entry
+                has to end on the line it starts on, which lets the
+                entries be split at line breaks and parsed in parallel
+                with the same result for any number of threads
+
+      Methods:  Parse
+                  Parses a text height map held in memory
+                INVALID_BLOCK_TYPE
+                  Block type of the columns missing from the text
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class HeightMapText final
+    {
+    public:
+        static constexpr const uint8_t INVALID_BLOCK_TYPE = 0xFFu;
+
+        HeightMapText() = delete;
+
+        static void Parse(
+            const char* pBegin,
+            const char* pEnd,
+            char firstBlockType,
+            uint32_t uNumBlockTypes,
+            ThreadPool* pThreadPool,
+            HeightMapTextData& outData
+        );
+
+    private:
+        static uint16_t toColumnHeight(uint32_t uHeight, float height);
+        static bool isWhitespace(char character);
+        static bool skipWhitespace(const char*& pCursor, const char* pEnd);
+        static bool skipBlanks(const char*& pCursor, const char* pEnd);
+        static void skipToken(const char*& pCursor, const char* pEnd);
+        template <typename T>
+        static bool parseNumber(const char*& pCursor, const char* pEnd, T& value);
+    };
+}
@@ -0,0 +1,458 @@
+#include "Scene/PerlinNoise.h"
+
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// MSVC emits AVX2 instructions wherever the intrinsics are used, other
+// compilers only inside functions built for the AVX2 target
+#if defined(_MSC_VER)
+#define PERLIN_NOISE_AVX2
+#else
+#define PERLIN_NOISE_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace library
+{
+    namespace
+    {
+        constexpr const uint32_t HASHES[] =
+        {
+            208,34,231,213,32,248,233,56,161,78,24,140,71,48,140,254,245,255,247,247,40,
+            185,248,251,245,28,124,204,204,76,36,1,107,28,234,163,202,224,245,128,167,204,
+            9,92,217,54,239,174,173,102,193,189,190,121,100,108,167,44,43,77,180,204,8,81,
+            70,223,11,38,24,254,210,210,177,32,81,195,243,125,8,169,112,32,97,53,195,13,
+            203,9,47,104,125,117,114,124,165,203,181,235,193,206,70,180,174,0,167,181,41,
+            164,30,116,127,198,245,146,87,224,149,206,57,4,192,210,65,210,129,240,178,105,
+            228,108,245,148,140,40,35,195,38,58,65,207,215,253,65,85,208,76,62,3,237,55,89,
+            232,50,217,64,244,157,199,121,252,90,17,212,203,149,152,140,187,234,177,73,174,
+            193,100,192,143,97,53,145,135,19,103,13,90,135,151,199,91,239,247,33,39,145,
+            101,120,99,3,186,86,99,41,237,203,111,79,220,135,158,42,30,154,120,67,87,167,
+            135,176,183,191,253,115,184,21,233,58,129,233,142,39,128,211,118,137,139,255,
+            114,20,218,113,154,27,127,246,250,1,8,198,250,209,92,222,173,21,88,102,219
+        };
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: truncate4
+
+          Summary:  Truncates four coordinates to unsigned integers the
+                    way static_cast<uint32_t> does. Lanes of 2^31 and
+                    above are offset into the signed range first, as
+                    SSE2 only converts to signed integers
+
+          Args:     __m128 x
+                      Coordinates in [0, 2^32)
+                    __m128& truncated
+                      Truncated coordinates as floats
+
+          Returns:  __m128i
+                      Truncated coordinates as unsigned integers
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        __m128i truncate4(__m128 x, __m128& truncated)
+        {
+            const __m128 signBit = _mm_set1_ps(2147483648.0f);
+            const __m128 large = _mm_cmpge_ps(x, signBit);
+            const __m128i integer = _mm_xor_si128(
+                _mm_cvttps_epi32(_mm_sub_ps(x, _mm_and_ps(large, signBit))),
+                _mm_slli_epi32(_mm_castps_si128(large), 31)
+            );
+
+            // Floats of 2^31 and above have no fraction
+            truncated = _mm_or_ps(_mm_and_ps(large, x), _mm_andnot_ps(large, _mm_cvtepi32_ps(integer)));
+
+            return integer;
+        }
+
+        PERLIN_NOISE_AVX2 __m256i truncate8(__m256 x, __m256& truncated)
+        {
+            const __m256 signBit = _mm256_set1_ps(2147483648.0f);
+            const __m256 large = _mm256_cmp_ps(x, signBit, _CMP_GE_OQ);
+            const __m256i integer = _mm256_xor_si256(
+                _mm256_cvttps_epi32(_mm256_sub_ps(x, _mm256_and_ps(large, signBit))),
+                _mm256_slli_epi32(_mm256_castps_si256(large), 31)
+            );
+
+            truncated = _mm256_blendv_ps(_mm256_cvtepi32_ps(integer), x, large);
+
+            return integer;
+        }
+
+        __m128 smoothLerp4(__m128 x, __m128 y, __m128 s)
+        {
+            const __m128 weight = _mm_mul_ps(_mm_mul_ps(s, s), _mm_sub_ps(_mm_set1_ps(3.0f), _mm_mul_ps(_mm_set1_ps(2.0f), s)));
+
+            return _mm_add_ps(x, _mm_mul_ps(weight, _mm_sub_ps(y, x)));
+        }
+
+        PERLIN_NOISE_AVX2 __m256 smoothLerp8(__m256 x, __m256 y, __m256 s)
+        {
+            const __m256 weight = _mm256_mul_ps(_mm256_mul_ps(s, s), _mm256_sub_ps(_mm256_set1_ps(3.0f), _mm256_mul_ps(_mm256_set1_ps(2.0f), s)));
+
+            return _mm256_add_ps(x, _mm256_mul_ps(weight, _mm256_sub_ps(y, x)));
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: getNoise2d4
+
+          Summary:  getNoise2d for four samples. SSE2 has no gather, so
+                    the hashes of the four lanes are looked up one by
+                    one, sharing the row hash of the two corners of
+                    each row
+
+          Args:     __m128 x
+                      x coordinates of the samples
+                    __m128 y
+                      y coordinates of the samples
+
+          Returns:  __m128
+                      Value noise of the samples
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        __m128 getNoise2d4(__m128 x, __m128 y)
+        {
+            __m128 truncatedX;
+            __m128 truncatedY;
+            const __m128i iX = truncate4(x, truncatedX);
+            const __m128i iY = truncate4(y, truncatedY);
+            const __m128 xFrac = _mm_sub_ps(x, truncatedX);
+            const __m128 yFrac = _mm_sub_ps(y, truncatedY);
+
+            alignas(16) uint32_t aX[4];
+            alignas(16) uint32_t aY[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(aX), iX);
+            _mm_store_si128(reinterpret_cast<__m128i*>(aY), iY);
+
+            alignas(16) uint32_t aS[4];
+            alignas(16) uint32_t aT[4];
+            alignas(16) uint32_t aU[4];
+            alignas(16) uint32_t aV[4];
+            for (uint32_t uLane = 0u; uLane < 4u; ++uLane)
+            {
+                const uint32_t uLow = HASHES[aY[uLane] % 256u] + aX[uLane];
+                const uint32_t uHigh = HASHES[(aY[uLane] + 1u) % 256u] + aX[uLane];
+                aS[uLane] = HASHES[uLow % 256u];
+                aT[uLane] = HASHES[(uLow + 1u) % 256u];
+                aU[uLane] = HASHES[uHigh % 256u];
+                aV[uLane] = HASHES[(uHigh + 1u) % 256u];
+            }
+
+            const __m128 s = _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(aS)));
+            const __m128 t = _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(aT)));
+            const __m128 u = _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(aU)));
+            const __m128 v = _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(aV)));
+
+            const __m128 low = smoothLerp4(s, t, xFrac);
+            const __m128 high = smoothLerp4(u, v, xFrac);
+
+            return smoothLerp4(low, high, yFrac);
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: getNoise2d8
+
+          Summary:  getNoise2d for eight samples, the hashes are
+                    gathered
+
+          Args:     __m256 x
+                      x coordinates of the samples
+                    __m256 y
+                      y coordinates of the samples
+
+          Returns:  __m256
+                      Value noise of the samples
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        PERLIN_NOISE_AVX2 __m256 getNoise2d8(__m256 x, __m256 y)
+        {
+            const int* pHashes = reinterpret_cast<const int*>(HASHES);
+            const __m256i mask = _mm256_set1_epi32(255);
+            const __m256i one = _mm256_set1_epi32(1);
+
+            __m256 truncatedX;
+            __m256 truncatedY;
+            const __m256i iX = truncate8(x, truncatedX);
+            const __m256i iY = truncate8(y, truncatedY);
+            const __m256 xFrac = _mm256_sub_ps(x, truncatedX);
+            const __m256 yFrac = _mm256_sub_ps(y, truncatedY);
+
+            const __m256i low = _mm256_add_epi32(_mm256_i32gather_epi32(pHashes, _mm256_and_si256(iY, mask), 4), iX);
+            const __m256i high = _mm256_add_epi32(_mm256_i32gather_epi32(pHashes, _mm256_and_si256(_mm256_add_epi32(iY, one), mask), 4), iX);
+
+            const __m256 s = _mm256_cvtepi32_ps(_mm256_i32gather_epi32(pHashes, _mm256_and_si256(low, mask), 4));
+            const __m256 t = _mm256_cvtepi32_ps(_mm256_i32gather_epi32(pHashes, _mm256_and_si256(_mm256_add_epi32(low, one), mask), 4));
+            const __m256 u = _mm256_cvtepi32_ps(_mm256_i32gather_epi32(pHashes, _mm256_and_si256(high, mask), 4));
+            const __m256 v = _mm256_cvtepi32_ps(_mm256_i32gather_epi32(pHashes, _mm256_and_si256(_mm256_add_epi32(high, one), mask), 4));
+
+            return smoothLerp8(smoothLerp8(s, t, xFrac), smoothLerp8(u, v, xFrac), yFrac);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PerlinNoise::GetPerlin2d
+
+      Summary:  Sums uDepth octaves of value noise, each at twice the
+                frequency and half the amplitude of the previous one
+
+      Args:     float x
+                  x coordinate of the sample
+                float y
+                  y coordinate of the sample
+                float frequency
+                  Frequency of the first octave
+                uint32_t uDepth
+                  Number of octaves
+
+      Returns:  float
+                  Noise value in [0, 1)
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    float PerlinNoise::GetPerlin2d(float x, float y, float frequency, uint32_t uDepth)
+    {
+        float xa = x * frequency;
+        float ya = y * frequency;
+        float amp = 1.0f;
+        float fin = 0.0f;
+        float div = 0.0f;
+
+        for (uint32_t i = 0; i < uDepth; ++i)
+        {
+            div += 256.0f * amp;
+            fin += getNoise2d(xa, ya) * amp;
+            amp /= 2.0f;
+            xa *= 2.0f;
+            ya *= 2.0f;
+        }
+
+        return fin / div;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PerlinNoise::GetPerlin2dBatch
+
+      Summary:  Evaluates GetPerlin2d for a batch of sample positions,
+                eight samples at a time with AVX2 when the CPU supports
+                it and four at a time with SSE2 otherwise. The vector
+                paths perform the same operations in the same order as
+                GetPerlin2d, so every result matches it bit for bit
+
+      Args:     const float* pX
+                  x coordinates of the samples
+                const float* pY
+                  y coordinates of the samples
+                uint32_t uCount
+                  Number of samples
+                float frequency
+                  Frequency of the first octave
+                uint32_t uDepth
+                  Number of octaves
+                float* pResults
+                  Noise value of each sample
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void PerlinNoise::GetPerlin2dBatch(
+        const float* pX,
+        const float* pY,
+        uint32_t uCount,
+        float frequency,
+        uint32_t uDepth,
+        float* pResults
+    )
+    {
+        static const bool s_bAvx2Supported = IsAvx2Supported();
+
+        uint32_t i = 0u;
+        if (s_bAvx2Supported)
+        {
+            i = GetPerlin2dBatchAvx2(pX, pY, uCount, frequency, uDepth, pResults);
+        }
+        else
+        {
+            i = GetPerlin2dBatchSse2(pX, pY, uCount, frequency, uDepth, pResults);
+        }
+
+        for (; i < uCount; ++i)
+        {
+            pResults[i] = GetPerlin2d(pX[i], pY[i], frequency, uDepth);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PerlinNoise::GetPerlin2dBatchSse2
+
+      Summary:  Evaluates the samples of a batch four at a time
+
+      Args:     const float* pX
+                  x coordinates of the samples
+                const float* pY
+                  y coordinates of the samples
+                uint32_t uCount
+                  Number of samples
+                float frequency
+                  Frequency of the first octave
+                uint32_t uDepth
+                  Number of octaves
+                float* pResults
+                  Noise value of each sample
+
+      Returns:  uint32_t
+                  Number of samples evaluated, the rest is left to the
+                  scalar path
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t PerlinNoise::GetPerlin2dBatchSse2(
+        const float* pX,
+        const float* pY,
+        uint32_t uCount,
+        float frequency,
+        uint32_t uDepth,
+        float* pResults
+    )
+    {
+        uint32_t i = 0u;
+        for (; i + 4u <= uCount; i += 4u)
+        {
+            __m128 xa = _mm_mul_ps(_mm_loadu_ps(pX + i), _mm_set1_ps(frequency));
+            __m128 ya = _mm_mul_ps(_mm_loadu_ps(pY + i), _mm_set1_ps(frequency));
+            __m128 fin = _mm_setzero_ps();
+            float amp = 1.0f;
+            float div = 0.0f;
+
+            for (uint32_t uOctave = 0u; uOctave < uDepth; ++uOctave)
+            {
+                div += 256.0f * amp;
+                fin = _mm_add_ps(fin, _mm_mul_ps(getNoise2d4(xa, ya), _mm_set1_ps(amp)));
+                amp /= 2.0f;
+                xa = _mm_mul_ps(xa, _mm_set1_ps(2.0f));
+                ya = _mm_mul_ps(ya, _mm_set1_ps(2.0f));
+            }
+
+            _mm_storeu_ps(pResults + i, _mm_div_ps(fin, _mm_set1_ps(div)));
+        }
+
+        return i;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PerlinNoise::GetPerlin2dBatchAvx2
+
+      Summary:  Evaluates the samples of a batch eight at a time. Must
+                only be called when IsAvx2Supported returns true
+
+      Args:     const float* pX
+                  x coordinates of the samples
+                const float* pY
+                  y coordinates of the samples
+                uint32_t uCount
+                  Number of samples
+                float frequency
+                  Frequency of the first octave
+                uint32_t uDepth
+                  Number of octaves
+                float* pResults
+                  Noise value of each sample
+
+      Returns:  uint32_t
+                  Number of samples evaluated, the rest is left to the
+                  scalar path
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PERLIN_NOISE_AVX2 uint32_t PerlinNoise::GetPerlin2dBatchAvx2(
+        const float* pX,
+        const float* pY,
+        uint32_t uCount,
+        float frequency,
+        uint32_t uDepth,
+        float* pResults
+    )
+    {
+        uint32_t i = 0u;
+        for (; i + 8u <= uCount; i += 8u)
+        {
+            __m256 xa = _mm256_mul_ps(_mm256_loadu_ps(pX + i), _mm256_set1_ps(frequency));
+            __m256 ya = _mm256_mul_ps(_mm256_loadu_ps(pY + i), _mm256_set1_ps(frequency));
+            __m256 fin = _mm256_setzero_ps();
+            float amp = 1.0f;
+            float div = 0.0f;
+
+            for (uint32_t uOctave = 0u; uOctave < uDepth; ++uOctave)
+            {
+                div += 256.0f * amp;
+                fin = _mm256_add_ps(fin, _mm256_mul_ps(getNoise2d8(xa, ya), _mm256_set1_ps(amp)));
+                amp /= 2.0f;
+                xa = _mm256_mul_ps(xa, _mm256_set1_ps(2.0f));
+                ya = _mm256_mul_ps(ya, _mm256_set1_ps(2.0f));
+            }
+
+            _mm256_storeu_ps(pResults + i, _mm256_div_ps(fin, _mm256_set1_ps(div)));
+        }
+        _mm256_zeroupper();
+
+        return i;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PerlinNoise::IsAvx2Supported
+
+      Summary:  Returns whether the CPU and the OS support AVX2
+
+      Returns:  bool
+                  True if GetPerlin2dBatchAvx2 can run
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool PerlinNoise::IsAvx2Supported()
+    {
+#if defined(_MSC_VER)
+        int aCpuInfo[4];
+        __cpuid(aCpuInfo, 0);
+        if (aCpuInfo[0] < 7)
+        {
+            return false;
+        }
+
+        // The OS has to save the YMM registers on context switches
+        __cpuid(aCpuInfo, 1);
+        const bool bOsxsave = (aCpuInfo[2] & (1 << 27)) != 0;
+        const bool bAvx = (aCpuInfo[2] & (1 << 28)) != 0;
+        if (!bOsxsave || !bAvx || (_xgetbv(0) & 0x6u) != 0x6u)
+        {
+            return false;
+        }
+
+        __cpuidex(aCpuInfo, 7, 0);
+        return (aCpuInfo[1] & (1 << 5)) != 0;
+#else
+        // Also checks that the OS saves the YMM registers
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+    }
+
+    float PerlinNoise::getNoise2(uint32_t x, uint32_t y)
+    {
+        uint32_t temp = HASHES[y % 256u];
+
+        return static_cast<float>(HASHES[(temp + x) % 256u]);
+    }
+
+    float PerlinNoise::getNoise2d(float x, float y)
+    {
+        uint32_t uX = static_cast<uint32_t>(x);
+        uint32_t uY = static_cast<uint32_t>(y);
+        float xFrac = x - static_cast<float>(uX);
+        float yFrac = y - static_cast<float>(uY);
+
+        uint32_t s = static_cast<uint32_t>(getNoise2(uX, uY));
+        uint32_t t = static_cast<uint32_t>(getNoise2(uX + 1u, uY));
+        uint32_t u = static_cast<uint32_t>(getNoise2(uX, uY + 1u));
+        uint32_t v = static_cast<uint32_t>(getNoise2(uX + 1u, uY + 1u));
+
+        float low = smoothLerp(static_cast<float>(s), static_cast<float>(t), xFrac);
+        float high = smoothLerp(static_cast<float>(u), static_cast<float>(v), xFrac);
+
+        return smoothLerp(low, high, yFrac);
+    }
+
+    float PerlinNoise::lerp(float x, float y, float s)
+    {
+        return x + s * (y - x);
+    }
+
+    float PerlinNoise::smoothLerp(float x, float y, float s)
+    {
+        return lerp(x, y, s * s * (3.0f - 2.0f * s));
+    }
+}
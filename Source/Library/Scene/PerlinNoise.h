@@ -0,0 +1,80 @@
+/*+===================================================================
+  File:      PERLINNOISE.H
+
+  Summary:   PerlinNoise header file contains declarations of the
+             value noise the terrain is generated from, with a scalar
+             reference and SSE2 / AVX2 batch paths. It only depends on
+             the standard library so it can be tested without
+             Direct3D.
+
+  Classes: PerlinNoise
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    PerlinNoise
+
+      Summary:  Octaves of value noise over a 256-entry hash table.
+                The coordinates of a sample are truncated to unsigned
+                32-bit integers, so x * frequency and y * frequency
+                scaled by 2^(depth - 1) must lie in [0, 2^32). Within
+                that range the batch paths match GetPerlin2d bit for
+                bit
+
+      Methods:  GetPerlin2d
+                  Returns the noise of one sample
+                GetPerlin2dBatch
+                  Returns the noise of a batch of samples with the
+                  widest vector path the CPU supports
+                GetPerlin2dBatchSse2
+                  Evaluates a batch four samples at a time
+                GetPerlin2dBatchAvx2
+                  Evaluates a batch eight samples at a time
+                IsAvx2Supported
+                  Returns whether the CPU and the OS support AVX2
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class PerlinNoise final
+    {
+    public:
+        PerlinNoise() = delete;
+
+        static float GetPerlin2d(float x, float y, float frequency, uint32_t uDepth);
+        static void GetPerlin2dBatch(
+            const float* pX,
+            const float* pY,
+            uint32_t uCount,
+            float frequency,
+            uint32_t uDepth,
+            float* pResults
+        );
+        static uint32_t GetPerlin2dBatchSse2(
+            const float* pX,
+            const float* pY,
+            uint32_t uCount,
+            float frequency,
+            uint32_t uDepth,
+            float* pResults
+        );
+        static uint32_t GetPerlin2dBatchAvx2(
+            const float* pX,
+            const float* pY,
+            uint32_t uCount,
+            float frequency,
+            uint32_t uDepth,
+            float* pResults
+        );
+        static bool IsAvx2Supported();
+
+    private:
+        static float getNoise2(uint32_t x, uint32_t y);
+        static float getNoise2d(float x, float y);
+        static float lerp(float x, float y, float s);
+        static float smoothLerp(float x, float y, float s);
+    };
+}
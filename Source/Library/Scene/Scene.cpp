@@ -1,158 +1,212 @@
 #include "Scene/Scene.h"
 
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+
+#include "Profiler/Profiler.h"
+#include "Scene/PerlinNoise.h"
+#include "Scene/VoxelInstanceExtractor.h"
 #include "Shader/SkyMapVertexShader.h"
 
 namespace library
 {
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetPerlin2d
+
+      Summary:  Returns the noise of one sample, see
+                PerlinNoise::GetPerlin2d
+
+      Args:     FLOAT x
+                  x coordinate of the sample
+                FLOAT y
+                  y coordinate of the sample
+                FLOAT frequency
+                  Frequency of the first octave
+                UINT uDepth
+                  Number of octaves
+
+      Returns:  FLOAT
+                  Noise value in [0, 1)
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     FLOAT Scene::GetPerlin2d(FLOAT x, FLOAT y, FLOAT frequency, UINT uDepth)
     {
-        FLOAT xa = x * frequency;
-        FLOAT ya = y * frequency;
-        FLOAT amp = 1.0f;
-        FLOAT fin = 0.0f;
-        FLOAT div = 0.0f;
-
-        for (UINT i = 0; i < uDepth; ++i)
-        {
-            div += 256.0f * amp;
-            fin += getNoise2d(xa, ya) * amp;
-            amp /= 2.0f;
-            xa *= 2.0f;
-            ya *= 2.0f;
-        }
+        return PerlinNoise::GetPerlin2d(x, y, frequency, uDepth);
+    }
 
-        return fin / div;
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetPerlin2dBatch
+
+      Summary:  Evaluates GetPerlin2d for a batch of sample positions
+                with the widest vector path the CPU supports, see
+                PerlinNoise::GetPerlin2dBatch
+
+      Args:     const FLOAT* pX
+                  x coordinates of the samples
+                const FLOAT* pY
+                  y coordinates of the samples
+                UINT uCount
+                  Number of samples
+                FLOAT frequency
+                  Frequency of the first octave
+                UINT uDepth
+                  Number of octaves
+                FLOAT* pResults
+                  Noise value of each sample
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::GetPerlin2dBatch(
+        _In_reads_(uCount) const FLOAT* pX,
+        _In_reads_(uCount) const FLOAT* pY,
+        _In_ UINT uCount,
+        _In_ FLOAT frequency,
+        _In_ UINT uDepth,
+        _Out_writes_(uCount) FLOAT* pResults
+    )
+    {
+        PerlinNoise::GetPerlin2dBatch(pX, pY, uCount, frequency, uDepth, pResults);
     }
 
-    Scene::Scene(const std::filesystem::path& filePath)
+    Scene::Scene(const std::filesystem::path& filePath, _In_ eVoxelExtractionMode extractionMode)
         : m_filePath(filePath)
         , m_voxels()
+        , m_voxelChunks()
         , m_renderables()
-        , m_aPointLights{ nullptr }
+        , m_renderableHandles()
+        , m_models()
+        , m_modelHandles()
+        , m_aPointLights()
+        , m_directionalLight()
         , m_vertexShaders()
+        , m_vertexShaderHandles()
         , m_pixelShaders()
+        , m_pixelShaderHandles()
         , m_skyBox()
+        , m_uNumFilledVoxelInstances(0u)
+        , m_uNumVoxelInstances(0u)
+        , m_uStaticVersion(0u)
+        , m_extractionMode(eVoxelExtractionMode::FILLED_COLUMNS)
+        , m_bQuantizedTerrain(FALSE)
+        , m_uTerrainWidth(0u)
+        , m_uTerrainHeight(0u)
+        , m_uTerrainDepth(0u)
+        , m_uNumChunksX(0u)
+        , m_uNumChunksZ(0u)
+        , m_terrainStreamer()
     {
-        std::ifstream inputFile;
-        inputFile.open(m_filePath.string());
-
-        std::string trash;
-        UINT aDimension[4] = { 0u, };
-        UINT uDimensionIdx = 0u;
-        while (!inputFile.eof() && uDimensionIdx < ARRAYSIZE(aDimension))
+        ThreadPool threadPool;
+        HeightMap heightMap;
+        if (FAILED(heightMap.Load(m_filePath, &threadPool)))
         {
-            inputFile >> aDimension[uDimensionIdx];
-
-            if (inputFile.fail())
-            {
-                if (inputFile.eof())
-                {
-                    break;
-                }
-                inputFile.clear();
-                inputFile >> trash;
-            }
-            else
-            {
-                ++uDimensionIdx;
-            }
+            return;
         }
 
-        UINT uColorIdx = 0u;
-        XMFLOAT4 color;
-        while (!inputFile.eof() && uColorIdx < aDimension[3])
-        {
-            inputFile >> color.x >> color.y >> color.z;
+        createTerrain(heightMap, extractionMode, &threadPool);
+    }
 
-            if (inputFile.fail())
-            {
-                if (inputFile.eof())
-                {
-                    break;
-                }
-                inputFile.clear();
-                inputFile >> trash;
-            }
-            else
-            {
-                color.w = 1.0f;
-                m_voxels.push_back(std::make_shared<Voxel>(color));
-                ++uColorIdx;
-            }
-        }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::Scene
 
-        std::vector<std::vector<InstanceData>> aInstanceData;
-        aInstanceData.reserve(m_voxels.size());
-        for (UINT renderableIdx = 0u; renderableIdx < m_voxels.size(); ++renderableIdx)
-        {
-            aInstanceData.push_back(std::vector<InstanceData>());
-            aInstanceData.back().reserve(
-                static_cast<size_t>(aDimension[0]) * static_cast<size_t>(aDimension[1]) * static_cast<size_t>(aDimension[2])
-            );
-        }
+      Summary:  Constructor. Builds the terrain from a height map that
+                is already in memory, e.g. a generated one
 
-        UINT uDepthIdx = 0u;
-        UINT uWidthIdx = 0u;
-        CHAR voxelType;
-        FLOAT height;
-        while (!inputFile.eof())
-        {
-            inputFile >> voxelType >> height;
+      Args:     const HeightMap& heightMap
+                  Block type / column height grid of the terrain
+                eVoxelExtractionMode extractionMode
+                  How the voxels are extracted from the height map
+                ThreadPool* pThreadPool
+                  Pool to build the terrain on, nullptr to build it on
+                  the calling thread only
 
-            if (inputFile.fail())
-            {
-                if (inputFile.eof())
-                {
-                    break;
-                }
-                inputFile.clear();
-                inputFile >> trash;
-            }
-            else if (static_cast<CHAR>(eBlockType::GRASSLAND) <= voxelType && voxelType < static_cast<CHAR>(eBlockType::COUNT))
-            {
-                for (UINT heightIdx = 0; heightIdx < static_cast<UINT>(static_cast<float>(aDimension[1]) * height); ++heightIdx)
-                {
-                    aInstanceData[static_cast<size_t>(voxelType) - static_cast<size_t>(eBlockType::GRASSLAND)].push_back(
-                        InstanceData
-                        {
-                            .Transformation = XMMatrixTranslation(
-                                2.0f * (static_cast<FLOAT>(uWidthIdx) - static_cast<FLOAT>(aDimension[0]) / 2.0f),
-                                2.0f * (static_cast<FLOAT>(heightIdx) - static_cast<FLOAT>(aDimension[1])) + (static_cast<FLOAT>(aDimension[1]) * 0.75f),
-                                2.0f * (static_cast<FLOAT>(uDepthIdx) - static_cast<FLOAT>(aDimension[2]) / 2.0f)
-                                )
-                        }
-                    );
-                }
-                ++uWidthIdx;
-                if (uWidthIdx >= aDimension[0])
-                {
-                    uWidthIdx -= aDimension[0];
-                    ++uDepthIdx;
+      Modifies: [m_voxelChunks, m_uNumFilledVoxelInstances,
+                 m_uNumVoxelInstances].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Scene::Scene(_In_ const HeightMap& heightMap, _In_ eVoxelExtractionMode extractionMode, _In_opt_ ThreadPool* pThreadPool)
+        : m_filePath()
+        , m_voxels()
+        , m_voxelChunks()
+        , m_renderables()
+        , m_renderableHandles()
+        , m_models()
+        , m_modelHandles()
+        , m_aPointLights()
+        , m_directionalLight()
+        , m_vertexShaders()
+        , m_vertexShaderHandles()
+        , m_pixelShaders()
+        , m_pixelShaderHandles()
+        , m_skyBox()
+        , m_uNumFilledVoxelInstances(0u)
+        , m_uNumVoxelInstances(0u)
+        , m_uStaticVersion(0u)
+        , m_extractionMode(eVoxelExtractionMode::FILLED_COLUMNS)
+        , m_bQuantizedTerrain(FALSE)
+        , m_uTerrainWidth(0u)
+        , m_uTerrainHeight(0u)
+        , m_uTerrainDepth(0u)
+        , m_uNumChunksX(0u)
+        , m_uNumChunksZ(0u)
+        , m_terrainStreamer()
+    {
+        createTerrain(heightMap, extractionMode, pThreadPool);
+    }
 
-                    if (uDepthIdx >= aDimension[2])
-                    {
-                        uDepthIdx -= aDimension[2];
-                    }
-                }
-            }
-        }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::Scene
+
+      Summary:  Constructor. Opens a tiled world file whose chunks are
+                streamed in around the camera by UpdateTerrainStreaming
+                instead of being built up front. Streamed terrain
+                cannot be edited
 
-        inputFile.close();
+      Args:     const std::filesystem::path& worldFilePath
+                  Path to the tiled world file
+                const TerrainStreamingDesc& streamingDesc
+                  Parameters of the streaming
+
+      Modifies: [m_terrainStreamer, m_uTerrainWidth, m_uTerrainHeight,
+                 m_uTerrainDepth, m_aBlockColors].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Scene::Scene(_In_ const std::filesystem::path& worldFilePath, _In_ const TerrainStreamingDesc& streamingDesc)
+        : m_filePath(worldFilePath)
+        , m_voxels()
+        , m_voxelChunks()
+        , m_renderables()
+        , m_renderableHandles()
+        , m_models()
+        , m_modelHandles()
+        , m_aPointLights()
+        , m_directionalLight()
+        , m_vertexShaders()
+        , m_vertexShaderHandles()
+        , m_pixelShaders()
+        , m_pixelShaderHandles()
+        , m_skyBox()
+        , m_uNumFilledVoxelInstances(0u)
+        , m_uNumVoxelInstances(0u)
+        , m_uStaticVersion(0u)
+        , m_extractionMode(streamingDesc.ExtractionMode)
+        , m_bQuantizedTerrain(FALSE)
+        , m_uTerrainWidth(0u)
+        , m_uTerrainHeight(0u)
+        , m_uTerrainDepth(0u)
+        , m_uNumChunksX(0u)
+        , m_uNumChunksZ(0u)
+        , m_terrainStreamer(std::make_unique<TerrainStreamer>(streamingDesc))
+    {
+        if (FAILED(m_terrainStreamer->Open(m_filePath)))
+        {
+            m_terrainStreamer.reset();
+            return;
+        }
 
-        UINT uVoxelIdx = 0u;
-        auto it = m_voxels.begin();
-        while (it != m_voxels.end())
+        const TiledHeightMap& tiledHeightMap = m_terrainStreamer->GetTiledHeightMap();
+        m_uTerrainWidth = tiledHeightMap.GetWidth();
+        m_uTerrainHeight = tiledHeightMap.GetHeight();
+        m_uTerrainDepth = tiledHeightMap.GetDepth();
+        m_aBlockColors.reserve(tiledHeightMap.GetNumColors());
+        for (UINT uColorIdx = 0u; uColorIdx < tiledHeightMap.GetNumColors(); ++uColorIdx)
         {
-            if (aInstanceData[uVoxelIdx].size() <= 0)
-            {
-                it = m_voxels.erase(it);
-            }
-            else
-            {
-                (*it)->SetInstanceData(std::move(aInstanceData[uVoxelIdx]));
-                ++it;
-            }
-            ++uVoxelIdx;
+            m_aBlockColors.push_back(tiledHeightMap.GetColor(uColorIdx));
         }
     }
 
@@ -181,44 +235,53 @@ namespace library
             }
         }
 
-        for (auto it = m_vertexShaders.begin(); it != m_vertexShaders.end(); ++it)
+        for (auto voxelChunk : m_voxelChunks)
         {
-            HRESULT hr = it->second->Initialize(pDevice);
+            HRESULT hr = voxelChunk->Initialize(pDevice, pImmediateContext);
             if (FAILED(hr))
             {
                 return hr;
             }
         }
 
-        for (auto it = m_pixelShaders.begin(); it != m_pixelShaders.end(); ++it)
+        for (const std::shared_ptr<VertexShader>& vertexShader : m_vertexShaders)
         {
-            HRESULT hr = it->second->Initialize(pDevice);
+            HRESULT hr = vertexShader->Initialize(pDevice);
             if (FAILED(hr))
             {
                 return hr;
             }
         }
 
-        for (auto it = m_renderables.begin(); it != m_renderables.end(); ++it)
+        for (const std::shared_ptr<PixelShader>& pixelShader : m_pixelShaders)
         {
-            HRESULT hr = it->second->Initialize(pDevice, pImmediateContext);
+            HRESULT hr = pixelShader->Initialize(pDevice);
             if (FAILED(hr))
             {
                 return hr;
             }
         }
 
-        for (auto it = m_models.begin(); it != m_models.end(); ++it)
+        for (const std::shared_ptr<Renderable>& renderable : m_renderables)
         {
-            HRESULT hr = it->second->Initialize(pDevice, pImmediateContext);
+            HRESULT hr = renderable->Initialize(pDevice, pImmediateContext);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        for (const std::shared_ptr<Model>& model : m_models)
+        {
+            HRESULT hr = model->Initialize(pDevice, pImmediateContext);
             if (FAILED(hr))
             {
                 return hr;
             }
             
-            for (int i = 0; i < it->second->GetNumMaterials(); ++i)
+            for (int i = 0; i < model->GetNumMaterials(); ++i)
             {
-                AddMaterial(it->second->GetMaterial(i));
+                AddMaterial(model->GetMaterial(i));
             }
             
         }
@@ -248,7 +311,7 @@ namespace library
       Args:     const std::shared_ptr<Voxel>& voxel
                   Shared pointer to the voxel object
 
-      Modifies: [m_renderables].
+      Modifies: [m_voxels, m_uStaticVersion].
 
       Returns:  HRESULT
                   Status code.
@@ -256,6 +319,7 @@ namespace library
     HRESULT Scene::AddVoxel(_In_ const std::shared_ptr<Voxel>& voxel)
     {
         m_voxels.push_back(voxel);
+        ++m_uStaticVersion;
 
         return S_OK;
     }
@@ -270,19 +334,23 @@ namespace library
                 const std::shared_ptr<Renderable>& renderable
                   Shared pointer to the renderable object
 
-      Modifies: [m_renderables].
+      Modifies: [m_renderables, m_renderableHandles, m_uStaticVersion].
 
       Returns:  HRESULT
                   Status code.
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::AddRenderable(_In_ PCWSTR pszRenderableName, _In_ const std::shared_ptr<Renderable>& renderable)
     {
-        if (m_renderables.contains(pszRenderableName))
+        if (m_renderableHandles.contains(pszRenderableName))
         {
             return E_FAIL;
         }
 
-        m_renderables[pszRenderableName] = renderable;
+        m_renderableHandles[pszRenderableName] = m_renderables.Insert(renderable);
+        if (renderable->IsStatic())
+        {
+            ++m_uStaticVersion;
+        }
 
         return S_OK;
     }
@@ -297,19 +365,19 @@ namespace library
                 const std::shared_ptr<Model>& model
                   Shared pointer to the model object
 
-      Modifies: [m_models].
+      Modifies: [m_models, m_modelHandles].
 
       Returns:  HRESULT
                   Status code.
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::AddModel(_In_ PCWSTR pszModelName, _In_ const std::shared_ptr<Model>& pModel)
     {
-        if (m_models.contains(pszModelName))
+        if (m_modelHandles.contains(pszModelName))
         {
             return E_FAIL;
         }
 
-        m_models[pszModelName] = pModel;
+        m_modelHandles[pszModelName] = m_models.Insert(pModel);
 
         return S_OK;
     }
@@ -317,7 +385,9 @@ namespace library
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Scene::AddPointLight
 
-      Summary:  Add a point light object
+      Summary:  Add a point light object. Indices up to
+                MAX_NUM_POINT_LIGHTS are accepted, the indices skipped
+                over stay empty
 
       Args:     size_t index
                   Index of the point light
@@ -333,16 +403,37 @@ namespace library
     {
         HRESULT hr = S_OK;
 
-        if (index >= NUM_LIGHTS)
+        if (index >= MAX_NUM_POINT_LIGHTS)
         {
             return E_FAIL;
         }
 
+        if (index >= m_aPointLights.size())
+        {
+            m_aPointLights.resize(index + 1u);
+        }
         m_aPointLights[index] = pPointLight;
 
         return hr;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetDirectionalLight
+
+      Summary:  Sets the directional light, the one light that casts
+                the cascaded shadows
+
+      Args:     const std::shared_ptr<DirectionalLight>& directionalLight
+                  Shared pointer to the directional light, nullptr
+                  removes it
+
+      Modifies: [m_directionalLight].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::SetDirectionalLight(_In_ const std::shared_ptr<DirectionalLight>& directionalLight)
+    {
+        m_directionalLight = directionalLight;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Scene::AddVertexShader
 
@@ -353,19 +444,19 @@ namespace library
                 const std::shared_ptr<VertexShader>&
                   Vertex shader to add
 
-      Modifies: [m_vertexShaders].
+      Modifies: [m_vertexShaders, m_vertexShaderHandles].
 
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::AddVertexShader(_In_ PCWSTR pszVertexShaderName, _In_ const std::shared_ptr<VertexShader>& vertexShader)
     {
-        if (m_vertexShaders.contains(pszVertexShaderName))
+        if (m_vertexShaderHandles.contains(pszVertexShaderName))
         {
             return E_FAIL;
         }
 
-        m_vertexShaders[pszVertexShaderName] = vertexShader;
+        m_vertexShaderHandles[pszVertexShaderName] = m_vertexShaders.Insert(vertexShader);
 
         return S_OK;
     }
@@ -380,19 +471,19 @@ namespace library
                 const std::shared_ptr<PixelShader>&
                   Pixel shader to add
 
-      Modifies: [m_pixelShaders].
+      Modifies: [m_pixelShaders, m_pixelShaderHandles].
 
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::AddPixelShader(_In_ PCWSTR pszPixelShaderName, _In_ const std::shared_ptr<PixelShader>& pixelShader)
     {
-        if (m_pixelShaders.contains(pszPixelShaderName))
+        if (m_pixelShaderHandles.contains(pszPixelShaderName))
         {
             return E_FAIL;
         }
 
-        m_pixelShaders[pszPixelShaderName] = pixelShader;
+        m_pixelShaderHandles[pszPixelShaderName] = m_pixelShaders.Insert(pixelShader);
 
         return S_OK;
     }
@@ -452,163 +543,825 @@ namespace library
     --------------------------------------------------------------------*/
     void Scene::Update(_In_ FLOAT deltaTime)
     {
+        ProfileScope profileScope("Scene::Update");
+
         m_skyBox->Update(deltaTime);
+        for (const std::shared_ptr<PointLight>& pointLight : m_aPointLights)
+        {
+            if (pointLight)
+            {
+                pointLight->Update(deltaTime);
+            }
+        }
+        if (m_directionalLight)
+        {
+            m_directionalLight->Update(deltaTime);
+        }
     }
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Scene::GetVoxels
 
-      Summary:  Returns the vector of voxels
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetTerrainVoxel
+
+      Summary:  Places a cube of a block type on the instanced terrain,
+                replacing the cube already at the position. Only the
+                touched instances are uploaded by the next
+                UpdateTerrainBuffers. Cubes that become visible by
+                digging into a SURFACE terrain have to be set as well
+
+      Args:     UINT x
+                  Column along the x-axis
+                UINT y
+                  Height index of the cube
+                UINT z
+                  Column along the z-axis
+                BYTE uBlockType
+                  Palette index of the cube
+
+      Modifies: [m_voxelChunks, m_aChunkGrid, m_aNewVoxels,
+                 m_aDirtyVoxels, m_uNumVoxelInstances].
 
-      Returns:  std::vector<std::shared_ptr<Voxel>>&
-                  Voxels
+      Returns:  HRESULT
+                  Status code, E_NOTIMPL if the terrain is not made of
+                  quantized instances
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    std::vector<std::shared_ptr<Voxel>>& Scene::GetVoxels()
+    HRESULT Scene::SetTerrainVoxel(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ BYTE uBlockType)
     {
-        return m_voxels;
-    }
-
+        if (m_extractionMode == eVoxelExtractionMode::GREEDY_MESH || !m_bQuantizedTerrain)
+        {
+            return E_NOTIMPL;
+        }
 
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Scene::GetRenderables
+        if (x >= m_uTerrainWidth || z >= m_uTerrainDepth || y > SHRT_MAX || uBlockType >= m_aBlockColors.size())
+        {
+            return E_INVALIDARG;
+        }
 
-      Summary:  Returns the vector of renderables
+        RemoveTerrainVoxel(x, y, z);
 
-      Returns:  std::unordered_map<std::wstring, std::shared_ptr<Renderable>>&
-                  Renderables
-    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    std::unordered_map<std::wstring, std::shared_ptr<Renderable>>& Scene::GetRenderables()
-    {
-        return m_renderables;
-    }
+        std::shared_ptr<VoxelChunk> voxelChunk = getOrCreateChunk(x, y, z);
+        std::shared_ptr<Voxel> voxel = voxelChunk->GetVoxel(uBlockType);
+        if (!voxel)
+        {
+            voxel = std::make_shared<Voxel>(std::vector<VoxelInstanceData>(), m_aBlockColors[uBlockType]);
+            voxel->Translate(
+                XMVectorSet(
+                    2.0f * static_cast<FLOAT>(voxelChunk->GetChunkX() * VoxelChunk::CHUNK_SIZE) - static_cast<FLOAT>(m_uTerrainWidth),
+                    -static_cast<FLOAT>(m_uTerrainHeight) * 1.25f,
+                    2.0f * static_cast<FLOAT>(voxelChunk->GetChunkZ() * VoxelChunk::CHUNK_SIZE) - static_cast<FLOAT>(m_uTerrainDepth),
+                    0.0f
+                )
+            );
+            if (m_voxelQuantizedVertexShader)
+            {
+                voxel->SetVertexShader(m_voxelQuantizedVertexShader);
+            }
+            if (m_voxelPixelShader)
+            {
+                voxel->SetPixelShader(m_voxelPixelShader);
+            }
 
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Scene::GetModels
+            voxelChunk->AddVoxel(uBlockType, voxel);
+            m_aNewVoxels.push_back(voxel);
+        }
 
-      Summary:  Returns the vector of models
+        if (!voxel->HasDirtyInstances())
+        {
+            m_aDirtyVoxels.push_back(voxel);
+        }
+        voxel->AddVoxelInstance(
+            VoxelInstanceData
+            {
+                .GridPosition =
+                {
+                    static_cast<SHORT>(x - voxelChunk->GetChunkX() * VoxelChunk::CHUNK_SIZE),
+                    static_cast<SHORT>(y),
+                    static_cast<SHORT>(z - voxelChunk->GetChunkZ() * VoxelChunk::CHUNK_SIZE),
+                    0,
+                }
+            }
+        );
+        ++m_uNumVoxelInstances;
 
-      Returns:  std::unordered_map<std::wstring, std::shared_ptr<Model>>&
-                  Models
-    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    std::unordered_map<std::wstring, std::shared_ptr<Model>>& Scene::GetModels()
-    {
-        return m_models;
+        return S_OK;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Scene::GetPointLight
+      Method:   Scene::RemoveTerrainVoxel
 
-      Summary:  Returns a point light according to the given index
+      Summary:  Removes the cube at a position of the instanced
+                terrain
 
-      Args:     size_t index
-                  Index of the point light
+      Args:     UINT x
+                  Column along the x-axis
+                UINT y
+                  Height index of the cube
+                UINT z
+                  Column along the z-axis
 
-      Returns:  std::shared_ptr<PointLight>&
-                  Point light
+      Modifies: [m_aDirtyVoxels, m_uNumVoxelInstances].
+
+      Returns:  HRESULT
+                  S_OK if a cube was removed, S_FALSE if there was none
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    std::shared_ptr<PointLight>& Scene::GetPointLight(_In_ size_t index)
+    HRESULT Scene::RemoveTerrainVoxel(_In_ UINT x, _In_ UINT y, _In_ UINT z)
     {
-        assert(index < NUM_LIGHTS);
-
-        return m_aPointLights[index];
-    }
+        if (m_extractionMode == eVoxelExtractionMode::GREEDY_MESH || !m_bQuantizedTerrain)
+        {
+            return E_NOTIMPL;
+        }
 
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Scene::GetVertexShaders
+        if (x >= m_uTerrainWidth || z >= m_uTerrainDepth || y > SHRT_MAX)
+        {
+            return E_INVALIDARG;
+        }
 
-      Summary:  Returns a hash map of vertex shaders
+        const UINT uChunkX = x / VoxelChunk::CHUNK_SIZE;
+        const UINT uChunkZ = z / VoxelChunk::CHUNK_SIZE;
+        const std::shared_ptr<VoxelChunk>& voxelChunk = m_aChunkGrid[static_cast<size_t>(uChunkZ) * m_uNumChunksX + uChunkX];
+        if (!voxelChunk)
+        {
+            return S_FALSE;
+        }
 
-      Returns:  std::unordered_map<std::wstring, std::shared_ptr<VertexShader>>&
-                  Vertex shaders
-    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    std::unordered_map<std::wstring, std::shared_ptr<VertexShader>>& Scene::GetVertexShaders()
-    {
-        return m_vertexShaders;
-    }
+        for (std::shared_ptr<Voxel>& voxel : voxelChunk->GetVoxels())
+        {
+            const BOOL bWasDirty = voxel->HasDirtyInstances();
+            if (voxel->RemoveVoxelInstance(
+                static_cast<SHORT>(x - uChunkX * VoxelChunk::CHUNK_SIZE),
+                static_cast<SHORT>(y),
+                static_cast<SHORT>(z - uChunkZ * VoxelChunk::CHUNK_SIZE)))
+            {
+                if (!bWasDirty && voxel->HasDirtyInstances())
+                {
+                    m_aDirtyVoxels.push_back(voxel);
+                }
+                --m_uNumVoxelInstances;
 
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Scene::GetPixelShaders
+                // The hole may open the solid part of the chunk
+                voxelChunk->ClearOccluderBounds();
 
-      Summary:  Returns a hash map of pixel shaders
+                return S_OK;
+            }
+        }
 
-      Returns:  std::unordered_map<std::wstring, std::shared_ptr<PixelShader>>&
-                  Pixel shaders
-    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    std::unordered_map<std::wstring, std::shared_ptr<PixelShader>>& Scene::GetPixelShaders()
-    {
-        return m_pixelShaders;
+        return S_FALSE;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Scene::GetSkyBox
-
-      Summary:  Returns a sky box
+      Method:   Scene::SetTerrainColumn
 
-      Returns:  std::shared_ptr<Skybox>&
-                  Sky box
-    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    /*--------------------------------------------------------------------
-      TODO: Scene::GetSkyBox definition (remove the comment)
-    --------------------------------------------------------------------*/
-    std::shared_ptr<Skybox>& Scene::GetSkyBox()
-    {
-        return m_skyBox;
-    }
+      Summary:  Changes a column of the greedy-meshed terrain. The
+                meshes of the chunks the column borders on are rebuilt
+                by the next RebuildVoxelMeshes
 
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Scene::GetFilePath
+      Args:     UINT x
+                  Column along the x-axis
+                UINT z
+                  Column along the z-axis
+                WORD uHeight
+                  Number of cubes of the column, 0 to clear it
+                BYTE uBlockType
+                  Palette index of the column
 
-      Summary:  Returns the file path to the height map
+      Modifies: [m_aBlockTypes, m_aColumnHeights,
+                 m_dirtyVoxelMeshChunks].
 
-      Returns:  const std::filesystem::path&
-                  File path to the height map
+      Returns:  HRESULT
+                  Status code, E_NOTIMPL if the terrain is not greedy
+                  meshed
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    const std::filesystem::path& Scene::GetFilePath() const
+    HRESULT Scene::SetTerrainColumn(_In_ UINT x, _In_ UINT z, _In_ WORD uHeight, _In_ BYTE uBlockType)
     {
-        return m_filePath;
-    }
+        if (m_extractionMode != eVoxelExtractionMode::GREEDY_MESH || m_terrainStreamer)
+        {
+            return E_NOTIMPL;
+        }
 
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Scene::GetFileName
+        if (x >= m_uTerrainWidth || z >= m_uTerrainDepth || uBlockType >= m_aBlockColors.size())
+        {
+            return E_INVALIDARG;
+        }
 
-      Summary:  Returns the file name of the height map
+        const size_t uColumnIdx = static_cast<size_t>(z) * m_uTerrainWidth + x;
+        m_aBlockTypes[uColumnIdx] = uBlockType;
+        m_aColumnHeights[uColumnIdx] = uHeight;
 
-      Returns:  PCWSTR
-                  File name of the height map
-    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    PCWSTR Scene::GetFileName() const
-    {
-        return m_filePath.c_str();
+        // Side faces of the neighboring columns may appear or vanish
+        const UINT uChunkX = x / VoxelChunk::CHUNK_SIZE;
+        const UINT uChunkZ = z / VoxelChunk::CHUNK_SIZE;
+        const std::shared_ptr<VoxelChunk>& voxelChunk = m_aChunkGrid[static_cast<size_t>(uChunkZ) * m_uNumChunksX + uChunkX];
+        if (voxelChunk)
+        {
+            // Restored by the rebuild of the mesh
+            voxelChunk->ClearOccluderBounds();
+        }
+        markVoxelMeshDirty(uChunkX, uChunkZ);
+        if (x % VoxelChunk::CHUNK_SIZE == 0u && uChunkX > 0u)
+        {
+            markVoxelMeshDirty(uChunkX - 1u, uChunkZ);
+        }
+        if (x % VoxelChunk::CHUNK_SIZE == VoxelChunk::CHUNK_SIZE - 1u)
+        {
+            markVoxelMeshDirty(uChunkX + 1u, uChunkZ);
+        }
+        if (z % VoxelChunk::CHUNK_SIZE == 0u && uChunkZ > 0u)
+        {
+            markVoxelMeshDirty(uChunkX, uChunkZ - 1u);
+        }
+        if (z % VoxelChunk::CHUNK_SIZE == VoxelChunk::CHUNK_SIZE - 1u)
+        {
+            markVoxelMeshDirty(uChunkX, uChunkZ + 1u);
+        }
+
+        return S_OK;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Scene::SetVertexShaderOfRenderable
-
-      Summary:  Sets the vertex shader for a renderable
+      Method:   Scene::RebuildVoxelMeshes
 
-      Args:     PCWSTR pszRenderableName
-                  Key of the renderable
-                PCWSTR pszVertexShaderName
-                  Key of the vertex shader
+      Summary:  Remeshes the chunks changed by SetTerrainColumn. The
+                columns are copied once for all the chunks, so further
+                edits do not race with the mesher. With a thread pool
+                the meshes are built in the background and swapped in
+                by the first UpdateTerrainBuffers after they are done,
+                the old meshes are drawn until then
 
-      Modifies: [m_renderables].
+      Args:     ThreadPool* pThreadPool
+                  Pool to mesh on, nullptr to mesh on the calling
+                  thread
 
-      Returns:  HRESULT
-                  Status code
+      Modifies: [m_dirtyVoxelMeshChunks, m_voxelMeshRebuilds].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Scene::SetVertexShaderOfRenderable(_In_ PCWSTR pszRenderableName, _In_ PCWSTR pszVertexShaderName)
+    void Scene::RebuildVoxelMeshes(_In_opt_ ThreadPool* pThreadPool)
     {
-        if (!m_renderables.contains(pszRenderableName) || !m_vertexShaders.contains(pszVertexShaderName))
+        if (m_dirtyVoxelMeshChunks.empty())
         {
-            return E_FAIL;
+            return;
         }
 
-        m_renderables[pszRenderableName]->SetVertexShader(m_vertexShaders[pszVertexShaderName]);
-
-        return S_OK;
-    }
+        std::shared_ptr<HeightMap> snapshot = std::make_shared<HeightMap>();
+        if (FAILED(snapshot->Create(
+            m_uTerrainWidth,
+            m_uTerrainHeight,
+            m_uTerrainDepth,
+            std::vector<XMFLOAT4>(m_aBlockColors),
+            std::vector<BYTE>(m_aBlockTypes),
+            std::vector<WORD>(m_aColumnHeights))))
+        {
+            return;
+        }
 
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Scene::SetPixelShaderOfRenderable
+        for (size_t uChunkIdx : m_dirtyVoxelMeshChunks)
+        {
+            const UINT uOriginX = static_cast<UINT>(uChunkIdx % m_uNumChunksX) * VoxelChunk::CHUNK_SIZE;
+            const UINT uOriginZ = static_cast<UINT>(uChunkIdx / m_uNumChunksX) * VoxelChunk::CHUNK_SIZE;
+            const UINT uSizeX = (std::min)(VoxelChunk::CHUNK_SIZE, m_uTerrainWidth - uOriginX);
+            const UINT uSizeZ = (std::min)(VoxelChunk::CHUNK_SIZE, m_uTerrainDepth - uOriginZ);
+
+            // A newer rebuild of the same chunk replaces the pending one
+            std::shared_ptr<VoxelMeshRebuild> rebuild = std::make_shared<VoxelMeshRebuild>();
+            auto meshChunk = [snapshot, rebuild, uOriginX, uOriginZ, uSizeX, uSizeZ]()
+            {
+                const VoxelGridView grid =
+                {
+                    .Width = snapshot->GetWidth(),
+                    .Depth = snapshot->GetDepth(),
+                    .NumBlockTypes = snapshot->GetNumColors(),
+                    .BlockTypes = snapshot->GetBlockTypes(),
+                    .ColumnHeights = snapshot->GetColumnHeights(),
+                };
+
+                GreedyMeshData meshData;
+                if (!GreedyMesher::MeshChunk(grid, uOriginX, uOriginZ, uSizeX, uSizeZ, meshData) || meshData.Indices.empty())
+                {
+                    return;
+                }
+
+                UINT uMinHeight = UINT_MAX;
+                UINT uMaxHeight = 0u;
+                for (UINT uDepthIdx = uOriginZ; uDepthIdx < uOriginZ + uSizeZ; ++uDepthIdx)
+                {
+                    for (UINT uWidthIdx = uOriginX; uWidthIdx < uOriginX + uSizeX; ++uWidthIdx)
+                    {
+                        uMinHeight = (std::min)(uMinHeight, grid.GetColumnHeight(uWidthIdx, uDepthIdx));
+                        uMaxHeight = (std::max)(uMaxHeight, grid.GetColumnHeight(uWidthIdx, uDepthIdx));
+                    }
+                }
+
+                rebuild->Mesh = std::make_shared<VoxelMesh>(meshData, *snapshot);
+                rebuild->Bounds = getChunkBounds(*snapshot, uOriginX, uOriginZ, uSizeX, uSizeZ, 0u, uMaxHeight);
+                rebuild->OccluderBounds = getChunkBounds(*snapshot, uOriginX, uOriginZ, uSizeX, uSizeZ, 0u, uMinHeight);
+                rebuild->MinColumnHeight = uMinHeight;
+            };
+
+            if (pThreadPool)
+            {
+                rebuild->Done = pThreadPool->Submit(meshChunk);
+            }
+            else
+            {
+                std::promise<void> done;
+                meshChunk();
+                done.set_value();
+                rebuild->Done = done.get_future();
+            }
+            m_voxelMeshRebuilds[uChunkIdx] = rebuild;
+        }
+        m_dirtyVoxelMeshChunks.clear();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::UpdateTerrainBuffers
+
+      Summary:  Applies the terrain edits to the GPU once per frame.
+                New voxels get their buffers, the other edited voxels
+                upload only their dirty instance ranges, and finished
+                mesh rebuilds replace the meshes of their chunks. Any
+                change to the terrain advances the static version
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to upload with
+
+      Modifies: [m_voxelChunks, m_aChunkGrid, m_aNewVoxels,
+                 m_aDirtyVoxels, m_voxelMeshRebuilds, m_uStaticVersion].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::UpdateTerrainBuffers(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        HRESULT hr = S_OK;
+
+        if (!m_aNewVoxels.empty() || !m_aDirtyVoxels.empty())
+        {
+            ++m_uStaticVersion;
+        }
+
+        for (std::shared_ptr<Voxel>& voxel : m_aNewVoxels)
+        {
+            // Voxels added before Initialize already have their buffers
+            if (voxel->GetVertexBuffer())
+            {
+                continue;
+            }
+
+            hr = voxel->Initialize(pDevice, pImmediateContext);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+        m_aNewVoxels.clear();
+
+        for (std::shared_ptr<Voxel>& voxel : m_aDirtyVoxels)
+        {
+            hr = voxel->UpdateInstanceBuffer(pImmediateContext);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+        m_aDirtyVoxels.clear();
+
+        for (auto it = m_voxelMeshRebuilds.begin(); it != m_voxelMeshRebuilds.end();)
+        {
+            VoxelMeshRebuild& rebuild = *it->second;
+            if (rebuild.Done.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                ++it;
+                continue;
+            }
+
+            const size_t uChunkIdx = it->first;
+            std::shared_ptr<VoxelChunk>& voxelChunk = m_aChunkGrid[uChunkIdx];
+            if (rebuild.Mesh)
+            {
+                hr = rebuild.Mesh->Initialize(pDevice, pImmediateContext);
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+                if (m_voxelMeshVertexShader)
+                {
+                    rebuild.Mesh->SetVertexShader(m_voxelMeshVertexShader);
+                }
+                if (m_voxelMeshPixelShader)
+                {
+                    rebuild.Mesh->SetPixelShader(m_voxelMeshPixelShader);
+                }
+
+                if (!voxelChunk)
+                {
+                    voxelChunk = std::make_shared<VoxelChunk>(
+                        static_cast<UINT>(uChunkIdx % m_uNumChunksX),
+                        static_cast<UINT>(uChunkIdx / m_uNumChunksX),
+                        rebuild.Bounds
+                    );
+                    m_voxelChunks.push_back(voxelChunk);
+                }
+                voxelChunk->SetBounds(rebuild.Bounds);
+                voxelChunk->SetVoxelMesh(rebuild.Mesh);
+                if (rebuild.MinColumnHeight > 0u)
+                {
+                    voxelChunk->SetOccluderBounds(rebuild.OccluderBounds);
+                }
+                else
+                {
+                    voxelChunk->ClearOccluderBounds();
+                }
+            }
+            else if (voxelChunk)
+            {
+                voxelChunk->SetVoxelMesh(nullptr);
+            }
+
+            it = m_voxelMeshRebuilds.erase(it);
+            ++m_uStaticVersion;
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::UpdateTerrainStreaming
+
+      Summary:  Streams the terrain around the camera, once per frame.
+                When the resident chunks change they replace the voxel
+                chunks of the scene and advance the static version.
+                Does nothing unless the scene was created from a tiled
+                world file
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set buffers
+                const XMVECTOR& eye
+                  Position of the camera
+                const XMVECTOR& forward
+                  Forward vector of the camera
+
+      Modifies: [m_voxelChunks, m_uNumVoxelInstances, m_uStaticVersion].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::UpdateTerrainStreaming(
+        _In_ ID3D11Device* pDevice,
+        _In_ ID3D11DeviceContext* pImmediateContext,
+        _In_ const XMVECTOR& eye,
+        _In_ const XMVECTOR& forward
+    )
+    {
+        if (!m_terrainStreamer)
+        {
+            return S_FALSE;
+        }
+
+        HRESULT hr = m_terrainStreamer->Update(pDevice, pImmediateContext, eye, forward);
+        if (hr != S_OK)
+        {
+            return hr;
+        }
+
+        m_voxelChunks = m_terrainStreamer->GetResidentChunks();
+        m_uNumVoxelInstances = 0u;
+        ++m_uStaticVersion;
+        for (std::shared_ptr<VoxelChunk>& voxelChunk : m_voxelChunks)
+        {
+            for (std::shared_ptr<Voxel>& voxel : voxelChunk->GetVoxels())
+            {
+                const std::shared_ptr<VertexShader>& vertexShader = voxel->IsQuantized() ? m_voxelQuantizedVertexShader : m_voxelVertexShader;
+                if (vertexShader)
+                {
+                    voxel->SetVertexShader(vertexShader);
+                }
+                if (m_voxelPixelShader)
+                {
+                    voxel->SetPixelShader(m_voxelPixelShader);
+                }
+            }
+            m_uNumVoxelInstances += voxelChunk->GetNumInstances();
+        }
+
+        return S_OK;
+    }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetVoxels
+
+      Summary:  Returns the vector of voxels
+
+      Returns:  std::vector<std::shared_ptr<Voxel>>&
+                  Voxels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<std::shared_ptr<Voxel>>& Scene::GetVoxels()
+    {
+        return m_voxels;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetVoxelChunks
+
+      Summary:  Returns the vector of terrain chunks
+
+      Returns:  std::vector<std::shared_ptr<VoxelChunk>>&
+                  Voxel chunks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<std::shared_ptr<VoxelChunk>>& Scene::GetVoxelChunks()
+    {
+        return m_voxelChunks;
+    }
+
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetRenderables
+
+      Summary:  Returns the slot map of renderables. Iterating over it
+                walks a dense array
+
+      Returns:  SlotMap<std::shared_ptr<Renderable>>&
+                  Renderables
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SlotMap<std::shared_ptr<Renderable>>& Scene::GetRenderables()
+    {
+        return m_renderables;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetModels
+
+      Summary:  Returns the slot map of models
+
+      Returns:  SlotMap<std::shared_ptr<Model>>&
+                  Models
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SlotMap<std::shared_ptr<Model>>& Scene::GetModels()
+    {
+        return m_models;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetPointLight
+
+      Summary:  Returns a point light according to the given index
+
+      Args:     size_t index
+                  Index of the point light
+
+      Returns:  std::shared_ptr<PointLight>&
+                  Point light
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::shared_ptr<PointLight>& Scene::GetPointLight(_In_ size_t index)
+    {
+        assert(index < m_aPointLights.size());
+
+        return m_aPointLights[index];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetPointLights
+
+      Summary:  Returns all point lights, indexed as they were added.
+                Entries that were skipped over are empty
+
+      Returns:  const std::vector<std::shared_ptr<PointLight>>&
+                  Point lights
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<std::shared_ptr<PointLight>>& Scene::GetPointLights() const
+    {
+        return m_aPointLights;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetDirectionalLight
+
+      Summary:  Returns the directional light
+
+      Returns:  std::shared_ptr<DirectionalLight>&
+                  Directional light, nullptr when the scene has none
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::shared_ptr<DirectionalLight>& Scene::GetDirectionalLight()
+    {
+        return m_directionalLight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetVertexShaders
+
+      Summary:  Returns the slot map of vertex shaders
+
+      Returns:  SlotMap<std::shared_ptr<VertexShader>>&
+                  Vertex shaders
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SlotMap<std::shared_ptr<VertexShader>>& Scene::GetVertexShaders()
+    {
+        return m_vertexShaders;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetPixelShaders
+
+      Summary:  Returns the slot map of pixel shaders
+
+      Returns:  SlotMap<std::shared_ptr<PixelShader>>&
+                  Pixel shaders
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SlotMap<std::shared_ptr<PixelShader>>& Scene::GetPixelShaders()
+    {
+        return m_pixelShaders;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetSkyBox
+
+      Summary:  Returns a sky box
+
+      Returns:  std::shared_ptr<Skybox>&
+                  Sky box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    /*--------------------------------------------------------------------
+      TODO: Scene::GetSkyBox definition (remove the comment)
+    --------------------------------------------------------------------*/
+    std::shared_ptr<Skybox>& Scene::GetSkyBox()
+    {
+        return m_skyBox;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::FindRenderable
+
+      Summary:  Returns the handle of a renderable by its name. Meant for setup, the
+                handle is what should be kept around
+
+      Args:     PCWSTR pszRenderableName
+                  Key of the renderable
+
+      Returns:  SlotHandle
+                  Handle of the renderable, invalid if there is none
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SlotHandle Scene::FindRenderable(_In_ PCWSTR pszRenderableName) const
+    {
+        auto it = m_renderableHandles.find(pszRenderableName);
+
+        return it != m_renderableHandles.end() ? it->second : SlotHandle();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::FindModel
+
+      Summary:  Returns the handle of a model by its name
+
+      Args:     PCWSTR pszModelName
+                  Key of the model
+
+      Returns:  SlotHandle
+                  Handle of the model, invalid if there is none
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SlotHandle Scene::FindModel(_In_ PCWSTR pszModelName) const
+    {
+        auto it = m_modelHandles.find(pszModelName);
+
+        return it != m_modelHandles.end() ? it->second : SlotHandle();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::FindVertexShader
+
+      Summary:  Returns the handle of a vertex shader by its name
+
+      Args:     PCWSTR pszVertexShaderName
+                  Key of the vertex shader
+
+      Returns:  SlotHandle
+                  Handle of the vertex shader, invalid if there is none
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SlotHandle Scene::FindVertexShader(_In_ PCWSTR pszVertexShaderName) const
+    {
+        auto it = m_vertexShaderHandles.find(pszVertexShaderName);
+
+        return it != m_vertexShaderHandles.end() ? it->second : SlotHandle();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::FindPixelShader
+
+      Summary:  Returns the handle of a pixel shader by its name
+
+      Args:     PCWSTR pszPixelShaderName
+                  Key of the pixel shader
+
+      Returns:  SlotHandle
+                  Handle of the pixel shader, invalid if there is none
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SlotHandle Scene::FindPixelShader(_In_ PCWSTR pszPixelShaderName) const
+    {
+        auto it = m_pixelShaderHandles.find(pszPixelShaderName);
+
+        return it != m_pixelShaderHandles.end() ? it->second : SlotHandle();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetNumFilledVoxelInstances
+
+      Summary:  Returns the number of voxel instances the height map
+                would need with its columns filled completely
+
+      Returns:  size_t
+                  Number of voxel instances of the filled columns
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t Scene::GetNumFilledVoxelInstances() const
+    {
+        return m_uNumFilledVoxelInstances;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetNumVoxelInstances
+
+      Summary:  Returns the number of voxel instances actually extracted
+                from the height map
+
+      Returns:  size_t
+                  Number of extracted voxel instances
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t Scene::GetNumVoxelInstances() const
+    {
+        return m_uNumVoxelInstances;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetStaticVersion
+
+      Summary:  Returns a number that changes whenever the geometry
+                that never moves changes: voxels, terrain chunks and
+                static renderables. Whatever is derived from the static
+                geometry only has to be rebuilt when it differs
+
+      Returns:  UINT64
+                  Version of the static geometry
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 Scene::GetStaticVersion() const
+    {
+        return m_uStaticVersion;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetFilePath
+
+      Summary:  Returns the file path to the height map
+
+      Returns:  const std::filesystem::path&
+                  File path to the height map
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::filesystem::path& Scene::GetFilePath() const
+    {
+        return m_filePath;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetFileName
+
+      Summary:  Returns the file name of the height map
+
+      Returns:  PCWSTR
+                  File name of the height map
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PCWSTR Scene::GetFileName() const
+    {
+        return m_filePath.c_str();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetVertexShaderOfRenderable
+
+      Summary:  Sets the vertex shader for a renderable
+
+      Args:     PCWSTR pszRenderableName
+                  Key of the renderable
+                PCWSTR pszVertexShaderName
+                  Key of the vertex shader
+
+      Modifies: [m_renderables].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetVertexShaderOfRenderable(_In_ PCWSTR pszRenderableName, _In_ PCWSTR pszVertexShaderName)
+    {
+        std::shared_ptr<Renderable>* pRenderable = m_renderables.Get(FindRenderable(pszRenderableName));
+        std::shared_ptr<VertexShader>* pVertexShader = m_vertexShaders.Get(FindVertexShader(pszVertexShaderName));
+        if (!pRenderable || !pVertexShader)
+        {
+            return E_FAIL;
+        }
+
+        (*pRenderable)->SetVertexShader(*pVertexShader);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetPixelShaderOfRenderable
 
       Summary:  Sets the pixel shader for a renderable
 
@@ -624,12 +1377,14 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::SetPixelShaderOfRenderable(_In_ PCWSTR pszRenderableName, _In_ PCWSTR pszPixelShaderName)
     {
-        if (!m_renderables.contains(pszRenderableName) || !m_pixelShaders.contains(pszPixelShaderName))
+        std::shared_ptr<Renderable>* pRenderable = m_renderables.Get(FindRenderable(pszRenderableName));
+        std::shared_ptr<PixelShader>* pPixelShader = m_pixelShaders.Get(FindPixelShader(pszPixelShaderName));
+        if (!pRenderable || !pPixelShader)
         {
             return E_FAIL;
         }
 
-        m_renderables[pszRenderableName]->SetPixelShader(m_pixelShaders[pszPixelShaderName]);
+        (*pRenderable)->SetPixelShader(*pPixelShader);
 
         return S_OK;
     }
@@ -651,12 +1406,14 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::SetVertexShaderOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszVertexShaderName)
     {
-        if (!m_models.contains(pszModelName) || !m_vertexShaders.contains(pszVertexShaderName))
+        std::shared_ptr<Model>* pModel = m_models.Get(FindModel(pszModelName));
+        std::shared_ptr<VertexShader>* pVertexShader = m_vertexShaders.Get(FindVertexShader(pszVertexShaderName));
+        if (!pModel || !pVertexShader)
         {
             return E_FAIL;
         }
 
-        m_models[pszModelName]->SetVertexShader(m_vertexShaders[pszVertexShaderName]);
+        (*pModel)->SetVertexShader(*pVertexShader);
 
         return S_OK;
     }
@@ -678,12 +1435,14 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::SetPixelShaderOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszPixelShaderName)
     {
-        if (!m_models.contains(pszModelName) || !m_pixelShaders.contains(pszPixelShaderName))
+        std::shared_ptr<Model>* pModel = m_models.Get(FindModel(pszModelName));
+        std::shared_ptr<PixelShader>* pPixelShader = m_pixelShaders.Get(FindPixelShader(pszPixelShaderName));
+        if (!pModel || !pPixelShader)
         {
             return E_FAIL;
         }
 
-        m_models[pszModelName]->SetPixelShader(m_pixelShaders[pszPixelShaderName]);
+        (*pModel)->SetPixelShader(*pPixelShader);
 
         return S_OK;
     }
@@ -705,14 +1464,79 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::SetVertexShaderOfVoxel(_In_ PCWSTR pszVertexShaderName)
     {
-        if (!m_vertexShaders.contains(pszVertexShaderName))
+        std::shared_ptr<VertexShader>* pVertexShader = m_vertexShaders.Get(FindVertexShader(pszVertexShaderName));
+        if (!pVertexShader)
+        {
+            return E_FAIL;
+        }
+
+        m_voxelVertexShader = *pVertexShader;
+
+        for (std::shared_ptr<Voxel>& voxel : m_voxels)
+        {
+            if (!voxel->IsQuantized())
+            {
+                voxel->SetVertexShader(*pVertexShader);
+            }
+        }
+
+        for (std::shared_ptr<VoxelChunk>& voxelChunk : m_voxelChunks)
+        {
+            for (std::shared_ptr<Voxel>& voxel : voxelChunk->GetVoxels())
+            {
+                if (!voxel->IsQuantized())
+                {
+                    voxel->SetVertexShader(*pVertexShader);
+                }
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetVertexShaderOfQuantizedVoxel
+
+      Summary:  Sets the vertex shader for the voxels whose instance
+                data are 16-bit grid positions. The other voxels keep
+                the shader of SetVertexShaderOfVoxel, which reads full
+                transformation matrices
+
+      Args:     PCWSTR pszVertexShaderName
+                  Key of the vertex shader
+
+      Modifies: [m_voxelQuantizedVertexShader, m_voxels, m_voxelChunks].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetVertexShaderOfQuantizedVoxel(_In_ PCWSTR pszVertexShaderName)
+    {
+        std::shared_ptr<VertexShader>* pVertexShader = m_vertexShaders.Get(FindVertexShader(pszVertexShaderName));
+        if (!pVertexShader)
         {
             return E_FAIL;
         }
 
+        m_voxelQuantizedVertexShader = *pVertexShader;
+
         for (std::shared_ptr<Voxel>& voxel : m_voxels)
         {
-            voxel->SetVertexShader(m_vertexShaders[pszVertexShaderName]);
+            if (voxel->IsQuantized())
+            {
+                voxel->SetVertexShader(*pVertexShader);
+            }
+        }
+
+        for (std::shared_ptr<VoxelChunk>& voxelChunk : m_voxelChunks)
+        {
+            for (std::shared_ptr<Voxel>& voxel : voxelChunk->GetVoxels())
+            {
+                if (voxel->IsQuantized())
+                {
+                    voxel->SetVertexShader(*pVertexShader);
+                }
+            }
         }
 
         return S_OK;
@@ -735,51 +1559,601 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::SetPixelShaderOfVoxel(_In_ PCWSTR pszPixelShaderName)
     {
-        if (!m_pixelShaders.contains(pszPixelShaderName))
+        std::shared_ptr<PixelShader>* pPixelShader = m_pixelShaders.Get(FindPixelShader(pszPixelShaderName));
+        if (!pPixelShader)
         {
             return E_FAIL;
         }
 
+        m_voxelPixelShader = *pPixelShader;
+
         for (std::shared_ptr<Voxel>& voxel : m_voxels)
         {
-            voxel->SetPixelShader(m_pixelShaders[pszPixelShaderName]);
+            voxel->SetPixelShader(*pPixelShader);
+        }
+
+        for (std::shared_ptr<VoxelChunk>& voxelChunk : m_voxelChunks)
+        {
+            for (std::shared_ptr<Voxel>& voxel : voxelChunk->GetVoxels())
+            {
+                voxel->SetPixelShader(*pPixelShader);
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetVertexShaderOfVoxelMesh
+
+      Summary:  Sets the vertex shader for the voxel meshes in a scene
+
+      Args:     PCWSTR pszVertexShaderName
+                  Key of the vertex shader
+
+      Modifies: [m_voxelChunks].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetVertexShaderOfVoxelMesh(_In_ PCWSTR pszVertexShaderName)
+    {
+        std::shared_ptr<VertexShader>* pVertexShader = m_vertexShaders.Get(FindVertexShader(pszVertexShaderName));
+        if (!pVertexShader)
+        {
+            return E_FAIL;
+        }
+
+        m_voxelMeshVertexShader = *pVertexShader;
+
+        for (std::shared_ptr<VoxelChunk>& voxelChunk : m_voxelChunks)
+        {
+            if (voxelChunk->GetVoxelMesh())
+            {
+                voxelChunk->GetVoxelMesh()->SetVertexShader(*pVertexShader);
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetPixelShaderOfVoxelMesh
+
+      Summary:  Sets the pixel shader for the voxel meshes in a scene
+
+      Args:     PCWSTR pszPixelShaderName
+                  Key of the pixel shader
+
+      Modifies: [m_voxelChunks].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetPixelShaderOfVoxelMesh(_In_ PCWSTR pszPixelShaderName)
+    {
+        std::shared_ptr<PixelShader>* pPixelShader = m_pixelShaders.Get(FindPixelShader(pszPixelShaderName));
+        if (!pPixelShader)
+        {
+            return E_FAIL;
+        }
+
+        m_voxelMeshPixelShader = *pPixelShader;
+
+        for (std::shared_ptr<VoxelChunk>& voxelChunk : m_voxelChunks)
+        {
+            if (voxelChunk->GetVoxelMesh())
+            {
+                voxelChunk->GetVoxelMesh()->SetPixelShader(*pPixelShader);
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetInstancedVertexShader
+
+      Summary:  Sets the instanced variant of a vertex shader, so the
+                renderables using it can be drawn as instances
+
+      Args:     PCWSTR pszVertexShaderName
+                  Key of the vertex shader
+                PCWSTR pszInstancedVertexShaderName
+                  Key of its instanced variant
+
+      Modifies: [m_vertexShaders].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetInstancedVertexShader(_In_ PCWSTR pszVertexShaderName, _In_ PCWSTR pszInstancedVertexShaderName)
+    {
+        std::shared_ptr<VertexShader>* pVertexShader = m_vertexShaders.Get(FindVertexShader(pszVertexShaderName));
+        std::shared_ptr<VertexShader>* pInstancedVertexShader = m_vertexShaders.Get(FindVertexShader(pszInstancedVertexShaderName));
+        if (!pVertexShader || !pInstancedVertexShader)
+        {
+            return E_FAIL;
         }
 
+        (*pVertexShader)->SetInstancedVertexShader(*pInstancedVertexShader);
+
         return S_OK;
     }
 
-    FLOAT Scene::getNoise2(UINT x, UINT y)
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::createTerrain
+
+      Summary:  Creates the terrain chunks of the height map with the
+                given extraction mode
+
+      Args:     const HeightMap& heightMap
+                  Loaded height map
+                eVoxelExtractionMode extractionMode
+                  How the voxels are extracted from the height map
+                ThreadPool* pThreadPool
+                  Pool to build the terrain on, nullptr to build it on
+                  the calling thread only
+
+      Modifies: [m_voxelChunks, m_aChunkGrid, m_uNumFilledVoxelInstances,
+                 m_uNumVoxelInstances, m_extractionMode, m_aBlockColors,
+                 m_aBlockTypes, m_aColumnHeights, terrain dimensions].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::createTerrain(_In_ const HeightMap& heightMap, _In_ eVoxelExtractionMode extractionMode, _In_opt_ ThreadPool* pThreadPool)
+    {
+        m_extractionMode = extractionMode;
+        m_uTerrainWidth = heightMap.GetWidth();
+        m_uTerrainHeight = heightMap.GetHeight();
+        m_uTerrainDepth = heightMap.GetDepth();
+        m_uNumChunksX = (m_uTerrainWidth + VoxelChunk::CHUNK_SIZE - 1u) / VoxelChunk::CHUNK_SIZE;
+        m_uNumChunksZ = (m_uTerrainDepth + VoxelChunk::CHUNK_SIZE - 1u) / VoxelChunk::CHUNK_SIZE;
+        m_aBlockColors.resize(heightMap.GetNumColors());
+        for (UINT uColorIdx = 0u; uColorIdx < heightMap.GetNumColors(); ++uColorIdx)
+        {
+            m_aBlockColors[uColorIdx] = heightMap.GetColor(uColorIdx);
+        }
+
+        if (extractionMode == eVoxelExtractionMode::GREEDY_MESH)
+        {
+            // Meshes are rebuilt from the columns, so they have to
+            // outlive the height map
+            const size_t uNumColumns = static_cast<size_t>(m_uTerrainWidth) * static_cast<size_t>(m_uTerrainDepth);
+            m_aBlockTypes.assign(heightMap.GetBlockTypes(), heightMap.GetBlockTypes() + uNumColumns);
+            m_aColumnHeights.assign(heightMap.GetColumnHeights(), heightMap.GetColumnHeights() + uNumColumns);
+
+            createVoxelMeshes(heightMap);
+        }
+        else
+        {
+            createVoxels(heightMap, extractionMode, pThreadPool);
+        }
+
+        m_aChunkGrid.assign(static_cast<size_t>(m_uNumChunksX) * static_cast<size_t>(m_uNumChunksZ), nullptr);
+        for (const std::shared_ptr<VoxelChunk>& voxelChunk : m_voxelChunks)
+        {
+            m_aChunkGrid[static_cast<size_t>(voxelChunk->GetChunkZ()) * m_uNumChunksX + voxelChunk->GetChunkX()] = voxelChunk;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::createVoxels
+
+      Summary:  Splits the height map into chunks and creates a voxel
+                per palette color in every chunk, filled with the
+                cubes of its columns. In the SURFACE mode only the
+                cubes with at least one exposed face are emitted: the
+                top cube of a column and the cubes above the lowest of
+                its four neighboring columns. The instances are 16-bit
+                grid positions relative to the chunk unless the columns
+                are too tall for them. Chunks are built in parallel
+                when a thread pool is given
+
+      Args:     const HeightMap& heightMap
+                  Loaded height map
+                eVoxelExtractionMode extractionMode
+                  Whether to fill the whole columns or to emit the
+                  surface cubes only
+                ThreadPool* pThreadPool
+                  Pool to generate the instances on, nullptr to
+                  generate them on the calling thread only
+
+      Modifies: [m_voxelChunks, m_uNumFilledVoxelInstances,
+                 m_uNumVoxelInstances].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::createVoxels(_In_ const HeightMap& heightMap, _In_ eVoxelExtractionMode extractionMode, _In_opt_ ThreadPool* pThreadPool)
     {
-        UINT temp = ms_aHashes[y % 256u];
+        const UINT uWidth = heightMap.GetWidth();
+        const UINT uHeight = heightMap.GetHeight();
+        const UINT uDepth = heightMap.GetDepth();
+        const UINT uNumColors = heightMap.GetNumColors();
+        const BYTE* pBlockTypes = heightMap.GetBlockTypes();
+        const WORD* pColumnHeights = heightMap.GetColumnHeights();
+        const size_t uNumColumns = static_cast<size_t>(uWidth) * static_cast<size_t>(uDepth);
+
+        const VoxelGridView grid =
+        {
+            .Width = uWidth,
+            .Depth = uDepth,
+            .NumBlockTypes = uNumColors,
+            .BlockTypes = pBlockTypes,
+            .ColumnHeights = pColumnHeights,
+        };
+        const bool bSurface = extractionMode == eVoxelExtractionMode::SURFACE;
+
+        // Chunk-local grid positions always fit in the 16-bit instance
+        // stream, only columns taller than that keep using full
+        // transformation matrices
+        UINT uMaxColumnHeight = 0u;
+        for (size_t uColumnIdx = 0u; uColumnIdx < uNumColumns; ++uColumnIdx)
+        {
+            uMaxColumnHeight = (std::max)(uMaxColumnHeight, static_cast<UINT>(pColumnHeights[uColumnIdx]));
+        }
+        const BOOL bQuantized = uMaxColumnHeight <= SHRT_MAX + 1u;
+        m_bQuantizedTerrain = bQuantized;
+
+        // Every chunk counts and fills its own per-type instance
+        // buffers, so the chunks are independent of each other and of
+        // the number of threads
+        const UINT uNumChunksX = (uWidth + VoxelChunk::CHUNK_SIZE - 1u) / VoxelChunk::CHUNK_SIZE;
+        const UINT uNumChunksZ = (uDepth + VoxelChunk::CHUNK_SIZE - 1u) / VoxelChunk::CHUNK_SIZE;
+        const size_t uNumChunks = static_cast<size_t>(uNumChunksX) * static_cast<size_t>(uNumChunksZ);
+        std::vector<std::shared_ptr<VoxelChunk>> aChunks(uNumChunks);
+        std::vector<size_t> aNumFilledInstances(uNumChunks, 0u);
+        auto createChunks = [&](size_t uBegin, size_t uEnd)
+        {
+            ChunkInstanceCounts counts;
+            for (size_t uChunkIdx = uBegin; uChunkIdx < uEnd; ++uChunkIdx)
+            {
+                const UINT uChunkX = static_cast<UINT>(uChunkIdx % uNumChunksX);
+                const UINT uChunkZ = static_cast<UINT>(uChunkIdx / uNumChunksX);
+                const UINT uOriginX = uChunkX * VoxelChunk::CHUNK_SIZE;
+                const UINT uOriginZ = uChunkZ * VoxelChunk::CHUNK_SIZE;
+                const UINT uEndX = (std::min)(uOriginX + VoxelChunk::CHUNK_SIZE, uWidth);
+                const UINT uEndZ = (std::min)(uOriginZ + VoxelChunk::CHUNK_SIZE, uDepth);
+
+                VoxelInstanceExtractor::CountChunk(grid, bSurface, uOriginX, uOriginZ, uEndX - uOriginX, uEndZ - uOriginZ, counts);
+                aNumFilledInstances[uChunkIdx] = counts.NumFilledInstances;
+                if (counts.MaxHeight == 0u)
+                {
+                    continue;
+                }
+
+                std::vector<std::vector<InstanceData>> aInstanceData(bQuantized ? 0u : uNumColors);
+                std::vector<std::vector<VoxelInstanceData>> aVoxelInstanceData(bQuantized ? uNumColors : 0u);
+                for (UINT uColorIdx = 0u; uColorIdx < uNumColors; ++uColorIdx)
+                {
+                    if (bQuantized)
+                    {
+                        aVoxelInstanceData[uColorIdx].reserve(counts.NumInstances[uColorIdx]);
+                    }
+                    else
+                    {
+                        aInstanceData[uColorIdx].reserve(counts.NumInstances[uColorIdx]);
+                    }
+                }
+
+                VoxelInstanceExtractor::ForEachInstance(
+                    grid,
+                    bSurface,
+                    uOriginX,
+                    uOriginZ,
+                    uEndX - uOriginX,
+                    uEndZ - uOriginZ,
+                    [&](UINT uBlockType, UINT uWidthIdx, UINT heightIdx, UINT uDepthIdx)
+                    {
+                        if (bQuantized)
+                        {
+                            aVoxelInstanceData[uBlockType].push_back(
+                                VoxelInstanceData
+                                {
+                                    .GridPosition =
+                                    {
+                                        static_cast<SHORT>(uWidthIdx - uOriginX),
+                                        static_cast<SHORT>(heightIdx),
+                                        static_cast<SHORT>(uDepthIdx - uOriginZ),
+                                        0,
+                                    }
+                                }
+                            );
+                        }
+                        else
+                        {
+                            aInstanceData[uBlockType].push_back(
+                                InstanceData
+                                {
+                                    .Transformation = XMMatrixTranslation(
+                                        2.0f * (static_cast<FLOAT>(uWidthIdx) - static_cast<FLOAT>(uWidth) / 2.0f),
+                                        2.0f * (static_cast<FLOAT>(heightIdx) - static_cast<FLOAT>(uHeight)) + (static_cast<FLOAT>(uHeight) * 0.75f),
+                                        2.0f * (static_cast<FLOAT>(uDepthIdx) - static_cast<FLOAT>(uDepth) / 2.0f)
+                                        )
+                                }
+                            );
+                        }
+                    }
+                );
+
+                std::shared_ptr<VoxelChunk> chunk = std::make_shared<VoxelChunk>(
+                    uChunkX,
+                    uChunkZ,
+                    getChunkBounds(heightMap, uOriginX, uOriginZ, uEndX - uOriginX, uEndZ - uOriginZ, counts.MinHeight, counts.MaxHeight)
+                );
+                if (counts.MinColumnHeight > 0u)
+                {
+                    chunk->SetOccluderBounds(getChunkBounds(heightMap, uOriginX, uOriginZ, uEndX - uOriginX, uEndZ - uOriginZ, 0u, counts.MinColumnHeight));
+                }
+                for (UINT uColorIdx = 0u; uColorIdx < uNumColors; ++uColorIdx)
+                {
+                    if (bQuantized)
+                    {
+                        if (aVoxelInstanceData[uColorIdx].empty())
+                        {
+                            continue;
+                        }
+
+                        // A cube at the grid position (x, h, z) is centered at
+                        // (2x - W, 2h - 1.25H, 2z - D), the chunk origin is
+                        // folded into the world matrix
+                        std::shared_ptr<Voxel> voxel = std::make_shared<Voxel>(std::move(aVoxelInstanceData[uColorIdx]), heightMap.GetColor(uColorIdx));
+                        voxel->Translate(
+                            XMVectorSet(
+                                2.0f * static_cast<FLOAT>(uOriginX) - static_cast<FLOAT>(uWidth),
+                                -static_cast<FLOAT>(uHeight) * 1.25f,
+                                2.0f * static_cast<FLOAT>(uOriginZ) - static_cast<FLOAT>(uDepth),
+                                0.0f
+                            )
+                        );
+                        chunk->AddVoxel(static_cast<BYTE>(uColorIdx), voxel);
+                    }
+                    else if (!aInstanceData[uColorIdx].empty())
+                    {
+                        chunk->AddVoxel(static_cast<BYTE>(uColorIdx), std::make_shared<Voxel>(std::move(aInstanceData[uColorIdx]), heightMap.GetColor(uColorIdx)));
+                    }
+                }
+
+                aChunks[uChunkIdx] = std::move(chunk);
+            }
+        };
+
+        if (pThreadPool)
+        {
+            pThreadPool->ParallelFor(uNumChunks, 1u, createChunks);
+        }
+        else
+        {
+            createChunks(0u, uNumChunks);
+        }
+
+        m_uNumFilledVoxelInstances = 0u;
+        m_uNumVoxelInstances = 0u;
+        for (size_t uChunkIdx = 0u; uChunkIdx < uNumChunks; ++uChunkIdx)
+        {
+            m_uNumFilledVoxelInstances += aNumFilledInstances[uChunkIdx];
+            if (aChunks[uChunkIdx] && !aChunks[uChunkIdx]->IsEmpty())
+            {
+                m_uNumVoxelInstances += aChunks[uChunkIdx]->GetNumInstances();
+                m_voxelChunks.push_back(std::move(aChunks[uChunkIdx]));
+            }
+        }
 
-        return static_cast<FLOAT>(ms_aHashes[(temp + x) % 256u]);
+        CHAR szMessage[256];
+        sprintf_s(
+            szMessage,
+            "Voxel instances of %ls: %zu filled, %zu extracted in %zu chunks\n",
+            m_filePath.c_str(),
+            m_uNumFilledVoxelInstances,
+            m_uNumVoxelInstances,
+            m_voxelChunks.size()
+        );
+        OutputDebugStringA(szMessage);
     }
 
-    FLOAT Scene::getNoise2d(FLOAT x, FLOAT y)
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::createVoxelMeshes
+
+      Summary:  Greedy-meshes the height map chunk by chunk into static
+                voxel meshes
+
+      Args:     const HeightMap& heightMap
+                  Loaded height map
+
+      Modifies: [m_voxelChunks, m_uNumFilledVoxelInstances].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::createVoxelMeshes(_In_ const HeightMap& heightMap)
     {
-        UINT uX = static_cast<UINT>(x);
-        UINT uY = static_cast<UINT>(y);
-        FLOAT xFrac = x - static_cast<FLOAT>(uX);
-        FLOAT yFrac = y - static_cast<FLOAT>(uY);
+        const VoxelGridView grid =
+        {
+            .Width = heightMap.GetWidth(),
+            .Depth = heightMap.GetDepth(),
+            .NumBlockTypes = heightMap.GetNumColors(),
+            .BlockTypes = heightMap.GetBlockTypes(),
+            .ColumnHeights = heightMap.GetColumnHeights(),
+        };
+
+        m_uNumFilledVoxelInstances = 0u;
+        for (UINT uDepthIdx = 0u; uDepthIdx < grid.Depth; ++uDepthIdx)
+        {
+            for (UINT uWidthIdx = 0u; uWidthIdx < grid.Width; ++uWidthIdx)
+            {
+                m_uNumFilledVoxelInstances += grid.GetColumnHeight(uWidthIdx, uDepthIdx);
+            }
+        }
+
+        size_t uNumVertices = 0u;
+        size_t uNumIndices = 0u;
+        GreedyMeshData meshData;
+        for (UINT uOriginZ = 0u; uOriginZ < grid.Depth; uOriginZ += VoxelChunk::CHUNK_SIZE)
+        {
+            for (UINT uOriginX = 0u; uOriginX < grid.Width; uOriginX += VoxelChunk::CHUNK_SIZE)
+            {
+                const UINT uSizeX = (std::min)(VoxelChunk::CHUNK_SIZE, grid.Width - uOriginX);
+                const UINT uSizeZ = (std::min)(VoxelChunk::CHUNK_SIZE, grid.Depth - uOriginZ);
+                if (!GreedyMesher::MeshChunk(grid, uOriginX, uOriginZ, uSizeX, uSizeZ, meshData) || meshData.Indices.empty())
+                {
+                    continue;
+                }
+
+                UINT uMinHeight = UINT_MAX;
+                UINT uMaxHeight = 0u;
+                for (UINT uDepthIdx = uOriginZ; uDepthIdx < uOriginZ + uSizeZ; ++uDepthIdx)
+                {
+                    for (UINT uWidthIdx = uOriginX; uWidthIdx < uOriginX + uSizeX; ++uWidthIdx)
+                    {
+                        uMinHeight = (std::min)(uMinHeight, static_cast<UINT>(grid.GetColumnHeight(uWidthIdx, uDepthIdx)));
+                        uMaxHeight = (std::max)(uMaxHeight, static_cast<UINT>(grid.GetColumnHeight(uWidthIdx, uDepthIdx)));
+                    }
+                }
+
+                uNumVertices += meshData.Vertices.size();
+                uNumIndices += meshData.Indices.size();
+                std::shared_ptr<VoxelChunk> chunk = std::make_shared<VoxelChunk>(
+                    uOriginX / VoxelChunk::CHUNK_SIZE,
+                    uOriginZ / VoxelChunk::CHUNK_SIZE,
+                    getChunkBounds(heightMap, uOriginX, uOriginZ, uSizeX, uSizeZ, 0u, uMaxHeight)
+                );
+                chunk->SetVoxelMesh(std::make_shared<VoxelMesh>(meshData, heightMap));
+                if (uMinHeight > 0u)
+                {
+                    chunk->SetOccluderBounds(getChunkBounds(heightMap, uOriginX, uOriginZ, uSizeX, uSizeZ, 0u, uMinHeight));
+                }
+                m_voxelChunks.push_back(chunk);
+            }
+        }
+
+        CHAR szMessage[256];
+        sprintf_s(
+            szMessage,
+            "Voxel meshes of %ls: %zu chunks, %zu vertices, %zu triangles for %zu filled voxels\n",
+            m_filePath.c_str(),
+            m_voxelChunks.size(),
+            uNumVertices,
+            uNumIndices / 3u,
+            m_uNumFilledVoxelInstances
+        );
+        OutputDebugStringA(szMessage);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::getOrCreateChunk
+
+      Summary:  Returns the chunk of a column, creating an empty one if
+                the column had no cubes, and grows its bounds to
+                contain the cube at the given height
 
-        UINT s = static_cast<UINT>(getNoise2(uX, uY));
-        UINT t = static_cast<UINT>(getNoise2(uX + 1u, uY));
-        UINT u = static_cast<UINT>(getNoise2(uX, uY + 1u));
-        UINT v = static_cast<UINT>(getNoise2(uX + 1u, uY + 1u));
+      Args:     UINT x
+                  Column along the x-axis
+                UINT y
+                  Height index of the cube
+                UINT z
+                  Column along the z-axis
 
-        FLOAT low = smoothLerp(static_cast<FLOAT>(s), static_cast<FLOAT>(t), xFrac);
-        FLOAT high = smoothLerp(static_cast<FLOAT>(u), static_cast<FLOAT>(v), xFrac);
+      Modifies: [m_voxelChunks, m_aChunkGrid].
+
+      Returns:  std::shared_ptr<VoxelChunk>
+                  Chunk of the column
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::shared_ptr<VoxelChunk> Scene::getOrCreateChunk(_In_ UINT x, _In_ UINT y, _In_ UINT z)
+    {
+        // A cube at the grid position (x, h, z) is centered at
+        // (2x - W, 2h - 1.25H, 2z - D)
+        const BoundingBox cubeBounds(
+            XMFLOAT3(
+                2.0f * static_cast<FLOAT>(x) - static_cast<FLOAT>(m_uTerrainWidth),
+                2.0f * static_cast<FLOAT>(y) - static_cast<FLOAT>(m_uTerrainHeight) * 1.25f,
+                2.0f * static_cast<FLOAT>(z) - static_cast<FLOAT>(m_uTerrainDepth)
+            ),
+            XMFLOAT3(1.0f, 1.0f, 1.0f)
+        );
+
+        const UINT uChunkX = x / VoxelChunk::CHUNK_SIZE;
+        const UINT uChunkZ = z / VoxelChunk::CHUNK_SIZE;
+        std::shared_ptr<VoxelChunk>& voxelChunk = m_aChunkGrid[static_cast<size_t>(uChunkZ) * m_uNumChunksX + uChunkX];
+        if (!voxelChunk)
+        {
+            voxelChunk = std::make_shared<VoxelChunk>(uChunkX, uChunkZ, cubeBounds);
+            m_voxelChunks.push_back(voxelChunk);
+        }
+        else
+        {
+            voxelChunk->ExpandBounds(cubeBounds);
+        }
 
-        return smoothLerp(low, high, yFrac);
+        return voxelChunk;
     }
 
-    FLOAT Scene::lerp(FLOAT x, FLOAT y, FLOAT s)
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::markVoxelMeshDirty
+
+      Summary:  Queues a chunk of the greedy-meshed terrain for the
+                next RebuildVoxelMeshes
+
+      Args:     UINT uChunkX
+                  Chunk coordinate along the x-axis
+                UINT uChunkZ
+                  Chunk coordinate along the z-axis
+
+      Modifies: [m_dirtyVoxelMeshChunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::markVoxelMeshDirty(_In_ UINT uChunkX, _In_ UINT uChunkZ)
     {
-        return x + s * (y - x);
+        if (uChunkX >= m_uNumChunksX || uChunkZ >= m_uNumChunksZ)
+        {
+            return;
+        }
+
+        m_dirtyVoxelMeshChunks.insert(static_cast<size_t>(uChunkZ) * m_uNumChunksX + uChunkX);
     }
 
-    FLOAT Scene::smoothLerp(FLOAT x, FLOAT y, FLOAT s)
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::getChunkBounds
+
+      Summary:  Returns the world space bounds of a block of columns
+
+      Args:     const HeightMap& heightMap
+                  Loaded height map
+                UINT uOriginX
+                  First column of the block along the x-axis
+                UINT uOriginZ
+                  First column of the block along the z-axis
+                UINT uSizeX
+                  Number of columns along the x-axis
+                UINT uSizeZ
+                  Number of columns along the z-axis
+                UINT uMinHeight
+                  Grid height of the lowest cube of the block
+                UINT uMaxHeight
+                  Grid height above the highest cube of the block
+
+      Returns:  BoundingBox
+                  Bounds of the cubes of the block
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BoundingBox Scene::getChunkBounds(
+        _In_ const HeightMap& heightMap,
+        _In_ UINT uOriginX,
+        _In_ UINT uOriginZ,
+        _In_ UINT uSizeX,
+        _In_ UINT uSizeZ,
+        _In_ UINT uMinHeight,
+        _In_ UINT uMaxHeight
+    )
     {
-        return lerp(x, y, s * s * (3.0f - 2.0f * s));
+        // A cube at the grid position (x, h, z) spans
+        // [2x - W - 1, 2x - W + 1] and so on for the other axes
+        const XMVECTOR minimum = XMVectorSet(
+            2.0f * static_cast<FLOAT>(uOriginX) - static_cast<FLOAT>(heightMap.GetWidth()) - 1.0f,
+            2.0f * static_cast<FLOAT>(uMinHeight) - static_cast<FLOAT>(heightMap.GetHeight()) * 1.25f - 1.0f,
+            2.0f * static_cast<FLOAT>(uOriginZ) - static_cast<FLOAT>(heightMap.GetDepth()) - 1.0f,
+            0.0f
+        );
+        const XMVECTOR extent = XMVectorSet(
+            2.0f * static_cast<FLOAT>(uSizeX),
+            2.0f * static_cast<FLOAT>(uMaxHeight - (std::min)(uMinHeight, uMaxHeight)),
+            2.0f * static_cast<FLOAT>(uSizeZ),
+            0.0f
+        );
+
+        BoundingBox bounds;
+        BoundingBox::CreateFromPoints(bounds, minimum, XMVectorAdd(minimum, extent));
+
+        return bounds;
     }
-}
\ No newline at end of file
+}
@@ -16,10 +16,17 @@
 #include <fstream>
 
 #include "Model/Model.h"
+#include "Light/DirectionalLight.h"
 #include "Light/PointLight.h"
 #include "Renderer/Skybox.h"
 #include "Renderer/Renderable.h"
+#include "Scene/HeightMap.h"
+#include "Scene/SlotMap.h"
+#include "Scene/TerrainStreamer.h"
 #include "Scene/Voxel.h"
+#include "Scene/VoxelChunk.h"
+#include "Scene/VoxelMesh.h"
+#include "Thread/ThreadPool.h"
 
 namespace library
 {
@@ -27,8 +34,18 @@ namespace library
     {
     public:
         static FLOAT GetPerlin2d(FLOAT x, FLOAT y, FLOAT frequency, UINT uDepth);
-
-        Scene(const std::filesystem::path& filePath);
+        static void GetPerlin2dBatch(
+            _In_reads_(uCount) const FLOAT* pX,
+            _In_reads_(uCount) const FLOAT* pY,
+            _In_ UINT uCount,
+            _In_ FLOAT frequency,
+            _In_ UINT uDepth,
+            _Out_writes_(uCount) FLOAT* pResults
+        );
+
+        Scene(const std::filesystem::path& filePath, _In_ eVoxelExtractionMode extractionMode = eVoxelExtractionMode::FILLED_COLUMNS);
+        Scene(_In_ const HeightMap& heightMap, _In_ eVoxelExtractionMode extractionMode = eVoxelExtractionMode::FILLED_COLUMNS, _In_opt_ ThreadPool* pThreadPool = nullptr);
+        Scene(_In_ const std::filesystem::path& worldFilePath, _In_ const TerrainStreamingDesc& streamingDesc);
         Scene(const Scene& other) = delete;
         Scene(Scene&& other) = delete;
         Scene& operator=(const Scene& other) = delete;
@@ -41,6 +58,7 @@ namespace library
         HRESULT AddRenderable(_In_ PCWSTR pszRenderableName, _In_ const std::shared_ptr<Renderable>& renderable);
         HRESULT AddModel(_In_ PCWSTR pszModelName, _In_ const std::shared_ptr<Model>& pModel);
         HRESULT AddPointLight(_In_ size_t index, _In_ const std::shared_ptr<PointLight>& pPointLight);
+        void SetDirectionalLight(_In_ const std::shared_ptr<DirectionalLight>& directionalLight);
         HRESULT AddVertexShader(_In_ PCWSTR pszVertexShaderName, _In_ const std::shared_ptr<VertexShader>& vertexShader);
         HRESULT AddPixelShader(_In_ PCWSTR pszPixelShaderName, _In_ const std::shared_ptr<PixelShader>& pixelShader);
         HRESULT AddSkyBox(_In_ const std::shared_ptr<Skybox>& skybox);
@@ -48,14 +66,38 @@ namespace library
 
         void Update(_In_ FLOAT deltaTime);
 
+        HRESULT SetTerrainVoxel(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ BYTE uBlockType);
+        HRESULT RemoveTerrainVoxel(_In_ UINT x, _In_ UINT y, _In_ UINT z);
+        HRESULT SetTerrainColumn(_In_ UINT x, _In_ UINT z, _In_ WORD uHeight, _In_ BYTE uBlockType);
+        void RebuildVoxelMeshes(_In_opt_ ThreadPool* pThreadPool = nullptr);
+        HRESULT UpdateTerrainBuffers(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+        HRESULT UpdateTerrainStreaming(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ const XMVECTOR& eye,
+            _In_ const XMVECTOR& forward
+        );
+
         std::vector<std::shared_ptr<Voxel>>& GetVoxels();
-        std::unordered_map<std::wstring, std::shared_ptr<Renderable>>& GetRenderables();
-        std::unordered_map<std::wstring, std::shared_ptr<Model>>& GetModels();
+        std::vector<std::shared_ptr<VoxelChunk>>& GetVoxelChunks();
+        SlotMap<std::shared_ptr<Renderable>>& GetRenderables();
+        SlotMap<std::shared_ptr<Model>>& GetModels();
         std::shared_ptr<PointLight>& GetPointLight(_In_ size_t index);
-        std::unordered_map<std::wstring, std::shared_ptr<VertexShader>>& GetVertexShaders();
-        std::unordered_map<std::wstring, std::shared_ptr<PixelShader>>& GetPixelShaders();
+        const std::vector<std::shared_ptr<PointLight>>& GetPointLights() const;
+        std::shared_ptr<DirectionalLight>& GetDirectionalLight();
+        SlotMap<std::shared_ptr<VertexShader>>& GetVertexShaders();
+        SlotMap<std::shared_ptr<PixelShader>>& GetPixelShaders();
         std::shared_ptr<Skybox>& GetSkyBox();
 
+        SlotHandle FindRenderable(_In_ PCWSTR pszRenderableName) const;
+        SlotHandle FindModel(_In_ PCWSTR pszModelName) const;
+        SlotHandle FindVertexShader(_In_ PCWSTR pszVertexShaderName) const;
+        SlotHandle FindPixelShader(_In_ PCWSTR pszPixelShaderName) const;
+
+        size_t GetNumFilledVoxelInstances() const;
+        size_t GetNumVoxelInstances() const;
+        UINT64 GetStaticVersion() const;
+
         const std::filesystem::path& GetFilePath() const;
         PCWSTR GetFileName() const;
 
@@ -64,40 +106,80 @@ namespace library
         HRESULT SetVertexShaderOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszVertexShaderName);
         HRESULT SetPixelShaderOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszPixelShaderName);
         HRESULT SetVertexShaderOfVoxel(_In_ PCWSTR pszVertexShaderName);
+        HRESULT SetVertexShaderOfQuantizedVoxel(_In_ PCWSTR pszVertexShaderName);
         HRESULT SetPixelShaderOfVoxel(_In_ PCWSTR pszPixelShaderName);
+        HRESULT SetVertexShaderOfVoxelMesh(_In_ PCWSTR pszVertexShaderName);
+        HRESULT SetPixelShaderOfVoxelMesh(_In_ PCWSTR pszPixelShaderName);
+        HRESULT SetInstancedVertexShader(_In_ PCWSTR pszVertexShaderName, _In_ PCWSTR pszInstancedVertexShaderName);
 
     private:
-        static FLOAT getNoise2(UINT x, UINT y);
-        static FLOAT getNoise2d(FLOAT x, FLOAT y);
-        static FLOAT lerp(FLOAT x, FLOAT y, FLOAT s);
-        static FLOAT smoothLerp(FLOAT x, FLOAT y, FLOAT s);
+        void createTerrain(_In_ const HeightMap& heightMap, _In_ eVoxelExtractionMode extractionMode, _In_opt_ ThreadPool* pThreadPool);
+        void createVoxels(_In_ const HeightMap& heightMap, _In_ eVoxelExtractionMode extractionMode, _In_opt_ ThreadPool* pThreadPool = nullptr);
+        void createVoxelMeshes(_In_ const HeightMap& heightMap);
+
+        std::shared_ptr<VoxelChunk> getOrCreateChunk(_In_ UINT x, _In_ UINT y, _In_ UINT z);
+        void markVoxelMeshDirty(_In_ UINT uChunkX, _In_ UINT uChunkZ);
+
+        static BoundingBox getChunkBounds(
+            _In_ const HeightMap& heightMap,
+            _In_ UINT uOriginX,
+            _In_ UINT uOriginZ,
+            _In_ UINT uSizeX,
+            _In_ UINT uSizeZ,
+            _In_ UINT uMinHeight,
+            _In_ UINT uMaxHeight
+        );
 
     private:
-        static constexpr const UINT ms_aHashes[] =
+        struct VoxelMeshRebuild
         {
-            208,34,231,213,32,248,233,56,161,78,24,140,71,48,140,254,245,255,247,247,40,
-            185,248,251,245,28,124,204,204,76,36,1,107,28,234,163,202,224,245,128,167,204,
-            9,92,217,54,239,174,173,102,193,189,190,121,100,108,167,44,43,77,180,204,8,81,
-            70,223,11,38,24,254,210,210,177,32,81,195,243,125,8,169,112,32,97,53,195,13,
-            203,9,47,104,125,117,114,124,165,203,181,235,193,206,70,180,174,0,167,181,41,
-            164,30,116,127,198,245,146,87,224,149,206,57,4,192,210,65,210,129,240,178,105,
-            228,108,245,148,140,40,35,195,38,58,65,207,215,253,65,85,208,76,62,3,237,55,89,
-            232,50,217,64,244,157,199,121,252,90,17,212,203,149,152,140,187,234,177,73,174,
-            193,100,192,143,97,53,145,135,19,103,13,90,135,151,199,91,239,247,33,39,145,
-            101,120,99,3,186,86,99,41,237,203,111,79,220,135,158,42,30,154,120,67,87,167,
-            135,176,183,191,253,115,184,21,233,58,129,233,142,39,128,211,118,137,139,255,
-            114,20,218,113,154,27,127,246,250,1,8,198,250,209,92,222,173,21,88,102,219
+            std::future<void> Done;
+            std::shared_ptr<VoxelMesh> Mesh;
+            BoundingBox Bounds;
+            BoundingBox OccluderBounds;
+            UINT MinColumnHeight;
         };
 
     private:
         std::filesystem::path m_filePath;
         std::vector<std::shared_ptr<Voxel>> m_voxels;
-        std::unordered_map<std::wstring, std::shared_ptr<Renderable>> m_renderables;
-        std::unordered_map<std::wstring, std::shared_ptr<Model>> m_models;
-        std::shared_ptr<PointLight> m_aPointLights[NUM_LIGHTS];
-        std::unordered_map<std::wstring, std::shared_ptr<VertexShader>> m_vertexShaders;
-        std::unordered_map<std::wstring, std::shared_ptr<PixelShader>> m_pixelShaders;
+        std::vector<std::shared_ptr<VoxelChunk>> m_voxelChunks;
+        SlotMap<std::shared_ptr<Renderable>> m_renderables;
+        std::unordered_map<std::wstring, SlotHandle> m_renderableHandles;
+        SlotMap<std::shared_ptr<Model>> m_models;
+        std::unordered_map<std::wstring, SlotHandle> m_modelHandles;
+        std::vector<std::shared_ptr<PointLight>> m_aPointLights;
+        std::shared_ptr<DirectionalLight> m_directionalLight;
+        SlotMap<std::shared_ptr<VertexShader>> m_vertexShaders;
+        std::unordered_map<std::wstring, SlotHandle> m_vertexShaderHandles;
+        SlotMap<std::shared_ptr<PixelShader>> m_pixelShaders;
+        std::unordered_map<std::wstring, SlotHandle> m_pixelShaderHandles;
         std::unordered_map<std::wstring, std::shared_ptr<Material>> m_materials;
         std::shared_ptr<Skybox> m_skyBox;
+        size_t m_uNumFilledVoxelInstances;
+        size_t m_uNumVoxelInstances;
+        UINT64 m_uStaticVersion;
+
+        eVoxelExtractionMode m_extractionMode;
+        BOOL m_bQuantizedTerrain;
+        UINT m_uTerrainWidth;
+        UINT m_uTerrainHeight;
+        UINT m_uTerrainDepth;
+        UINT m_uNumChunksX;
+        UINT m_uNumChunksZ;
+        std::vector<XMFLOAT4> m_aBlockColors;
+        std::vector<BYTE> m_aBlockTypes;
+        std::vector<WORD> m_aColumnHeights;
+        std::vector<std::shared_ptr<VoxelChunk>> m_aChunkGrid;
+        std::vector<std::shared_ptr<Voxel>> m_aNewVoxels;
+        std::vector<std::shared_ptr<Voxel>> m_aDirtyVoxels;
+        std::unordered_set<size_t> m_dirtyVoxelMeshChunks;
+        std::unordered_map<size_t, std::shared_ptr<VoxelMeshRebuild>> m_voxelMeshRebuilds;
+        std::shared_ptr<VertexShader> m_voxelVertexShader;
+        std::shared_ptr<VertexShader> m_voxelQuantizedVertexShader;
+        std::shared_ptr<PixelShader> m_voxelPixelShader;
+        std::shared_ptr<VertexShader> m_voxelMeshVertexShader;
+        std::shared_ptr<PixelShader> m_voxelMeshPixelShader;
+        std::unique_ptr<TerrainStreamer> m_terrainStreamer;
     };
 }
\ No newline at end of file
@@ -0,0 +1,340 @@
+/*+===================================================================
+  File:      SLOTMAP.H
+
+  Summary:   SlotMap header file contains declarations of SlotMap
+             class template that keeps objects in a dense array
+             addressed by generational handles.
+
+  Classes: SlotHandle, SlotMap
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   SlotHandle
+
+      Summary:  Handle to an element of a SlotMap. The generation
+                changes every time the slot is reused, so a handle to a
+                removed element never resolves to a newer one
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct SlotHandle
+    {
+        static constexpr const UINT INVALID_INDEX = 0xFFFFFFFF;
+
+        UINT uIndex = INVALID_INDEX;
+        UINT uGeneration = 0u;
+
+        BOOL IsValid() const
+        {
+            return uIndex != INVALID_INDEX;
+        }
+
+        bool operator==(const SlotHandle& other) const = default;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    SlotMap
+
+      Summary:  Stores values contiguously and hands out handles that
+                stay valid while values are added and removed. Removing
+                moves the last value into the hole, so iterating over
+                the values is a walk over one array in no particular
+                order. Slots are recycled through a free list
+
+      Methods:  Insert
+                  Adds a value and returns its handle
+                Remove
+                  Removes the value of a handle
+                Clear
+                  Removes all values
+                Get
+                  Returns the value of a handle or null
+                Contains
+                  Returns whether a handle refers to a value
+                GetHandle
+                  Returns the handle of a value by its position
+                GetSize
+                  Returns the number of values
+                IsEmpty
+                  Returns whether there are no values
+                begin
+                  Returns an iterator to the first value
+                end
+                  Returns an iterator past the last value
+                SlotMap
+                  Constructor.
+                ~SlotMap
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    template <typename T>
+    class SlotMap final
+    {
+    private:
+        struct Slot
+        {
+            UINT uDenseIndex;
+            UINT uGeneration;
+        };
+
+    public:
+        SlotMap() = default;
+        SlotMap(const SlotMap& other) = delete;
+        SlotMap(SlotMap&& other) = delete;
+        SlotMap& operator=(const SlotMap& other) = delete;
+        SlotMap& operator=(SlotMap&& other) = delete;
+        ~SlotMap() = default;
+
+        SlotHandle Insert(_In_ T value);
+        BOOL Remove(_In_ SlotHandle handle);
+        void Clear();
+
+        T* Get(_In_ SlotHandle handle);
+        const T* Get(_In_ SlotHandle handle) const;
+        BOOL Contains(_In_ SlotHandle handle) const;
+        SlotHandle GetHandle(_In_ size_t uPosition) const;
+        size_t GetSize() const;
+        BOOL IsEmpty() const;
+
+        typename std::vector<T>::iterator begin();
+        typename std::vector<T>::iterator end();
+        typename std::vector<T>::const_iterator begin() const;
+        typename std::vector<T>::const_iterator end() const;
+
+    private:
+        std::vector<T> m_aValues;
+        std::vector<UINT> m_aSlotIndices;
+        std::vector<Slot> m_aSlots;
+        std::vector<UINT> m_aFreeSlots;
+    };
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SlotMap<T>::Insert
+
+      Summary:  Adds a value at the end of the dense array
+
+      Args:     T value
+                  Value to add
+
+      Modifies: [m_aValues, m_aSlotIndices, m_aSlots, m_aFreeSlots].
+
+      Returns:  SlotHandle
+                  Handle of the value
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <typename T>
+    SlotHandle SlotMap<T>::Insert(_In_ T value)
+    {
+        UINT uSlotIdx;
+        if (m_aFreeSlots.empty())
+        {
+            uSlotIdx = static_cast<UINT>(m_aSlots.size());
+            m_aSlots.push_back(Slot{ .uDenseIndex = 0u, .uGeneration = 0u });
+        }
+        else
+        {
+            uSlotIdx = m_aFreeSlots.back();
+            m_aFreeSlots.pop_back();
+        }
+
+        m_aSlots[uSlotIdx].uDenseIndex = static_cast<UINT>(m_aValues.size());
+        m_aValues.push_back(std::move(value));
+        m_aSlotIndices.push_back(uSlotIdx);
+
+        return SlotHandle{ .uIndex = uSlotIdx, .uGeneration = m_aSlots[uSlotIdx].uGeneration };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SlotMap<T>::Remove
+
+      Summary:  Removes the value of a handle by moving the last value
+                into its place
+
+      Args:     SlotHandle handle
+                  Handle of the value
+
+      Modifies: [m_aValues, m_aSlotIndices, m_aSlots, m_aFreeSlots].
+
+      Returns:  BOOL
+                  TRUE if the handle referred to a value
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <typename T>
+    BOOL SlotMap<T>::Remove(_In_ SlotHandle handle)
+    {
+        if (!Contains(handle))
+        {
+            return FALSE;
+        }
+
+        const UINT uDenseIdx = m_aSlots[handle.uIndex].uDenseIndex;
+        const UINT uLastIdx = static_cast<UINT>(m_aValues.size()) - 1u;
+        if (uDenseIdx != uLastIdx)
+        {
+            m_aValues[uDenseIdx] = std::move(m_aValues[uLastIdx]);
+            m_aSlotIndices[uDenseIdx] = m_aSlotIndices[uLastIdx];
+            m_aSlots[m_aSlotIndices[uDenseIdx]].uDenseIndex = uDenseIdx;
+        }
+        m_aValues.pop_back();
+        m_aSlotIndices.pop_back();
+
+        ++m_aSlots[handle.uIndex].uGeneration;
+        m_aFreeSlots.push_back(handle.uIndex);
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SlotMap<T>::Clear
+
+      Summary:  Removes all values. Outstanding handles stay invalid
+
+      Modifies: [m_aValues, m_aSlotIndices, m_aSlots, m_aFreeSlots].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <typename T>
+    void SlotMap<T>::Clear()
+    {
+        for (UINT uSlotIdx : m_aSlotIndices)
+        {
+            ++m_aSlots[uSlotIdx].uGeneration;
+            m_aFreeSlots.push_back(uSlotIdx);
+        }
+        m_aValues.clear();
+        m_aSlotIndices.clear();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SlotMap<T>::Get
+
+      Summary:  Returns the value of a handle
+
+      Args:     SlotHandle handle
+                  Handle of the value
+
+      Returns:  T*
+                  The value, null if the handle is stale or invalid
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <typename T>
+    T* SlotMap<T>::Get(_In_ SlotHandle handle)
+    {
+        return Contains(handle) ? &m_aValues[m_aSlots[handle.uIndex].uDenseIndex] : nullptr;
+    }
+
+    template <typename T>
+    const T* SlotMap<T>::Get(_In_ SlotHandle handle) const
+    {
+        return Contains(handle) ? &m_aValues[m_aSlots[handle.uIndex].uDenseIndex] : nullptr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SlotMap<T>::Contains
+
+      Summary:  Returns whether a handle refers to a value
+
+      Args:     SlotHandle handle
+                  Handle to check
+
+      Returns:  BOOL
+                  TRUE if the value of the handle was not removed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <typename T>
+    BOOL SlotMap<T>::Contains(_In_ SlotHandle handle) const
+    {
+        return handle.uIndex < m_aSlots.size()
+            && m_aSlots[handle.uIndex].uGeneration == handle.uGeneration
+            && m_aSlots[handle.uIndex].uDenseIndex < m_aValues.size()
+            && m_aSlotIndices[m_aSlots[handle.uIndex].uDenseIndex] == handle.uIndex;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SlotMap<T>::GetHandle
+
+      Summary:  Returns the handle of the value at a position of the
+                dense array
+
+      Args:     size_t uPosition
+                  Position of the value, less than GetSize
+
+      Returns:  SlotHandle
+                  Handle of the value
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <typename T>
+    SlotHandle SlotMap<T>::GetHandle(_In_ size_t uPosition) const
+    {
+        const UINT uSlotIdx = m_aSlotIndices[uPosition];
+
+        return SlotHandle{ .uIndex = uSlotIdx, .uGeneration = m_aSlots[uSlotIdx].uGeneration };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SlotMap<T>::GetSize
+
+      Summary:  Returns the number of values
+
+      Returns:  size_t
+                  Number of values
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <typename T>
+    size_t SlotMap<T>::GetSize() const
+    {
+        return m_aValues.size();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SlotMap<T>::IsEmpty
+
+      Summary:  Returns whether there are no values
+
+      Returns:  BOOL
+                  TRUE if there are no values
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <typename T>
+    BOOL SlotMap<T>::IsEmpty() const
+    {
+        return m_aValues.empty();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SlotMap<T>::begin
+
+      Summary:  Returns an iterator to the first value of the dense
+                array
+
+      Returns:  std::vector<T>::iterator
+                  Iterator to the first value
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <typename T>
+    typename std::vector<T>::iterator SlotMap<T>::begin()
+    {
+        return m_aValues.begin();
+    }
+
+    template <typename T>
+    typename std::vector<T>::const_iterator SlotMap<T>::begin() const
+    {
+        return m_aValues.begin();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SlotMap<T>::end
+
+      Summary:  Returns an iterator past the last value of the dense
+                array
+
+      Returns:  std::vector<T>::iterator
+                  Iterator past the last value
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <typename T>
+    typename std::vector<T>::iterator SlotMap<T>::end()
+    {
+        return m_aValues.end();
+    }
+
+    template <typename T>
+    typename std::vector<T>::const_iterator SlotMap<T>::end() const
+    {
+        return m_aValues.end();
+    }
+}
@@ -0,0 +1,244 @@
+#include "Scene/TerrainGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Scene/Scene.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::TerrainGenerator
+
+      Summary:  Constructor
+
+      Args:     const TerrainDesc& desc
+                  Size and noise parameters of the terrain
+
+      Modifies: [m_desc].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TerrainGenerator::TerrainGenerator(_In_ const TerrainDesc& desc)
+        : m_desc(desc)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::Generate
+
+      Summary:  Generates the terrain tile by tile, a tile being
+                ROWS_PER_TILE rows of the map, and hands the grid to
+                the height map without going through a file
+
+      Args:     HeightMap& heightMap
+                  Height map to fill
+                ThreadPool* pThreadPool
+                  Pool to generate the tiles on, nullptr to generate
+                  them on the calling thread only
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TerrainGenerator::Generate(_Out_ HeightMap& heightMap, _In_opt_ ThreadPool* pThreadPool) const
+    {
+        const size_t uNumColumns = static_cast<size_t>(m_desc.Width) * static_cast<size_t>(m_desc.Depth);
+        std::vector<BYTE> aBlockTypes(uNumColumns);
+        std::vector<WORD> aColumnHeights(uNumColumns);
+
+        const size_t uNumTiles = (static_cast<size_t>(m_desc.Depth) + ROWS_PER_TILE - 1u) / ROWS_PER_TILE;
+        auto generateTiles = [&](size_t uBegin, size_t uEnd)
+        {
+            for (size_t uTileIdx = uBegin; uTileIdx < uEnd; ++uTileIdx)
+            {
+                const UINT uBeginZ = static_cast<UINT>(uTileIdx) * ROWS_PER_TILE;
+                const UINT uEndZ = (std::min)(uBeginZ + ROWS_PER_TILE, m_desc.Depth);
+                const size_t uOffset = static_cast<size_t>(uBeginZ) * m_desc.Width;
+                generateRows(uBeginZ, uEndZ, aBlockTypes.data() + uOffset, aColumnHeights.data() + uOffset);
+            }
+        };
+
+        if (pThreadPool)
+        {
+            pThreadPool->ParallelFor(uNumTiles, 1u, generateTiles);
+        }
+        else
+        {
+            generateTiles(0u, uNumTiles);
+        }
+
+        return heightMap.Create(
+            m_desc.Width,
+            m_desc.Height,
+            m_desc.Depth,
+            std::vector<XMFLOAT4>(std::begin(PALETTE), std::end(PALETTE)),
+            std::move(aBlockTypes),
+            std::move(aColumnHeights)
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::generateRows
+
+      Summary:  Generates a range of rows. For every row all the noise
+                layers of the height and the moisture are evaluated
+                with one batch call per layer and field, or one per
+                layer when the two fields share their samples, before
+                the columns are classified
+
+      Args:     UINT uBeginZ
+                  First row to generate
+                UINT uEndZ
+                  Row after the last row to generate
+                BYTE* pBlockTypes
+                  Palette indices of the rows
+                WORD* pColumnHeights
+                  Column heights of the rows
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainGenerator::generateRows(_In_ UINT uBeginZ, _In_ UINT uEndZ, _Out_ BYTE* pBlockTypes, _Out_ WORD* pColumnHeights) const
+    {
+        const UINT uWidth = m_desc.Width;
+        const BOOL bSharedSamples = m_desc.MoistureOffsetX == 0.0f && m_desc.MoistureOffsetZ == 0.0f;
+
+        std::vector<FLOAT> aSampleX(uWidth);
+        std::vector<FLOAT> aSampleZ(uWidth);
+        std::vector<FLOAT> aNoise(uWidth);
+        std::vector<FLOAT> aHeights(uWidth);
+        std::vector<FLOAT> aMoistures(uWidth);
+        for (UINT z = uBeginZ; z < uEndZ; ++z)
+        {
+            std::fill(aHeights.begin(), aHeights.end(), 0.0f);
+            std::fill(aMoistures.begin(), aMoistures.end(), 0.0f);
+
+            FLOAT frequencySum = 0.0f;
+            for (UINT i = 0u; i < m_desc.NumLayers; ++i)
+            {
+                const FLOAT frequency = pow(2.0f, static_cast<FLOAT>(i));
+                frequencySum += 1.0f / frequency;
+
+                for (UINT x = 0u; x < uWidth; ++x)
+                {
+                    aSampleX[x] = frequency * static_cast<FLOAT>(x);
+                    aSampleZ[x] = frequency * static_cast<FLOAT>(z);
+                }
+                Scene::GetPerlin2dBatch(aSampleX.data(), aSampleZ.data(), uWidth, m_desc.NoiseFrequency, m_desc.NoiseDepth, aNoise.data());
+                for (UINT x = 0u; x < uWidth; ++x)
+                {
+                    aHeights[x] += aNoise[x] / frequency;
+                }
+
+                if (!bSharedSamples)
+                {
+                    for (UINT x = 0u; x < uWidth; ++x)
+                    {
+                        aSampleX[x] = frequency * (static_cast<FLOAT>(x) + m_desc.MoistureOffsetX);
+                        aSampleZ[x] = frequency * (static_cast<FLOAT>(z) + m_desc.MoistureOffsetZ);
+                    }
+                    Scene::GetPerlin2dBatch(aSampleX.data(), aSampleZ.data(), uWidth, m_desc.NoiseFrequency, m_desc.NoiseDepth, aNoise.data());
+                }
+                for (UINT x = 0u; x < uWidth; ++x)
+                {
+                    aMoistures[x] += aNoise[x] / frequency;
+                }
+            }
+
+            const size_t uRowOffset = static_cast<size_t>(z - uBeginZ) * uWidth;
+            for (UINT x = 0u; x < uWidth; ++x)
+            {
+                const FLOAT height = pow(aHeights[x] / frequencySum * 1.2f, 1.25f);
+                const FLOAT moisture = pow(aMoistures[x] / frequencySum * 1.2f, 1.25f);
+
+                FLOAT columnHeight = static_cast<FLOAT>(m_desc.Height) * height;
+                columnHeight = columnHeight < 0.0f ? 0.0f : columnHeight;
+                columnHeight = columnHeight > static_cast<FLOAT>(0xFFFF) ? static_cast<FLOAT>(0xFFFF) : columnHeight;
+
+                pBlockTypes[uRowOffset + x] = static_cast<BYTE>(static_cast<CHAR>(getBlockType(height, moisture)) - static_cast<CHAR>(eBlockType::GRASSLAND));
+                pColumnHeights[uRowOffset + x] = static_cast<WORD>(columnHeight);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::getBlockType
+
+      Summary:  Classifies a column into a biome
+
+      Args:     FLOAT height
+                  Normalized height of the column
+                FLOAT moisture
+                  Normalized moisture of the column
+
+      Returns:  eBlockType
+                  Block type of the column
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eBlockType TerrainGenerator::getBlockType(_In_ FLOAT height, _In_ FLOAT moisture)
+    {
+        if (height < 0.1f)
+        {
+            return eBlockType::OCEAN;
+        }
+        if (height < 0.12f)
+        {
+            return eBlockType::SAND;
+        }
+
+        if (height > 0.8f)
+        {
+            if (moisture < 0.1f)
+            {
+                return eBlockType::SCORCHED;
+            }
+            if (moisture < 0.2f)
+            {
+                return eBlockType::BARE;
+            }
+            if (moisture < 0.5f)
+            {
+                return eBlockType::TUNDRA;
+            }
+            return eBlockType::SNOW;
+        }
+
+        if (height > 0.6f)
+        {
+            if (moisture < 0.33f)
+            {
+                return eBlockType::TEMPERATE_DESERT;
+            }
+            if (moisture < 0.66f)
+            {
+                return eBlockType::SHRUBLAND;
+            }
+            return eBlockType::TAIGA;
+        }
+
+        if (height > 0.3f)
+        {
+            if (moisture < 0.16f)
+            {
+                return eBlockType::TEMPERATE_DESERT;
+            }
+            if (moisture < 0.5f)
+            {
+                return eBlockType::GRASSLAND;
+            }
+            if (moisture < 0.83f)
+            {
+                return eBlockType::TEMPERATE_DECIDUOUS_FOREST;
+            }
+            return eBlockType::TEMPERATE_RAIN_FOREST;
+        }
+
+        if (moisture < 0.16f)
+        {
+            return eBlockType::SUBTROPICAL_DESERT;
+        }
+        if (moisture < 0.33f)
+        {
+            return eBlockType::GRASSLAND;
+        }
+        if (moisture < 0.66f)
+        {
+            return eBlockType::TROPICAL_SEASONAL_FOREST;
+        }
+        return eBlockType::TROPICAL_RAIN_FOREST;
+    }
+}
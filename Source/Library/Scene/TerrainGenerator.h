@@ -0,0 +1,101 @@
+/*+===================================================================
+  File:      TERRAINGENERATOR.H
+
+  Summary:   TerrainGenerator header file contains declarations of
+             TerrainGenerator class that builds the block / height
+             grid of a procedural voxel scene directly in memory.
+
+  Classes: TerrainGenerator
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Scene/HeightMap.h"
+#include "Thread/ThreadPool.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TerrainDesc
+
+      Summary:  Size and noise parameters of a procedural terrain. The
+                height and the moisture are sums of NumLayers noise
+                layers of doubling frequency, each evaluated with
+                Scene::GetPerlin2d(.., NoiseFrequency, NoiseDepth).
+                The moisture field is sampled at an offset from the
+                height field, with no offset both are the same field
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TerrainDesc
+    {
+        UINT Width;
+        UINT Height;
+        UINT Depth;
+        FLOAT NoiseFrequency = 0.1f;
+        UINT NoiseDepth = 4u;
+        UINT NumLayers = 4u;
+        FLOAT MoistureOffsetX = 0.0f;
+        FLOAT MoistureOffsetZ = 0.0f;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TerrainGenerator
+
+      Summary:  Generates a biome height map from value noise. Bands of
+                rows are generated in parallel, and every row evaluates
+                the height and moisture noise of all its columns in one
+                fused pass before classifying the columns
+
+      Methods:  Generate
+                  Fills a height map with the generated terrain
+                TerrainGenerator
+                  Constructor.
+                ~TerrainGenerator
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TerrainGenerator
+    {
+    public:
+        static constexpr const UINT ROWS_PER_TILE = 16u;
+
+    public:
+        explicit TerrainGenerator(_In_ const TerrainDesc& desc);
+        TerrainGenerator(const TerrainGenerator& other) = delete;
+        TerrainGenerator(TerrainGenerator&& other) = delete;
+        TerrainGenerator& operator=(const TerrainGenerator& other) = delete;
+        TerrainGenerator& operator=(TerrainGenerator&& other) = delete;
+        ~TerrainGenerator() = default;
+
+        HRESULT Generate(_Out_ HeightMap& heightMap, _In_opt_ ThreadPool* pThreadPool = nullptr) const;
+
+    private:
+        void generateRows(_In_ UINT uBeginZ, _In_ UINT uEndZ, _Out_ BYTE* pBlockTypes, _Out_ WORD* pColumnHeights) const;
+
+        static eBlockType getBlockType(_In_ FLOAT height, _In_ FLOAT moisture);
+
+    private:
+        static constexpr const XMFLOAT4 PALETTE[] =
+        {
+            XMFLOAT4(0.0f,      0.666f, 0.0f,   1.0f),  // GRASSLAND
+            XMFLOAT4(1.0f,      1.0f,   1.0f,   1.0f),  // SNOW
+            XMFLOAT4(0.0f,      0.0f,   0.666f, 1.0f),  // OCEAN
+            XMFLOAT4(1.0f,      0.666f, 0.0f,   1.0f),  // SAND
+            XMFLOAT4(0.666f,    0.0f,   0.0f,   1.0f),  // SCORCHED
+            XMFLOAT4(0.956f,    0.643f, 0.376f, 1.0f),  // BARE
+            XMFLOAT4(0.941f,    0.0f,   1.0f,   1.0f),  // TUNDRA
+            XMFLOAT4(0.803f,    0.521f, 0.247f, 1.0f),  // TEMPERATE_DESERT
+            XMFLOAT4(0.42f,     0.556f, 0.137f, 1.0f),  // SHRUBLAND
+            XMFLOAT4(0.0f,      0.392f, 0.0f,   1.0f),  // TAIGA
+            XMFLOAT4(1.0f,      0.55f,  0.0f,   1.0f),  // TEMPERATE_DECIDUOUS_FOREST
+            XMFLOAT4(0.0f,      0.5f,   0.0f,   1.0f),  // TEMPERATE_RAIN_FOREST
+            XMFLOAT4(0.956f,    0.643f, 0.376f, 1.0f),  // SUBTROPICAL_DESERT
+            XMFLOAT4(0.133f,    0.545f, 0.133f, 1.0f),  // TROPICAL_SEASONAL_FOREST
+            XMFLOAT4(0.15f,     0.372f, 0.15f,  1.0f),  // TROPICAL_RAIN_FOREST
+        };
+        static_assert(ARRAYSIZE(PALETTE) == static_cast<size_t>(eBlockType::COUNT) - static_cast<size_t>(eBlockType::GRASSLAND));
+
+        TerrainDesc m_desc;
+    };
+}
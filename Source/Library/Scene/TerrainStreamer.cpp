@@ -0,0 +1,527 @@
+#include "Scene/TerrainStreamer.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::TerrainStreamer
+
+      Summary:  Constructor. Starts the loader threads
+
+      Args:     const TerrainStreamingDesc& desc
+                  Parameters of the streaming
+
+      Modifies: [m_desc, m_tiledHeightMap, m_tiles, m_lruTiles,
+                 m_tileLoads, m_aResidentChunks, m_iCenterTileX,
+                 m_iCenterTileZ, m_lastEye, m_bHasLastEye,
+                 m_threadPool].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TerrainStreamer::TerrainStreamer(_In_ const TerrainStreamingDesc& desc)
+        : m_desc(desc)
+        , m_tiledHeightMap()
+        , m_tiles()
+        , m_lruTiles()
+        , m_tileLoads()
+        , m_aResidentChunks()
+        , m_iCenterTileX(INT_MIN)
+        , m_iCenterTileZ(INT_MIN)
+        , m_lastEye()
+        , m_bHasLastEye(FALSE)
+        , m_threadPool((std::max)(desc.NumThreads, 1u))
+    {
+        const UINT uDiameter = 2u * m_desc.LoadRadius + 1u;
+        m_desc.MaxCachedTiles = (std::max)(m_desc.MaxCachedTiles, uDiameter * uDiameter);
+        m_desc.MaxLoadsInFlight = (std::max)(m_desc.MaxLoadsInFlight, 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::Open
+
+      Summary:  Opens the tiled world file. Nothing is loaded until
+                the first Update
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the tiled world file
+
+      Modifies: [m_tiledHeightMap].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TerrainStreamer::Open(_In_ const std::filesystem::path& filePath)
+    {
+        return m_tiledHeightMap.Open(filePath);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::Update
+
+      Summary:  Moves the loaded tiles into the cache, creating their
+                buffers, then queues the missing tiles within the load
+                radius. The queue is ordered by the distance to the
+                camera tile, shortened for tiles in the direction of
+                travel, which is the movement of the eye since the last
+                update or the forward vector when standing still.
+                Tiles outside the radius are evicted in LRU order when
+                the cache is over its budget
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set buffers
+                const XMVECTOR& eye
+                  Position of the camera
+                const XMVECTOR& forward
+                  Forward vector of the camera
+
+      Modifies: [m_tiles, m_lruTiles, m_tileLoads, m_aResidentChunks,
+                 m_iCenterTileX, m_iCenterTileZ, m_lastEye,
+                 m_bHasLastEye].
+
+      Returns:  HRESULT
+                  S_OK if the resident chunks changed, S_FALSE if not
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TerrainStreamer::Update(
+        _In_ ID3D11Device* pDevice,
+        _In_ ID3D11DeviceContext* pImmediateContext,
+        _In_ const XMVECTOR& eye,
+        _In_ const XMVECTOR& forward
+    )
+    {
+        const UINT uNumTilesX = m_tiledHeightMap.GetNumTilesX();
+        const UINT uNumTilesZ = m_tiledHeightMap.GetNumTilesZ();
+        if (uNumTilesX == 0u || uNumTilesZ == 0u)
+        {
+            return S_FALSE;
+        }
+
+        // A cube at the grid position (x, h, z) is centered at
+        // (2x - W, 2h - 1.25H, 2z - D)
+        XMFLOAT3 eyePosition;
+        XMStoreFloat3(&eyePosition, eye);
+        const FLOAT tileExtent = 2.0f * static_cast<FLOAT>(m_tiledHeightMap.GetTileSize());
+        const INT iCenterTileX = static_cast<INT>(floorf((eyePosition.x + static_cast<FLOAT>(m_tiledHeightMap.GetWidth())) / tileExtent));
+        const INT iCenterTileZ = static_cast<INT>(floorf((eyePosition.z + static_cast<FLOAT>(m_tiledHeightMap.GetDepth())) / tileExtent));
+
+        BOOL bChanged = iCenterTileX != m_iCenterTileX || iCenterTileZ != m_iCenterTileZ;
+        m_iCenterTileX = iCenterTileX;
+        m_iCenterTileZ = iCenterTileZ;
+
+        XMVECTOR direction = forward;
+        if (m_bHasLastEye)
+        {
+            const XMVECTOR movement = XMVectorSubtract(eye, XMLoadFloat3(&m_lastEye));
+            if (XMVectorGetX(XMVector2LengthSq(XMVectorSwizzle<XM_SWIZZLE_X, XM_SWIZZLE_Z, XM_SWIZZLE_Y, XM_SWIZZLE_W>(movement))) > 1e-6f)
+            {
+                direction = movement;
+            }
+        }
+        XMFLOAT3 travelDirection;
+        XMStoreFloat3(&travelDirection, XMVector3Normalize(XMVectorSetY(direction, 0.0f)));
+        m_lastEye = eyePosition;
+        m_bHasLastEye = TRUE;
+
+        for (auto it = m_tileLoads.begin(); it != m_tileLoads.end();)
+        {
+            TileLoad& tileLoad = *it->second;
+            if (tileLoad.Done.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                ++it;
+                continue;
+            }
+
+            const size_t uTileIdx = it->first;
+            if (FAILED(tileLoad.Result))
+            {
+                // Kept as an empty tile, so a broken tile is not read
+                // over and over
+                CHAR szMessage[128];
+                sprintf_s(szMessage, "Failed to load terrain tile %zu: 0x%08X\n", uTileIdx, static_cast<UINT>(tileLoad.Result));
+                OutputDebugStringA(szMessage);
+                tileLoad.Chunk = nullptr;
+            }
+            else if (tileLoad.Chunk)
+            {
+                HRESULT hr = tileLoad.Chunk->Initialize(pDevice, pImmediateContext);
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+            }
+
+            m_lruTiles.push_front(uTileIdx);
+            m_tiles.emplace(uTileIdx, TileEntry{ .Chunk = tileLoad.Chunk, .LruPosition = m_lruTiles.begin() });
+            if (tileLoad.Chunk && isInLoadRadius(static_cast<UINT>(uTileIdx % uNumTilesX), static_cast<UINT>(uTileIdx / uNumTilesX)))
+            {
+                bChanged = TRUE;
+            }
+
+            it = m_tileLoads.erase(it);
+        }
+
+        struct TileRequest
+        {
+            FLOAT Priority;
+            UINT TileX;
+            UINT TileZ;
+        };
+        std::vector<TileRequest> aTileRequests;
+
+        const INT iRadius = static_cast<INT>(m_desc.LoadRadius);
+        for (INT iOffsetZ = -iRadius; iOffsetZ <= iRadius; ++iOffsetZ)
+        {
+            for (INT iOffsetX = -iRadius; iOffsetX <= iRadius; ++iOffsetX)
+            {
+                const INT iTileX = iCenterTileX + iOffsetX;
+                const INT iTileZ = iCenterTileZ + iOffsetZ;
+                if (iTileX < 0 || iTileZ < 0 || iTileX >= static_cast<INT>(uNumTilesX) || iTileZ >= static_cast<INT>(uNumTilesZ) ||
+                    !isInLoadRadius(static_cast<UINT>(iTileX), static_cast<UINT>(iTileZ)))
+                {
+                    continue;
+                }
+
+                const size_t uTileIdx = static_cast<size_t>(iTileZ) * uNumTilesX + static_cast<size_t>(iTileX);
+                if (m_tiles.contains(uTileIdx))
+                {
+                    touchTile(uTileIdx);
+                    continue;
+                }
+
+                if (m_tileLoads.contains(uTileIdx))
+                {
+                    continue;
+                }
+
+                const FLOAT offsetX = static_cast<FLOAT>(iOffsetX);
+                const FLOAT offsetZ = static_cast<FLOAT>(iOffsetZ);
+                aTileRequests.push_back(
+                    TileRequest
+                    {
+                        .Priority = sqrtf(offsetX * offsetX + offsetZ * offsetZ) - DIRECTION_WEIGHT * (offsetX * travelDirection.x + offsetZ * travelDirection.z),
+                        .TileX = static_cast<UINT>(iTileX),
+                        .TileZ = static_cast<UINT>(iTileZ),
+                    }
+                );
+            }
+        }
+
+        std::sort(
+            aTileRequests.begin(),
+            aTileRequests.end(),
+            [](const TileRequest& a, const TileRequest& b) { return a.Priority < b.Priority; }
+        );
+        for (const TileRequest& tileRequest : aTileRequests)
+        {
+            if (m_tileLoads.size() >= m_desc.MaxLoadsInFlight)
+            {
+                break;
+            }
+
+            std::shared_ptr<TileLoad> tileLoad = std::make_shared<TileLoad>();
+            tileLoad->Result = S_OK;
+            const eVoxelExtractionMode extractionMode = m_desc.ExtractionMode;
+            const TiledHeightMap& tiledHeightMap = m_tiledHeightMap;
+            tileLoad->Done = m_threadPool.Submit(
+                [tileLoad, &tiledHeightMap, tileRequest, extractionMode]()
+                {
+                    HeightMapTile tile;
+                    tileLoad->Result = tiledHeightMap.ReadTile(tileRequest.TileX, tileRequest.TileZ, tile);
+                    if (SUCCEEDED(tileLoad->Result))
+                    {
+                        tileLoad->Chunk = createChunk(tiledHeightMap, tile, extractionMode);
+                    }
+                }
+            );
+            m_tileLoads.emplace(static_cast<size_t>(tileRequest.TileZ) * uNumTilesX + tileRequest.TileX, tileLoad);
+        }
+
+        evictTiles();
+
+        if (bChanged)
+        {
+            updateResidentChunks();
+        }
+
+        return bChanged ? S_OK : S_FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::GetResidentChunks
+
+      Summary:  Returns the loaded, non-empty chunks within the load
+                radius
+
+      Returns:  const std::vector<std::shared_ptr<VoxelChunk>>&
+                  Chunks to draw
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<std::shared_ptr<VoxelChunk>>& TerrainStreamer::GetResidentChunks() const
+    {
+        return m_aResidentChunks;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::GetTiledHeightMap
+
+      Summary:  Returns the tiled world
+
+      Returns:  const TiledHeightMap&
+                  Tiled world being streamed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const TiledHeightMap& TerrainStreamer::GetTiledHeightMap() const
+    {
+        return m_tiledHeightMap;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::isInLoadRadius
+
+      Summary:  Returns whether a tile is within the load radius of
+                the camera tile
+
+      Args:     UINT uTileX
+                  Tile coordinate along the x-axis
+                UINT uTileZ
+                  Tile coordinate along the z-axis
+
+      Returns:  BOOL
+                  TRUE if the tile should be resident
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL TerrainStreamer::isInLoadRadius(_In_ UINT uTileX, _In_ UINT uTileZ) const
+    {
+        const INT64 iOffsetX = static_cast<INT64>(uTileX) - m_iCenterTileX;
+        const INT64 iOffsetZ = static_cast<INT64>(uTileZ) - m_iCenterTileZ;
+        const INT64 iRadius = static_cast<INT64>(m_desc.LoadRadius);
+
+        return iOffsetX * iOffsetX + iOffsetZ * iOffsetZ <= iRadius * iRadius;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::touchTile
+
+      Summary:  Marks a cached tile as the most recently used
+
+      Args:     size_t uTileIdx
+                  Index of the tile
+
+      Modifies: [m_tiles, m_lruTiles].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainStreamer::touchTile(_In_ size_t uTileIdx)
+    {
+        TileEntry& tileEntry = m_tiles.at(uTileIdx);
+        m_lruTiles.splice(m_lruTiles.begin(), m_lruTiles, tileEntry.LruPosition);
+        tileEntry.LruPosition = m_lruTiles.begin();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::evictTiles
+
+      Summary:  Drops least recently used tiles until the cache fits
+                its budget. Tiles within the load radius are touched
+                every update, so reaching one of them means the rest of
+                the cache is needed as well
+
+      Modifies: [m_tiles, m_lruTiles].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainStreamer::evictTiles()
+    {
+        const UINT uNumTilesX = m_tiledHeightMap.GetNumTilesX();
+        while (m_tiles.size() > m_desc.MaxCachedTiles)
+        {
+            const size_t uTileIdx = m_lruTiles.back();
+            if (isInLoadRadius(static_cast<UINT>(uTileIdx % uNumTilesX), static_cast<UINT>(uTileIdx / uNumTilesX)))
+            {
+                break;
+            }
+
+            m_tiles.erase(uTileIdx);
+            m_lruTiles.pop_back();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::updateResidentChunks
+
+      Summary:  Collects the loaded chunks within the load radius
+
+      Modifies: [m_aResidentChunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainStreamer::updateResidentChunks()
+    {
+        const UINT uNumTilesX = m_tiledHeightMap.GetNumTilesX();
+        m_aResidentChunks.clear();
+        for (const std::pair<const size_t, TileEntry>& tile : m_tiles)
+        {
+            if (tile.second.Chunk && !tile.second.Chunk->IsEmpty() &&
+                isInLoadRadius(static_cast<UINT>(tile.first % uNumTilesX), static_cast<UINT>(tile.first / uNumTilesX)))
+            {
+                m_aResidentChunks.push_back(tile.second.Chunk);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::createChunk
+
+      Summary:  Builds the instanced chunk of a tile, like
+                Scene::createVoxels does for a whole height map. Runs
+                on a loader thread, so only the instance arrays are
+                built here and the buffers are created by Update.
+                Columns of neighboring tiles are not loaded, so SURFACE
+                extraction treats them as empty and keeps the cubes
+                along the tile edges. GREEDY_MESH is streamed as
+                SURFACE. Column heights are capped to the 16-bit
+                instance range
+
+      Args:     const TiledHeightMap& tiledHeightMap
+                  Tiled world the tile belongs to
+                const HeightMapTile& tile
+                  Columns of the tile
+                eVoxelExtractionMode extractionMode
+                  How the voxels are extracted from the columns
+
+      Returns:  std::shared_ptr<VoxelChunk>
+                  Chunk of the tile, nullptr if the tile has no cubes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::shared_ptr<VoxelChunk> TerrainStreamer::createChunk(
+        _In_ const TiledHeightMap& tiledHeightMap,
+        _In_ const HeightMapTile& tile,
+        _In_ eVoxelExtractionMode extractionMode
+    )
+    {
+        const UINT uTileSize = tiledHeightMap.GetTileSize();
+        const UINT uWidth = tiledHeightMap.GetWidth();
+        const UINT uHeight = tiledHeightMap.GetHeight();
+        const UINT uDepth = tiledHeightMap.GetDepth();
+        const UINT uNumColors = tiledHeightMap.GetNumColors();
+        const UINT uOriginX = tile.TileX * uTileSize;
+        const UINT uOriginZ = tile.TileZ * uTileSize;
+
+        auto getColumnHeight = [&](INT x, INT z) -> UINT
+        {
+            if (x < 0 || z < 0 || x >= static_cast<INT>(uTileSize) || z >= static_cast<INT>(uTileSize))
+            {
+                return 0u;
+            }
+
+            const size_t uColumnIdx = static_cast<size_t>(z) * uTileSize + static_cast<size_t>(x);
+            return tile.BlockTypes[uColumnIdx] < uNumColors ? (std::min)(static_cast<UINT>(tile.ColumnHeights[uColumnIdx]), SHRT_MAX + 1u) : 0u;
+        };
+
+        auto getLowestHeight = [&](INT x, INT z) -> UINT
+        {
+            if (extractionMode == eVoxelExtractionMode::FILLED_COLUMNS)
+            {
+                return 0u;
+            }
+
+            return (std::min)(
+                {
+                    getColumnHeight(x, z) - 1u,
+                    getColumnHeight(x - 1, z),
+                    getColumnHeight(x + 1, z),
+                    getColumnHeight(x, z - 1),
+                    getColumnHeight(x, z + 1),
+                }
+            );
+        };
+
+        std::vector<std::vector<VoxelInstanceData>> aVoxelInstanceData(uNumColors);
+        UINT uMinHeight = UINT_MAX;
+        UINT uMaxHeight = 0u;
+        for (INT z = 0; z < static_cast<INT>(uTileSize); ++z)
+        {
+            for (INT x = 0; x < static_cast<INT>(uTileSize); ++x)
+            {
+                const UINT uColumnHeight = getColumnHeight(x, z);
+                if (uColumnHeight == 0u)
+                {
+                    continue;
+                }
+
+                const UINT uLowestHeight = getLowestHeight(x, z);
+                std::vector<VoxelInstanceData>& aInstances = aVoxelInstanceData[tile.BlockTypes[static_cast<size_t>(z) * uTileSize + static_cast<size_t>(x)]];
+                for (UINT heightIdx = uLowestHeight; heightIdx < uColumnHeight; ++heightIdx)
+                {
+                    aInstances.push_back(
+                        VoxelInstanceData
+                        {
+                            .GridPosition =
+                            {
+                                static_cast<SHORT>(x),
+                                static_cast<SHORT>(heightIdx),
+                                static_cast<SHORT>(z),
+                                0,
+                            }
+                        }
+                    );
+                }
+                uMinHeight = (std::min)(uMinHeight, uLowestHeight);
+                uMaxHeight = (std::max)(uMaxHeight, uColumnHeight);
+            }
+        }
+
+        if (uMaxHeight == 0u)
+        {
+            return nullptr;
+        }
+
+        // Same bounds as Scene::getChunkBounds
+        const XMVECTOR minimum = XMVectorSet(
+            2.0f * static_cast<FLOAT>(uOriginX) - static_cast<FLOAT>(uWidth) - 1.0f,
+            2.0f * static_cast<FLOAT>(uMinHeight) - static_cast<FLOAT>(uHeight) * 1.25f - 1.0f,
+            2.0f * static_cast<FLOAT>(uOriginZ) - static_cast<FLOAT>(uDepth) - 1.0f,
+            0.0f
+        );
+        const XMVECTOR extent = XMVectorSet(
+            2.0f * static_cast<FLOAT>((std::min)(uTileSize, uWidth - uOriginX)),
+            2.0f * static_cast<FLOAT>(uMaxHeight - uMinHeight),
+            2.0f * static_cast<FLOAT>((std::min)(uTileSize, uDepth - uOriginZ)),
+            0.0f
+        );
+        BoundingBox bounds;
+        BoundingBox::CreateFromPoints(bounds, minimum, XMVectorAdd(minimum, extent));
+
+        std::shared_ptr<VoxelChunk> chunk = std::make_shared<VoxelChunk>(tile.TileX, tile.TileZ, bounds);
+
+        // The solid part of the tile below its lowest column occludes
+        UINT uMinColumnHeight = UINT_MAX;
+        for (INT z = 0; z < static_cast<INT>((std::min)(uTileSize, uDepth - uOriginZ)); ++z)
+        {
+            for (INT x = 0; x < static_cast<INT>((std::min)(uTileSize, uWidth - uOriginX)); ++x)
+            {
+                uMinColumnHeight = (std::min)(uMinColumnHeight, getColumnHeight(x, z));
+            }
+        }
+        if (uMinColumnHeight > 0u)
+        {
+            const XMVECTOR occluderMinimum = XMVectorSetY(minimum, -static_cast<FLOAT>(uHeight) * 1.25f - 1.0f);
+            const XMVECTOR occluderExtent = XMVectorSetY(extent, 2.0f * static_cast<FLOAT>(uMinColumnHeight));
+            BoundingBox occluderBounds;
+            BoundingBox::CreateFromPoints(occluderBounds, occluderMinimum, XMVectorAdd(occluderMinimum, occluderExtent));
+            chunk->SetOccluderBounds(occluderBounds);
+        }
+        for (UINT uColorIdx = 0u; uColorIdx < uNumColors; ++uColorIdx)
+        {
+            if (aVoxelInstanceData[uColorIdx].empty())
+            {
+                continue;
+            }
+
+            std::shared_ptr<Voxel> voxel = std::make_shared<Voxel>(std::move(aVoxelInstanceData[uColorIdx]), tiledHeightMap.GetColor(uColorIdx));
+            voxel->Translate(
+                XMVectorSet(
+                    2.0f * static_cast<FLOAT>(uOriginX) - static_cast<FLOAT>(uWidth),
+                    -static_cast<FLOAT>(uHeight) * 1.25f,
+                    2.0f * static_cast<FLOAT>(uOriginZ) - static_cast<FLOAT>(uDepth),
+                    0.0f
+                )
+            );
+            chunk->AddVoxel(static_cast<BYTE>(uColorIdx), voxel);
+        }
+
+        return chunk;
+    }
+}
@@ -0,0 +1,134 @@
+/*+===================================================================
+  File:      TERRAINSTREAMER.H
+
+  Summary:   TerrainStreamer header file contains declarations of
+             TerrainStreamer class that keeps the chunks of a tiled
+             voxel world around the camera resident.
+
+  Classes: TerrainStreamer
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <list>
+
+#include "Scene/TiledHeightMap.h"
+#include "Scene/VoxelChunk.h"
+#include "Thread/ThreadPool.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TerrainStreamingDesc
+
+      Summary:  Parameters of terrain streaming. Distances are in
+                tiles, a tile being one chunk of the terrain.
+                MaxCachedTiles caps the number of loaded tiles, it is
+                raised to the number of tiles within LoadRadius if
+                smaller
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TerrainStreamingDesc
+    {
+        UINT LoadRadius = 8u;
+        UINT MaxCachedTiles = 384u;
+        UINT MaxLoadsInFlight = 8u;
+        UINT NumThreads = 2u;
+        eVoxelExtractionMode ExtractionMode = eVoxelExtractionMode::SURFACE;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TerrainStreamer
+
+      Summary:  Streams the chunks of a tiled world around the camera.
+                Tiles within the load radius are read and turned into
+                instanced chunks on background threads, nearest first
+                and ahead of the camera before behind it. Loaded tiles
+                are kept in an LRU cache, tiles outside the radius are
+                evicted once the cache is full
+
+      Methods:  Open
+                  Opens the tiled world file
+                Update
+                  Schedules loads and collects the loaded chunks
+                GetResidentChunks
+                  Returns the loaded chunks within the load radius
+                GetTiledHeightMap
+                  Returns the tiled world
+                TerrainStreamer
+                  Constructor.
+                ~TerrainStreamer
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TerrainStreamer
+    {
+    public:
+        // Weight of the direction of travel in the load priority, a
+        // tile straight ahead counts as this much closer
+        static constexpr const FLOAT DIRECTION_WEIGHT = 0.5f;
+
+    private:
+        struct TileEntry
+        {
+            std::shared_ptr<VoxelChunk> Chunk;
+            std::list<size_t>::iterator LruPosition;
+        };
+
+        struct TileLoad
+        {
+            std::future<void> Done;
+            std::shared_ptr<VoxelChunk> Chunk;
+            HRESULT Result;
+        };
+
+    public:
+        explicit TerrainStreamer(_In_ const TerrainStreamingDesc& desc);
+        TerrainStreamer(const TerrainStreamer& other) = delete;
+        TerrainStreamer(TerrainStreamer&& other) = delete;
+        TerrainStreamer& operator=(const TerrainStreamer& other) = delete;
+        TerrainStreamer& operator=(TerrainStreamer&& other) = delete;
+        ~TerrainStreamer() = default;
+
+        HRESULT Open(_In_ const std::filesystem::path& filePath);
+        HRESULT Update(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ const XMVECTOR& eye,
+            _In_ const XMVECTOR& forward
+        );
+
+        const std::vector<std::shared_ptr<VoxelChunk>>& GetResidentChunks() const;
+        const TiledHeightMap& GetTiledHeightMap() const;
+
+    private:
+        BOOL isInLoadRadius(_In_ UINT uTileX, _In_ UINT uTileZ) const;
+        void touchTile(_In_ size_t uTileIdx);
+        void evictTiles();
+        void updateResidentChunks();
+
+        static std::shared_ptr<VoxelChunk> createChunk(
+            _In_ const TiledHeightMap& tiledHeightMap,
+            _In_ const HeightMapTile& tile,
+            _In_ eVoxelExtractionMode extractionMode
+        );
+
+    private:
+        TerrainStreamingDesc m_desc;
+        TiledHeightMap m_tiledHeightMap;
+
+        std::unordered_map<size_t, TileEntry> m_tiles;
+        std::list<size_t> m_lruTiles;
+        std::unordered_map<size_t, std::shared_ptr<TileLoad>> m_tileLoads;
+        std::vector<std::shared_ptr<VoxelChunk>> m_aResidentChunks;
+
+        INT m_iCenterTileX;
+        INT m_iCenterTileZ;
+        XMFLOAT3 m_lastEye;
+        BOOL m_bHasLastEye;
+
+        // Destroyed first, so no load outlives the tiled world
+        ThreadPool m_threadPool;
+    };
+}
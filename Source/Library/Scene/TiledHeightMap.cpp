@@ -0,0 +1,382 @@
+#include "Scene/TiledHeightMap.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TiledHeightMap::TiledHeightMap
+
+      Summary:  Constructor
+
+      Modifies: [m_header, m_aColors, m_hFile].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TiledHeightMap::TiledHeightMap()
+        : m_header()
+        , m_aColors()
+        , m_hFile(INVALID_HANDLE_VALUE)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TiledHeightMap::~TiledHeightMap
+
+      Summary:  Destructor. Closes the world file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TiledHeightMap::~TiledHeightMap()
+    {
+        release();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TiledHeightMap::Open
+
+      Summary:  Opens a tiled world file and reads its header and
+                palette. No tile is read
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the tiled world file
+
+      Modifies: [m_header, m_aColors, m_hFile].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TiledHeightMap::Open(_In_ const std::filesystem::path& filePath)
+    {
+        release();
+
+        m_hFile = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if (m_hFile == INVALID_HANDLE_VALUE)
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(m_hFile, &fileSize))
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            release();
+            return hr;
+        }
+
+        DWORD dwNumBytesRead = 0u;
+        if (!ReadFile(m_hFile, &m_header, sizeof(FileHeader), &dwNumBytesRead, nullptr) || dwNumBytesRead != sizeof(FileHeader))
+        {
+            release();
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+
+        const UINT64 ullFileSize = static_cast<UINT64>(fileSize.QuadPart);
+        const UINT64 ullPaletteEnd = sizeof(FileHeader) + static_cast<UINT64>(m_header.uNumColors) * sizeof(XMFLOAT4);
+        const UINT64 ullNumTiles = static_cast<UINT64>(m_header.uNumTilesX) * static_cast<UINT64>(m_header.uNumTilesZ);
+
+        if (m_header.dwMagic != FILE_MAGIC ||
+            m_header.dwVersion != FILE_VERSION ||
+            m_header.uTileSize == 0u ||
+            m_header.uNumTilesX != (m_header.uWidth + m_header.uTileSize - 1u) / m_header.uTileSize ||
+            m_header.uNumTilesZ != (m_header.uDepth + m_header.uTileSize - 1u) / m_header.uTileSize ||
+            ullPaletteEnd > m_header.ullTilesOffset ||
+            m_header.ullTilesOffset + ullNumTiles * getTileBytes() > ullFileSize)
+        {
+            release();
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+
+        m_aColors.resize(m_header.uNumColors);
+        const DWORD dwPaletteBytes = static_cast<DWORD>(m_aColors.size() * sizeof(XMFLOAT4));
+        if (!ReadFile(m_hFile, m_aColors.data(), dwPaletteBytes, &dwNumBytesRead, nullptr) || dwNumBytesRead != dwPaletteBytes)
+        {
+            release();
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TiledHeightMap::ReadTile
+
+      Summary:  Reads the columns of a tile with a single positional
+                read. Safe to call from several threads at once
+
+      Args:     UINT uTileX
+                  Tile coordinate along the x-axis
+                UINT uTileZ
+                  Tile coordinate along the z-axis
+                HeightMapTile& tile
+                  Receives the columns of the tile
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TiledHeightMap::ReadTile(_In_ UINT uTileX, _In_ UINT uTileZ, _Out_ HeightMapTile& tile) const
+    {
+        if (m_hFile == INVALID_HANDLE_VALUE)
+        {
+            return E_FAIL;
+        }
+
+        if (uTileX >= m_header.uNumTilesX || uTileZ >= m_header.uNumTilesZ)
+        {
+            return E_INVALIDARG;
+        }
+
+        const size_t uNumColumns = static_cast<size_t>(m_header.uTileSize) * m_header.uTileSize;
+        std::vector<BYTE> aTileData(static_cast<size_t>(getTileBytes()));
+
+        const UINT64 ullOffset = m_header.ullTilesOffset + (static_cast<UINT64>(uTileZ) * m_header.uNumTilesX + uTileX) * getTileBytes();
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(ullOffset & 0xFFFFFFFFu);
+        overlapped.OffsetHigh = static_cast<DWORD>(ullOffset >> 32u);
+
+        DWORD dwNumBytesRead = 0u;
+        if (!ReadFile(m_hFile, aTileData.data(), static_cast<DWORD>(aTileData.size()), &dwNumBytesRead, &overlapped))
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+        if (dwNumBytesRead != aTileData.size())
+        {
+            return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+        }
+
+        tile.TileX = uTileX;
+        tile.TileZ = uTileZ;
+        tile.ColumnHeights.resize(uNumColumns);
+        tile.BlockTypes.resize(uNumColumns);
+        memcpy(tile.ColumnHeights.data(), aTileData.data(), uNumColumns * sizeof(WORD));
+        memcpy(tile.BlockTypes.data(), aTileData.data() + uNumColumns * sizeof(WORD), uNumColumns * sizeof(BYTE));
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TiledHeightMap::ConvertHeightMap
+
+      Summary:  Writes a height map as a tiled world file. A
+                memory-mapped binary height map is read one tile at a
+                time, so this works for maps larger than memory too
+
+      Args:     const HeightMap& heightMap
+                  Height map to convert
+                const std::filesystem::path& filePath
+                  Path to the tiled world file to write
+                UINT uTileSize
+                  Number of columns along a tile edge
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TiledHeightMap::ConvertHeightMap(_In_ const HeightMap& heightMap, _In_ const std::filesystem::path& filePath, _In_ UINT uTileSize)
+    {
+        if (uTileSize == 0u)
+        {
+            return E_INVALIDARG;
+        }
+
+        const UINT uWidth = heightMap.GetWidth();
+        const UINT uDepth = heightMap.GetDepth();
+        FileHeader header =
+        {
+            .dwMagic = FILE_MAGIC,
+            .dwVersion = FILE_VERSION,
+            .uWidth = uWidth,
+            .uHeight = heightMap.GetHeight(),
+            .uDepth = uDepth,
+            .uNumColors = heightMap.GetNumColors(),
+            .uTileSize = uTileSize,
+            .uNumTilesX = (uWidth + uTileSize - 1u) / uTileSize,
+            .uNumTilesZ = (uDepth + uTileSize - 1u) / uTileSize,
+            .uReserved = 0u,
+            .ullTilesOffset = sizeof(FileHeader) + static_cast<UINT64>(heightMap.GetNumColors()) * sizeof(XMFLOAT4),
+        };
+
+        std::ofstream outputFile(filePath, std::ios::binary | std::ios::trunc);
+        if (!outputFile.is_open())
+        {
+            return HRESULT_FROM_WIN32(ERROR_CANNOT_MAKE);
+        }
+
+        outputFile.write(reinterpret_cast<const CHAR*>(&header), sizeof(header));
+        for (UINT uColorIdx = 0u; uColorIdx < header.uNumColors; ++uColorIdx)
+        {
+            outputFile.write(reinterpret_cast<const CHAR*>(&heightMap.GetColor(uColorIdx)), sizeof(XMFLOAT4));
+        }
+
+        const size_t uNumColumns = static_cast<size_t>(uTileSize) * uTileSize;
+        std::vector<WORD> aColumnHeights(uNumColumns);
+        std::vector<BYTE> aBlockTypes(uNumColumns);
+        for (UINT uTileZ = 0u; uTileZ < header.uNumTilesZ; ++uTileZ)
+        {
+            for (UINT uTileX = 0u; uTileX < header.uNumTilesX; ++uTileX)
+            {
+                std::fill(aColumnHeights.begin(), aColumnHeights.end(), static_cast<WORD>(0u));
+                std::fill(aBlockTypes.begin(), aBlockTypes.end(), HeightMap::INVALID_BLOCK_TYPE);
+
+                const UINT uOriginX = uTileX * uTileSize;
+                const UINT uOriginZ = uTileZ * uTileSize;
+                const UINT uEndX = (std::min)(uOriginX + uTileSize, uWidth);
+                const UINT uEndZ = (std::min)(uOriginZ + uTileSize, uDepth);
+                for (UINT uDepthIdx = uOriginZ; uDepthIdx < uEndZ; ++uDepthIdx)
+                {
+                    for (UINT uWidthIdx = uOriginX; uWidthIdx < uEndX; ++uWidthIdx)
+                    {
+                        const size_t uColumnIdx = static_cast<size_t>(uDepthIdx - uOriginZ) * uTileSize + (uWidthIdx - uOriginX);
+                        aBlockTypes[uColumnIdx] = heightMap.GetBlockType(uWidthIdx, uDepthIdx);
+                        aColumnHeights[uColumnIdx] = static_cast<WORD>(heightMap.GetColumnHeight(uWidthIdx, uDepthIdx));
+                    }
+                }
+
+                outputFile.write(reinterpret_cast<const CHAR*>(aColumnHeights.data()), static_cast<std::streamsize>(uNumColumns * sizeof(WORD)));
+                outputFile.write(reinterpret_cast<const CHAR*>(aBlockTypes.data()), static_cast<std::streamsize>(uNumColumns * sizeof(BYTE)));
+            }
+        }
+
+        if (outputFile.fail())
+        {
+            return HRESULT_FROM_WIN32(ERROR_WRITE_FAULT);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TiledHeightMap::GetWidth
+
+      Summary:  Returns the number of columns along the x-axis
+
+      Returns:  UINT
+                  Width of the world
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TiledHeightMap::GetWidth() const
+    {
+        return m_header.uWidth;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TiledHeightMap::GetHeight
+
+      Summary:  Returns the height scale of the world
+
+      Returns:  UINT
+                  Height of the world
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TiledHeightMap::GetHeight() const
+    {
+        return m_header.uHeight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TiledHeightMap::GetDepth
+
+      Summary:  Returns the number of columns along the z-axis
+
+      Returns:  UINT
+                  Depth of the world
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TiledHeightMap::GetDepth() const
+    {
+        return m_header.uDepth;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TiledHeightMap::GetNumColors
+
+      Summary:  Returns the number of palette colors
+
+      Returns:  UINT
+                  Number of block types
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TiledHeightMap::GetNumColors() const
+    {
+        return static_cast<UINT>(m_aColors.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TiledHeightMap::GetColor
+
+      Summary:  Returns the palette color of the given block type
+
+      Args:     UINT uIndex
+                  Palette index
+
+      Returns:  const XMFLOAT4&
+                  Color of the block type
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMFLOAT4& TiledHeightMap::GetColor(_In_ UINT uIndex) const
+    {
+        return m_aColors[uIndex];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TiledHeightMap::GetTileSize
+
+      Summary:  Returns the number of columns along a tile edge
+
+      Returns:  UINT
+                  Tile size
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TiledHeightMap::GetTileSize() const
+    {
+        return m_header.uTileSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TiledHeightMap::GetNumTilesX
+
+      Summary:  Returns the number of tiles along the x-axis
+
+      Returns:  UINT
+                  Number of tiles along the x-axis
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TiledHeightMap::GetNumTilesX() const
+    {
+        return m_header.uNumTilesX;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TiledHeightMap::GetNumTilesZ
+
+      Summary:  Returns the number of tiles along the z-axis
+
+      Returns:  UINT
+                  Number of tiles along the z-axis
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TiledHeightMap::GetNumTilesZ() const
+    {
+        return m_header.uNumTilesZ;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TiledHeightMap::release
+
+      Summary:  Closes the world file and clears the header
+
+      Modifies: [m_header, m_aColors, m_hFile].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TiledHeightMap::release()
+    {
+        if (m_hFile != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_hFile);
+            m_hFile = INVALID_HANDLE_VALUE;
+        }
+
+        m_header = FileHeader();
+        m_aColors.clear();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TiledHeightMap::getTileBytes
+
+      Summary:  Returns the size of a tile in the file
+
+      Returns:  UINT64
+                  Number of bytes per tile
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 TiledHeightMap::getTileBytes() const
+    {
+        return static_cast<UINT64>(m_header.uTileSize) * m_header.uTileSize * (sizeof(WORD) + sizeof(BYTE));
+    }
+}
@@ -0,0 +1,135 @@
+/*+===================================================================
+  File:      TILEDHEIGHTMAP.H
+
+  Summary:   TiledHeightMap header file contains declarations of
+             TiledHeightMap class that reads the block / height grid
+             of a voxel world one tile at a time, so that worlds larger
+             than memory can be streamed.
+
+  Classes: TiledHeightMap
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Scene/HeightMap.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   HeightMapTile
+
+      Summary:  Columns of one tile. Both arrays hold TileSize x
+                TileSize elements, row by row (x fastest). Columns past
+                the edge of the world have INVALID_BLOCK_TYPE
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct HeightMapTile
+    {
+        UINT TileX;
+        UINT TileZ;
+        std::vector<BYTE> BlockTypes;
+        std::vector<WORD> ColumnHeights;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TiledHeightMap
+
+      Summary:  Tiled voxel world (.vxw). Only the header and the
+                palette are kept in memory, tiles are read on demand
+                with positional reads, so any number of threads can
+                read tiles at the same time. Tiles are stored one after
+                another in row order and have a fixed size, a tile is
+                found without a directory
+
+      Methods:  Open
+                  Opens a tiled world file
+                ReadTile
+                  Reads the columns of a tile
+                ConvertHeightMap
+                  Writes a height map as a tiled world file
+                GetWidth
+                  Returns the number of columns along the x-axis
+                GetHeight
+                  Returns the height scale of the world
+                GetDepth
+                  Returns the number of columns along the z-axis
+                GetNumColors
+                  Returns the number of palette colors
+                GetColor
+                  Returns the palette color of the given block type
+                GetTileSize
+                  Returns the number of columns along a tile edge
+                GetNumTilesX
+                  Returns the number of tiles along the x-axis
+                GetNumTilesZ
+                  Returns the number of tiles along the z-axis
+                TiledHeightMap
+                  Constructor.
+                ~TiledHeightMap
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TiledHeightMap
+    {
+    public:
+        static constexpr const DWORD FILE_MAGIC = 0x54575856u; // "VXWT"
+        static constexpr const DWORD FILE_VERSION = 1u;
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   FileHeader
+
+          Summary:  Header of a tiled world file. The palette (XMFLOAT4
+                    x uNumColors) follows the header, the tiles start
+                    at ullTilesOffset. A tile holds the column heights
+                    (WORD x uTileSize x uTileSize) followed by the
+                    block types (BYTE x uTileSize x uTileSize)
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct FileHeader
+        {
+            DWORD dwMagic;
+            DWORD dwVersion;
+            UINT uWidth;
+            UINT uHeight;
+            UINT uDepth;
+            UINT uNumColors;
+            UINT uTileSize;
+            UINT uNumTilesX;
+            UINT uNumTilesZ;
+            UINT uReserved;
+            UINT64 ullTilesOffset;
+        };
+
+    public:
+        TiledHeightMap();
+        TiledHeightMap(const TiledHeightMap& other) = delete;
+        TiledHeightMap(TiledHeightMap&& other) = delete;
+        TiledHeightMap& operator=(const TiledHeightMap& other) = delete;
+        TiledHeightMap& operator=(TiledHeightMap&& other) = delete;
+        ~TiledHeightMap();
+
+        HRESULT Open(_In_ const std::filesystem::path& filePath);
+        HRESULT ReadTile(_In_ UINT uTileX, _In_ UINT uTileZ, _Out_ HeightMapTile& tile) const;
+
+        static HRESULT ConvertHeightMap(_In_ const HeightMap& heightMap, _In_ const std::filesystem::path& filePath, _In_ UINT uTileSize);
+
+        UINT GetWidth() const;
+        UINT GetHeight() const;
+        UINT GetDepth() const;
+        UINT GetNumColors() const;
+        const XMFLOAT4& GetColor(_In_ UINT uIndex) const;
+        UINT GetTileSize() const;
+        UINT GetNumTilesX() const;
+        UINT GetNumTilesZ() const;
+
+    private:
+        void release();
+        UINT64 getTileBytes() const;
+
+    private:
+        FileHeader m_header;
+        std::vector<XMFLOAT4> m_aColors;
+        HANDLE m_hFile;
+    };
+}
@@ -1,5 +1,8 @@
 #include "Scene/Voxel.h"
 
+#include <algorithm>
+#include <climits>
+
 #include "Texture/Material.h"
 
 namespace library
@@ -15,6 +18,10 @@ namespace library
     --------------------------------------------------------------------*/
     Voxel::Voxel(_In_ const XMFLOAT4& outputColor)
         : InstancedRenderable(outputColor)
+        , m_aVoxelInstanceData()
+        , m_voxelInstanceIndices()
+        , m_bQuantized(FALSE)
+        , m_bIndexed(FALSE)
     {
 
     }
@@ -32,11 +39,32 @@ namespace library
     --------------------------------------------------------------------*/
     Voxel::Voxel(_In_ std::vector<InstanceData>&& aInstanceData, _In_ const XMFLOAT4& outputColor)
         : InstancedRenderable(std::move(aInstanceData), outputColor)
+        , m_aVoxelInstanceData()
+        , m_voxelInstanceIndices()
+        , m_bQuantized(FALSE)
+        , m_bIndexed(FALSE)
     {
 
     }
 
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Voxel::Voxel
+      Summary:  Constructor
+      Args:     std::vector<VoxelInstanceData>&& aVoxelInstanceData
+                  Quantized instance data, grid positions of the cubes
+                const XMFLOAT4& outputColor
+                  Color of the voxel
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Voxel::Voxel(_In_ std::vector<VoxelInstanceData>&& aVoxelInstanceData, _In_ const XMFLOAT4& outputColor)
+        : InstancedRenderable(outputColor)
+        , m_aVoxelInstanceData(std::move(aVoxelInstanceData))
+        , m_voxelInstanceIndices()
+        , m_bQuantized(TRUE)
+        , m_bIndexed(FALSE)
+    {
+    }
+
     HRESULT Voxel::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
     {
         BasicMeshEntry basicMeshEntry;
@@ -142,4 +170,247 @@ namespace library
         return INDICES;
     }
 
-}
\ No newline at end of file
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Voxel::SetVoxelInstanceData
+      Summary:  Sets the quantized instance data. The voxel is drawn
+                from the grid positions from now on
+
+      Args:     std::vector<VoxelInstanceData>&& aVoxelInstanceData
+                  Quantized instance data
+
+      Modifies: [m_aVoxelInstanceData, m_aInstanceData,
+                 m_voxelInstanceIndices, m_bQuantized, m_bIndexed,
+                 m_aDirtyInstanceRanges].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Voxel::SetVoxelInstanceData(_In_ std::vector<VoxelInstanceData>&& aVoxelInstanceData)
+    {
+        m_aVoxelInstanceData = std::move(aVoxelInstanceData);
+        m_aInstanceData.clear();
+        m_voxelInstanceIndices.clear();
+        m_bQuantized = TRUE;
+        m_bIndexed = FALSE;
+        m_bHasInstanceBounds = FALSE;
+        markInstancesDirty(0u, GetNumInstances());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Voxel::AddVoxelInstance
+      Summary:  Adds a cube at a grid position of a quantized voxel.
+                Nothing is added if the position is already occupied
+
+      Args:     const VoxelInstanceData& voxelInstanceData
+                  Grid position of the cube
+
+      Modifies: [m_aVoxelInstanceData, m_voxelInstanceIndices,
+                 m_aDirtyInstanceRanges].
+
+      Returns:  UINT
+                  Index of the instance at the position
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Voxel::AddVoxelInstance(_In_ const VoxelInstanceData& voxelInstanceData)
+    {
+        buildInstanceIndices();
+
+        const UINT64 uKey = getGridKey(voxelInstanceData.GridPosition[0], voxelInstanceData.GridPosition[1], voxelInstanceData.GridPosition[2]);
+        auto it = m_voxelInstanceIndices.find(uKey);
+        if (it != m_voxelInstanceIndices.end())
+        {
+            return it->second;
+        }
+
+        const UINT uIndex = static_cast<UINT>(m_aVoxelInstanceData.size());
+        m_aVoxelInstanceData.push_back(voxelInstanceData);
+        m_voxelInstanceIndices.emplace(uKey, uIndex);
+        markInstancesDirty(uIndex, uIndex + 1u);
+
+        return uIndex;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Voxel::RemoveVoxelInstance
+      Summary:  Removes the cube at a grid position of a quantized
+                voxel. The last instance is moved into the freed slot,
+                so a removal uploads at most one instance
+
+      Args:     SHORT x
+                  Grid position along the x-axis
+                SHORT y
+                  Grid position along the y-axis
+                SHORT z
+                  Grid position along the z-axis
+
+      Modifies: [m_aVoxelInstanceData, m_voxelInstanceIndices,
+                 m_aDirtyInstanceRanges].
+
+      Returns:  BOOL
+                  TRUE if there was a cube at the position
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Voxel::RemoveVoxelInstance(_In_ SHORT x, _In_ SHORT y, _In_ SHORT z)
+    {
+        buildInstanceIndices();
+
+        auto it = m_voxelInstanceIndices.find(getGridKey(x, y, z));
+        if (it == m_voxelInstanceIndices.end())
+        {
+            return FALSE;
+        }
+
+        const UINT uIndex = it->second;
+        const UINT uLastIndex = static_cast<UINT>(m_aVoxelInstanceData.size()) - 1u;
+        m_voxelInstanceIndices.erase(it);
+        if (uIndex != uLastIndex)
+        {
+            const VoxelInstanceData& lastInstance = m_aVoxelInstanceData[uLastIndex];
+            m_voxelInstanceIndices[getGridKey(lastInstance.GridPosition[0], lastInstance.GridPosition[1], lastInstance.GridPosition[2])] = uIndex;
+            m_aVoxelInstanceData[uIndex] = lastInstance;
+            markInstancesDirty(uIndex, uIndex + 1u);
+        }
+        m_aVoxelInstanceData.pop_back();
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Voxel::IsQuantized
+      Summary:  Returns whether the instances are quantized grid
+                positions instead of transformation matrices
+
+      Returns:  BOOL
+                  Whether the instances are quantized
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Voxel::IsQuantized() const
+    {
+        return m_bQuantized;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Voxel::GetNumInstances
+      Summary:  Returns the number of instances
+
+      Returns:  UINT
+                  Number of instances
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Voxel::GetNumInstances() const
+    {
+        return IsQuantized() ? static_cast<UINT>(m_aVoxelInstanceData.size()) : InstancedRenderable::GetNumInstances();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Voxel::GetInstanceStride
+      Summary:  Returns the size of an instance in the instance buffer
+
+      Returns:  UINT
+                  Size of an instance in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Voxel::GetInstanceStride() const
+    {
+        return IsQuantized() ? static_cast<UINT>(sizeof(VoxelInstanceData)) : InstancedRenderable::GetInstanceStride();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Voxel::getInstanceData
+      Summary:  Returns the instance data uploaded to the instance
+                buffer
+
+      Returns:  const void*
+                  Pointer to the instance data
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const void* Voxel::getInstanceData() const
+    {
+        return IsQuantized() ? static_cast<const void*>(m_aVoxelInstanceData.data()) : InstancedRenderable::getInstanceData();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Voxel::computeInstanceBounds
+      Summary:  Computes the local bounding box of a range of
+                instances. Quantized cubes are 2 units wide and
+                centered at twice their grid position
+
+      Args:     UINT uBegin
+                  Index of the first instance
+                UINT uEnd
+                  One past the index of the last instance
+                BoundingBox& bounds
+                  Receives the bounding box in the space of the voxel
+
+      Returns:  BOOL
+                  FALSE if the range has no instances
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Voxel::computeInstanceBounds(_In_ UINT uBegin, _In_ UINT uEnd, _Out_ BoundingBox& bounds) const
+    {
+        if (!IsQuantized())
+        {
+            return InstancedRenderable::computeInstanceBounds(uBegin, uEnd, bounds);
+        }
+
+        uEnd = (std::min)(uEnd, static_cast<UINT>(m_aVoxelInstanceData.size()));
+        if (uBegin >= uEnd)
+        {
+            return FALSE;
+        }
+
+        SHORT aMin[3] = { SHRT_MAX, SHRT_MAX, SHRT_MAX };
+        SHORT aMax[3] = { SHRT_MIN, SHRT_MIN, SHRT_MIN };
+        for (UINT i = uBegin; i < uEnd; ++i)
+        {
+            for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+            {
+                aMin[uAxis] = (std::min)(aMin[uAxis], m_aVoxelInstanceData[i].GridPosition[uAxis]);
+                aMax[uAxis] = (std::max)(aMax[uAxis], m_aVoxelInstanceData[i].GridPosition[uAxis]);
+            }
+        }
+
+        BoundingBox::CreateFromPoints(
+            bounds,
+            XMVectorSet(2.0f * aMin[0] - 1.0f, 2.0f * aMin[1] - 1.0f, 2.0f * aMin[2] - 1.0f, 0.0f),
+            XMVectorSet(2.0f * aMax[0] + 1.0f, 2.0f * aMax[1] + 1.0f, 2.0f * aMax[2] + 1.0f, 0.0f)
+        );
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Voxel::getGridKey
+      Summary:  Packs a grid position into a lookup key
+
+      Args:     SHORT x
+                  Grid position along the x-axis
+                SHORT y
+                  Grid position along the y-axis
+                SHORT z
+                  Grid position along the z-axis
+
+      Returns:  UINT64
+                  Key of the grid position
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 Voxel::getGridKey(_In_ SHORT x, _In_ SHORT y, _In_ SHORT z)
+    {
+        return static_cast<UINT64>(static_cast<USHORT>(x))
+            | (static_cast<UINT64>(static_cast<USHORT>(y)) << 16u)
+            | (static_cast<UINT64>(static_cast<USHORT>(z)) << 32u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Voxel::buildInstanceIndices
+      Summary:  Builds the grid position to instance index lookup on
+                the first edit, voxels that are never edited do not pay
+                for it
+
+      Modifies: [m_voxelInstanceIndices, m_bIndexed].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Voxel::buildInstanceIndices()
+    {
+        if (m_bIndexed)
+        {
+            return;
+        }
+
+        m_voxelInstanceIndices.reserve(m_aVoxelInstanceData.size());
+        for (UINT i = 0u; i < static_cast<UINT>(m_aVoxelInstanceData.size()); ++i)
+        {
+            const VoxelInstanceData& instance = m_aVoxelInstanceData[i];
+            m_voxelInstanceIndices.emplace(getGridKey(instance.GridPosition[0], instance.GridPosition[1], instance.GridPosition[2]), i);
+        }
+        m_bIndexed = TRUE;
+    }
+}
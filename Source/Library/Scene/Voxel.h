@@ -21,9 +21,26 @@ namespace library
     /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
       Class:    Voxel
 
-      Summary:  Base class for renderable 3d cube object
-
-      Methods:  Voxel
+      Summary:  Base class for renderable 3d cube object. The
+                instances are either full transformation matrices or
+                quantized grid positions on the 2-unit voxel grid
+
+      Methods:  SetVoxelInstanceData
+                  Sets the quantized instance data
+                AddVoxelInstance
+                  Adds a cube at a grid position
+                RemoveVoxelInstance
+                  Removes the cube at a grid position
+                IsQuantized
+                  Returns whether the instances are grid positions
+                GetNumInstances
+                  Returns the number of instances
+                GetInstanceStride
+                  Returns the size of an instance in bytes
+                computeInstanceBounds
+                  Computes the local bounding box of a range of
+                  instances
+                Voxel
                   Constructor.
                 ~Voxel
                   Destructor.
@@ -33,6 +50,7 @@ namespace library
     public:
         Voxel(_In_ const XMFLOAT4& outputColor);
         Voxel(_In_ std::vector<InstanceData>&& aInstanceData, _In_ const XMFLOAT4& outputColor);
+        Voxel(_In_ std::vector<VoxelInstanceData>&& aVoxelInstanceData, _In_ const XMFLOAT4& outputColor);
         Voxel(const Voxel& other) = delete;
         Voxel(Voxel&& other) = delete;
         Voxel& operator=(const Voxel& other) = delete;
@@ -42,12 +60,22 @@ namespace library
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext) override;
         virtual void Update(_In_ FLOAT deltaTime) override;
 
+        void SetVoxelInstanceData(_In_ std::vector<VoxelInstanceData>&& aVoxelInstanceData);
+        UINT AddVoxelInstance(_In_ const VoxelInstanceData& voxelInstanceData);
+        BOOL RemoveVoxelInstance(_In_ SHORT x, _In_ SHORT y, _In_ SHORT z);
+        BOOL IsQuantized() const;
+
+        UINT GetNumInstances() const override;
+        UINT GetInstanceStride() const override;
+
         UINT GetNumVertices() const override;
         UINT GetNumIndices() const override;
 
     protected:
         const SimpleVertex* getVertices() const override;
         const WORD* getIndices() const override;
+        const void* getInstanceData() const override;
+        BOOL computeInstanceBounds(_In_ UINT uBegin, _In_ UINT uEnd, _Out_ BoundingBox& bounds) const override;
 
         static constexpr const SimpleVertex VERTICES[] =
         {
@@ -103,5 +131,15 @@ namespace library
             23,20,22
         };
         static constexpr const UINT NUM_INDICES = 36u;
+
+    private:
+        static UINT64 getGridKey(_In_ SHORT x, _In_ SHORT y, _In_ SHORT z);
+        void buildInstanceIndices();
+
+    private:
+        std::vector<VoxelInstanceData> m_aVoxelInstanceData;
+        std::unordered_map<UINT64, UINT> m_voxelInstanceIndices;
+        BOOL m_bQuantized;
+        BOOL m_bIndexed;
     };
 }
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include "Scene/VoxelChunk.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::VoxelChunk
+
+      Summary:  Constructor
+
+      Args:     UINT uChunkX
+                  Chunk coordinate along the x-axis
+                UINT uChunkZ
+                  Chunk coordinate along the z-axis
+                const BoundingBox& bounds
+                  World space bounds of the cubes of the chunk
+
+      Modifies: [m_uChunkX, m_uChunkZ, m_bounds, m_occluderBounds,
+                 m_bHasOccluder, m_voxels, m_aBlockTypes, m_voxelMesh].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelChunk::VoxelChunk(_In_ UINT uChunkX, _In_ UINT uChunkZ, _In_ const BoundingBox& bounds)
+        : m_uChunkX(uChunkX)
+        , m_uChunkZ(uChunkZ)
+        , m_bounds(bounds)
+        , m_occluderBounds()
+        , m_bHasOccluder(FALSE)
+        , m_voxels()
+        , m_aBlockTypes()
+        , m_voxelMesh()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::Initialize
+
+      Summary:  Creates the vertex, index and instance buffers of the
+                voxels and the buffers of the mesh
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set buffers
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelChunk::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        for (std::shared_ptr<Voxel>& voxel : m_voxels)
+        {
+            HRESULT hr = voxel->Initialize(pDevice, pImmediateContext);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        if (m_voxelMesh)
+        {
+            HRESULT hr = m_voxelMesh->Initialize(pDevice, pImmediateContext);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::AddVoxel
+
+      Summary:  Adds the instanced voxel of a block type
+
+      Args:     BYTE uBlockType
+                  Palette index of the voxel
+                const std::shared_ptr<Voxel>& voxel
+                  Voxel whose instances lie inside the chunk
+
+      Modifies: [m_voxels, m_aBlockTypes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelChunk::AddVoxel(_In_ BYTE uBlockType, _In_ const std::shared_ptr<Voxel>& voxel)
+    {
+        m_voxels.push_back(voxel);
+        m_aBlockTypes.push_back(uBlockType);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetVoxel
+
+      Summary:  Returns the instanced voxel of a block type
+
+      Args:     BYTE uBlockType
+                  Palette index of the voxel
+
+      Returns:  std::shared_ptr<Voxel>
+                  Voxel of the block type, nullptr if the chunk has none
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::shared_ptr<Voxel> VoxelChunk::GetVoxel(_In_ BYTE uBlockType) const
+    {
+        for (size_t i = 0u; i < m_voxels.size(); ++i)
+        {
+            if (m_aBlockTypes[i] == uBlockType)
+            {
+                return m_voxels[i];
+            }
+        }
+
+        return nullptr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::SetVoxelMesh
+
+      Summary:  Sets the greedy mesh of the chunk
+
+      Args:     const std::shared_ptr<VoxelMesh>& voxelMesh
+                  Greedy mesh of the columns of the chunk
+
+      Modifies: [m_voxelMesh].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelChunk::SetVoxelMesh(_In_ const std::shared_ptr<VoxelMesh>& voxelMesh)
+    {
+        m_voxelMesh = voxelMesh;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::SetBounds
+
+      Summary:  Sets the world space bounding box of the chunk
+
+      Args:     const BoundingBox& bounds
+                  Bounds of all the cubes of the chunk
+
+      Modifies: [m_bounds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelChunk::SetBounds(_In_ const BoundingBox& bounds)
+    {
+        m_bounds = bounds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::ExpandBounds
+
+      Summary:  Grows the bounding box of the chunk to contain a box,
+                e.g. a cube added by an edit. Removals never shrink it
+
+      Args:     const BoundingBox& bounds
+                  Box to contain
+
+      Modifies: [m_bounds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelChunk::ExpandBounds(_In_ const BoundingBox& bounds)
+    {
+        BoundingBox::CreateMerged(m_bounds, m_bounds, bounds);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::SetOccluderBounds
+
+      Summary:  Sets the world space box that is completely filled or
+                enclosed by the cubes of the chunk, from the bottom of
+                the terrain to its lowest column. Seen from above the
+                terrain, nothing behind it is visible
+
+      Args:     const BoundingBox& occluderBounds
+                  Solid box of the chunk
+
+      Modifies: [m_occluderBounds, m_bHasOccluder].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelChunk::SetOccluderBounds(_In_ const BoundingBox& occluderBounds)
+    {
+        m_occluderBounds = occluderBounds;
+        m_bHasOccluder = TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::ClearOccluderBounds
+
+      Summary:  Removes the occluder box, e.g. when an edit may have
+                carved into it
+
+      Modifies: [m_bHasOccluder].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelChunk::ClearOccluderBounds()
+    {
+        m_bHasOccluder = FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetChunkX
+
+      Summary:  Returns the chunk coordinate along the x-axis
+
+      Returns:  UINT
+                  Index of the first column divided by CHUNK_SIZE
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelChunk::GetChunkX() const
+    {
+        return m_uChunkX;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetChunkZ
+
+      Summary:  Returns the chunk coordinate along the z-axis
+
+      Returns:  UINT
+                  Index of the first row divided by CHUNK_SIZE
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelChunk::GetChunkZ() const
+    {
+        return m_uChunkZ;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetBounds
+
+      Summary:  Returns the world space bounding box of the chunk
+
+      Returns:  const BoundingBox&
+                  Bounds of all the cubes of the chunk
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BoundingBox& VoxelChunk::GetBounds() const
+    {
+        return m_bounds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::HasOccluder
+
+      Summary:  Returns whether the chunk has an occluder box
+
+      Returns:  BOOL
+                  TRUE if GetOccluderBounds is valid
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelChunk::HasOccluder() const
+    {
+        return m_bHasOccluder;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetOccluderBounds
+
+      Summary:  Returns the solid box of the chunk
+
+      Returns:  const BoundingBox&
+                  World space occluder box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BoundingBox& VoxelChunk::GetOccluderBounds() const
+    {
+        return m_occluderBounds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetVoxels
+
+      Summary:  Returns the instanced voxels of the chunk
+
+      Returns:  std::vector<std::shared_ptr<Voxel>>&
+                  One voxel per block type present in the chunk
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<std::shared_ptr<Voxel>>& VoxelChunk::GetVoxels()
+    {
+        return m_voxels;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetVoxelMesh
+
+      Summary:  Returns the greedy mesh of the chunk
+
+      Returns:  std::shared_ptr<VoxelMesh>&
+                  Greedy mesh, nullptr if the chunk is instanced
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::shared_ptr<VoxelMesh>& VoxelChunk::GetVoxelMesh()
+    {
+        return m_voxelMesh;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetNumInstances
+
+      Summary:  Returns the number of voxel instances of the chunk
+
+      Returns:  size_t
+                  Sum of the instances of all the voxels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t VoxelChunk::GetNumInstances() const
+    {
+        size_t uNumInstances = 0u;
+        for (const std::shared_ptr<Voxel>& voxel : m_voxels)
+        {
+            uNumInstances += voxel->GetNumInstances();
+        }
+
+        return uNumInstances;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::IsEmpty
+
+      Summary:  Returns whether the chunk has nothing to draw
+
+      Returns:  BOOL
+                  TRUE if there are no voxels and no mesh indices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelChunk::IsEmpty() const
+    {
+        return m_voxels.empty() && (!m_voxelMesh || m_voxelMesh->GetNumIndices() == 0u);
+    }
+}
@@ -0,0 +1,115 @@
+/*+===================================================================
+  File:      VOXELCHUNK.H
+
+  Summary:   VoxelChunk header file contains declarations of
+             VoxelChunk class, a fixed-size block of columns of a
+             voxel scene that is drawn, culled and updated as a unit.
+
+  Classes: VoxelChunk
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <DirectXCollision.h>
+
+#include "Scene/Voxel.h"
+#include "Scene/VoxelMesh.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelChunk
+
+      Summary:  CHUNK_SIZE x CHUNK_SIZE columns of the voxel terrain.
+                The chunk owns one instanced voxel per block type, each
+                with its own instance buffer, or the greedy mesh of its
+                columns, together with the world space bounds of all
+                of them. Every voxel of the chunk is one instanced
+                draw, the mesh is one draw per block type
+
+      Methods:  Initialize
+                  Creates the buffers of the voxels and the mesh
+                AddVoxel
+                  Adds the instanced voxel of a block type
+                GetVoxel
+                  Returns the instanced voxel of a block type
+                SetVoxelMesh
+                  Sets the greedy mesh of the chunk
+                GetChunkX
+                  Returns the chunk coordinate along the x-axis
+                GetChunkZ
+                  Returns the chunk coordinate along the z-axis
+                SetBounds
+                  Sets the world space bounding box
+                ExpandBounds
+                  Grows the bounding box to contain a box
+                SetOccluderBounds
+                  Sets the solid box used as an occluder
+                ClearOccluderBounds
+                  Removes the occluder box
+                GetBounds
+                  Returns the world space bounding box
+                HasOccluder
+                  Returns whether the chunk has an occluder box
+                GetOccluderBounds
+                  Returns the occluder box
+                GetVoxels
+                  Returns the instanced voxels
+                GetVoxelMesh
+                  Returns the greedy mesh
+                GetNumInstances
+                  Returns the number of voxel instances
+                IsEmpty
+                  Returns whether there is nothing to draw
+                VoxelChunk
+                  Constructor.
+                ~VoxelChunk
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelChunk
+    {
+    public:
+        static constexpr const UINT CHUNK_SIZE = 32u;
+
+    public:
+        VoxelChunk(_In_ UINT uChunkX, _In_ UINT uChunkZ, _In_ const BoundingBox& bounds);
+        VoxelChunk(const VoxelChunk& other) = delete;
+        VoxelChunk(VoxelChunk&& other) = delete;
+        VoxelChunk& operator=(const VoxelChunk& other) = delete;
+        VoxelChunk& operator=(VoxelChunk&& other) = delete;
+        ~VoxelChunk() = default;
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+
+        void AddVoxel(_In_ BYTE uBlockType, _In_ const std::shared_ptr<Voxel>& voxel);
+        std::shared_ptr<Voxel> GetVoxel(_In_ BYTE uBlockType) const;
+        void SetVoxelMesh(_In_ const std::shared_ptr<VoxelMesh>& voxelMesh);
+        void SetBounds(_In_ const BoundingBox& bounds);
+        void ExpandBounds(_In_ const BoundingBox& bounds);
+        void SetOccluderBounds(_In_ const BoundingBox& occluderBounds);
+        void ClearOccluderBounds();
+
+        UINT GetChunkX() const;
+        UINT GetChunkZ() const;
+        const BoundingBox& GetBounds() const;
+        BOOL HasOccluder() const;
+        const BoundingBox& GetOccluderBounds() const;
+        std::vector<std::shared_ptr<Voxel>>& GetVoxels();
+        std::shared_ptr<VoxelMesh>& GetVoxelMesh();
+        size_t GetNumInstances() const;
+        BOOL IsEmpty() const;
+
+    private:
+        UINT m_uChunkX;
+        UINT m_uChunkZ;
+        BoundingBox m_bounds;
+        BoundingBox m_occluderBounds;
+        BOOL m_bHasOccluder;
+        std::vector<std::shared_ptr<Voxel>> m_voxels;
+        std::vector<BYTE> m_aBlockTypes;
+        std::shared_ptr<VoxelMesh> m_voxelMesh;
+    };
+}
@@ -0,0 +1,104 @@
+#include "Scene/VoxelInstanceExtractor.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceExtractor::GetLowestHeight
+
+      Summary:  Returns the height index of the lowest cube emitted for
+                a non-empty column
+
+      Args:     const VoxelGridView& grid
+                  Block / height grid
+                uint32_t x
+                  Column along the x-axis
+                uint32_t z
+                  Column along the z-axis
+                bool bSurface
+                  Whether only the surface cubes are emitted
+
+      Returns:  uint32_t
+                  0 when the whole column is filled, otherwise the
+                  lower of the top cube and the lowest neighbor
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t VoxelInstanceExtractor::GetLowestHeight(const VoxelGridView& grid, uint32_t x, uint32_t z, bool bSurface)
+    {
+        if (!bSurface)
+        {
+            return 0u;
+        }
+
+        const int64_t iX = static_cast<int64_t>(x);
+        const int64_t iZ = static_cast<int64_t>(z);
+        return (std::min)(
+            {
+                grid.GetColumnHeight(iX, iZ) - 1u,
+                grid.GetColumnHeight(iX - 1, iZ),
+                grid.GetColumnHeight(iX + 1, iZ),
+                grid.GetColumnHeight(iX, iZ - 1),
+                grid.GetColumnHeight(iX, iZ + 1),
+            }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstanceExtractor::CountChunk
+
+      Summary:  Counts the instances of a chunk per block type
+
+      Args:     const VoxelGridView& grid
+                  Block / height grid
+                bool bSurface
+                  Whether only the surface cubes are emitted
+                uint32_t uOriginX
+                  First column of the chunk along the x-axis
+                uint32_t uOriginZ
+                  First column of the chunk along the z-axis
+                uint32_t uSizeX
+                  Number of columns of the chunk along the x-axis
+                uint32_t uSizeZ
+                  Number of columns of the chunk along the z-axis
+                ChunkInstanceCounts& outCounts
+                  Instance counts and height range of the chunk. The
+                  height range is empty (MaxHeight of 0) when the
+                  chunk has no instances
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelInstanceExtractor::CountChunk(
+        const VoxelGridView& grid,
+        bool bSurface,
+        uint32_t uOriginX,
+        uint32_t uOriginZ,
+        uint32_t uSizeX,
+        uint32_t uSizeZ,
+        ChunkInstanceCounts& outCounts
+    )
+    {
+        outCounts.NumInstances.assign(grid.NumBlockTypes, 0u);
+        outCounts.NumFilledInstances = 0u;
+        outCounts.MinHeight = UINT_MAX;
+        outCounts.MaxHeight = 0u;
+        outCounts.MinColumnHeight = UINT_MAX;
+
+        for (uint32_t z = uOriginZ; z < uOriginZ + uSizeZ; ++z)
+        {
+            for (uint32_t x = uOriginX; x < uOriginX + uSizeX; ++x)
+            {
+                const uint32_t uColumnHeight = grid.GetColumnHeight(x, z);
+                outCounts.MinColumnHeight = (std::min)(outCounts.MinColumnHeight, uColumnHeight);
+                if (uColumnHeight == 0u)
+                {
+                    continue;
+                }
+
+                const uint32_t uLowestHeight = GetLowestHeight(grid, x, z, bSurface);
+                outCounts.NumFilledInstances += uColumnHeight;
+                outCounts.NumInstances[grid.GetBlockType(x, z)] += uColumnHeight - uLowestHeight;
+                outCounts.MinHeight = (std::min)(outCounts.MinHeight, uLowestHeight);
+                outCounts.MaxHeight = (std::max)(outCounts.MaxHeight, uColumnHeight);
+            }
+        }
+    }
+}
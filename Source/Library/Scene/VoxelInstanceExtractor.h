@@ -0,0 +1,125 @@
+/*+===================================================================
+  File:      VOXELINSTANCEEXTRACTOR.H
+
+  Summary:   VoxelInstanceExtractor header file contains declarations
+             of the extraction of the cube instances of a chunk of a
+             block / height grid. It only depends on the standard
+             library so it can be tested without Direct3D.
+
+  Classes: VoxelInstanceExtractor
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Scene/GreedyMesher.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   ChunkInstanceCounts
+
+      Summary:  Number of instances per block type of a chunk and the
+                height range of its cubes. MinColumnHeight is 0 when a
+                column of the chunk is empty
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ChunkInstanceCounts
+    {
+        std::vector<size_t> NumInstances;
+        size_t NumFilledInstances;
+        uint32_t MinHeight;
+        uint32_t MaxHeight;
+        uint32_t MinColumnHeight;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelInstanceExtractor
+
+      Summary:  Emits a cube per voxel of the columns of a chunk. In
+                the surface mode only the cubes with at least one
+                exposed face are emitted: the top cube of a column and
+                the cubes above the lowest of its four neighboring
+                columns. Neighbors outside of the chunk are read from
+                the grid, so every chunk is extracted on its own
+
+      Methods:  GetLowestHeight
+                  Returns the height index of the lowest cube emitted
+                  for a column
+                CountChunk
+                  Counts the instances of a chunk per block type
+                ForEachInstance
+                  Calls a function for every instance of a chunk, row
+                  by row and bottom to top within a column
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelInstanceExtractor final
+    {
+    public:
+        VoxelInstanceExtractor() = delete;
+
+        static uint32_t GetLowestHeight(const VoxelGridView& grid, uint32_t x, uint32_t z, bool bSurface);
+        static void CountChunk(
+            const VoxelGridView& grid,
+            bool bSurface,
+            uint32_t uOriginX,
+            uint32_t uOriginZ,
+            uint32_t uSizeX,
+            uint32_t uSizeZ,
+            ChunkInstanceCounts& outCounts
+        );
+
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   VoxelInstanceExtractor::ForEachInstance
+
+          Summary:  Calls emit(uBlockType, x, h, z) for every instance
+                    of the chunk with grid coordinates
+
+          Args:     const VoxelGridView& grid
+                      Block / height grid
+                    bool bSurface
+                      Whether only the surface cubes are emitted
+                    uint32_t uOriginX
+                      First column of the chunk along the x-axis
+                    uint32_t uOriginZ
+                      First column of the chunk along the z-axis
+                    uint32_t uSizeX
+                      Number of columns of the chunk along the x-axis
+                    uint32_t uSizeZ
+                      Number of columns of the chunk along the z-axis
+                    Emit&& emit
+                      Function called for every instance
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        template <typename Emit>
+        static void ForEachInstance(
+            const VoxelGridView& grid,
+            bool bSurface,
+            uint32_t uOriginX,
+            uint32_t uOriginZ,
+            uint32_t uSizeX,
+            uint32_t uSizeZ,
+            Emit&& emit
+        )
+        {
+            for (uint32_t z = uOriginZ; z < uOriginZ + uSizeZ; ++z)
+            {
+                for (uint32_t x = uOriginX; x < uOriginX + uSizeX; ++x)
+                {
+                    const uint32_t uColumnHeight = grid.GetColumnHeight(x, z);
+                    if (uColumnHeight == 0u)
+                    {
+                        continue;
+                    }
+
+                    const uint32_t uBlockType = grid.GetBlockType(x, z);
+                    for (uint32_t h = GetLowestHeight(grid, x, z, bSurface); h < uColumnHeight; ++h)
+                    {
+                        emit(uBlockType, x, h, z);
+                    }
+                }
+            }
+        }
+    };
+}
@@ -0,0 +1,190 @@
+#include "Scene/VoxelMesh.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesh::VoxelMesh
+
+      Summary:  Constructor. Copies the greedy mesh of a chunk and
+                places it where the instanced voxels of the same
+                height map would be
+
+      Args:     const GreedyMeshData& meshData
+                  Greedy mesh of the chunk, in grid units
+                const HeightMap& heightMap
+                  Height map the chunk was meshed from
+
+      Modifies: [m_aVertices, m_aIndices, m_aMeshColors, m_aMeshes,
+                 m_aNormalData, m_world].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelMesh::VoxelMesh(_In_ const GreedyMeshData& meshData, _In_ const HeightMap& heightMap)
+        : Renderable(XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f))
+        , m_aVertices()
+        , m_aIndices(meshData.Indices.begin(), meshData.Indices.end())
+        , m_aMeshColors()
+    {
+        m_aVertices.reserve(meshData.Vertices.size());
+        m_aNormalData.reserve(meshData.Vertices.size());
+        for (const GreedyMeshVertex& vertex : meshData.Vertices)
+        {
+            m_aVertices.push_back(
+                SimpleVertex
+                {
+                    .Position = XMFLOAT3(vertex.Position[0], vertex.Position[1], vertex.Position[2]),
+                    .TexCoord = XMFLOAT2(vertex.TexCoord[0], vertex.TexCoord[1]),
+                    .Normal = XMFLOAT3(vertex.Normal[0], vertex.Normal[1], vertex.Normal[2]),
+                }
+            );
+
+            // Faces are axis aligned, so the tangent frame follows from the normal
+            NormalData normalData;
+            if (vertex.Normal[0] != 0.0f)
+            {
+                normalData.Tangent = XMFLOAT3(0.0f, 0.0f, 1.0f);
+                normalData.Bitangent = XMFLOAT3(0.0f, 1.0f, 0.0f);
+            }
+            else if (vertex.Normal[1] != 0.0f)
+            {
+                normalData.Tangent = XMFLOAT3(1.0f, 0.0f, 0.0f);
+                normalData.Bitangent = XMFLOAT3(0.0f, 0.0f, 1.0f);
+            }
+            else
+            {
+                normalData.Tangent = XMFLOAT3(1.0f, 0.0f, 0.0f);
+                normalData.Bitangent = XMFLOAT3(0.0f, 1.0f, 0.0f);
+            }
+            m_aNormalData.push_back(normalData);
+        }
+
+        m_aMeshes.reserve(meshData.Sections.size());
+        m_aMeshColors.reserve(meshData.Sections.size());
+        for (const GreedyMeshSection& section : meshData.Sections)
+        {
+            BasicMeshEntry basicMeshEntry;
+            basicMeshEntry.uNumIndices = section.NumIndices;
+            basicMeshEntry.uBaseVertex = section.BaseVertex;
+            basicMeshEntry.uBaseIndex = section.BaseIndex;
+
+            m_aMeshes.push_back(basicMeshEntry);
+            m_aMeshColors.push_back(heightMap.GetColor(section.BlockType));
+        }
+
+        // A cube at the grid position (x, h, z) is centered at
+        // (2x - W, 2h - 1.25H, 2z - D), see Scene::createVoxels
+        Scale(2.0f, 2.0f, 2.0f);
+        Translate(
+            XMVectorSet(
+                -static_cast<FLOAT>(heightMap.GetWidth()) - 1.0f,
+                -static_cast<FLOAT>(heightMap.GetHeight()) * 1.25f - 1.0f,
+                -static_cast<FLOAT>(heightMap.GetDepth()) - 1.0f,
+                0.0f
+            )
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesh::Initialize
+
+      Summary:  Creates the vertex, normal, index and constant buffers
+                of the chunk
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set buffers
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelMesh::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        if (m_aVertices.empty())
+        {
+            return S_OK;
+        }
+
+        return initialize(pDevice, pImmediateContext);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesh::Update
+
+      Summary:  Updates the chunk every frame
+
+      Args:     FLOAT deltaTime
+                  Elapsed time
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelMesh::Update(_In_ FLOAT deltaTime)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesh::GetMeshColor
+
+      Summary:  Returns the palette color of a mesh
+
+      Args:     UINT uIndex
+                  Index of the mesh
+
+      Returns:  const XMFLOAT4&
+                  Palette color of the block type of the mesh
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMFLOAT4& VoxelMesh::GetMeshColor(_In_ UINT uIndex) const
+    {
+        assert(uIndex < m_aMeshColors.size());
+
+        return m_aMeshColors[uIndex];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesh::GetNumVertices
+
+      Summary:  Returns the number of vertices of the chunk
+
+      Returns:  UINT
+                  Number of vertices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelMesh::GetNumVertices() const
+    {
+        return static_cast<UINT>(m_aVertices.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesh::GetNumIndices
+
+      Summary:  Returns the number of indices of the chunk
+
+      Returns:  UINT
+                  Number of indices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelMesh::GetNumIndices() const
+    {
+        return static_cast<UINT>(m_aIndices.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesh::getVertices
+
+      Summary:  Returns the pointer to the vertices data
+
+      Returns:  const library::SimpleVertex*
+                  Pointer to the vertices data
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const SimpleVertex* VoxelMesh::getVertices() const
+    {
+        return m_aVertices.data();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesh::getIndices
+
+      Summary:  Returns the pointer to the indices data
+
+      Returns:  const WORD*
+                  Pointer to the indices data
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const WORD* VoxelMesh::getIndices() const
+    {
+        return m_aIndices.data();
+    }
+}
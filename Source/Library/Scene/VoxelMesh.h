@@ -0,0 +1,72 @@
+/*+===================================================================
+  File:      VOXELMESH.H
+
+  Summary:   VoxelMesh header file contains declarations of VoxelMesh
+             class, the greedy-meshed terrain of a chunk of a voxel
+             scene.
+
+  Classes: VoxelMesh
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+#include "Renderer/Renderable.h"
+#include "Scene/GreedyMesher.h"
+#include "Scene/HeightMap.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelMesh
+
+      Summary:  Static vertex / index buffer of a chunk of the voxel
+                terrain. Each block type is a mesh of its own so that
+                it can be drawn with its palette color
+
+      Methods:  Initialize
+                  Creates the buffers of the chunk
+                Update
+                  Updates the chunk each frame
+                GetMeshColor
+                  Returns the palette color of a mesh
+                GetNumVertices
+                  Returns the number of vertices
+                GetNumIndices
+                  Returns the number of indices
+                VoxelMesh
+                  Constructor.
+                ~VoxelMesh
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelMesh : public Renderable
+    {
+    public:
+        VoxelMesh(_In_ const GreedyMeshData& meshData, _In_ const HeightMap& heightMap);
+        VoxelMesh(const VoxelMesh& other) = delete;
+        VoxelMesh(VoxelMesh&& other) = delete;
+        VoxelMesh& operator=(const VoxelMesh& other) = delete;
+        VoxelMesh& operator=(VoxelMesh&& other) = delete;
+        ~VoxelMesh() = default;
+
+        virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext) override;
+        virtual void Update(_In_ FLOAT deltaTime) override;
+
+        const XMFLOAT4& GetMeshColor(_In_ UINT uIndex) const;
+
+        UINT GetNumVertices() const override;
+        UINT GetNumIndices() const override;
+
+    protected:
+        const SimpleVertex* getVertices() const override;
+        const WORD* getIndices() const override;
+
+    private:
+        std::vector<SimpleVertex> m_aVertices;
+        std::vector<WORD> m_aIndices;
+        std::vector<XMFLOAT4> m_aMeshColors;
+    };
+}
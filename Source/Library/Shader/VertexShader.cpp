@@ -16,13 +16,15 @@ namespace library
                   Specifies the shader target or set of shader features
                   to compile against
 
-      Modifies: [m_vertexShader].
+      Modifies: [m_vertexShader, m_vertexLayout,
+                 m_instancedVertexShader].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     /*--------------------------------------------------------------------
       TODO: VertexShader::VertexShader definition (remove the comment)
     --------------------------------------------------------------------*/
     VertexShader::VertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel) 
         : Shader(pszFileName, pszEntryPoint, pszShaderModel)
+        , m_instancedVertexShader()
     {
         m_vertexShader = nullptr;
         m_vertexLayout = nullptr;
@@ -184,4 +186,35 @@ namespace library
     {
         return m_vertexLayout;
     }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexShader::SetInstancedVertexShader
+
+      Summary:  Sets the variant of this shader that reads the world
+                matrix of each instance from INSTANCE_TRANSFORM in the
+                input slot 2 instead of the World constant. Renderables
+                drawn with this shader can then be instanced
+
+      Args:     const std::shared_ptr<VertexShader>& instancedVertexShader
+                  Instanced variant
+
+      Modifies: [m_instancedVertexShader].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VertexShader::SetInstancedVertexShader(_In_ const std::shared_ptr<VertexShader>& instancedVertexShader)
+    {
+        m_instancedVertexShader = instancedVertexShader;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexShader::GetInstancedVertexShader
+
+      Summary:  Returns the instanced variant of this shader
+
+      Returns:  const std::shared_ptr<VertexShader>&
+                  Instanced variant. Could be a nullptr
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::shared_ptr<VertexShader>& VertexShader::GetInstancedVertexShader() const
+    {
+        return m_instancedVertexShader;
+    }
 }
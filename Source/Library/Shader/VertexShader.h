@@ -28,6 +28,11 @@ namespace library
                   Returns the vertex shader
                 GetVertexLayout
                   Returns the vertex input layout
+                SetInstancedVertexShader
+                  Sets the variant that reads the world matrix from the
+                  instance stream
+                GetInstancedVertexShader
+                  Returns the instanced variant
                 Game
                   Constructor.
                 ~Game
@@ -49,8 +54,12 @@ namespace library
         ComPtr<ID3D11VertexShader>& GetVertexShader();
         ComPtr<ID3D11InputLayout>& GetVertexLayout();
 
+        void SetInstancedVertexShader(_In_ const std::shared_ptr<VertexShader>& instancedVertexShader);
+        const std::shared_ptr<VertexShader>& GetInstancedVertexShader() const;
+
     protected:
         ComPtr<ID3D11VertexShader> m_vertexShader;
         ComPtr<ID3D11InputLayout> m_vertexLayout;
+        std::shared_ptr<VertexShader> m_instancedVertexShader;
     };
 }
\ No newline at end of file
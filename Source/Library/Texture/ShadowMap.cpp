@@ -0,0 +1,253 @@
+#include "Texture/ShadowMap.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShadowMap::ShadowMap
+
+      Summary:  Constructor
+
+      Args:     UINT uSize
+                  Width and height of a slice
+                DXGI_FORMAT depthFormat
+                  DXGI_FORMAT_D32_FLOAT or DXGI_FORMAT_D16_UNORM
+                UINT uNumSlices
+                  Number of slices of the array
+
+      Modifies: [m_uSize, m_uNumSlices, m_depthFormat, m_viewport,
+                 m_texture2D, m_aDepthStencilViews,
+                 m_shaderResourceView, m_samplerComparison].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ShadowMap::ShadowMap(_In_ UINT uSize, _In_ DXGI_FORMAT depthFormat, _In_ UINT uNumSlices)
+        : m_uSize(uSize)
+        , m_uNumSlices(uNumSlices)
+        , m_depthFormat(depthFormat)
+        , m_viewport{
+            .TopLeftX = 0.0f,
+            .TopLeftY = 0.0f,
+            .Width = static_cast<FLOAT>(uSize),
+            .Height = static_cast<FLOAT>(uSize),
+            .MinDepth = 0.0f,
+            .MaxDepth = 1.0f
+        }
+        , m_texture2D()
+        , m_aDepthStencilViews()
+        , m_shaderResourceView()
+        , m_samplerComparison()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShadowMap::Initialize
+
+      Summary:  Creates the depth texture array in the typeless format
+                of the depth format so it can be both a depth stencil
+                and a shader resource, a depth stencil view per slice,
+                and a sampler that compares against it with bilinear
+                filtering. Outside the texture the comparison passes,
+                so nothing there is in shadow
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the resources with
+
+      Modifies: [m_texture2D, m_aDepthStencilViews, m_shaderResourceView,
+                 m_samplerComparison].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT ShadowMap::Initialize(_In_ ID3D11Device* pDevice)
+    {
+        DXGI_FORMAT textureFormat = DXGI_FORMAT_R32_TYPELESS;
+        DXGI_FORMAT shaderResourceFormat = DXGI_FORMAT_R32_FLOAT;
+        switch (m_depthFormat)
+        {
+        case DXGI_FORMAT_D32_FLOAT:
+            break;
+        case DXGI_FORMAT_D16_UNORM:
+            textureFormat = DXGI_FORMAT_R16_TYPELESS;
+            shaderResourceFormat = DXGI_FORMAT_R16_UNORM;
+            break;
+        default:
+            return E_INVALIDARG;
+        }
+
+        D3D11_TEXTURE2D_DESC textureDesc = {
+            .Width = m_uSize,
+            .Height = m_uSize,
+            .MipLevels = 1,
+            .ArraySize = m_uNumSlices,
+            .Format = textureFormat,
+            .SampleDesc = {.Count = 1},
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE,
+            .CPUAccessFlags = 0,
+            .MiscFlags = 0
+        };
+        HRESULT hr = pDevice->CreateTexture2D(&textureDesc, nullptr, m_texture2D.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        m_aDepthStencilViews.resize(m_uNumSlices);
+        for (UINT uSlice = 0u; uSlice < m_uNumSlices; ++uSlice)
+        {
+            D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc = {
+                .Format = m_depthFormat,
+                .ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2DARRAY,
+                .Texture2DArray = {.MipSlice = 0, .FirstArraySlice = uSlice, .ArraySize = 1}
+            };
+            hr = pDevice->CreateDepthStencilView(m_texture2D.Get(), &depthStencilViewDesc, m_aDepthStencilViews[uSlice].GetAddressOf());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc = {
+            .Format = shaderResourceFormat,
+            .ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY,
+            .Texture2DArray = {.MostDetailedMip = 0, .MipLevels = 1, .FirstArraySlice = 0, .ArraySize = m_uNumSlices}
+        };
+        hr = pDevice->CreateShaderResourceView(m_texture2D.Get(), &shaderResourceViewDesc, m_shaderResourceView.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        D3D11_SAMPLER_DESC samplerDesc = {
+            .Filter = D3D11_FILTER_COMPARISON_MIN_MAG_LINEAR_MIP_POINT,
+            .AddressU = D3D11_TEXTURE_ADDRESS_BORDER,
+            .AddressV = D3D11_TEXTURE_ADDRESS_BORDER,
+            .AddressW = D3D11_TEXTURE_ADDRESS_BORDER,
+            .MipLODBias = 0.0f,
+            .MaxAnisotropy = 1,
+            .ComparisonFunc = D3D11_COMPARISON_LESS_EQUAL,
+            .BorderColor = { 1.0f, 1.0f, 1.0f, 1.0f },
+            .MinLOD = 0.0f,
+            .MaxLOD = D3D11_FLOAT32_MAX
+        };
+        hr = pDevice->CreateSamplerState(&samplerDesc, m_samplerComparison.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShadowMap::GetSize
+
+      Summary:  Returns the width and height of a slice
+
+      Returns:  UINT
+                  Size of a slice in texels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ShadowMap::GetSize() const
+    {
+        return m_uSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShadowMap::GetNumSlices
+
+      Summary:  Returns the number of slices of the array
+
+      Returns:  UINT
+                  Number of slices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ShadowMap::GetNumSlices() const
+    {
+        return m_uNumSlices;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShadowMap::GetViewport
+
+      Summary:  Returns the viewport covering a slice
+
+      Returns:  const D3D11_VIEWPORT&
+                  Viewport of the shadow pass
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const D3D11_VIEWPORT& ShadowMap::GetViewport() const
+    {
+        return m_viewport;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShadowMap::GetTexture2D
+
+      Summary:  Returns the depth texture array
+
+      Returns:  ComPtr<ID3D11Texture2D>&
+                  Texture holding every slice
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Texture2D>& ShadowMap::GetTexture2D()
+    {
+        return m_texture2D;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShadowMap::GetSubresource
+
+      Summary:  Returns the subresource index of a slice, to copy it
+
+      Args:     UINT uSlice
+                  Index of the slice
+
+      Returns:  UINT
+                  Subresource of the only mip of the slice
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ShadowMap::GetSubresource(_In_ UINT uSlice) const
+    {
+        assert(uSlice < m_uNumSlices);
+
+        return D3D11CalcSubresource(0u, uSlice, 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShadowMap::GetDepthStencilView
+
+      Summary:  Returns the view the depth of a slice is written to
+
+      Args:     UINT uSlice
+                  Index of the slice
+
+      Returns:  ComPtr<ID3D11DepthStencilView>&
+                  Depth stencil view of the slice
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11DepthStencilView>& ShadowMap::GetDepthStencilView(_In_ UINT uSlice)
+    {
+        assert(uSlice < m_uNumSlices);
+
+        return m_aDepthStencilViews[uSlice];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShadowMap::GetShaderResourceView
+
+      Summary:  Returns the view the depth is read from
+
+      Returns:  ComPtr<ID3D11ShaderResourceView>&
+                  Shader resource view
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11ShaderResourceView>& ShadowMap::GetShaderResourceView()
+    {
+        return m_shaderResourceView;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShadowMap::GetSamplerState
+
+      Summary:  Returns the comparison sampler
+
+      Returns:  ComPtr<ID3D11SamplerState>&
+                  Sampler comparing against the stored depth
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11SamplerState>& ShadowMap::GetSamplerState()
+    {
+        return m_samplerComparison;
+    }
+}
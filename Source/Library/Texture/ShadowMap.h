@@ -0,0 +1,84 @@
+/*+===================================================================
+  File:      SHADOWMAP.H
+
+  Summary:   ShadowMap header file contains declaration of class
+             ShadowMap, a depth-only texture array rendered from a
+             light and sampled with depth comparison.
+
+  Classes: ShadowMap
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ShadowMap
+
+      Summary:  Array of square depth textures of a typeless format,
+                one slice per shadow cascade. Each slice is written
+                through its own depth stencil view with no pixel
+                shader, and the whole array is read through one shader
+                resource view with a comparison sampler. Its size does
+                not follow the window
+
+      Methods:  Initialize
+                  Creates the texture, its views and the sampler
+                GetSize
+                  Returns the width and height of a slice
+                GetNumSlices
+                  Returns the number of slices
+                GetViewport
+                  Returns the viewport covering a slice
+                GetTexture2D
+                  Returns the depth texture array
+                GetSubresource
+                  Returns the subresource index of a slice
+                GetDepthStencilView
+                  Returns the view the depth of a slice is written to
+                GetShaderResourceView
+                  Returns the view the depth is read from
+                GetSamplerState
+                  Returns the comparison sampler
+                ShadowMap
+                  Constructor.
+                ~ShadowMap
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ShadowMap final
+    {
+    public:
+        ShadowMap() = delete;
+        ShadowMap(_In_ UINT uSize, _In_ DXGI_FORMAT depthFormat, _In_ UINT uNumSlices);
+        ShadowMap(const ShadowMap& other) = delete;
+        ShadowMap(ShadowMap&& other) = delete;
+        ShadowMap& operator=(const ShadowMap& other) = delete;
+        ShadowMap& operator=(ShadowMap&& other) = delete;
+        ~ShadowMap() = default;
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice);
+
+        UINT GetSize() const;
+        UINT GetNumSlices() const;
+        const D3D11_VIEWPORT& GetViewport() const;
+        ComPtr<ID3D11Texture2D>& GetTexture2D();
+        UINT GetSubresource(_In_ UINT uSlice) const;
+        ComPtr<ID3D11DepthStencilView>& GetDepthStencilView(_In_ UINT uSlice);
+        ComPtr<ID3D11ShaderResourceView>& GetShaderResourceView();
+        ComPtr<ID3D11SamplerState>& GetSamplerState();
+
+    private:
+        UINT m_uSize;
+        UINT m_uNumSlices;
+        DXGI_FORMAT m_depthFormat;
+        D3D11_VIEWPORT m_viewport;
+
+        ComPtr<ID3D11Texture2D> m_texture2D;
+        std::vector<ComPtr<ID3D11DepthStencilView>> m_aDepthStencilViews;
+        ComPtr<ID3D11ShaderResourceView> m_shaderResourceView;
+        ComPtr<ID3D11SamplerState> m_samplerComparison;
+    };
+}
@@ -0,0 +1,205 @@
+#include "Thread/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::ThreadPool
+
+      Summary:  Constructor. Starts the worker threads
+
+      Args:     uint32_t uNumThreads
+                  Number of worker threads, 0 to use one per hardware
+                  thread except the calling one
+
+      Modifies: [m_aWorkers, m_tasks, m_bStopping].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ThreadPool::ThreadPool(uint32_t uNumThreads)
+        : m_aWorkers()
+        , m_tasks()
+        , m_mutex()
+        , m_taskAvailable()
+        , m_bStopping(false)
+    {
+        if (uNumThreads == 0u)
+        {
+            const uint32_t uNumHardwareThreads = std::thread::hardware_concurrency();
+            uNumThreads = uNumHardwareThreads > 1u ? uNumHardwareThreads - 1u : 1u;
+        }
+
+        m_aWorkers.reserve(uNumThreads);
+        for (uint32_t i = 0u; i < uNumThreads; ++i)
+        {
+            m_aWorkers.emplace_back(&ThreadPool::workerMain, this);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::~ThreadPool
+
+      Summary:  Destructor. Runs the tasks still in the queue and joins
+                the worker threads
+
+      Modifies: [m_aWorkers, m_bStopping].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bStopping = true;
+        }
+        m_taskAvailable.notify_all();
+
+        for (std::thread& worker : m_aWorkers)
+        {
+            worker.join();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::Submit
+
+      Summary:  Queues a task to be run by a worker thread
+
+      Args:     std::function<void()> task
+                  Task to run
+
+      Modifies: [m_tasks].
+
+      Returns:  std::future<void>
+                  Future that becomes ready when the task has run
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::future<void> ThreadPool::Submit(std::function<void()> task)
+    {
+        std::packaged_task<void()> packagedTask(std::move(task));
+        std::future<void> future = packagedTask.get_future();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push(std::move(packagedTask));
+        }
+        m_taskAvailable.notify_one();
+
+        return future;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::ParallelFor
+
+      Summary:  Splits [0, uCount) into batches of uBatchSize indices and
+                runs the task on every batch. The calling thread takes
+                batches as well, so nested calls from a worker cannot
+                dead-lock. Which thread runs a batch is unspecified, so
+                the task should only write to outputs owned by its
+                batch
+
+      Args:     size_t uCount
+                  Number of indices
+                size_t uBatchSize
+                  Number of indices per batch
+                const std::function<void(size_t, size_t)>& task
+                  Task run with the [uBegin, uEnd) range of a batch
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ThreadPool::ParallelFor(size_t uCount, size_t uBatchSize, const std::function<void(size_t uBegin, size_t uEnd)>& task)
+    {
+        if (uCount == 0u)
+        {
+            return;
+        }
+
+        uBatchSize = (std::max)(uBatchSize, static_cast<size_t>(1u));
+        const size_t uNumBatches = (uCount + uBatchSize - 1u) / uBatchSize;
+        if (uNumBatches == 1u || m_aWorkers.empty())
+        {
+            task(0u, uCount);
+            return;
+        }
+
+        struct SharedState
+        {
+            std::atomic<size_t> uNextBatch;
+            std::atomic<size_t> uNumDoneBatches;
+            std::mutex mutex;
+            std::condition_variable done;
+        };
+        std::shared_ptr<SharedState> state = std::make_shared<SharedState>();
+        state->uNextBatch = 0u;
+        state->uNumDoneBatches = 0u;
+
+        // Helpers that start after the last batch was taken return
+        // immediately, the shared state keeps them valid after we return
+        auto runBatches = [state, uCount, uBatchSize, uNumBatches, &task]()
+        {
+            for (size_t uBatch = state->uNextBatch++; uBatch < uNumBatches; uBatch = state->uNextBatch++)
+            {
+                const size_t uBegin = uBatch * uBatchSize;
+                task(uBegin, (std::min)(uBegin + uBatchSize, uCount));
+
+                if (++state->uNumDoneBatches == uNumBatches)
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->done.notify_all();
+                }
+            }
+        };
+
+        const size_t uNumHelpers = (std::min)(uNumBatches - 1u, m_aWorkers.size());
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (size_t i = 0u; i < uNumHelpers; ++i)
+            {
+                m_tasks.push(std::packaged_task<void()>(runBatches));
+            }
+        }
+        m_taskAvailable.notify_all();
+
+        runBatches();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->done.wait(lock, [&state, uNumBatches]() { return state->uNumDoneBatches == uNumBatches; });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::GetNumThreads
+
+      Summary:  Returns the number of worker threads
+
+      Returns:  uint32_t
+                  Number of worker threads
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t ThreadPool::GetNumThreads() const
+    {
+        return static_cast<uint32_t>(m_aWorkers.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::workerMain
+
+      Summary:  Loop of a worker thread, runs queued tasks until the
+                pool is destroyed and the queue is empty
+
+      Modifies: [m_tasks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ThreadPool::workerMain()
+    {
+        for (;;)
+        {
+            std::packaged_task<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_taskAvailable.wait(lock, [this]() { return m_bStopping || !m_tasks.empty(); });
+                if (m_tasks.empty())
+                {
+                    return;
+                }
+
+                task = std::move(m_tasks.front());
+                m_tasks.pop();
+            }
+
+            task();
+        }
+    }
+}
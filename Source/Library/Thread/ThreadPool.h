@@ -0,0 +1,70 @@
+/*+===================================================================
+  File:      THREADPOOL.H
+
+  Summary:   ThreadPool header file contains declarations of the
+             worker pool used to split loading and meshing work across
+             the CPU cores. It only depends on the standard library.
+
+  Classes: ThreadPool
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ThreadPool
+
+      Summary:  Fixed set of worker threads fed from a FIFO task queue
+
+      Methods:  Submit
+                  Queues a task and returns a future for its completion
+                ParallelFor
+                  Splits an index range into batches and runs them on
+                  the workers and the calling thread, returns when all
+                  batches are done
+                GetNumThreads
+                  Returns the number of worker threads
+                ThreadPool
+                  Constructor.
+                ~ThreadPool
+                  Destructor. Finishes the queued tasks and joins the
+                  workers
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ThreadPool final
+    {
+    public:
+        explicit ThreadPool(uint32_t uNumThreads = 0u);
+        ThreadPool(const ThreadPool& other) = delete;
+        ThreadPool(ThreadPool&& other) = delete;
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+        ThreadPool& operator=(ThreadPool&& other) = delete;
+        ~ThreadPool();
+
+        std::future<void> Submit(std::function<void()> task);
+        void ParallelFor(size_t uCount, size_t uBatchSize, const std::function<void(size_t uBegin, size_t uEnd)>& task);
+
+        uint32_t GetNumThreads() const;
+
+    private:
+        void workerMain();
+
+    private:
+        std::vector<std::thread> m_aWorkers;
+        std::queue<std::packaged_task<void()>> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_taskAvailable;
+        bool m_bStopping;
+    };
+}
@@ -154,6 +154,12 @@ namespace library
                 case 0x10:
                     m_directions.bDown = true;
                     break;
+                case 0x50: // p, once per press
+                    if (!(lParam & (1 << 30)))
+                    {
+                        m_bDepthPrepassToggled = TRUE;
+                    }
+                    break;
                 }
                 return 0;
             }
@@ -237,6 +243,24 @@ namespace library
         m_mouseRelativeMovement = {0, 0};
         ///////////////////////////////
     }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MainWindow::TakeDepthPrepassToggle
+
+      Summary:  Returns whether P was pressed since the last call, and
+                forgets the press
+
+      Modifies: [m_bDepthPrepassToggled].
+
+      Returns:  BOOL
+                  Whether the depth pre-pass is to be toggled
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL MainWindow::TakeDepthPrepassToggle()
+    {
+        const BOOL bToggled = m_bDepthPrepassToggled;
+        m_bDepthPrepassToggled = FALSE;
+        return bToggled;
+    }
     
     
 
@@ -35,6 +35,9 @@ namespace library
                   Returns the mouse relative movement
                 ResetMouseMovement
                   Reset the mouse relative movement to zero
+                TakeDepthPrepassToggle
+                  Returns whether the depth pre-pass key was pressed
+                  since the last call
                 MainWindow
                   Constructor.
                 ~MainWindow
@@ -57,10 +60,12 @@ namespace library
         const DirectionsInput& GetDirections() const;
         const MouseRelativeMovement& GetMouseRelativeMovement() const;
         void ResetMouseMovement();
+        BOOL TakeDepthPrepassToggle();
 
     private:
         DirectionsInput m_directions;
         MouseRelativeMovement m_mouseRelativeMovement;
+        BOOL m_bDepthPrepassToggled = FALSE;
     };
 }
 
@@ -0,0 +1,287 @@
+/*+===================================================================
+  File:      COMMANDSTREAMANALYZERTEST.CPP
+
+  Summary:   Headless test of the command stream analyzer. Records a
+             synthetic frame on a RecordingCommandContext and checks
+             the draws, binds, redundant binds and uploaded bytes the
+             analyzer counts in it.
+
+  Functions: RunCommandStreamAnalyzerTests
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "Renderer/CommandStreamAnalyzer.h"
+#include "Renderer/RecordingCommandContext.h"
+
+#include "Tests.h"
+
+namespace
+{
+    constexpr const uint32_t NUM_OBJECTS = 16u;
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: getHandle
+
+      Summary:  Returns a distinct fake handle. The recording context
+                only compares and stores handles, it never follows them
+
+      Args:     char* pObjects
+                  Storage whose bytes give the handles their addresses
+                uint32_t uIndex
+                  Index of the handle, below NUM_OBJECTS
+
+      Returns:  T*
+                  Handle
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    template <typename T>
+    T* getHandle(char* pObjects, uint32_t uIndex)
+    {
+        return reinterpret_cast<T*>(pObjects + uIndex);
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: checkCount
+
+      Summary:  Compares a counter with its expected value
+
+      Args:     const char* pszName
+                  Name of the test case
+                const char* pszCounter
+                  Name of the counter
+                uint64_t uActual
+                  Counted value
+                uint64_t uExpected
+                  Expected value
+
+      Returns:  bool
+                  True if the values are equal
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    bool checkCount(const char* pszName, const char* pszCounter, uint64_t uActual, uint64_t uExpected)
+    {
+        if (uActual != uExpected)
+        {
+            std::printf(
+                "[FAIL] %s: %llu %s instead of %llu\n",
+                pszName,
+                static_cast<unsigned long long>(uActual),
+                pszCounter,
+                static_cast<unsigned long long>(uExpected)
+            );
+            return false;
+        }
+
+        return true;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: testSyntheticFrame
+
+      Summary:  Records a frame with clears, binds, rebinds of the same
+                state, uploads, draws and a command list from a
+                deferred context, then checks every counter of the
+                analyzer
+
+      Returns:  bool
+                  True if all checks passed
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    bool testSyntheticFrame()
+    {
+        using namespace library;
+
+        char aObjects[NUM_OBJECTS] = {};
+        GpuRenderTargetView* pRenderTargetView = getHandle<GpuRenderTargetView>(aObjects, 0u);
+        GpuDepthStencilView* pDepthStencilView = getHandle<GpuDepthStencilView>(aObjects, 1u);
+        GpuBuffer* apVertexBuffers[2] = { getHandle<GpuBuffer>(aObjects, 2u), getHandle<GpuBuffer>(aObjects, 3u) };
+        GpuBuffer* pIndexBuffer = getHandle<GpuBuffer>(aObjects, 4u);
+        GpuInputLayout* pInputLayout = getHandle<GpuInputLayout>(aObjects, 5u);
+        GpuVertexShader* pVertexShader = getHandle<GpuVertexShader>(aObjects, 6u);
+        GpuPixelShader* pPixelShader = getHandle<GpuPixelShader>(aObjects, 7u);
+        GpuBuffer* pConstantBuffer = getHandle<GpuBuffer>(aObjects, 8u);
+        GpuBuffer* pRingBuffer = getHandle<GpuBuffer>(aObjects, 9u);
+        GpuBuffer* pInstanceBuffer = getHandle<GpuBuffer>(aObjects, 10u);
+
+        RecordingCommandContext immediate;
+        RecordingCommandContext deferred;
+
+        // Frame setup: 2 clears and 10 binds, one per vertex buffer slot
+        const float aClearColor[4] = { 0.0f, 0.125f, 0.6f, 1.0f };
+        immediate.ClearRenderTargetView(pRenderTargetView, aClearColor);
+        immediate.ClearDepthStencilView(pDepthStencilView, CommandContext::CLEAR_DEPTH, 1.0f, 0u);
+        immediate.OMSetRenderTargets(1u, &pRenderTargetView, pDepthStencilView);
+        immediate.RSSetViewport(
+            Viewport
+            {
+                .TopLeftX = 0.0f,
+                .TopLeftY = 0.0f,
+                .Width = 1280.0f,
+                .Height = 720.0f,
+                .MinDepth = 0.0f,
+                .MaxDepth = 1.0f,
+            }
+        );
+        immediate.IASetPrimitiveTopology(ePrimitiveTopology::TRIANGLE_LIST);
+        const uint32_t auStrides[2] = { 32u, 64u };
+        const uint32_t auOffsets[2] = { 0u, 0u };
+        immediate.IASetVertexBuffers(0u, 2u, apVertexBuffers, auStrides, auOffsets);
+        immediate.IASetIndexBuffer(pIndexBuffer, eIndexFormat::UINT32, 0u);
+        immediate.IASetInputLayout(pInputLayout);
+        immediate.VSSetShader(pVertexShader);
+        immediate.PSSetShader(pPixelShader);
+        immediate.VSSetConstantBuffer(0u, pConstantBuffer);
+
+        // First draw with a 64-byte constant upload
+        uint8_t aConstants[64] = {};
+        immediate.UpdateSubresource(pConstantBuffer, aConstants, sizeof(aConstants));
+        immediate.DrawIndexed(36u, 0u, 0);
+
+        // Rebinding the same shader and the same vertex buffer slot is
+        // redundant, an index buffer with another format is not
+        immediate.VSSetShader(pVertexShader);
+        immediate.IASetVertexBuffers(0u, 1u, apVertexBuffers, auStrides, auOffsets);
+        immediate.IASetIndexBuffer(pIndexBuffer, eIndexFormat::UINT16, 0u);
+
+        // The same range of the ring is redundant, another range is not
+        immediate.PSSetConstantBufferRange(1u, pRingBuffer, 16u, 4u);
+        immediate.PSSetConstantBufferRange(1u, pRingBuffer, 16u, 4u);
+        immediate.PSSetConstantBufferRange(1u, pRingBuffer, 32u, 4u);
+
+        // Instanced draw after writing 512 bytes of a mapped buffer
+        void* pData = nullptr;
+        if (!immediate.Map(pInstanceBuffer, eMapType::WRITE_DISCARD, 256u, 512u, &pData) || !pData)
+        {
+            std::printf("[FAIL] synthetic frame: Map failed\n");
+            return false;
+        }
+        std::memset(pData, 0xAB, 512u);
+        immediate.Unmap(pInstanceBuffer);
+        immediate.DrawIndexedInstanced(36u, 10u, 0u, 0, 0u);
+
+        // A command list starts from nothing bound, so its first shader
+        // bind is not redundant and its second one is
+        deferred.VSSetShader(pVertexShader);
+        deferred.VSSetShader(pVertexShader);
+        if (!deferred.Map(pRingBuffer, eMapType::WRITE_NO_OVERWRITE, 0u, 128u, &pData) || !pData)
+        {
+            std::printf("[FAIL] synthetic frame: deferred Map failed\n");
+            return false;
+        }
+        std::memset(pData, 0xCD, 128u);
+        deferred.Unmap(pRingBuffer);
+        deferred.DrawIndexed(36u, 0u, 0);
+        if (!deferred.FinishCommandList())
+        {
+            std::printf("[FAIL] synthetic frame: FinishCommandList failed\n");
+            return false;
+        }
+        immediate.ExecuteCommandList(&deferred);
+
+        // Running the list leaves nothing bound
+        immediate.VSSetShader(pVertexShader);
+
+        bool bPassed = checkCount("synthetic frame", "commands left in the deferred context", deferred.GetCommands().size(), 0u);
+
+        CommandStreamAnalyzer analyzer;
+        analyzer.Analyze(immediate.GetCommands());
+        bPassed &= checkCount("synthetic frame", "commands", analyzer.GetNumCommands(), 30u);
+        bPassed &= checkCount("synthetic frame", "draws", analyzer.GetNumDraws(), 3u);
+        bPassed &= checkCount("synthetic frame", "binds", analyzer.GetNumBinds(), 19u);
+        bPassed &= checkCount("synthetic frame", "redundant binds", analyzer.GetNumRedundantBinds(), 4u);
+        bPassed &= checkCount("synthetic frame", "uploads", analyzer.GetNumUploads(), 3u);
+        bPassed &= checkCount("synthetic frame", "bytes uploaded", analyzer.GetNumBytesUploaded(), 64u + 512u + 128u);
+        if (!bPassed)
+        {
+            return false;
+        }
+
+        std::printf(
+            "[ OK ] synthetic frame: %u commands, %u draws, %u binds, %u redundant, %llu bytes uploaded\n",
+            analyzer.GetNumCommands(),
+            analyzer.GetNumDraws(),
+            analyzer.GetNumBinds(),
+            analyzer.GetNumRedundantBinds(),
+            static_cast<unsigned long long>(analyzer.GetNumBytesUploaded())
+        );
+
+        // Analyzing again starts over
+        immediate.Reset();
+        analyzer.Analyze(immediate.GetCommands());
+        bPassed &= checkCount("empty frame", "commands", analyzer.GetNumCommands(), 0u);
+        bPassed &= checkCount("empty frame", "bytes uploaded", analyzer.GetNumBytesUploaded(), 0u);
+
+        return bPassed;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: testMapRange
+
+      Summary:  Checks that Map returns the address of the first byte
+                of the range, so a ring written after an earlier range
+                lands at the right offset of the buffer
+
+      Returns:  bool
+                  True if all checks passed
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    bool testMapRange()
+    {
+        using namespace library;
+
+        char aObjects[NUM_OBJECTS] = {};
+        GpuBuffer* pRingBuffer = getHandle<GpuBuffer>(aObjects, 0u);
+
+        RecordingCommandContext context;
+        void* pBase = nullptr;
+        if (!context.Map(pRingBuffer, eMapType::WRITE_DISCARD, 0u, 1024u, &pBase))
+        {
+            std::printf("[FAIL] map range: Map failed\n");
+            return false;
+        }
+        context.Unmap(pRingBuffer);
+
+        void* pRange = nullptr;
+        if (!context.Map(pRingBuffer, eMapType::WRITE_NO_OVERWRITE, 256u, 512u, &pRange))
+        {
+            std::printf("[FAIL] map range: Map of the range failed\n");
+            return false;
+        }
+        context.Unmap(pRingBuffer);
+
+        const ptrdiff_t offset = static_cast<uint8_t*>(pRange) - static_cast<uint8_t*>(pBase);
+        if (offset != 256)
+        {
+            std::printf("[FAIL] map range: range starts at byte %td instead of 256\n", offset);
+            return false;
+        }
+
+        CommandStreamAnalyzer analyzer;
+        analyzer.Analyze(context.GetCommands());
+        if (!checkCount("map range", "bytes uploaded", analyzer.GetNumBytesUploaded(), 1024u + 512u))
+        {
+            return false;
+        }
+
+        std::printf("[ OK ] map range: range starts at byte %td, %llu bytes uploaded\n", offset, static_cast<unsigned long long>(analyzer.GetNumBytesUploaded()));
+        return true;
+    }
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: RunCommandStreamAnalyzerTests
+
+  Summary:  Runs the test cases of the command stream analyzer
+
+  Returns:  bool
+              True if every test case passed
+F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+bool RunCommandStreamAnalyzerTests()
+{
+    bool bPassed = true;
+    bPassed &= testSyntheticFrame();
+    bPassed &= testMapRange();
+
+    return bPassed;
+}
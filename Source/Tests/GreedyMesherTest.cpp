@@ -0,0 +1,361 @@
+/*+===================================================================
+  File:      GREEDYMESHERTEST.CPP
+
+  Summary:   Headless test of the greedy mesher. Meshes small grids
+             and compares the quads against a brute-force count of the
+             exposed cube faces.
+
+  Functions: RunGreedyMesherTests
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Scene/GreedyMesher.h"
+
+#include "Tests.h"
+
+namespace
+{
+    constexpr const uint32_t NUM_DIRECTIONS = 5u;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TestGrid
+
+      Summary:  Owns the arrays a VoxelGridView points to
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TestGrid
+    {
+        uint32_t Width;
+        uint32_t Depth;
+        uint32_t NumBlockTypes;
+        std::vector<uint8_t> aBlockTypes;
+        std::vector<uint16_t> aColumnHeights;
+
+        library::VoxelGridView GetView() const
+        {
+            return library::VoxelGridView
+            {
+                .Width = Width,
+                .Depth = Depth,
+                .NumBlockTypes = NumBlockTypes,
+                .BlockTypes = aBlockTypes.data(),
+                .ColumnHeights = aColumnHeights.data(),
+            };
+        }
+    };
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: makeRandomGrid
+
+      Summary:  Creates a grid with random block types and heights
+
+      Args:     uint32_t uWidth
+                  Number of columns along the x-axis
+                uint32_t uDepth
+                  Number of columns along the z-axis
+                uint32_t uNumBlockTypes
+                  Number of block types
+                uint32_t uMaxHeight
+                  Largest column height
+                uint32_t uSeed
+                  Seed of the generator
+
+      Returns:  TestGrid
+                  Grid, a few columns are empty
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    TestGrid makeRandomGrid(uint32_t uWidth, uint32_t uDepth, uint32_t uNumBlockTypes, uint32_t uMaxHeight, uint32_t uSeed)
+    {
+        TestGrid grid =
+        {
+            .Width = uWidth,
+            .Depth = uDepth,
+            .NumBlockTypes = uNumBlockTypes,
+            .aBlockTypes = std::vector<uint8_t>(static_cast<size_t>(uWidth) * uDepth),
+            .aColumnHeights = std::vector<uint16_t>(static_cast<size_t>(uWidth) * uDepth),
+        };
+
+        std::mt19937 generator(uSeed);
+        std::uniform_int_distribution<uint32_t> blockTypes(0u, uNumBlockTypes);
+        std::uniform_int_distribution<uint32_t> heights(0u, uMaxHeight);
+        for (size_t i = 0u; i < grid.aBlockTypes.size(); ++i)
+        {
+            grid.aBlockTypes[i] = static_cast<uint8_t>(blockTypes(generator));
+            grid.aColumnHeights[i] = static_cast<uint16_t>(heights(generator));
+        }
+
+        return grid;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: getDirection
+
+      Summary:  Maps an axis-aligned normal to -x, +x, +y, -z, +z
+
+      Args:     const float aNormal[3]
+                  Normal of a vertex
+
+      Returns:  uint32_t
+                  Index of the direction, NUM_DIRECTIONS if the normal
+                  is not one of them
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    uint32_t getDirection(const float aNormal[3])
+    {
+        if (aNormal[0] < 0.0f) return 0u;
+        if (aNormal[0] > 0.0f) return 1u;
+        if (aNormal[1] > 0.0f) return 2u;
+        if (aNormal[2] < 0.0f) return 3u;
+        if (aNormal[2] > 0.0f) return 4u;
+        return NUM_DIRECTIONS;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: countFaces
+
+      Summary:  Brute force count of the exposed faces of every cube
+                of the chunk, per direction and block type
+
+      Args:     const library::VoxelGridView& grid
+                  Grid
+                uint32_t uOriginX, uOriginZ, uSizeX, uSizeZ
+                  Chunk
+                std::vector<uint64_t>& aFaces
+                  NUM_DIRECTIONS counters per block type
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void countFaces(
+        const library::VoxelGridView& grid,
+        uint32_t uOriginX,
+        uint32_t uOriginZ,
+        uint32_t uSizeX,
+        uint32_t uSizeZ,
+        std::vector<uint64_t>& aFaces
+    )
+    {
+        static constexpr const int32_t aOffsets[NUM_DIRECTIONS][2] = { { -1, 0 }, { 1, 0 }, { 0, 0 }, { 0, -1 }, { 0, 1 } };
+
+        aFaces.assign(static_cast<size_t>(grid.NumBlockTypes) * NUM_DIRECTIONS, 0u);
+        for (uint32_t z = uOriginZ; z < uOriginZ + uSizeZ; ++z)
+        {
+            for (uint32_t x = uOriginX; x < uOriginX + uSizeX; ++x)
+            {
+                const uint32_t uHeight = grid.GetColumnHeight(x, z);
+                for (uint32_t y = 0u; y < uHeight; ++y)
+                {
+                    for (uint32_t uDirection = 0u; uDirection < NUM_DIRECTIONS; ++uDirection)
+                    {
+                        const bool bExposed = uDirection == 2u
+                            ? y + 1u == uHeight
+                            : grid.GetColumnHeight(static_cast<int64_t>(x) + aOffsets[uDirection][0], static_cast<int64_t>(z) + aOffsets[uDirection][1]) <= y;
+                        if (bExposed)
+                        {
+                            ++aFaces[static_cast<size_t>(grid.GetBlockType(x, z)) * NUM_DIRECTIONS + uDirection];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: checkChunk
+
+      Summary:  Meshes a chunk and checks that the vertex and index
+                counts match the quads, that every index stays inside
+                its section and that the quad areas add up to the
+                brute force face counts
+
+      Args:     const char* pszName
+                  Name of the test case
+                const TestGrid& testGrid
+                  Grid
+                uint32_t uOriginX, uOriginZ, uSizeX, uSizeZ
+                  Chunk
+                size_t* puNumQuads
+                  Number of emitted quads, optional
+
+      Returns:  bool
+                  True if all checks passed
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    bool checkChunk(
+        const char* pszName,
+        const TestGrid& testGrid,
+        uint32_t uOriginX,
+        uint32_t uOriginZ,
+        uint32_t uSizeX,
+        uint32_t uSizeZ,
+        size_t* puNumQuads = nullptr
+    )
+    {
+        const library::VoxelGridView grid = testGrid.GetView();
+
+        library::GreedyMeshData meshData;
+        if (!library::GreedyMesher::MeshChunk(grid, uOriginX, uOriginZ, uSizeX, uSizeZ, meshData))
+        {
+            std::printf("[FAIL] %s: MeshChunk failed\n", pszName);
+            return false;
+        }
+
+        const size_t uNumQuads = meshData.Vertices.size() / 4u;
+        if (meshData.Vertices.size() != uNumQuads * 4u || meshData.Indices.size() != uNumQuads * 6u)
+        {
+            std::printf("[FAIL] %s: %zu vertices and %zu indices for %zu quads\n", pszName, meshData.Vertices.size(), meshData.Indices.size(), uNumQuads);
+            return false;
+        }
+
+        std::vector<uint64_t> aFaces;
+        countFaces(grid, uOriginX, uOriginZ, uSizeX, uSizeZ, aFaces);
+
+        uint64_t uNumFaces = 0u;
+        for (uint64_t uCount : aFaces)
+        {
+            uNumFaces += uCount;
+        }
+        if (uNumQuads > uNumFaces)
+        {
+            std::printf("[FAIL] %s: %zu quads for %llu faces\n", pszName, uNumQuads, static_cast<unsigned long long>(uNumFaces));
+            return false;
+        }
+
+        std::vector<uint64_t> aAreas(aFaces.size(), 0u);
+        size_t uNextIndex = 0u;
+        for (const library::GreedyMeshSection& section : meshData.Sections)
+        {
+            if (section.BlockType >= grid.NumBlockTypes || section.BaseIndex != uNextIndex || section.NumIndices % 6u != 0u)
+            {
+                std::printf("[FAIL] %s: malformed section\n", pszName);
+                return false;
+            }
+            uNextIndex += section.NumIndices;
+
+            for (uint32_t i = 0u; i < section.NumIndices; i += 6u)
+            {
+                const library::GreedyMeshVertex* apCorners[3];
+                for (uint32_t uCorner = 0u; uCorner < 3u; ++uCorner)
+                {
+                    const size_t uVertex = static_cast<size_t>(section.BaseVertex) + meshData.Indices[section.BaseIndex + i + uCorner];
+                    if (uVertex >= meshData.Vertices.size())
+                    {
+                        std::printf("[FAIL] %s: index out of range\n", pszName);
+                        return false;
+                    }
+                    apCorners[uCorner] = &meshData.Vertices[uVertex];
+                }
+
+                // Quads are axis aligned, the area is |edge1 x edge2|
+                double aEdge1[3];
+                double aEdge2[3];
+                for (uint32_t axis = 0u; axis < 3u; ++axis)
+                {
+                    aEdge1[axis] = static_cast<double>(apCorners[1]->Position[axis]) - apCorners[0]->Position[axis];
+                    aEdge2[axis] = static_cast<double>(apCorners[2]->Position[axis]) - apCorners[0]->Position[axis];
+                }
+                const double aCross[3] =
+                {
+                    aEdge1[1] * aEdge2[2] - aEdge1[2] * aEdge2[1],
+                    aEdge1[2] * aEdge2[0] - aEdge1[0] * aEdge2[2],
+                    aEdge1[0] * aEdge2[1] - aEdge1[1] * aEdge2[0],
+                };
+
+                const uint32_t uDirection = getDirection(apCorners[0]->Normal);
+                if (uDirection == NUM_DIRECTIONS)
+                {
+                    std::printf("[FAIL] %s: unexpected normal\n", pszName);
+                    return false;
+                }
+
+                aAreas[static_cast<size_t>(section.BlockType) * NUM_DIRECTIONS + uDirection] +=
+                    static_cast<uint64_t>(std::llround(std::sqrt(aCross[0] * aCross[0] + aCross[1] * aCross[1] + aCross[2] * aCross[2])));
+            }
+        }
+
+        if (uNextIndex != meshData.Indices.size())
+        {
+            std::printf("[FAIL] %s: sections cover %zu of %zu indices\n", pszName, uNextIndex, meshData.Indices.size());
+            return false;
+        }
+
+        if (aAreas != aFaces)
+        {
+            std::printf("[FAIL] %s: quad areas differ from the brute force face count\n", pszName);
+            return false;
+        }
+
+        std::printf(
+            "[ OK ] %s: %llu faces, %zu quads, %zu vertices, %zu indices, %zu sections\n",
+            pszName,
+            static_cast<unsigned long long>(uNumFaces),
+            uNumQuads,
+            meshData.Vertices.size(),
+            meshData.Indices.size(),
+            meshData.Sections.size()
+        );
+
+        if (puNumQuads)
+        {
+            *puNumQuads = uNumQuads;
+        }
+
+        return true;
+    }
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: RunGreedyMesherTests
+
+  Summary:  Runs the test cases of the greedy mesher
+
+  Returns:  bool
+              True if every test case passed
+F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+bool RunGreedyMesherTests()
+{
+    bool bPassed = true;
+
+    // A flat chunk merges into one top quad and one quad per side
+    {
+        TestGrid grid =
+        {
+            .Width = 32u,
+            .Depth = 32u,
+            .NumBlockTypes = 1u,
+            .aBlockTypes = std::vector<uint8_t>(32u * 32u, 0u),
+            .aColumnHeights = std::vector<uint16_t>(32u * 32u, 4u),
+        };
+
+        size_t uNumQuads = 0u;
+        bPassed &= checkChunk("flat", grid, 0u, 0u, 32u, 32u, &uNumQuads);
+        if (uNumQuads != 5u)
+        {
+            std::printf("[FAIL] flat: %zu quads instead of 5\n", uNumQuads);
+            bPassed = false;
+        }
+    }
+
+    // Random terrain, chunks inside and on the border of the grid
+    {
+        const TestGrid grid = makeRandomGrid(80u, 72u, 6u, 24u, 1u);
+        bPassed &= checkChunk("random interior", grid, 32u, 32u, 32u, 32u);
+        bPassed &= checkChunk("random border", grid, 64u, 64u, 16u, 8u);
+        bPassed &= checkChunk("random whole grid", grid, 0u, 0u, 80u, 72u);
+    }
+
+    // A large noisy chunk has more vertices than 16-bit indices can
+    // address, so its block types are split into several sections
+    {
+        const TestGrid grid = makeRandomGrid(128u, 128u, 2u, 24u, 2u);
+
+        size_t uNumQuads = 0u;
+        bPassed &= checkChunk("split sections", grid, 0u, 0u, 128u, 128u, &uNumQuads);
+        if (uNumQuads * 4u <= library::GreedyMesher::MAX_SECTION_VERTICES * 2u)
+        {
+            std::printf("[FAIL] split sections: the mesh fits in one section per block type\n");
+            bPassed = false;
+        }
+    }
+
+    return bPassed;
+}
@@ -0,0 +1,586 @@
+/*+===================================================================
+  File:      HEIGHTMAPTEST.CPP
+
+  Summary:   Headless test of the text height map parser and of the
+             voxel instance extraction. Maps are parsed serially and
+             on thread pools of several sizes and compared with the
+             istream loader and the single-pass instance loop the
+             parallel code replaced.
+
+  Functions: RunHeightMapTests
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Scene/HeightMapText.h"
+#include "Scene/VoxelInstanceExtractor.h"
+#include "Thread/ThreadPool.h"
+
+#include "Tests.h"
+
+namespace
+{
+    constexpr const char FIRST_BLOCK_TYPE = 21;
+    constexpr const uint32_t NUM_BLOCK_TYPES = 15u;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   GridInstance
+
+      Summary:  Grid position of an emitted cube
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct GridInstance
+    {
+        uint32_t X;
+        uint32_t H;
+        uint32_t Z;
+
+        bool operator==(const GridInstance& other) const = default;
+    };
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: parseWithIstream
+
+      Summary:  The istream loader text height maps were read with
+                before the parser was split into line ranges, kept as
+                the reference
+
+      Args:     const std::string& text
+                  Text height map
+                library::HeightMapTextData& outData
+                  Parsed height map
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void parseWithIstream(const std::string& text, library::HeightMapTextData& outData)
+    {
+        std::istringstream inputFile(text);
+
+        std::string trash;
+        uint32_t aDimension[4] = { 0u, };
+        uint32_t uDimensionIdx = 0u;
+        while (!inputFile.eof() && uDimensionIdx < 4u)
+        {
+            inputFile >> aDimension[uDimensionIdx];
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                {
+                    break;
+                }
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else
+            {
+                ++uDimensionIdx;
+            }
+        }
+
+        outData.Width = aDimension[0];
+        outData.Height = aDimension[1];
+        outData.Depth = aDimension[2];
+        outData.Colors.clear();
+
+        std::array<float, 3> color;
+        while (!inputFile.eof() && outData.Colors.size() < aDimension[3])
+        {
+            inputFile >> color[0] >> color[1] >> color[2];
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                {
+                    break;
+                }
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else
+            {
+                outData.Colors.push_back(color);
+            }
+        }
+
+        const size_t uNumColumns = static_cast<size_t>(outData.Width) * static_cast<size_t>(outData.Depth);
+        outData.BlockTypes.assign(uNumColumns, library::HeightMapText::INVALID_BLOCK_TYPE);
+        outData.ColumnHeights.assign(uNumColumns, 0u);
+
+        size_t uColumnIdx = 0u;
+        char voxelType;
+        float height;
+        while (!inputFile.eof() && uColumnIdx < uNumColumns)
+        {
+            inputFile >> voxelType >> height;
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                {
+                    break;
+                }
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else if (FIRST_BLOCK_TYPE <= voxelType && voxelType < FIRST_BLOCK_TYPE + static_cast<char>(NUM_BLOCK_TYPES))
+            {
+                float columnHeight = static_cast<float>(outData.Height) * height;
+                columnHeight = columnHeight < 0.0f ? 0.0f : columnHeight;
+                columnHeight = columnHeight > static_cast<float>(0xFFFF) ? static_cast<float>(0xFFFF) : columnHeight;
+
+                outData.BlockTypes[uColumnIdx] = static_cast<uint8_t>(voxelType - FIRST_BLOCK_TYPE);
+                outData.ColumnHeights[uColumnIdx] = static_cast<uint16_t>(columnHeight);
+                ++uColumnIdx;
+            }
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: extractWithSinglePass
+
+      Summary:  The instance loop voxels were created with before the
+                extraction was split into chunks: one pass over the
+                whole grid, row by row, into a buffer per block type
+
+      Args:     const library::VoxelGridView& grid
+                  Block / height grid
+                bool bSurface
+                  Whether only the surface cubes are emitted
+
+      Returns:  std::vector<std::vector<GridInstance>>
+                  Instances per block type
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    std::vector<std::vector<GridInstance>> extractWithSinglePass(const library::VoxelGridView& grid, bool bSurface)
+    {
+        auto getColumnHeight = [&](int32_t x, int32_t z) -> uint32_t
+        {
+            if (x < 0 || z < 0 || x >= static_cast<int32_t>(grid.Width) || z >= static_cast<int32_t>(grid.Depth))
+            {
+                return 0u;
+            }
+
+            const size_t uColumnIdx = static_cast<size_t>(z) * grid.Width + static_cast<size_t>(x);
+            return grid.BlockTypes[uColumnIdx] < grid.NumBlockTypes ? grid.ColumnHeights[uColumnIdx] : 0u;
+        };
+
+        auto getLowestHeight = [&](uint32_t uWidthIdx, uint32_t uDepthIdx) -> uint32_t
+        {
+            if (!bSurface)
+            {
+                return 0u;
+            }
+
+            const int32_t x = static_cast<int32_t>(uWidthIdx);
+            const int32_t z = static_cast<int32_t>(uDepthIdx);
+            return (std::min)(
+                {
+                    getColumnHeight(x, z) - 1u,
+                    getColumnHeight(x - 1, z),
+                    getColumnHeight(x + 1, z),
+                    getColumnHeight(x, z - 1),
+                    getColumnHeight(x, z + 1),
+                }
+            );
+        };
+
+        std::vector<std::vector<GridInstance>> aInstances(grid.NumBlockTypes);
+        for (uint32_t uDepthIdx = 0u; uDepthIdx < grid.Depth; ++uDepthIdx)
+        {
+            for (uint32_t uWidthIdx = 0u; uWidthIdx < grid.Width; ++uWidthIdx)
+            {
+                const size_t uColumnIdx = static_cast<size_t>(uDepthIdx) * grid.Width + uWidthIdx;
+                const uint8_t blockType = grid.BlockTypes[uColumnIdx];
+                if (blockType >= grid.NumBlockTypes || grid.ColumnHeights[uColumnIdx] == 0u)
+                {
+                    continue;
+                }
+
+                for (uint32_t heightIdx = getLowestHeight(uWidthIdx, uDepthIdx); heightIdx < grid.ColumnHeights[uColumnIdx]; ++heightIdx)
+                {
+                    aInstances[blockType].push_back(GridInstance{ .X = uWidthIdx, .H = heightIdx, .Z = uDepthIdx });
+                }
+            }
+        }
+
+        return aInstances;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: makeRandomMap
+
+      Summary:  Writes a text height map with random block types and
+                heights. The heights and colors are multiples of 1/256,
+                so every parser reads them exactly. A few columns have
+                an unknown block type, a few heights are out of [0, 1]
+
+      Args:     uint32_t uWidth
+                  Number of columns along the x-axis
+                uint32_t uDepth
+                  Number of columns along the z-axis
+                const char* pszNewLine
+                  Line ending
+                bool bFinalNewLine
+                  Whether the last line is terminated
+                uint32_t uSeed
+                  Seed of the generator
+
+      Returns:  std::string
+                  Text height map
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    std::string makeRandomMap(uint32_t uWidth, uint32_t uDepth, const char* pszNewLine, bool bFinalNewLine, uint32_t uSeed)
+    {
+        std::mt19937 generator(uSeed);
+        std::uniform_int_distribution<uint32_t> blockTypes(0u, NUM_BLOCK_TYPES + 1u);
+        std::uniform_int_distribution<int32_t> heights(-16, 300);
+        std::uniform_int_distribution<uint32_t> colors(0u, 256u);
+        std::uniform_int_distribution<uint32_t> entriesPerLine(1u, 9u);
+
+        char szNumber[32];
+        std::string text;
+        text += std::to_string(uWidth) + " 48 " + std::to_string(uDepth) + " " + std::to_string(NUM_BLOCK_TYPES) + pszNewLine;
+        for (uint32_t uColorIdx = 0u; uColorIdx < NUM_BLOCK_TYPES; ++uColorIdx)
+        {
+            for (uint32_t uChannelIdx = 0u; uChannelIdx < 3u; ++uChannelIdx)
+            {
+                std::snprintf(szNumber, sizeof(szNumber), uChannelIdx == 0u ? "%.8g" : " %.8g", static_cast<double>(colors(generator)) / 256.0);
+                text += szNumber;
+            }
+            text += pszNewLine;
+        }
+
+        const size_t uNumColumns = static_cast<size_t>(uWidth) * static_cast<size_t>(uDepth);
+        size_t uColumnIdx = 0u;
+        while (uColumnIdx < uNumColumns)
+        {
+            const uint32_t uNumEntries = entriesPerLine(generator);
+            for (uint32_t uEntryIdx = 0u; uEntryIdx < uNumEntries && uColumnIdx < uNumColumns; ++uEntryIdx, ++uColumnIdx)
+            {
+                // The last block type is unknown and skipped by both
+                // parsers, which shifts the columns after it. The
+                // character of block type 11 is a space, it cannot be
+                // written to a text map and is replaced by an unknown
+                // one too
+                const uint32_t uBlockType = blockTypes(generator);
+                const char voxelType = uBlockType < NUM_BLOCK_TYPES && FIRST_BLOCK_TYPE + static_cast<char>(uBlockType) != ' '
+                    ? static_cast<char>(FIRST_BLOCK_TYPE + static_cast<char>(uBlockType))
+                    : 'A';
+                std::snprintf(szNumber, sizeof(szNumber), "%.8g", static_cast<double>(heights(generator)) / 256.0);
+
+                if (uEntryIdx > 0u)
+                {
+                    text += uEntryIdx % 3u == 0u ? "\t" : " ";
+                }
+                text += voxelType;
+                text += ' ';
+                text += szNumber;
+            }
+
+            if (uColumnIdx < uNumColumns || bFinalNewLine)
+            {
+                text += pszNewLine;
+            }
+        }
+
+        return text;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: checkParse
+
+      Summary:  Compares the parse of the text with the istream loader
+                on the calling thread and on pools of several sizes
+
+      Args:     const char* pszName
+                  Name of the test case
+                const std::string& text
+                  Text height map
+                library::HeightMapTextData& outReference
+                  Map read by the istream loader
+
+      Returns:  bool
+                  True if every parse matches the istream loader
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    bool checkParse(const char* pszName, const std::string& text, library::HeightMapTextData& outReference)
+    {
+        parseWithIstream(text, outReference);
+
+        const uint32_t aNumThreads[] = { 0u, 1u, 3u, 7u };
+        for (uint32_t uNumThreads : aNumThreads)
+        {
+            std::unique_ptr<library::ThreadPool> threadPool = uNumThreads > 0u ? std::make_unique<library::ThreadPool>(uNumThreads) : nullptr;
+
+            library::HeightMapTextData data;
+            library::HeightMapText::Parse(text.data(), text.data() + text.size(), FIRST_BLOCK_TYPE, NUM_BLOCK_TYPES, threadPool.get(), data);
+
+            const char* pszMismatch = nullptr;
+            if (data.Width != outReference.Width || data.Height != outReference.Height || data.Depth != outReference.Depth)
+            {
+                pszMismatch = "dimensions";
+            }
+            else if (data.Colors.size() != outReference.Colors.size()
+                || (!data.Colors.empty() && std::memcmp(data.Colors.data(), outReference.Colors.data(), data.Colors.size() * sizeof(data.Colors[0])) != 0))
+            {
+                pszMismatch = "colors";
+            }
+            else if (data.BlockTypes != outReference.BlockTypes)
+            {
+                pszMismatch = "block types";
+            }
+            else if (data.ColumnHeights != outReference.ColumnHeights)
+            {
+                pszMismatch = "column heights";
+            }
+
+            if (pszMismatch)
+            {
+                std::printf("[FAIL] %s: %s differ from the istream loader with %u threads\n", pszName, pszMismatch, uNumThreads);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: checkInstances
+
+      Summary:  Extracts the instances chunk by chunk on a thread pool
+                and compares every per-type chunk buffer with the
+                instances of the chunk the single pass emitted, in the
+                same order
+
+      Args:     const char* pszName
+                  Name of the test case
+                const library::HeightMapTextData& data
+                  Parsed height map
+                bool bSurface
+                  Whether only the surface cubes are emitted
+                uint32_t uChunkSize
+                  Number of columns along a side of a chunk
+                library::ThreadPool* pThreadPool
+                  Pool to extract the chunks on, nullptr to extract
+                  them on the calling thread
+
+      Returns:  bool
+                  True if every buffer matches
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    bool checkInstances(
+        const char* pszName,
+        const library::HeightMapTextData& data,
+        bool bSurface,
+        uint32_t uChunkSize,
+        library::ThreadPool* pThreadPool
+    )
+    {
+        const library::VoxelGridView grid =
+        {
+            .Width = data.Width,
+            .Depth = data.Depth,
+            .NumBlockTypes = static_cast<uint32_t>(data.Colors.size()),
+            .BlockTypes = data.BlockTypes.data(),
+            .ColumnHeights = data.ColumnHeights.data(),
+        };
+
+        const uint32_t uNumChunksX = (grid.Width + uChunkSize - 1u) / uChunkSize;
+        const uint32_t uNumChunksZ = (grid.Depth + uChunkSize - 1u) / uChunkSize;
+        const size_t uNumChunks = static_cast<size_t>(uNumChunksX) * static_cast<size_t>(uNumChunksZ);
+        std::vector<std::vector<std::vector<GridInstance>>> aChunkInstances(uNumChunks);
+        std::vector<library::ChunkInstanceCounts> aChunkCounts(uNumChunks);
+        auto extractChunks = [&](size_t uBegin, size_t uEnd)
+        {
+            for (size_t uChunkIdx = uBegin; uChunkIdx < uEnd; ++uChunkIdx)
+            {
+                const uint32_t uOriginX = static_cast<uint32_t>(uChunkIdx % uNumChunksX) * uChunkSize;
+                const uint32_t uOriginZ = static_cast<uint32_t>(uChunkIdx / uNumChunksX) * uChunkSize;
+                const uint32_t uSizeX = (std::min)(uChunkSize, grid.Width - uOriginX);
+                const uint32_t uSizeZ = (std::min)(uChunkSize, grid.Depth - uOriginZ);
+
+                library::VoxelInstanceExtractor::CountChunk(grid, bSurface, uOriginX, uOriginZ, uSizeX, uSizeZ, aChunkCounts[uChunkIdx]);
+
+                std::vector<std::vector<GridInstance>>& aInstances = aChunkInstances[uChunkIdx];
+                aInstances.resize(grid.NumBlockTypes);
+                library::VoxelInstanceExtractor::ForEachInstance(
+                    grid,
+                    bSurface,
+                    uOriginX,
+                    uOriginZ,
+                    uSizeX,
+                    uSizeZ,
+                    [&](uint32_t uBlockType, uint32_t x, uint32_t h, uint32_t z)
+                    {
+                        aInstances[uBlockType].push_back(GridInstance{ .X = x, .H = h, .Z = z });
+                    }
+                );
+            }
+        };
+
+        if (pThreadPool)
+        {
+            pThreadPool->ParallelFor(uNumChunks, 1u, extractChunks);
+        }
+        else
+        {
+            extractChunks(0u, uNumChunks);
+        }
+
+        const std::vector<std::vector<GridInstance>> aReference = extractWithSinglePass(grid, bSurface);
+        std::vector<GridInstance> aExpected;
+        for (size_t uChunkIdx = 0u; uChunkIdx < uNumChunks; ++uChunkIdx)
+        {
+            const uint32_t uOriginX = static_cast<uint32_t>(uChunkIdx % uNumChunksX) * uChunkSize;
+            const uint32_t uOriginZ = static_cast<uint32_t>(uChunkIdx / uNumChunksX) * uChunkSize;
+            for (uint32_t uBlockType = 0u; uBlockType < grid.NumBlockTypes; ++uBlockType)
+            {
+                aExpected.clear();
+                std::copy_if(
+                    aReference[uBlockType].begin(),
+                    aReference[uBlockType].end(),
+                    std::back_inserter(aExpected),
+                    [&](const GridInstance& instance)
+                    {
+                        return instance.X - uOriginX < uChunkSize && instance.Z - uOriginZ < uChunkSize;
+                    }
+                );
+
+                if (aChunkInstances[uChunkIdx][uBlockType] != aExpected)
+                {
+                    std::printf(
+                        "[FAIL] %s: chunk (%u, %u) has %zu instances of block type %u instead of the single pass' %zu, or in another order\n",
+                        pszName,
+                        uOriginX / uChunkSize,
+                        uOriginZ / uChunkSize,
+                        aChunkInstances[uChunkIdx][uBlockType].size(),
+                        uBlockType,
+                        aExpected.size()
+                    );
+                    return false;
+                }
+
+                if (aChunkCounts[uChunkIdx].NumInstances[uBlockType] != aExpected.size())
+                {
+                    std::printf(
+                        "[FAIL] %s: chunk (%u, %u) counts %zu instances of block type %u but emits %zu\n",
+                        pszName,
+                        uOriginX / uChunkSize,
+                        uOriginZ / uChunkSize,
+                        aChunkCounts[uChunkIdx].NumInstances[uBlockType],
+                        uBlockType,
+                        aExpected.size()
+                    );
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: checkMap
+
+      Summary:  Checks the parse of a map and the instances of both
+                extraction modes with a few chunk sizes and pools
+
+      Args:     const char* pszName
+                  Name of the test case
+                const std::string& text
+                  Text height map
+
+      Returns:  bool
+                  True if all checks passed
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    bool checkMap(const char* pszName, const std::string& text)
+    {
+        library::HeightMapTextData data;
+        if (!checkParse(pszName, text, data))
+        {
+            return false;
+        }
+
+        library::ThreadPool threadPool(3u);
+        const uint32_t aChunkSizes[] = { 32u, 7u };
+        for (uint32_t uChunkSize : aChunkSizes)
+        {
+            for (bool bSurface : { true, false })
+            {
+                if (!checkInstances(pszName, data, bSurface, uChunkSize, nullptr) || !checkInstances(pszName, data, bSurface, uChunkSize, &threadPool))
+                {
+                    return false;
+                }
+            }
+        }
+
+        const size_t uNumValidColumns = static_cast<size_t>(
+            std::count_if(
+                data.BlockTypes.begin(),
+                data.BlockTypes.end(),
+                [&](uint8_t blockType)
+                {
+                    return blockType < data.Colors.size();
+                }
+            )
+        );
+        std::printf(
+            "[ OK ] %s: %ux%u map, %zu of %zu columns, %zu colors match\n",
+            pszName,
+            data.Width,
+            data.Depth,
+            uNumValidColumns,
+            data.BlockTypes.size(),
+            data.Colors.size()
+        );
+
+        return true;
+    }
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: RunHeightMapTests
+
+  Summary:  Runs the test cases of the height map parser and of the
+            instance extraction
+
+  Returns:  bool
+              True if every test case passed
+F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+bool RunHeightMapTests()
+{
+    bool bPassed = true;
+
+    bPassed &= checkMap("height map LF", makeRandomMap(150u, 97u, "\n", true, 1u));
+    bPassed &= checkMap("height map CRLF", makeRandomMap(150u, 97u, "\r\n", true, 2u));
+    bPassed &= checkMap("height map without final LF", makeRandomMap(61u, 40u, "\n", false, 3u));
+    bPassed &= checkMap("height map without final CRLF", makeRandomMap(61u, 40u, "\r\n", false, 4u));
+
+    // Unreadable tokens in the header, the palette and between the
+    // columns, unknown block types, heights out of range and fewer
+    // columns than the dimensions ask for
+    bPassed &= checkMap(
+        "height map malformed",
+        "8 x 20 4 3\r\n"
+        "0.125 0.25 0.375\r\n"
+        "0.5 q 0.625 0.75 0.875\r\n"
+        "1 1 1\r\n"
+        "\x15 0.5 \x16 abc \x17 0.25\r\n"
+        "A 0.5 \x18 1.5 \x14 0.5 \x24 0.5\r\n"
+        "\x19 -0.5 \x1A 1e9 \x1B +0.75 \x1C .5\r\n"
+        "\x1D 0.5junk \x1E 0.0625\r\n"
+        "\x15 0.75\t\x16 0.875 \x17"
+    );
+
+    // More columns than the dimensions ask for, the rest is ignored
+    bPassed &= checkMap("height map extra columns", "2 16 2 1\n0 0.5 1\n\x15 1 \x15 0.5\n\x15 0.25 \x15 0.75\n\x15 1 \x15 1\n");
+
+    bPassed &= checkMap("height map header only", "4 16 4 2\n");
+    bPassed &= checkMap("height map empty", "");
+
+    return bPassed;
+}
@@ -0,0 +1,429 @@
+/*+===================================================================
+  File:      OCCLUSIONRASTERIZERTEST.CPP
+
+  Summary:   Headless test of the software occlusion rasterizer. Boxes
+             behind a full-screen occluder must be hidden, boxes in
+             front of it visible, occluders crossing the near plane
+             must be clipped and the chunk boxes must be skipped when
+             the eye is inside or below them.
+
+  Functions: RunOcclusionRasterizerTests
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+#include "Renderer/OcclusionRasterizer.h"
+#include "Thread/ThreadPool.h"
+
+#include "Tests.h"
+
+namespace
+{
+    constexpr const float NEAR_PLANE = 0.1f;
+    constexpr const float FAR_PLANE = 1000.0f;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   Camera
+
+      Summary:  Row-major view-projection matrix of a left-handed
+                camera, the layout the renderer passes to Begin
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct Camera
+    {
+        float Eye[3];
+        float ViewProjection[16];
+    };
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: makeCamera
+
+      Summary:  Builds the view-projection of a camera the same way
+                XMMatrixLookAtLH and XMMatrixPerspectiveFovLH do, with
+                a 90 degree vertical field of view
+
+      Args:     float eyeX, eyeY, eyeZ
+                  Position of the camera
+                float atX, atY, atZ
+                  Point the camera looks at
+                float aspectRatio
+                  Width over height of the screen
+
+      Returns:  Camera
+                  Camera
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    Camera makeCamera(float eyeX, float eyeY, float eyeZ, float atX, float atY, float atZ, float aspectRatio)
+    {
+        const float aEye[3] = { eyeX, eyeY, eyeZ };
+        float aAxisZ[3] = { atX - eyeX, atY - eyeY, atZ - eyeZ };
+        const float lengthZ = std::sqrt(aAxisZ[0] * aAxisZ[0] + aAxisZ[1] * aAxisZ[1] + aAxisZ[2] * aAxisZ[2]);
+        for (float& component : aAxisZ)
+        {
+            component /= lengthZ;
+        }
+
+        // x = normalize(cross(up, z)) with up = (0, 1, 0), y = cross(z, x)
+        float aAxisX[3] = { aAxisZ[2], 0.0f, -aAxisZ[0] };
+        const float lengthX = std::sqrt(aAxisX[0] * aAxisX[0] + aAxisX[2] * aAxisX[2]);
+        aAxisX[0] /= lengthX;
+        aAxisX[2] /= lengthX;
+        const float aAxisY[3] =
+        {
+            aAxisZ[1] * aAxisX[2] - aAxisZ[2] * aAxisX[1],
+            aAxisZ[2] * aAxisX[0] - aAxisZ[0] * aAxisX[2],
+            aAxisZ[0] * aAxisX[1] - aAxisZ[1] * aAxisX[0],
+        };
+
+        const float* apAxes[3] = { aAxisX, aAxisY, aAxisZ };
+        float aView[16] = { 0.0f, };
+        for (uint32_t uAxisIdx = 0u; uAxisIdx < 3u; ++uAxisIdx)
+        {
+            const float* pAxis = apAxes[uAxisIdx];
+            aView[0u * 4u + uAxisIdx] = pAxis[0];
+            aView[1u * 4u + uAxisIdx] = pAxis[1];
+            aView[2u * 4u + uAxisIdx] = pAxis[2];
+            aView[3u * 4u + uAxisIdx] = -(pAxis[0] * aEye[0] + pAxis[1] * aEye[1] + pAxis[2] * aEye[2]);
+        }
+        aView[15] = 1.0f;
+
+        const float scaleY = 1.0f / std::tan(0.25f * 3.14159265f);
+        const float range = FAR_PLANE / (FAR_PLANE - NEAR_PLANE);
+        const float aProjection[16] =
+        {
+            scaleY / aspectRatio, 0.0f, 0.0f, 0.0f,
+            0.0f, scaleY, 0.0f, 0.0f,
+            0.0f, 0.0f, range, 1.0f,
+            0.0f, 0.0f, -range * NEAR_PLANE, 0.0f,
+        };
+
+        Camera camera = { .Eye = { eyeX, eyeY, eyeZ }, .ViewProjection = { 0.0f, } };
+        for (uint32_t uRow = 0u; uRow < 4u; ++uRow)
+        {
+            for (uint32_t uColumn = 0u; uColumn < 4u; ++uColumn)
+            {
+                for (uint32_t k = 0u; k < 4u; ++k)
+                {
+                    camera.ViewProjection[uRow * 4u + uColumn] += aView[uRow * 4u + k] * aProjection[k * 4u + uColumn];
+                }
+            }
+        }
+
+        return camera;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: checkVisibility
+
+      Summary:  Tests a box against the depth buffer
+
+      Args:     const char* pszName
+                  Name of the test case
+                const library::OcclusionRasterizer& rasterizer
+                  Rasterizer after Rasterize
+                const float* pMin
+                  Minimum corner of the box
+                const float* pMax
+                  Maximum corner of the box
+                bool bExpected
+                  Whether the box must be visible
+
+      Returns:  bool
+                  True if the visibility is the expected one
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    bool checkVisibility(
+        const char* pszName,
+        const library::OcclusionRasterizer& rasterizer,
+        const float* pMin,
+        const float* pMax,
+        bool bExpected
+    )
+    {
+        if (rasterizer.IsVisible(pMin, pMax) != bExpected)
+        {
+            std::printf(
+                "[FAIL] %s: box (%g, %g, %g) - (%g, %g, %g) is %s\n",
+                pszName,
+                pMin[0],
+                pMin[1],
+                pMin[2],
+                pMax[0],
+                pMax[1],
+                pMax[2],
+                bExpected ? "hidden" : "visible"
+            );
+            return false;
+        }
+
+        return true;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: testFullScreenOccluder
+
+      Summary:  A wall covering the whole screen hides a box behind it
+                and not a box in front of it
+
+      Returns:  bool
+                  True if all checks passed
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    bool testFullScreenOccluder()
+    {
+        library::OcclusionRasterizer rasterizer;
+        const Camera camera = makeCamera(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 320.0f / 192.0f);
+
+        const float aBehindMin[3] = { -1.0f, -1.0f, 20.0f };
+        const float aBehindMax[3] = { 1.0f, 1.0f, 22.0f };
+        const float aFrontMin[3] = { -1.0f, -1.0f, 5.0f };
+        const float aFrontMax[3] = { 1.0f, 1.0f, 6.0f };
+
+        // Nothing is hidden before an occluder is drawn
+        rasterizer.Begin(camera.ViewProjection);
+        rasterizer.Rasterize();
+        if (!checkVisibility("occlusion empty", rasterizer, aBehindMin, aBehindMax, true))
+        {
+            return false;
+        }
+
+        const float aWallMin[3] = { -100.0f, -100.0f, 10.0f };
+        const float aWallMax[3] = { 100.0f, 100.0f, 11.0f };
+        rasterizer.Begin(camera.ViewProjection);
+        rasterizer.AddOccluderBox(aWallMin, aWallMax);
+        rasterizer.Rasterize();
+
+        const float* pDepth = rasterizer.GetDepthBuffer();
+        const size_t uNumPixels = static_cast<size_t>(rasterizer.GetWidth()) * rasterizer.GetHeight();
+        for (size_t i = 0u; i < uNumPixels; ++i)
+        {
+            if (!(pDepth[i] < 1.0f))
+            {
+                std::printf("[FAIL] occlusion full screen: pixel %zu has depth %g, the wall does not cover it\n", i, pDepth[i]);
+                return false;
+            }
+        }
+
+        if (!checkVisibility("occlusion full screen", rasterizer, aBehindMin, aBehindMax, false) ||
+            !checkVisibility("occlusion full screen", rasterizer, aFrontMin, aFrontMax, true))
+        {
+            return false;
+        }
+
+        std::printf("[ OK ] occlusion full screen: box behind the wall hidden, box in front visible\n");
+
+        return true;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: testNearPlaneClipping
+
+      Summary:  A ground quad reaching behind the camera is clipped at
+                the near plane instead of being dropped or projected
+                through the eye
+
+      Returns:  bool
+                  True if all checks passed
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    bool testNearPlaneClipping()
+    {
+        static constexpr const uint16_t QUAD_INDICES[] = { 0, 1, 2,  0, 2, 3 };
+        const float aGround[4][3] =
+        {
+            { -100.0f, 0.0f, -100.0f },
+            { -100.0f, 0.0f, 100.0f },
+            { 100.0f, 0.0f, 100.0f },
+            { 100.0f, 0.0f, -100.0f },
+        };
+
+        library::OcclusionRasterizer rasterizer;
+        const Camera camera = makeCamera(0.0f, 2.0f, 0.0f, 0.0f, 1.0f, 10.0f, 320.0f / 192.0f);
+        rasterizer.Begin(camera.ViewProjection);
+        rasterizer.AddOccluderTriangles(&aGround[0][0], sizeof(aGround[0]), QUAD_INDICES, static_cast<uint32_t>(std::size(QUAD_INDICES)));
+        rasterizer.Rasterize();
+
+        // Both triangles cross the near plane. The first one has one
+        // corner behind it and is split in two, the second has two
+        // corners behind it and stays one
+        if (rasterizer.GetNumTriangles() != 3u)
+        {
+            std::printf("[FAIL] occlusion near plane: %u triangles after clipping\n", rasterizer.GetNumTriangles());
+            return false;
+        }
+
+        const float* pDepth = rasterizer.GetDepthBuffer();
+        const size_t uNumPixels = static_cast<size_t>(rasterizer.GetWidth()) * rasterizer.GetHeight();
+        size_t uNumCovered = 0u;
+        for (size_t i = 0u; i < uNumPixels; ++i)
+        {
+            if (!std::isfinite(pDepth[i]) || pDepth[i] < 0.0f || pDepth[i] > 1.0f)
+            {
+                std::printf("[FAIL] occlusion near plane: pixel %zu has depth %g\n", i, pDepth[i]);
+                return false;
+            }
+            uNumCovered += pDepth[i] < 1.0f ? 1u : 0u;
+        }
+
+        // The bottom row looks down at the ground right in front of the
+        // camera, which only the clipped triangles cover
+        const float* pBottomRow = pDepth + static_cast<size_t>(rasterizer.GetHeight() - 1u) * rasterizer.GetWidth();
+        for (uint32_t x = 0u; x < rasterizer.GetWidth(); ++x)
+        {
+            if (!(pBottomRow[x] < 1.0f))
+            {
+                std::printf("[FAIL] occlusion near plane: bottom row pixel %u is not covered\n", x);
+                return false;
+            }
+        }
+
+        const float aBelowMin[3] = { -1.0f, -3.0f, 20.0f };
+        const float aBelowMax[3] = { 1.0f, -1.0f, 22.0f };
+        const float aAboveMin[3] = { -1.0f, 0.5f, 20.0f };
+        const float aAboveMax[3] = { 1.0f, 1.5f, 22.0f };
+        const float aCrossingMin[3] = { -1.0f, -1.0f, -1.0f };
+        const float aCrossingMax[3] = { 1.0f, 1.0f, 1.0f };
+        if (!checkVisibility("occlusion near plane", rasterizer, aBelowMin, aBelowMax, false) ||
+            !checkVisibility("occlusion near plane", rasterizer, aAboveMin, aAboveMax, true) ||
+            !checkVisibility("occlusion near plane", rasterizer, aCrossingMin, aCrossingMax, true))
+        {
+            return false;
+        }
+
+        std::printf(
+            "[ OK ] occlusion near plane: %u triangles, %zu of %zu pixels covered, box below the ground hidden\n",
+            rasterizer.GetNumTriangles(),
+            uNumCovered,
+            uNumPixels
+        );
+
+        return true;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: checkTerrainOccluder
+
+      Summary:  Adds a chunk box seen from a camera and tests a box
+                behind it
+
+      Args:     const char* pszName
+                  Name of the test case
+                const Camera& camera
+                  Camera
+                bool bExpectedAdded
+                  Whether the chunk box must be added
+                bool bExpectedVisible
+                  Whether the box behind the chunk must be visible
+
+      Returns:  bool
+                  True if all checks passed
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    bool checkTerrainOccluder(const char* pszName, const Camera& camera, bool bExpectedAdded, bool bExpectedVisible)
+    {
+        const float aChunkMin[3] = { -8.0f, 0.0f, -8.0f };
+        const float aChunkMax[3] = { 8.0f, 16.0f, 8.0f };
+        const float aBehindMin[3] = { -1.0f, 2.0f, 20.0f };
+        const float aBehindMax[3] = { 1.0f, 4.0f, 22.0f };
+
+        library::OcclusionRasterizer rasterizer;
+        rasterizer.Begin(camera.ViewProjection);
+        const bool bAdded = rasterizer.AddTerrainOccluderBox(aChunkMin, aChunkMax, camera.Eye);
+        rasterizer.Rasterize();
+
+        if (bAdded != bExpectedAdded || (rasterizer.GetNumTriangles() > 0u) != bExpectedAdded)
+        {
+            std::printf(
+                "[FAIL] %s: chunk box %s with %u triangles\n",
+                pszName,
+                bAdded ? "added" : "skipped",
+                rasterizer.GetNumTriangles()
+            );
+            return false;
+        }
+
+        if (!checkVisibility(pszName, rasterizer, aBehindMin, aBehindMax, bExpectedVisible))
+        {
+            return false;
+        }
+
+        std::printf(
+            "[ OK ] %s: chunk box %s, box behind it %s\n",
+            pszName,
+            bAdded ? "added" : "skipped",
+            bExpectedVisible ? "visible" : "hidden"
+        );
+
+        return true;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: checkSerialParallel
+
+      Summary:  Rasterizes a grid of boxes on the calling thread and on
+                a thread pool, the depth buffers must be identical
+
+      Returns:  bool
+                  True if the depth buffers match
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    bool checkSerialParallel()
+    {
+        const Camera camera = makeCamera(0.0f, 24.0f, -40.0f, 0.0f, 0.0f, 40.0f, 320.0f / 192.0f);
+        library::OcclusionRasterizer serial;
+        library::OcclusionRasterizer parallel;
+        library::ThreadPool threadPool(3u);
+
+        serial.Begin(camera.ViewProjection);
+        parallel.Begin(camera.ViewProjection);
+        for (int32_t z = -4; z < 8; ++z)
+        {
+            for (int32_t x = -6; x < 6; ++x)
+            {
+                const float aMin[3] = { static_cast<float>(x) * 16.0f, 0.0f, static_cast<float>(z) * 16.0f };
+                const float aMax[3] = { aMin[0] + 16.0f, static_cast<float>((x * 7 + z * 5) & 15) + 1.0f, aMin[2] + 16.0f };
+                serial.AddTerrainOccluderBox(aMin, aMax, camera.Eye);
+                parallel.AddTerrainOccluderBox(aMin, aMax, camera.Eye);
+            }
+        }
+        serial.Rasterize();
+        parallel.Rasterize(&threadPool);
+
+        const size_t uNumPixels = static_cast<size_t>(serial.GetWidth()) * serial.GetHeight();
+        if (std::memcmp(serial.GetDepthBuffer(), parallel.GetDepthBuffer(), uNumPixels * sizeof(float)) != 0)
+        {
+            std::printf("[FAIL] occlusion parallel: depth buffers differ\n");
+            return false;
+        }
+
+        std::printf("[ OK ] occlusion parallel: %u triangles, depth buffers match\n", serial.GetNumTriangles());
+
+        return true;
+    }
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: RunOcclusionRasterizerTests
+
+  Summary:  Runs the test cases of the occlusion rasterizer
+
+  Returns:  bool
+              True if every test case passed
+F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+bool RunOcclusionRasterizerTests()
+{
+    bool bPassed = true;
+    bPassed &= testFullScreenOccluder();
+    bPassed &= testNearPlaneClipping();
+
+    // From outside and above the terrain the chunk hides the box
+    // behind it. From inside, on a face or from below it is skipped,
+    // so the box stays visible
+    const float aspectRatio = 320.0f / 192.0f;
+    bPassed &= checkTerrainOccluder("occlusion chunk outside", makeCamera(0.0f, 20.0f, -40.0f, 0.0f, 8.0f, 0.0f, aspectRatio), true, false);
+    bPassed &= checkTerrainOccluder("occlusion chunk eye inside", makeCamera(0.0f, 8.0f, 0.0f, 0.0f, 3.0f, 21.0f, aspectRatio), false, true);
+    bPassed &= checkTerrainOccluder("occlusion chunk eye on face", makeCamera(0.0f, 16.0f, 0.0f, 0.0f, 3.0f, 21.0f, aspectRatio), false, true);
+    bPassed &= checkTerrainOccluder("occlusion chunk eye below", makeCamera(0.0f, -5.0f, -40.0f, 0.0f, 3.0f, 21.0f, aspectRatio), false, true);
+
+    bPassed &= checkSerialParallel();
+
+    return bPassed;
+}
@@ -0,0 +1,251 @@
+/*+===================================================================
+  File:      PERLINNOISETEST.CPP
+
+  Summary:   Headless test of the batch noise paths. Every sample of
+             the SSE2 and AVX2 paths and of the dispatching batch call
+             must equal GetPerlin2d bit for bit.
+
+  Functions: RunPerlinNoiseTests
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "Scene/PerlinNoise.h"
+
+#include "Tests.h"
+
+namespace
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   NoiseSamples
+
+      Summary:  Sample positions and the parameters of one test case
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct NoiseSamples
+    {
+        std::vector<float> aX;
+        std::vector<float> aY;
+        float Frequency;
+        uint32_t uDepth;
+    };
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: makeRandomSamples
+
+      Summary:  Creates samples uniformly distributed in a square
+
+      Args:     uint32_t uCount
+                  Number of samples
+                float minimum
+                  Smallest coordinate
+                float maximum
+                  Coordinates stay below this value
+                float frequency
+                  Frequency of the first octave
+                uint32_t uDepth
+                  Number of octaves
+                uint32_t uSeed
+                  Seed of the generator
+
+      Returns:  NoiseSamples
+                  Samples
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    NoiseSamples makeRandomSamples(uint32_t uCount, float minimum, float maximum, float frequency, uint32_t uDepth, uint32_t uSeed)
+    {
+        NoiseSamples samples =
+        {
+            .aX = std::vector<float>(uCount),
+            .aY = std::vector<float>(uCount),
+            .Frequency = frequency,
+            .uDepth = uDepth,
+        };
+
+        std::mt19937 generator(uSeed);
+        std::uniform_real_distribution<float> coordinates(minimum, maximum);
+        const float largest = std::nextafter(maximum, minimum);
+        for (uint32_t i = 0u; i < uCount; ++i)
+        {
+            samples.aX[i] = (std::min)(coordinates(generator), largest);
+            samples.aY[i] = (std::min)(coordinates(generator), largest);
+        }
+
+        return samples;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: checkResults
+
+      Summary:  Compares the first uNumChecked results with GetPerlin2d
+                bit for bit
+
+      Args:     const char* pszName
+                  Name of the test case
+                const char* pszPath
+                  Name of the path that produced the results
+                const NoiseSamples& samples
+                  Samples
+                const std::vector<float>& aResults
+                  Results of the path
+                uint32_t uNumChecked
+                  Number of results the path wrote
+
+      Returns:  bool
+                  True if every result matches
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    bool checkResults(
+        const char* pszName,
+        const char* pszPath,
+        const NoiseSamples& samples,
+        const std::vector<float>& aResults,
+        uint32_t uNumChecked
+    )
+    {
+        for (uint32_t i = 0u; i < uNumChecked; ++i)
+        {
+            const float expected = library::PerlinNoise::GetPerlin2d(samples.aX[i], samples.aY[i], samples.Frequency, samples.uDepth);
+
+            uint32_t uExpectedBits;
+            uint32_t uResultBits;
+            std::memcpy(&uExpectedBits, &expected, sizeof(float));
+            std::memcpy(&uResultBits, &aResults[i], sizeof(float));
+            if (uExpectedBits != uResultBits)
+            {
+                std::printf(
+                    "[FAIL] %s (%s): sample %u at (%.9g, %.9g) is %.9g instead of %.9g\n",
+                    pszName,
+                    pszPath,
+                    i,
+                    samples.aX[i],
+                    samples.aY[i],
+                    aResults[i],
+                    expected
+                );
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: checkSamples
+
+      Summary:  Runs the SSE2 path, the AVX2 path when the CPU has it
+                and the dispatching batch call on the samples and
+                compares each of them with GetPerlin2d
+
+      Args:     const char* pszName
+                  Name of the test case
+                const NoiseSamples& samples
+                  Samples
+
+      Returns:  bool
+                  True if all checks passed
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    bool checkSamples(const char* pszName, const NoiseSamples& samples)
+    {
+        const uint32_t uCount = static_cast<uint32_t>(samples.aX.size());
+        std::vector<float> aResults(uCount);
+
+        // The vector paths leave the last samples to the scalar tail
+        const uint32_t uNumSse2 = library::PerlinNoise::GetPerlin2dBatchSse2(
+            samples.aX.data(), samples.aY.data(), uCount, samples.Frequency, samples.uDepth, aResults.data()
+        );
+        if (uNumSse2 != uCount - uCount % 4u || !checkResults(pszName, "SSE2", samples, aResults, uNumSse2))
+        {
+            if (uNumSse2 != uCount - uCount % 4u)
+            {
+                std::printf("[FAIL] %s (SSE2): %u of %u samples evaluated\n", pszName, uNumSse2, uCount);
+            }
+            return false;
+        }
+
+        const bool bAvx2Supported = library::PerlinNoise::IsAvx2Supported();
+        if (bAvx2Supported)
+        {
+            std::fill(aResults.begin(), aResults.end(), std::numeric_limits<float>::quiet_NaN());
+            const uint32_t uNumAvx2 = library::PerlinNoise::GetPerlin2dBatchAvx2(
+                samples.aX.data(), samples.aY.data(), uCount, samples.Frequency, samples.uDepth, aResults.data()
+            );
+            if (uNumAvx2 != uCount - uCount % 8u || !checkResults(pszName, "AVX2", samples, aResults, uNumAvx2))
+            {
+                if (uNumAvx2 != uCount - uCount % 8u)
+                {
+                    std::printf("[FAIL] %s (AVX2): %u of %u samples evaluated\n", pszName, uNumAvx2, uCount);
+                }
+                return false;
+            }
+        }
+
+        std::fill(aResults.begin(), aResults.end(), std::numeric_limits<float>::quiet_NaN());
+        library::PerlinNoise::GetPerlin2dBatch(samples.aX.data(), samples.aY.data(), uCount, samples.Frequency, samples.uDepth, aResults.data());
+        if (!checkResults(pszName, "batch", samples, aResults, uCount))
+        {
+            return false;
+        }
+
+        std::printf("[ OK ] %s: %u samples, SSE2%s and batch match\n", pszName, uCount, bAvx2Supported ? ", AVX2" : " (no AVX2 on this CPU)");
+
+        return true;
+    }
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: RunPerlinNoiseTests
+
+  Summary:  Runs the test cases of the batch noise paths
+
+  Returns:  bool
+              True if every test case passed
+F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+bool RunPerlinNoiseTests()
+{
+    bool bPassed = true;
+
+    // Terrain-like samples, the count is neither a multiple of 4 nor
+    // of 8 so both vector paths leave a scalar tail
+    bPassed &= checkSamples("noise terrain", makeRandomSamples(1003u, 0.0f, 4096.0f, 0.01f, 8u, 1u));
+
+    // The last octaves scale these coordinates past 2^31, where a
+    // signed conversion of the lanes would differ from the scalar one
+    bPassed &= checkSamples("noise large coordinates", makeRandomSamples(517u, 4194304.0f, 33554432.0f, 1.0f, 8u, 2u));
+
+    // Integral coordinates have no fraction, the largest ones are at
+    // and around 2^31 and just below 2^32
+    {
+        const std::vector<float> aCoordinates =
+        {
+            0.0f, 1.0f, 255.0f, 256.0f, 257.0f, 0.5f, 65535.75f, 16777215.0f,
+            2147483520.0f, 2147483648.0f, 2147483904.0f, 3221225472.0f, 4294967040.0f,
+        };
+
+        NoiseSamples samples = { .aX = {}, .aY = {}, .Frequency = 1.0f, .uDepth = 1u };
+        for (float x : aCoordinates)
+        {
+            for (float y : aCoordinates)
+            {
+                samples.aX.push_back(x);
+                samples.aY.push_back(y);
+            }
+        }
+        bPassed &= checkSamples("noise edge coordinates", samples);
+    }
+
+    // Batches shorter than a vector only run the scalar tail
+    for (uint32_t uCount = 0u; uCount < 8u; ++uCount)
+    {
+        char szName[64];
+        std::snprintf(szName, sizeof(szName), "noise %u samples", uCount);
+        bPassed &= checkSamples(szName, makeRandomSamples(uCount, 0.0f, 512.0f, 0.05f, 4u, 3u + uCount));
+    }
+
+    return bPassed;
+}
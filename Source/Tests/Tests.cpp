@@ -0,0 +1,37 @@
+/*+===================================================================
+  File:      TESTS.CPP
+
+  Summary:   Entry point of the headless tests. Runs every suite and
+             reports the result in the exit code, so the tests can
+             gate a post-build step or a CI job.
+
+  Functions: main
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#include <cstdio>
+
+#include "Tests.h"
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: main
+
+  Summary:  Runs all test suites, a failing suite does not stop the
+            ones after it
+
+  Returns:  int
+              0 if every suite passed, 1 otherwise
+F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+int main()
+{
+    bool bPassed = true;
+    bPassed &= RunCommandStreamAnalyzerTests();
+    bPassed &= RunGreedyMesherTests();
+    bPassed &= RunHeightMapTests();
+    bPassed &= RunOcclusionRasterizerTests();
+    bPassed &= RunPerlinNoiseTests();
+
+    std::printf(bPassed ? "All tests passed\n" : "Some tests failed\n");
+
+    return bPassed ? 0 : 1;
+}
@@ -0,0 +1,21 @@
+/*+===================================================================
+  File:      TESTS.H
+
+  Summary:   Tests header file declares the headless test suites run
+             by the Tests program. Every suite only depends on the
+             standard library parts of the engine, so the program
+             builds with MSVC and on Linux alike.
+
+  Functions: RunCommandStreamAnalyzerTests, RunGreedyMesherTests,
+             RunHeightMapTests, RunOcclusionRasterizerTests,
+             RunPerlinNoiseTests
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+bool RunCommandStreamAnalyzerTests();
+bool RunGreedyMesherTests();
+bool RunHeightMapTests();
+bool RunOcclusionRasterizerTests();
+bool RunPerlinNoiseTests();